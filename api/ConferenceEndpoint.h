@@ -33,6 +33,7 @@ struct ConferenceEndpointExtendedInfo
     std::string protocol;
     std::string remoteIP;
     uint16_t remotePort;
+    uint64_t iceFastPathResponses;
     ConferenceEndpoint basicEndpointInfo;
 };
 } // namespace api
\ No newline at end of file
@@ -67,7 +67,7 @@ inline void addUserMediaEndpointStart(utils::StringBuilder<1024>& outMessage, co
 #if ENABLE_LEGACY_API
     legacyapi::DataChannelMessage::addUserMediaEndpointStart(outMessage, endpointId);
 #else
-    if (!outMessage.endsWidth('['))
+    if (!outMessage.endsWith('['))
     {
         outMessage.append(",");
     }
@@ -91,7 +91,7 @@ inline void addUserMediaSsrc(utils::StringBuilder<1024>& outMessage, uint32_t ss
 #if ENABLE_LEGACY_API
     legacyapi::DataChannelMessage::addUserMediaSsrc(outMessage, ssrc);
 #else
-    if (!outMessage.endsWidth('['))
+    if (!outMessage.endsWith('['))
     {
         outMessage.append(",");
     }
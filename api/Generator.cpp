@@ -2,8 +2,10 @@
 #include "api/BarbellDescription.h"
 #include "api/ConferenceEndpoint.h"
 #include "api/EndpointDescription.h"
+#include "api/JsonWriter.h"
 #include "api/utils.h"
 #include "utils/Base64.h"
+#include "utils/StringBuilder.h"
 
 namespace
 {
@@ -28,6 +30,10 @@ nlohmann::json generateTransport(const api::Transport& transport)
         nlohmann::json iceJson;
         iceJson["ufrag"] = ice.ufrag;
         iceJson["pwd"] = ice.pwd;
+        if (ice.lite)
+        {
+            iceJson["ice-lite"] = true;
+        }
 
         iceJson["candidates"] = nlohmann::json::array();
         for (const auto& candidate : ice.candidates)
@@ -125,6 +131,181 @@ nlohmann::json generateRtpHeaderExtensions(const std::vector<std::pair<uint32_t,
     return rtpHeaderExtensionsJson;
 }
 
+// Upper bounds of the json text of the variable parts, used to size the response buffer once.
+const size_t responseBaseSize = 512;
+const size_t transportSize = 384;
+const size_t candidateSize = 224;
+const size_t payloadTypeSize = 160;
+const size_t payloadTypeEntrySize = 64;
+const size_t ssrcEntrySize = 48;
+
+size_t estimateTransportSize(const api::Transport& transport)
+{
+    const size_t candidateCount = transport.ice.isSet() ? transport.ice.get().candidates.size() : 0;
+    return transportSize + candidateCount * candidateSize + transport.sdesKeys.size() * payloadTypeEntrySize;
+}
+
+size_t estimatePayloadTypesSize(const std::vector<api::PayloadType>& payloadTypes)
+{
+    size_t size = 0;
+    for (const auto& payloadType : payloadTypes)
+    {
+        size += payloadTypeSize +
+            (payloadType.parameters.size() + payloadType.rtcpFeedbacks.size()) * payloadTypeEntrySize;
+    }
+    return size;
+}
+
+size_t estimateAllocateEndpointResponseSize(const api::EndpointDescription& channelsDescription)
+{
+    size_t size = responseBaseSize;
+    if (channelsDescription.bundleTransport.isSet())
+    {
+        size += estimateTransportSize(channelsDescription.bundleTransport.get());
+    }
+
+    if (channelsDescription.audio.isSet())
+    {
+        const auto& audio = channelsDescription.audio.get();
+        size += audio.transport.isSet() ? estimateTransportSize(audio.transport.get()) : 0;
+        size += estimatePayloadTypesSize(audio.payloadTypes);
+        size += (audio.ssrcs.size() + audio.rtpHeaderExtensions.size()) * ssrcEntrySize;
+    }
+
+    if (channelsDescription.video.isSet())
+    {
+        const auto& video = channelsDescription.video.get();
+        size += video.transport.isSet() ? estimateTransportSize(video.transport.get()) : 0;
+        size += estimatePayloadTypesSize(video.payloadTypes);
+        size += video.rtpHeaderExtensions.size() * ssrcEntrySize;
+        for (const auto& stream : video.streams)
+        {
+            size += ssrcEntrySize + stream.sources.size() * ssrcEntrySize;
+        }
+    }
+
+    return size;
+}
+
+// All strings written are produced by the bridge and need no escaping.
+template <typename TBuilder>
+void writeTransport(TBuilder& builder, const char* name, const api::Transport& transport)
+{
+    auto transportJson = json::writer::createObjectWriter(builder, name);
+    transportJson.addProperty("rtcp-mux", transport.rtcpMux);
+
+    if (transport.ice.isSet())
+    {
+        const auto& ice = transport.ice.get();
+        auto iceJson = json::writer::createObjectWriter(builder, "ice");
+        iceJson.addProperty("ufrag", ice.ufrag);
+        iceJson.addProperty("pwd", ice.pwd);
+        if (ice.lite)
+        {
+            iceJson.addProperty("ice-lite", true);
+        }
+
+        auto candidatesJson = json::writer::createArrayWriter(builder, "candidates");
+        for (const auto& candidate : ice.candidates)
+        {
+            auto candidateJson = json::writer::createObjectWriter(builder);
+            candidateJson.addProperty("generation", candidate.generation);
+            candidateJson.addProperty("component", candidate.component);
+            candidateJson.addProperty("protocol", candidate.protocol);
+            candidateJson.addProperty("port", candidate.port);
+            candidateJson.addProperty("ip", candidate.ip);
+            candidateJson.addProperty("foundation", candidate.foundation);
+            candidateJson.addProperty("priority", candidate.priority);
+            candidateJson.addProperty("type", candidate.type);
+            candidateJson.addProperty("network", candidate.network);
+            if (candidate.relPort.isSet())
+            {
+                candidateJson.addProperty("rel-port", candidate.relPort.get());
+            }
+            if (candidate.relAddr.isSet())
+            {
+                candidateJson.addProperty("rel-addr", candidate.relAddr.get());
+            }
+        }
+    }
+
+    if (transport.dtls.isSet())
+    {
+        const auto& dtls = transport.dtls.get();
+        auto dtlsJson = json::writer::createObjectWriter(builder, "dtls");
+        dtlsJson.addProperty("type", dtls.type);
+        dtlsJson.addProperty("hash", dtls.hash);
+        dtlsJson.addProperty("setup", dtls.setup);
+    }
+
+    if (!transport.sdesKeys.empty())
+    {
+        auto sdesJson = json::writer::createArrayWriter(builder, "sdes");
+        for (const auto& sdesKey : transport.sdesKeys)
+        {
+            auto sdesKeyJson = json::writer::createObjectWriter(builder);
+            sdesKeyJson.addProperty("key", utils::Base64::encode(sdesKey.keySalt, sdesKey.getLength()));
+            sdesKeyJson.addProperty("profile", api::utils::toString(sdesKey.profile));
+        }
+    }
+
+    if (transport.connection.isSet())
+    {
+        auto connectionJson = json::writer::createObjectWriter(builder, "connection");
+        connectionJson.addProperty("port", transport.connection.get().port);
+        connectionJson.addProperty("ip", transport.connection.get().ip);
+    }
+}
+
+template <typename TBuilder>
+void writePayloadTypes(TBuilder& builder, const std::vector<api::PayloadType>& payloadTypes)
+{
+    auto payloadTypesJson = json::writer::createArrayWriter(builder, "payload-types");
+    for (const auto& payloadType : payloadTypes)
+    {
+        auto payloadTypeJson = json::writer::createObjectWriter(builder);
+        payloadTypeJson.addProperty("id", payloadType.id);
+        payloadTypeJson.addProperty("name", payloadType.name);
+        payloadTypeJson.addProperty("clockrate", payloadType.clockRate);
+        if (payloadType.channels.isSet())
+        {
+            payloadTypeJson.addProperty("channels", payloadType.channels.get());
+        }
+
+        {
+            auto parametersJson = json::writer::createObjectWriter(builder, "parameters");
+            for (const auto& parameter : payloadType.parameters)
+            {
+                parametersJson.addProperty(parameter.first.c_str(), parameter.second);
+            }
+        }
+
+        auto rtcpFeedbacksJson = json::writer::createArrayWriter(builder, "rtcp-fbs");
+        for (const auto& rtcpFeedback : payloadType.rtcpFeedbacks)
+        {
+            auto rtcpFeedbackJson = json::writer::createObjectWriter(builder);
+            rtcpFeedbackJson.addProperty("type", rtcpFeedback.first);
+            if (rtcpFeedback.second.isSet())
+            {
+                rtcpFeedbackJson.addProperty("subtype", rtcpFeedback.second.get());
+            }
+        }
+    }
+}
+
+template <typename TBuilder>
+void writeRtpHeaderExtensions(TBuilder& builder,
+    const std::vector<std::pair<uint32_t, std::string>>& rtpHeaderExtensions)
+{
+    auto rtpHeaderExtensionsJson = json::writer::createArrayWriter(builder, "rtp-hdrexts");
+    for (const auto& rtpHeaderExtension : rtpHeaderExtensions)
+    {
+        auto rtpHeaderExtensionJson = json::writer::createObjectWriter(builder);
+        rtpHeaderExtensionJson.addProperty("id", rtpHeaderExtension.first);
+        rtpHeaderExtensionJson.addProperty("uri", rtpHeaderExtension.second);
+    }
+}
+
 } // namespace
 
 namespace api
@@ -216,6 +397,82 @@ nlohmann::json generateAllocateEndpointResponse(const EndpointDescription& chann
     return responseJson;
 }
 
+std::string writeAllocateEndpointResponse(const EndpointDescription& channelsDescription)
+{
+    ::utils::DynamicStringBuilder builder(estimateAllocateEndpointResponseSize(channelsDescription));
+    {
+        auto responseJson = json::writer::createObjectWriter(builder);
+
+        if (channelsDescription.bundleTransport.isSet())
+        {
+            writeTransport(builder, "bundle-transport", channelsDescription.bundleTransport.get());
+        }
+
+        if (channelsDescription.audio.isSet())
+        {
+            const auto& audio = channelsDescription.audio.get();
+            auto audioJson = json::writer::createObjectWriter(builder, "audio");
+            if (audio.transport.isSet())
+            {
+                writeTransport(builder, "transport", audio.transport.get());
+            }
+
+            {
+                auto ssrcsJson = json::writer::createArrayWriter(builder, "ssrcs");
+                for (const auto ssrc : audio.ssrcs)
+                {
+                    ssrcsJson.addElement(ssrc);
+                }
+            }
+
+            writePayloadTypes(builder, audio.payloadTypes);
+            writeRtpHeaderExtensions(builder, audio.rtpHeaderExtensions);
+        }
+
+        if (channelsDescription.video.isSet())
+        {
+            const auto& video = channelsDescription.video.get();
+            auto videoJson = json::writer::createObjectWriter(builder, "video");
+            if (video.transport.isSet())
+            {
+                writeTransport(builder, "transport", video.transport.get());
+            }
+
+            {
+                auto streamsJson = json::writer::createArrayWriter(builder, "streams");
+                for (const auto& stream : video.streams)
+                {
+                    auto streamJson = json::writer::createObjectWriter(builder);
+                    {
+                        auto sourcesJson = json::writer::createArrayWriter(builder, "sources");
+                        for (const auto level : stream.sources)
+                        {
+                            auto sourceJson = json::writer::createObjectWriter(builder);
+                            sourceJson.addProperty("main", level.main);
+                            if (level.feedback != 0)
+                            {
+                                sourceJson.addProperty("feedback", level.feedback);
+                            }
+                        }
+                    }
+                    streamJson.addProperty("content", stream.content);
+                }
+            }
+
+            writePayloadTypes(builder, video.payloadTypes);
+            writeRtpHeaderExtensions(builder, video.rtpHeaderExtensions);
+        }
+
+        if (channelsDescription.data.isSet())
+        {
+            auto dataJson = json::writer::createObjectWriter(builder, "data");
+            dataJson.addProperty("port", channelsDescription.data.get().port);
+        }
+    }
+
+    return builder.release();
+}
+
 nlohmann::json generateConferenceEndpoint(const ConferenceEndpoint& endpoint)
 {
     nlohmann::json jsonEndpoint = nlohmann::json::object();
@@ -247,6 +504,7 @@ nlohmann::json generateExtendedConferenceEndpoint(const ConferenceEndpointExtend
         fiveTuple.emplace("remoteIP", endpoint.remoteIP);
         fiveTuple.emplace("remotePort", endpoint.remotePort);
         jsonEndpoint.emplace("iceSelectedTuple", fiveTuple);
+        jsonEndpoint.emplace("iceFastPathResponses", endpoint.iceFastPathResponses);
     }
     {
         nlohmann::json ssrcMap = nlohmann::json::array();
@@ -14,6 +14,8 @@ namespace Generator
 {
 
 nlohmann::json generateAllocateEndpointResponse(const EndpointDescription& channelsDescription);
+// Same content as generateAllocateEndpointResponse written as compact json without building a json document
+std::string writeAllocateEndpointResponse(const EndpointDescription& channelsDescription);
 nlohmann::json generateConferenceEndpoint(const ConferenceEndpoint&);
 nlohmann::json generateExtendedConferenceEndpoint(const ConferenceEndpointExtendedInfo&);
 nlohmann::json generateAllocateBarbellResponse(const BarbellDescription& channelsDescription);
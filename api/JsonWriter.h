@@ -36,7 +36,7 @@ public:
     Object(TBuilder& builder, const char* name) : _builder(builder)
     {
         assert(name);
-        if (!(_builder.empty() || _builder.endsWidth('[') || _builder.endsWidth('{')))
+        if (!(_builder.empty() || _builder.endsWith('[') || _builder.endsWith('{')))
         {
             _builder.append(",");
         }
@@ -50,7 +50,7 @@ public:
 
     Object(TBuilder& builder) : _builder(builder)
     {
-        if (!(_builder.empty() || _builder.endsWidth('[') || _builder.endsWidth('{')))
+        if (!(_builder.empty() || _builder.endsWith('[') || _builder.endsWith('{')))
         {
             _builder.append(",");
         }
@@ -62,7 +62,7 @@ public:
 
     void addProperty(const char* name, const char* value)
     {
-        if (!_builder.endsWidth('{'))
+        if (!_builder.endsWith('{'))
         {
             _builder.append(",");
         }
@@ -78,7 +78,7 @@ public:
     template <typename T>
     void addProperty(const char* name, const T& value)
     {
-        if (!_builder.endsWidth('{'))
+        if (!_builder.endsWith('{'))
         {
             _builder.append(",");
         }
@@ -97,7 +97,7 @@ class Array
 public:
     Array(TBuilder& builder, const char* name) : _builder(builder)
     {
-        if (!_builder.endsWidth('{'))
+        if (!_builder.endsWith('{'))
         {
             _builder.append(",");
         }
@@ -110,7 +110,7 @@ public:
 
     void addElement(const char* value)
     {
-        if (!_builder.endsWidth('['))
+        if (!_builder.endsWith('['))
         {
             _builder.append(",");
         }
@@ -124,7 +124,7 @@ public:
     template <typename T>
     void addElement(const T& value)
     {
-        if (!_builder.endsWidth('['))
+        if (!_builder.endsWith('['))
         {
             _builder.append(",");
         }
@@ -417,7 +417,7 @@ EndpointDescription parsePatchEndpoint(const nlohmann::json& data, const std::st
             auto& videoStream = videoChannel.streams.back();
             for (const auto& rtpSource : requiredJsonArray(stream, "sources"))
             {
-                api::SsrcPair level;
+                api::SsrcPair level = {0, 0};
                 level.main = rtpSource["main"].get<uint32_t>();
                 setIfExists(level.feedback, rtpSource, "feedback");
                 videoStream.sources.push_back(level);
@@ -653,7 +653,7 @@ BarbellDescription parsePatchBarbell(const nlohmann::json& data, const std::stri
             auto& videoStream = videoChannel.streams.back();
             for (const auto& rtpSource : requiredJsonArray(stream, "sources"))
             {
-                api::SsrcPair level;
+                api::SsrcPair level = {0, 0};
                 level.main = rtpSource["main"].get<uint32_t>();
                 setIfExists(level.feedback, rtpSource, "feedback");
                 videoStream.sources.push_back(level);
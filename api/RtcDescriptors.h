@@ -46,6 +46,7 @@ struct Ice
     std::string ufrag;
     std::string pwd;
     std::vector<Candidate> candidates;
+    bool lite = false;
 };
 
 struct Dtls
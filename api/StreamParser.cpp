@@ -0,0 +1,943 @@
+#include "api/StreamParser.h"
+#include "api/utils.h"
+#include "nlohmann/json.hpp"
+#include "utils/Base64.h"
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+enum class Frame
+{
+    Root,
+    Skip,
+    PatchRoot,
+    Transport,
+    Ice,
+    Candidates,
+    Candidate,
+    Dtls,
+    Sdes,
+    Connection,
+    Audio,
+    Video,
+    Ssrcs,
+    PayloadTypes,
+    PayloadType,
+    Parameters,
+    RtcpFeedbacks,
+    RtcpFeedback,
+    HeaderExtensions,
+    HeaderExtension,
+    Streams,
+    Stream,
+    Sources,
+    Source,
+    Data,
+    Neighbours,
+    Groups
+};
+
+// Properties of an object frame. The first requiredCount keys must be present when the object ends.
+struct FrameKeys
+{
+    const char* keys[12];
+    uint32_t requiredCount;
+};
+
+const FrameKeys patchRootKeys = {{"action", "bundle-transport", "audio", "video", "data", "neighbours"}, 1};
+const FrameKeys transportKeys = {{"rtcp-mux", "ice", "dtls", "sdes", "connection"}, 0};
+const FrameKeys iceKeys = {{"ufrag", "pwd", "candidates"}, 2};
+const FrameKeys candidateKeys = {
+    {"generation", "component", "protocol", "port", "ip", "foundation", "priority", "type", "rel-port", "rel-addr", "network"},
+    8};
+const FrameKeys dtlsKeys = {{"type", "hash", "setup"}, 0};
+const FrameKeys sdesKeys = {{"key", "profile"}, 0};
+const FrameKeys connectionKeys = {{"port", "ip"}, 2};
+const FrameKeys audioKeys = {{"transport", "ssrcs", "payload-types", "payload-type", "rtp-hdrexts"}, 0};
+const FrameKeys videoKeys = {{"transport", "payload-types", "rtp-hdrexts", "streams", "ssrc-whitelist"}, 0};
+const FrameKeys payloadTypeKeys = {{"id", "name", "clockrate", "channels", "parameters", "rtcp-fbs"}, 3};
+const FrameKeys rtcpFeedbackKeys = {{"type", "subtype"}, 1};
+const FrameKeys headerExtensionKeys = {{"id", "uri"}, 1};
+const FrameKeys streamKeys = {{"sources", "content"}, 2};
+const FrameKeys sourceKeys = {{"main", "feedback"}, 1};
+const FrameKeys dataKeys = {{"port"}, 1};
+const FrameKeys neighboursKeys = {{"groups"}, 1};
+
+const FrameKeys* getFrameKeys(const Frame frame)
+{
+    switch (frame)
+    {
+    case Frame::PatchRoot:
+        return &patchRootKeys;
+    case Frame::Transport:
+        return &transportKeys;
+    case Frame::Ice:
+        return &iceKeys;
+    case Frame::Candidate:
+        return &candidateKeys;
+    case Frame::Dtls:
+        return &dtlsKeys;
+    case Frame::Sdes:
+        return &sdesKeys;
+    case Frame::Connection:
+        return &connectionKeys;
+    case Frame::Audio:
+        return &audioKeys;
+    case Frame::Video:
+        return &videoKeys;
+    case Frame::PayloadType:
+        return &payloadTypeKeys;
+    case Frame::RtcpFeedback:
+        return &rtcpFeedbackKeys;
+    case Frame::HeaderExtension:
+        return &headerExtensionKeys;
+    case Frame::Stream:
+        return &streamKeys;
+    case Frame::Source:
+        return &sourceKeys;
+    case Frame::Data:
+        return &dataKeys;
+    case Frame::Neighbours:
+        return &neighboursKeys;
+    default:
+        return nullptr;
+    }
+}
+
+int findKeyIndex(const FrameKeys& frameKeys, const std::string& key)
+{
+    for (int i = 0; i < 12 && frameKeys.keys[i]; ++i)
+    {
+        if (key.compare(frameKeys.keys[i]) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+struct Value
+{
+    enum Type
+    {
+        Boolean,
+        Unsigned,
+        String,
+        Other
+    };
+
+    Type type;
+    bool boolean;
+    uint64_t number;
+    std::string* string;
+};
+
+bool readBool(const Value& value, bool& target)
+{
+    if (value.type != Value::Boolean)
+    {
+        return false;
+    }
+    target = value.boolean;
+    return true;
+}
+
+bool readUint32(const Value& value, uint32_t& target)
+{
+    if (value.type != Value::Unsigned)
+    {
+        return false;
+    }
+    target = static_cast<uint32_t>(value.number);
+    return true;
+}
+
+bool readUint32(const Value& value, utils::Optional<uint32_t>& target)
+{
+    if (value.type != Value::Unsigned)
+    {
+        return false;
+    }
+    target.set(static_cast<uint32_t>(value.number));
+    return true;
+}
+
+bool readString(const Value& value, std::string& target)
+{
+    if (value.type != Value::String)
+    {
+        return false;
+    }
+    target = std::move(*value.string);
+    return true;
+}
+
+bool readString(const Value& value, utils::Optional<std::string>& target)
+{
+    if (value.type != Value::String)
+    {
+        return false;
+    }
+    target.set(std::move(*value.string));
+    return true;
+}
+
+class PatchEndpointHandler final : public nlohmann::json::json_sax_t
+{
+public:
+    PatchEndpointHandler(std::string& action, api::EndpointDescription& description)
+        : _action(action),
+          _description(description),
+          _actionKnown(false),
+          _keyIndex(-1),
+          _transport(nullptr),
+          _ice(nullptr),
+          _dtlsComplete(false),
+          _sdesFields(0),
+          _audio(nullptr),
+          _video(nullptr),
+          _ssrcs(nullptr),
+          _payloadTypes(nullptr),
+          _headerExtensions(nullptr),
+          _headerExtensionId(0),
+          _dataPort(0)
+    {
+        _stack.reserve(16);
+    }
+
+    // After a known action, the body is ours and any failure is an invalid request
+    bool isActionKnown() const { return _actionKnown; }
+    const std::string& getError() const { return _error; }
+
+    bool null() override { return onValue(Value{Value::Other, false, 0, nullptr}); }
+    bool boolean(bool value) override { return onValue(Value{Value::Boolean, value, 0, nullptr}); }
+    bool number_integer(number_integer_t value) override { return onValue(Value{Value::Other, false, 0, nullptr}); }
+    bool number_unsigned(number_unsigned_t value) override
+    {
+        return onValue(Value{Value::Unsigned, false, value, nullptr});
+    }
+    bool number_float(number_float_t value, const string_t& s) override
+    {
+        return onValue(Value{Value::Other, false, 0, nullptr});
+    }
+    bool string(string_t& value) override { return onValue(Value{Value::String, false, 0, &value}); }
+
+    bool key(string_t& key) override
+    {
+        auto& entry = _stack.back();
+        if (entry.frame == Frame::Root && key.compare("action") != 0)
+        {
+            return false;
+        }
+
+        const auto* frameKeys = getFrameKeys(entry.frame);
+        _keyIndex = frameKeys ? findKeyIndex(*frameKeys, key) : -1;
+        _key.swap(key);
+        return true;
+    }
+
+    bool start_object(std::size_t) override
+    {
+        if (_stack.empty())
+        {
+            return push(Frame::Root);
+        }
+
+        switch (_stack.back().frame)
+        {
+        case Frame::Skip:
+            return push(Frame::Skip);
+        case Frame::PatchRoot:
+            return startPatchRootObject();
+        case Frame::Transport:
+            return startTransportObject();
+        case Frame::Candidates:
+            _candidate = api::Candidate();
+            _candidate.network = 0;
+            return push(Frame::Candidate);
+        case Frame::Audio:
+            if (_key.compare("transport") == 0)
+            {
+                markField();
+                return startTransport(_audio->transport.set());
+            }
+            else if (_key.compare("payload-type") == 0)
+            {
+                markField();
+                _payloadType = api::PayloadType();
+                return push(Frame::PayloadType);
+            }
+            break;
+        case Frame::Video:
+            if (_key.compare("transport") == 0)
+            {
+                markField();
+                return startTransport(_video->transport.set());
+            }
+            break;
+        case Frame::PayloadTypes:
+            _payloadType = api::PayloadType();
+            return push(Frame::PayloadType);
+        case Frame::PayloadType:
+            if (_key.compare("parameters") == 0)
+            {
+                markField();
+                return push(Frame::Parameters);
+            }
+            break;
+        case Frame::RtcpFeedbacks:
+            _rtcpFeedbackType.clear();
+            _rtcpFeedbackSubtype.clear();
+            return push(Frame::RtcpFeedback);
+        case Frame::HeaderExtensions:
+            _headerExtensionId = 0;
+            _headerExtensionUri.clear();
+            return push(Frame::HeaderExtension);
+        case Frame::Streams:
+            _video->streams.emplace_back();
+            return push(Frame::Stream);
+        case Frame::Sources:
+            _source = api::SsrcPair();
+            return push(Frame::Source);
+        default:
+            break;
+        }
+
+        return skipUnknown();
+    }
+
+    bool end_object() override
+    {
+        const auto entry = _stack.back();
+        _stack.pop_back();
+
+        const auto* frameKeys = getFrameKeys(entry.frame);
+        if (frameKeys)
+        {
+            for (uint32_t i = 0; i < frameKeys->requiredCount; ++i)
+            {
+                if ((entry.fields & (1u << i)) == 0)
+                {
+                    return fail(std::string("Missing required property: ").append(frameKeys->keys[i]));
+                }
+            }
+        }
+
+        return finishObject(entry);
+    }
+
+    bool start_array(std::size_t) override
+    {
+        if (_stack.empty())
+        {
+            return false;
+        }
+
+        switch (_stack.back().frame)
+        {
+        case Frame::Skip:
+            return push(Frame::Skip);
+        case Frame::Ice:
+            if (_key.compare("candidates") == 0)
+            {
+                markField();
+                return push(Frame::Candidates);
+            }
+            break;
+        case Frame::Audio:
+            if (_key.compare("ssrcs") == 0)
+            {
+                markField();
+                _ssrcs = &_audio->ssrcs;
+                return push(Frame::Ssrcs);
+            }
+            else if (_key.compare("payload-types") == 0)
+            {
+                markField();
+                _payloadTypes = &_audio->payloadTypes;
+                return push(Frame::PayloadTypes);
+            }
+            else if (_key.compare("rtp-hdrexts") == 0)
+            {
+                markField();
+                _headerExtensions = &_audio->rtpHeaderExtensions;
+                return push(Frame::HeaderExtensions);
+            }
+            break;
+        case Frame::Video:
+            if (_key.compare("payload-types") == 0)
+            {
+                markField();
+                _payloadTypes = &_video->payloadTypes;
+                return push(Frame::PayloadTypes);
+            }
+            else if (_key.compare("rtp-hdrexts") == 0)
+            {
+                markField();
+                _headerExtensions = &_video->rtpHeaderExtensions;
+                return push(Frame::HeaderExtensions);
+            }
+            else if (_key.compare("streams") == 0)
+            {
+                markField();
+                return push(Frame::Streams);
+            }
+            else if (_key.compare("ssrc-whitelist") == 0)
+            {
+                markField();
+                _ssrcs = &_video->ssrcWhitelist.set();
+                return push(Frame::Ssrcs);
+            }
+            break;
+        case Frame::PayloadType:
+            if (_key.compare("rtcp-fbs") == 0)
+            {
+                markField();
+                return push(Frame::RtcpFeedbacks);
+            }
+            break;
+        case Frame::Stream:
+            if (_key.compare("sources") == 0)
+            {
+                markField();
+                return push(Frame::Sources);
+            }
+            break;
+        case Frame::Neighbours:
+            if (_key.compare("groups") == 0)
+            {
+                markField();
+                _neighbours.clear();
+                return push(Frame::Groups);
+            }
+            break;
+        default:
+            break;
+        }
+
+        return skipUnknown();
+    }
+
+    bool end_array() override
+    {
+        _stack.pop_back();
+        return true;
+    }
+
+    bool parse_error(std::size_t position, const std::string& lastToken, const nlohmann::detail::exception&) override
+    {
+        if (!_actionKnown)
+        {
+            return false;
+        }
+        throw nlohmann::detail::parse_error::create(101, position, "unexpected '" + lastToken + "'");
+    }
+
+private:
+    struct StackEntry
+    {
+        Frame frame;
+        uint32_t fields;
+    };
+
+    bool push(const Frame frame)
+    {
+        _stack.push_back(StackEntry{frame, 0});
+        return true;
+    }
+
+    void markField()
+    {
+        if (_keyIndex >= 0)
+        {
+            _stack.back().fields |= 1u << _keyIndex;
+        }
+    }
+
+    bool hasField(const StackEntry& entry, const char* key) const
+    {
+        const int index = findKeyIndex(*getFrameKeys(entry.frame), key);
+        return index >= 0 && (entry.fields & (1u << index));
+    }
+
+    bool fail(std::string error)
+    {
+        _error = std::move(error);
+        return false;
+    }
+
+    // Known properties with an unexpected type abort, unknown properties are ignored like Parser does.
+    bool skipUnknown()
+    {
+        if (_keyIndex >= 0 || getFrameKeys(_stack.back().frame) == nullptr)
+        {
+            return fail("Unexpected value of property: " + _key);
+        }
+        return push(Frame::Skip);
+    }
+
+    bool startTransport(api::Transport& transport)
+    {
+        _transport = &transport;
+        _dtls = api::Dtls();
+        _dtlsComplete = false;
+        _sdesFields = 0;
+        _sdesKey.clear();
+        _sdesProfile.clear();
+        return push(Frame::Transport);
+    }
+
+    bool startPatchRootObject()
+    {
+        auto& description = _description;
+        if (_key.compare("bundle-transport") == 0)
+        {
+            markField();
+            return startTransport(description.bundleTransport.set());
+        }
+        else if (_key.compare("audio") == 0)
+        {
+            markField();
+            _audio = &description.audio.set();
+            _deprecatedPayloadType.clear();
+            return push(Frame::Audio);
+        }
+        else if (_key.compare("video") == 0)
+        {
+            markField();
+            _video = &description.video.set();
+            return push(Frame::Video);
+        }
+        else if (_key.compare("data") == 0)
+        {
+            markField();
+            return push(Frame::Data);
+        }
+        else if (_key.compare("neighbours") == 0)
+        {
+            markField();
+            return push(Frame::Neighbours);
+        }
+        return skipUnknown();
+    }
+
+    bool startTransportObject()
+    {
+        if (_key.compare("ice") == 0)
+        {
+            markField();
+            _ice = &_transport->ice.set();
+            return push(Frame::Ice);
+        }
+        else if (_key.compare("dtls") == 0)
+        {
+            markField();
+            return push(Frame::Dtls);
+        }
+        else if (_key.compare("sdes") == 0)
+        {
+            markField();
+            return push(Frame::Sdes);
+        }
+        else if (_key.compare("connection") == 0)
+        {
+            markField();
+            _connection = api::Connection();
+            return push(Frame::Connection);
+        }
+        return skipUnknown();
+    }
+
+    bool onValue(const Value& value)
+    {
+        if (_stack.empty())
+        {
+            return false;
+        }
+
+        const auto frame = _stack.back().frame;
+        if (frame == Frame::Skip)
+        {
+            return true;
+        }
+
+        if (!setValue(frame, value))
+        {
+            return _actionKnown ? fail("Unexpected value of property: " + _key) : false;
+        }
+
+        markField();
+        return true;
+    }
+
+    bool setValue(const Frame frame, const Value& value)
+    {
+        switch (frame)
+        {
+        case Frame::Root:
+            return setAction(value);
+        case Frame::Transport:
+            if (_key.compare("rtcp-mux") == 0)
+            {
+                return readBool(value, _transport->rtcpMux);
+            }
+            break;
+        case Frame::Ice:
+            if (_key.compare("ufrag") == 0)
+            {
+                return readString(value, _ice->ufrag);
+            }
+            else if (_key.compare("pwd") == 0)
+            {
+                return readString(value, _ice->pwd);
+            }
+            break;
+        case Frame::Candidate:
+            return setCandidateValue(value);
+        case Frame::Dtls:
+            if (_key.compare("type") == 0)
+            {
+                return readString(value, _dtls.type);
+            }
+            else if (_key.compare("hash") == 0)
+            {
+                return readString(value, _dtls.hash);
+            }
+            else if (_key.compare("setup") == 0)
+            {
+                return readString(value, _dtls.setup);
+            }
+            break;
+        case Frame::Sdes:
+            if (_key.compare("key") == 0)
+            {
+                return readString(value, _sdesKey);
+            }
+            else if (_key.compare("profile") == 0)
+            {
+                return readString(value, _sdesProfile);
+            }
+            break;
+        case Frame::Connection:
+            if (_key.compare("port") == 0)
+            {
+                return readUint32(value, _connection.port);
+            }
+            else if (_key.compare("ip") == 0)
+            {
+                return readString(value, _connection.ip);
+            }
+            break;
+        case Frame::Ssrcs:
+            if (value.type == Value::Unsigned)
+            {
+                _ssrcs->push_back(static_cast<uint32_t>(value.number));
+                return true;
+            }
+            return false;
+        case Frame::PayloadType:
+            if (_key.compare("id") == 0)
+            {
+                return readUint32(value, _payloadType.id);
+            }
+            else if (_key.compare("name") == 0)
+            {
+                return readString(value, _payloadType.name);
+            }
+            else if (_key.compare("clockrate") == 0)
+            {
+                return readUint32(value, _payloadType.clockRate);
+            }
+            else if (_key.compare("channels") == 0)
+            {
+                return readUint32(value, _payloadType.channels);
+            }
+            break;
+        case Frame::Parameters:
+            if (value.type == Value::String)
+            {
+                _payloadType.parameters.emplace_back(_key, std::move(*value.string));
+                return true;
+            }
+            return false;
+        case Frame::RtcpFeedback:
+            if (_key.compare("type") == 0)
+            {
+                return readString(value, _rtcpFeedbackType);
+            }
+            else if (_key.compare("subtype") == 0)
+            {
+                return readString(value, _rtcpFeedbackSubtype);
+            }
+            break;
+        case Frame::HeaderExtension:
+            if (_key.compare("id") == 0)
+            {
+                return readUint32(value, _headerExtensionId);
+            }
+            else if (_key.compare("uri") == 0)
+            {
+                return readString(value, _headerExtensionUri);
+            }
+            break;
+        case Frame::Stream:
+            if (_key.compare("content") == 0)
+            {
+                return readString(value, _video->streams.back().content);
+            }
+            break;
+        case Frame::Source:
+            if (_key.compare("main") == 0)
+            {
+                return readUint32(value, _source.main);
+            }
+            else if (_key.compare("feedback") == 0)
+            {
+                return readUint32(value, _source.feedback);
+            }
+            break;
+        case Frame::Data:
+            if (_key.compare("port") == 0)
+            {
+                return readUint32(value, _dataPort);
+            }
+            break;
+        case Frame::Groups:
+            if (value.type == Value::String)
+            {
+                _neighbours.push_back(std::move(*value.string));
+                return true;
+            }
+            return false;
+        default:
+            return false;
+        }
+
+        return _keyIndex < 0;
+    }
+
+    bool setAction(const Value& value)
+    {
+        if (!readString(value, _action) || (_action.compare("configure") != 0 && _action.compare("reconfigure") != 0))
+        {
+            return false;
+        }
+
+        _stack.back().frame = Frame::PatchRoot;
+        _actionKnown = true;
+        _keyIndex = 0;
+        return true;
+    }
+
+    bool setCandidateValue(const Value& value)
+    {
+        if (_key.compare("generation") == 0)
+        {
+            return readUint32(value, _candidate.generation);
+        }
+        else if (_key.compare("component") == 0)
+        {
+            return readUint32(value, _candidate.component);
+        }
+        else if (_key.compare("protocol") == 0)
+        {
+            return readString(value, _candidate.protocol);
+        }
+        else if (_key.compare("port") == 0)
+        {
+            return readUint32(value, _candidate.port);
+        }
+        else if (_key.compare("ip") == 0)
+        {
+            return readString(value, _candidate.ip);
+        }
+        else if (_key.compare("foundation") == 0)
+        {
+            return readString(value, _candidate.foundation);
+        }
+        else if (_key.compare("priority") == 0)
+        {
+            return readUint32(value, _candidate.priority);
+        }
+        else if (_key.compare("type") == 0)
+        {
+            return readString(value, _candidate.type);
+        }
+        else if (_key.compare("rel-port") == 0)
+        {
+            return readUint32(value, _candidate.relPort);
+        }
+        else if (_key.compare("rel-addr") == 0)
+        {
+            return readString(value, _candidate.relAddr);
+        }
+        else if (_key.compare("network") == 0)
+        {
+            return readUint32(value, _candidate.network);
+        }
+        return _keyIndex < 0;
+    }
+
+    bool finishObject(const StackEntry& entry)
+    {
+        switch (entry.frame)
+        {
+        case Frame::Transport:
+            return finishTransport(entry);
+        case Frame::Candidate:
+            _ice->candidates.push_back(std::move(_candidate));
+            return true;
+        case Frame::Dtls:
+            _dtlsComplete = entry.fields == 0x7;
+            return true;
+        case Frame::Sdes:
+            _sdesFields = entry.fields;
+            return true;
+        case Frame::Connection:
+            _transport->connection.set(std::move(_connection));
+            return true;
+        case Frame::Audio:
+            // payload-type is deprecated and only used if payload-types is missing
+            if (!hasField(entry, "payload-types") && _deprecatedPayloadType.isSet())
+            {
+                _audio->payloadTypes.push_back(std::move(_deprecatedPayloadType.get()));
+            }
+            return true;
+        case Frame::PayloadType:
+            if (_stack.back().frame == Frame::PayloadTypes)
+            {
+                _payloadTypes->push_back(std::move(_payloadType));
+            }
+            else
+            {
+                _deprecatedPayloadType.set(std::move(_payloadType));
+            }
+            return true;
+        case Frame::RtcpFeedback:
+            if (hasField(entry, "subtype"))
+            {
+                _payloadType.rtcpFeedbacks.emplace_back(_rtcpFeedbackType,
+                    utils::Optional<std::string>(_rtcpFeedbackSubtype));
+            }
+            else
+            {
+                _payloadType.rtcpFeedbacks.emplace_back(_rtcpFeedbackType, utils::Optional<std::string>());
+            }
+            return true;
+        case Frame::HeaderExtension:
+            if (_headerExtensionId > 0 && _headerExtensionId < 15)
+            {
+                if (!hasField(entry, "uri"))
+                {
+                    return fail("Missing required property: uri");
+                }
+                _headerExtensions->emplace_back(_headerExtensionId, _headerExtensionUri);
+            }
+            return true;
+        case Frame::Source:
+            _video->streams.back().sources.push_back(_source);
+            return true;
+        case Frame::Data:
+            _description.data.set(api::Data{_dataPort});
+            return true;
+        case Frame::Neighbours:
+            _description.neighbours.set(std::move(_neighbours));
+            return true;
+        default:
+            return true;
+        }
+    }
+
+    bool finishTransport(const StackEntry& entry)
+    {
+        if (_dtlsComplete)
+        {
+            _transport->dtls.set(_dtls);
+        }
+        else if (hasField(entry, "sdes"))
+        {
+            if (_sdesFields != 0x3)
+            {
+                return fail("Missing required under property: sdes");
+            }
+
+            srtp::AesKey aesKey;
+            const size_t decodedLength = utils::Base64::decode(_sdesKey, aesKey.keySalt, sizeof(aesKey.keySalt));
+            aesKey.profile = api::utils::stringToSrtpProfile(_sdesProfile);
+            if (decodedLength != aesKey.getLength())
+            {
+                return fail("Invalid sdes key length");
+            }
+            _transport->sdesKeys.push_back(aesKey);
+        }
+        return true;
+    }
+
+    std::string& _action;
+    api::EndpointDescription& _description;
+    bool _actionKnown;
+    std::string _error;
+    std::vector<StackEntry> _stack;
+    std::string _key;
+    int _keyIndex;
+
+    api::Transport* _transport;
+    api::Ice* _ice;
+    api::Candidate _candidate;
+    api::Dtls _dtls;
+    bool _dtlsComplete;
+    uint32_t _sdesFields;
+    std::string _sdesKey;
+    std::string _sdesProfile;
+    api::Connection _connection;
+
+    api::Audio* _audio;
+    api::Video* _video;
+    std::vector<uint32_t>* _ssrcs;
+    std::vector<api::PayloadType>* _payloadTypes;
+    api::PayloadType _payloadType;
+    utils::Optional<api::PayloadType> _deprecatedPayloadType;
+    std::string _rtcpFeedbackType;
+    std::string _rtcpFeedbackSubtype;
+    std::vector<std::pair<uint32_t, std::string>>* _headerExtensions;
+    uint32_t _headerExtensionId;
+    std::string _headerExtensionUri;
+    api::SsrcPair _source;
+    uint32_t _dataPort;
+    std::vector<std::string> _neighbours;
+};
+
+} // namespace
+
+namespace api
+{
+
+namespace StreamParser
+{
+
+bool parsePatchEndpoint(const ::utils::Span<const char>& body,
+    const std::string& endpointId,
+    std::string& outAction,
+    EndpointDescription& outDescription)
+{
+    PatchEndpointHandler handler(outAction, outDescription);
+    const bool parsed =
+        nlohmann::json::sax_parse(nlohmann::detail::input_adapter(body.data(), body.size()), &handler);
+    if (!handler.isActionKnown())
+    {
+        return false;
+    }
+    if (!parsed)
+    {
+        throw nlohmann::detail::other_error::create(-1, handler.getError());
+    }
+
+    outDescription.endpointId = endpointId;
+    return true;
+}
+
+} // namespace StreamParser
+
+} // namespace api
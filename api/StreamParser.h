@@ -0,0 +1,26 @@
+#pragma once
+
+#include "api/EndpointDescription.h"
+#include "utils/Span.h"
+#include <string>
+
+namespace api
+{
+
+namespace StreamParser
+{
+
+/**
+ * Parses "configure" and "reconfigure" bodies, the large endpoint descriptions, directly into EndpointDescription
+ * without building a json document. Returns false as soon as the first property is not "action" with one of these
+ * values, so the caller can hand other requests to Parser at the cost of a few tokens. Once the action is known the
+ * result is final. Malformed json throws parse_error and an invalid description throws other_error, like Parser.
+ */
+bool parsePatchEndpoint(const ::utils::Span<const char>& body,
+    const std::string& endpointId,
+    std::string& outAction,
+    EndpointDescription& outDescription);
+
+} // namespace StreamParser
+
+} // namespace api
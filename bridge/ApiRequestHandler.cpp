@@ -60,6 +60,10 @@ httpd::Response ApiRequestHandler::handleConferenceRequest(RequestLogger& reques
     {
         return getConferenceInfo(this, requestLogger, request, conferenceId);
     }
+    else if (request.method == httpd::Method::POST)
+    {
+        return processEndpointBatchRequest(this, requestLogger, request, conferenceId);
+    }
 
     throw httpd::RequestErrorException(httpd::StatusCode::METHOD_NOT_ALLOWED,
         utils::format("HTTP method '%s' not allowed on this endpoint", request.getMethodString()));
@@ -134,12 +138,21 @@ httpd::Response ApiRequestHandler::onRequest(const httpd::Request& request)
                             return handleBarbellStats(this, requestLogger, request);
                         }
                     }
+                    else if (utils::StringTokenizer::isEqual(token, "flows") && !token.next)
+                    {
+                        return handleFlowStats(this, requestLogger, request);
+                    }
                 }
                 else
                 {
                     return handleStats(this, requestLogger, request);
                 }
             }
+            else if (utils::StringTokenizer::isEqual(token, "metrics") && !token.next &&
+                request.method == httpd::Method::GET)
+            {
+                return handleMetrics(this, requestLogger, request);
+            }
             else if (utils::StringTokenizer::isEqual(token, "conferences") && !token.next)
             {
                 if (request.params.empty())
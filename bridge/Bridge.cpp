@@ -3,6 +3,7 @@
 #include "bridge/ApiRequestHandler.h"
 #include "bridge/MixerManager.h"
 #include "bridge/engine/Engine.h"
+#include "codec/Opus.h"
 #include "httpd/Httpd.h"
 #include "httpd/HttpdFactory.h"
 #include "jobmanager/JobManager.h"
@@ -18,6 +19,27 @@
 #include "utils/IdGenerator.h"
 #include "utils/SsrcGenerator.h"
 
+namespace
+{
+// only threads pinned to a core busy poll
+concurrency::PollConfig makePollConfig(const config::Config& config, int cpuCore)
+{
+    concurrency::PollConfig pollConfig;
+    pollConfig.cpuCore = cpuCore;
+    pollConfig.busyPoll = config.threads.busyPoll && cpuCore >= 0;
+    pollConfig.numaNode = config.threads.numaNode;
+    return pollConfig;
+}
+
+memory::page::Placement makePagePlacement(const config::Config& config)
+{
+    memory::page::Placement placement;
+    placement.hugePages = config.mem.hugePages;
+    placement.numaNode = config.threads.numaNode;
+    return placement;
+}
+} // namespace
+
 namespace bridge
 {
 
@@ -61,14 +83,19 @@ Bridge::Bridge(const config::Config& config)
       _idGenerator(std::make_unique<utils::IdGenerator>()),
       _ssrcGenerator(std::make_unique<utils::SsrcGenerator>()),
       _timers(std::make_unique<jobmanager::TimerQueue>(4096 * 8)),
-      _rtJobManager(std::make_unique<jobmanager::JobManager>(*_timers)),
+      _rtJobManager(std::make_unique<jobmanager::JobManager>(*_timers, 4096 * 8, config.metrics.jobQueueWait)),
       _backgroundJobQueue(std::make_unique<jobmanager::JobManager>(*_timers)),
       _sslDtls(std::make_unique<transport::SslDtls>()),
-      _network(transport::createRtcePoll()),
-      _mainPacketAllocator(std::make_unique<memory::PacketPoolAllocator>(_config.mem.sendPool / 4, "main")),
-      _sendPacketAllocator(std::make_unique<memory::PacketPoolAllocator>(_config.mem.sendPool, "send")),
-      _audioPacketAllocator(std::make_unique<memory::AudioPacketPoolAllocator>(4 * 1024, "audio")),
-      _engine(std::make_unique<bridge::Engine>(*_backgroundJobQueue))
+      _network(transport::createRtcePoll(makePollConfig(config, config.threads.networkCore),
+          config.threads.busyPoll ? config.threads.socketBusyPollUs.get() : 0)),
+      _mainPacketAllocator(std::make_unique<memory::PacketPoolAllocator>(_config.mem.sendPool / 4,
+          "main",
+          makePagePlacement(config))),
+      _sendPacketAllocator(
+          std::make_unique<memory::PacketPoolAllocator>(_config.mem.sendPool, "send", makePagePlacement(config))),
+      _audioPacketAllocator(
+          std::make_unique<memory::AudioPacketPoolAllocator>(4 * 1024, "audio", makePagePlacement(config))),
+      _engine(std::make_unique<bridge::Engine>(*_backgroundJobQueue, makePollConfig(config, config.threads.engineCore)))
 {
 }
 
@@ -168,6 +195,7 @@ void Bridge::initialize(std::shared_ptr<transport::EndpointFactory> endpointFact
     {
         _iceConfig.publicIpv6 = transport::SocketAddress::parse(_config.ice.publicIpv6);
     }
+    _iceConfig.lite = _config.ice.lite;
 
     startWorkerThreads();
     // Disabling yield because we don't want to yield jobs that holds mixer and MixerManager locks, otherwise it can
@@ -191,6 +219,15 @@ void Bridge::initialize(std::shared_ptr<transport::EndpointFactory> endpointFact
     _sctpConfig.receiveBufferSize = _config.sctp.bufferSize;
     _sctpConfig.transmitBufferSize = _config.sctp.bufferSize;
 
+    if (!codec::Opus::isSupportedMixFormat(_config.audio.mixSampleRate, _config.audio.mixChannels))
+    {
+        logger::warn("Unsupported audio mix format %uHz %u channels. Mixing at %uHz stereo",
+            "main",
+            _config.audio.mixSampleRate.get(),
+            _config.audio.mixChannels.get(),
+            codec::Opus::sampleRate);
+    }
+
     _srtpClientFactory = std::make_unique<transport::SrtpClientFactory>(*_sslDtls);
     _bweConfig.sanitize();
     _transportFactory = transport::createTransportFactory(*_rtJobManager,
@@ -260,13 +297,29 @@ void Bridge::startWorkerThreads()
         }
     }
 
-    logger::info("Starting %u worker threads", "main", numWorkerThreads);
+    const auto workerCores = concurrency::parseCpuList(_config.threads.workerCores);
+    if (workerCores.empty() && !_config.threads.workerCores.get().empty())
+    {
+        logger::warn("Invalid threads.workerCores '%s'. Workers are not pinned",
+            "main",
+            _config.threads.workerCores.get().c_str());
+    }
+
+    logger::info("Starting %u worker threads, %zu pinned%s",
+        "main",
+        numWorkerThreads,
+        std::min(workerCores.size(), static_cast<size_t>(numWorkerThreads)),
+        _config.threads.busyPoll ? " busy polling" : "");
 
     _workerThreads.reserve(numWorkerThreads);
 
     for (int i = 0; i < numWorkerThreads; ++i)
     {
-        _workerThreads.push_back(std::make_unique<jobmanager::WorkerThread>(*_rtJobManager, true, "RTWorker"));
+        const int cpuCore = i < static_cast<int>(workerCores.size()) ? workerCores[i] : -1;
+        _workerThreads.push_back(std::make_unique<jobmanager::WorkerThread>(*_rtJobManager,
+            true,
+            "RTWorker",
+            makePollConfig(_config, cpuCore)));
     }
 }
 } // namespace bridge
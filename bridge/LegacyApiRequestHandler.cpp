@@ -337,7 +337,7 @@ httpd::Response LegacyApiRequestHandler::patchConference(const httpd::Request& r
     {
         Mixer* mixer;
         auto scopedMixerLock = _mixerManager.getMixer(conferenceId, mixer);
-        assert(scopedMixerLock.owns_lock());
+        requestLogger.setLockWaitTime(scopedMixerLock.getWaitTime());
         if (!mixer)
         {
             httpd::Response response(httpd::StatusCode::NOT_FOUND);
@@ -778,6 +778,10 @@ httpd::Response LegacyApiRequestHandler::generatePatchConferenceResponse(const l
             const auto& transportDescriptionIce = transportDescription.ice.get();
             channelBundle._transport._ufrag.set(transportDescriptionIce.iceCredentials.first);
             channelBundle._transport._pwd.set(transportDescriptionIce.iceCredentials.second);
+            if (transportDescriptionIce.iceLite)
+            {
+                channelBundle._transport._iceLite.set(true);
+            }
             channelBundle._transport._candidates.clear();
             for (const auto& iceCandidate : transportDescriptionIce.iceCandidates)
             {
@@ -872,6 +876,10 @@ httpd::Response LegacyApiRequestHandler::generatePatchConferenceResponse(const l
                     const auto& transportDescriptionIce = transportDescription.ice.get();
                     channelTransport._ufrag.set(transportDescriptionIce.iceCredentials.first);
                     channelTransport._pwd.set(transportDescriptionIce.iceCredentials.second);
+                    if (transportDescriptionIce.iceLite)
+                    {
+                        channelTransport._iceLite.set(true);
+                    }
                     channelTransport._candidates.clear();
                     for (const auto& iceCandidate : transportDescriptionIce.iceCandidates)
                     {
@@ -81,12 +81,18 @@ std::vector<RtpMap> makeRtpMaps(const legacyapi::Channel& channel)
     }
 
     utils::Optional<uint8_t> absSendTimeExtensionId;
+    utils::Optional<uint8_t> transportCcExtensionId;
     for (const auto& rtpHeaderExtension : channel._rtpHeaderHdrExts)
     {
         if (rtpHeaderExtension._uri.compare("http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time") == 0)
         {
             absSendTimeExtensionId.set(utils::checkedCast<uint8_t>(rtpHeaderExtension._id));
         }
+        else if (rtpHeaderExtension._uri.compare(
+                     "http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01") == 0)
+        {
+            transportCcExtensionId.set(utils::checkedCast<uint8_t>(rtpHeaderExtension._id));
+        }
     }
 
     utils::Optional<uint8_t> audioLevelExtensionId;
@@ -106,6 +112,14 @@ std::vector<RtpMap> makeRtpMaps(const legacyapi::Channel& channel)
         }
     }
 
+    if (transportCcExtensionId.isSet())
+    {
+        for (auto& rtpMap : rtpMaps)
+        {
+            rtpMap.transportCcExtId = transportCcExtensionId;
+        }
+    }
+
     if (audioLevelExtensionId.isSet())
     {
         for (auto& rtpMap : rtpMaps)
@@ -16,6 +16,7 @@
 #include "bridge/engine/EngineMixer.h"
 #include "bridge/engine/EngineRecordingStream.h"
 #include "bridge/engine/EngineVideoStream.h"
+#include "bridge/engine/InboundPacketCache.h"
 #include "bridge/engine/PacketCache.h"
 #include "config/Config.h"
 #include "jobmanager/JobManager.h"
@@ -875,6 +876,58 @@ bridge::Stats::MixerBarbellStats Mixer::gatherBarbellStats(const uint64_t iterat
     return stats;
 }
 
+// Transport counters are published lock free by the transports. Engine streams are kept alive by the lock.
+EngineStats::MixerStats Mixer::gatherStats(const uint64_t timestamp)
+{
+    std::lock_guard<std::mutex> locker(_configurationLock);
+    EngineStats::MixerStats stats;
+    uint64_t idleTimestamp = timestamp - utils::Time::sec * 2;
+
+    for (const auto& audioStreamEntry : _audioEngineStreams)
+    {
+        const auto& transport = audioStreamEntry.second->transport;
+        const auto audioRecvCounters = transport.getAudioReceiveCounters(idleTimestamp);
+        const auto audioSendCounters = transport.getAudioSendCounters(idleTimestamp);
+        const auto videoRecvCounters = transport.getVideoReceiveCounters(idleTimestamp);
+        const auto videoSendCounters = transport.getVideoSendCounters(idleTimestamp);
+
+        stats.inbound.audio += audioRecvCounters;
+        stats.outbound.audio += audioSendCounters;
+        stats.inbound.video += videoRecvCounters;
+        stats.outbound.video += videoSendCounters;
+        stats.inbound.transport.addBandwidthGroup(transport.getDownlinkEstimateKbps());
+        stats.inbound.transport.addRttGroup(transport.getRtt() / utils::Time::ms);
+        stats.inbound.transport.addLossGroup((audioRecvCounters + videoRecvCounters).getReceiveLossRatio());
+        stats.outbound.transport.addLossGroup((audioSendCounters + videoSendCounters).getSendLossRatio());
+        stats.pacingQueue += transport.getPacingQueueCount();
+        stats.rtxPacingQueue += transport.getRtxPacingQueueCount();
+    }
+
+    for (const auto& videoStreamEntry : _videoEngineStreams)
+    {
+        if (_audioEngineStreams.find(videoStreamEntry.first) != _audioEngineStreams.end())
+        {
+            continue;
+        }
+
+        const auto& transport = videoStreamEntry.second->transport;
+        const auto videoRecvCounters = transport.getVideoReceiveCounters(idleTimestamp);
+        const auto videoSendCounters = transport.getVideoSendCounters(idleTimestamp);
+
+        stats.inbound.video += videoRecvCounters;
+        stats.outbound.video += videoSendCounters;
+        stats.inbound.transport.addBandwidthGroup(transport.getDownlinkEstimateKbps());
+        stats.inbound.transport.addRttGroup(transport.getRtt() / utils::Time::ms);
+        stats.inbound.transport.addLossGroup(videoRecvCounters.getReceiveLossRatio());
+        stats.outbound.transport.addLossGroup(videoSendCounters.getSendLossRatio());
+        stats.pacingQueue += transport.getPacingQueueCount();
+        stats.rtxPacingQueue += transport.getRtxPacingQueueCount();
+    }
+
+    _engineMixer->gatherInboundStats(stats);
+    return stats;
+}
+
 std::map<size_t, ActiveTalker> Mixer::getActiveTalkers() const
 {
     return _engineMixer->getActiveTalkers();
@@ -943,6 +996,7 @@ bool Mixer::getEndpointExtendedInfo(const std::string& endpointId,
     endpoint.localPort = transport->getLocalRtpPort().getPort();
     auto transportType = transport->getSelectedTransportType();
     endpoint.protocol = (transportType.isSet() ? ice::toString(transportType.get()) : "n/a");
+    endpoint.iceFastPathResponses = transport->getIceFastPathResponseCount();
 
     return true;
 }
@@ -1079,6 +1133,7 @@ bool Mixer::getTransportBundleDescription(const std::string& endpointId,
 
     outTransportDescription = TransportDescription(bundleTransport->getLocalCandidates(),
         bundleTransport->getLocalIceCredentials(),
+        bundleTransport->isIceLite(),
         bundleTransport->isDtlsClient(),
         sdesKeys,
         bundleTransportItr->second.srtpMode);
@@ -1086,6 +1141,35 @@ bool Mixer::getTransportBundleDescription(const std::string& endpointId,
     return true;
 }
 
+bool Mixer::isPacketCaptureActive(const std::string& endpointId, bool& outActive) const
+{
+    std::lock_guard<std::mutex> locker(_configurationLock);
+
+    auto bundleTransportItr = _bundleTransports.find(endpointId);
+    if (bundleTransportItr == _bundleTransports.end())
+    {
+        return false;
+    }
+
+    outActive = bundleTransportItr->second.packetCapture != nullptr;
+    return true;
+}
+
+bool Mixer::setPacketCapture(const std::string& endpointId, std::shared_ptr<logger::PacketCapture> packetCapture)
+{
+    std::lock_guard<std::mutex> locker(_configurationLock);
+
+    auto bundleTransportItr = _bundleTransports.find(endpointId);
+    if (bundleTransportItr == _bundleTransports.end())
+    {
+        return false;
+    }
+
+    bundleTransportItr->second.packetCapture = packetCapture;
+    bundleTransportItr->second.transport->asyncSetPacketCapture(packetCapture);
+    return true;
+}
+
 bool Mixer::getBarbellTransportDescription(const std::string& barbellId,
     TransportDescription& outTransportDescription) const
 {
@@ -1102,6 +1186,7 @@ bool Mixer::getBarbellTransportDescription(const std::string& barbellId,
 
     outTransportDescription = TransportDescription(bundleTransport->getLocalCandidates(),
         bundleTransport->getLocalIceCredentials(),
+        bundleTransport->isIceLite(),
         bundleTransport->isDtlsClient(),
         std::vector<srtp::AesKey>(),
         srtp::Mode::DTLS);
@@ -1132,6 +1217,7 @@ bool Mixer::getAudioStreamTransportDescription(const std::string& endpointId,
     {
         outTransportDescription = TransportDescription(transport->getLocalCandidates(),
             transport->getLocalIceCredentials(),
+            transport->isIceLite(),
             transport->isDtlsClient(),
             sdesKeys,
             audioStreamItr->second->srtpMode);
@@ -1180,6 +1266,7 @@ bool Mixer::getVideoStreamTransportDescription(const std::string& endpointId,
     {
         outTransportDescription = TransportDescription(videoStream.transport->getLocalCandidates(),
             videoStream.transport->getLocalIceCredentials(),
+            videoStream.transport->isIceLite(),
             videoStream.transport->isDtlsClient(),
             sdesKeys,
             videoStream.srtpMode);
@@ -1228,6 +1315,17 @@ void Mixer::freeVideoPacketCache(const uint32_t ssrc, const size_t endpointIdHas
     videoPacketCaches.erase(ssrc);
 }
 
+void Mixer::allocateInboundPacketCache(const uint32_t ssrc)
+{
+    // the engine owns the cache once added, so no configuration state is touched here
+    auto inboundPacketCache =
+        std::make_shared<InboundPacketCache>(_loggableId.c_str(), ssrc, _engineMixer->getSendAllocator());
+    if (!_engineMixer->asyncAddInboundPacketCache(ssrc, inboundPacketCache))
+    {
+        logger::warn("Failed to add inbound packet cache for ssrc %u", _loggableId.c_str(), ssrc);
+    }
+}
+
 Mixer::Stats Mixer::getStats()
 {
     std::lock_guard<std::mutex> locker(_configurationLock);
@@ -1283,6 +1381,10 @@ bool Mixer::configureAudioStream(const std::string& endpointId,
     {
         audioStream->transport->setAbsSendTimeExtensionId(audioStream->rtpMap.absSendTimeExtId.get());
     }
+    if (audioStream->rtpMap.transportCcExtId.isSet())
+    {
+        audioStream->transport->setTransportCcExtensionId(audioStream->rtpMap.transportCcExtId.get());
+    }
 
     audioStream->neighbours = neighbours;
     return true;
@@ -1389,6 +1491,10 @@ bool Mixer::configureVideoStream(const std::string& endpointId,
     {
         videoStream->transport->setAbsSendTimeExtensionId(videoStream->rtpMap.absSendTimeExtId.get());
     }
+    if (videoStream->rtpMap.transportCcExtId.isSet())
+    {
+        videoStream->transport->setTransportCcExtensionId(videoStream->rtpMap.transportCcExtId.get());
+    }
 
     videoStream->ssrcWhitelist = ssrcWhitelist;
     return true;
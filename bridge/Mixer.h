@@ -12,6 +12,7 @@
 #include "transport/Endpoint.h"
 #include "transport/dtls/SrtpClient.h"
 #include "transport/ice/IceSession.h"
+#include <atomic>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -43,6 +44,11 @@ class Optional;
 class SimpleJson;
 } // namespace utils
 
+namespace logger
+{
+class PacketCapture;
+}
+
 namespace config
 {
 class Config;
@@ -102,6 +108,7 @@ public:
 
     void markForDeletion();
     bool isMarkedForDeletion() const { return _markedForDeletion; }
+    std::mutex& getRequestLock() { return _requestLock; }
     bool hasVideoEnabled() const { return !_videoSsrcs.empty(); }
     void stopTransports();
 
@@ -260,6 +267,8 @@ public:
 
     bool getTransportBundleDescription(const std::string& endpointId,
         TransportDescription& outTransportDescription) const;
+    bool isPacketCaptureActive(const std::string& endpointId, bool& outActive) const;
+    bool setPacketCapture(const std::string& endpointId, std::shared_ptr<logger::PacketCapture> packetCapture);
     bool getAudioStreamTransportDescription(const std::string& endpointId,
         TransportDescription& outTransportDescription) const;
     bool getVideoStreamTransportDescription(const std::string& endpointId,
@@ -270,6 +279,7 @@ public:
 
     void allocateVideoPacketCache(const uint32_t ssrc, const size_t endpointIdHash);
     void freeVideoPacketCache(const uint32_t ssrc, const size_t endpointIdHash);
+    void allocateInboundPacketCache(const uint32_t ssrc);
 
     bool addOrUpdateRecording(const std::string& conferenceId,
         const std::vector<api::RecordingChannel>& channels,
@@ -304,6 +314,7 @@ public:
 
     const config::Config& getConfig() const { return _config; }
     bridge::Stats::MixerBarbellStats gatherBarbellStats(const uint64_t engineIterationStartTimestamp);
+    EngineStats::MixerStats gatherStats(const uint64_t timestamp);
 
     bool isH264Enabled() const;
 
@@ -313,12 +324,14 @@ private:
         explicit BundleTransport(const std::shared_ptr<transport::RtcTransport>& transport) : transport(transport) {}
         std::shared_ptr<transport::RtcTransport> transport;
         srtp::Mode srtpMode;
+        std::shared_ptr<logger::PacketCapture> packetCapture;
     };
 
     const config::Config& _config;
     const std::string _id;
     logger::LoggableId _loggableId;
-    bool _markedForDeletion;
+    // written with the request lock held, read without it to skip mixers that are being removed
+    std::atomic_bool _markedForDeletion;
 
     const std::vector<uint32_t> _audioSsrcs;
     const std::vector<api::SimulcastGroup> _videoSsrcs;
@@ -352,6 +365,7 @@ private:
     transport::Endpoints _barbellPorts;
 
     mutable std::mutex _configurationLock;
+    std::mutex _requestLock; // serializes API requests on this conference, held for the whole request
 
     RecordingStream* findRecordingStream(const std::string& recordingId);
 
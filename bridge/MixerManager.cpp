@@ -19,6 +19,7 @@
 #include "logger/Logger.h"
 #include "transport/TransportFactory.h"
 #include "utils/IdGenerator.h"
+#include "utils/Metrics.h"
 #include "utils/Pacer.h"
 #include "utils/SsrcGenerator.h"
 #include "utils/StringBuilder.h"
@@ -230,15 +231,21 @@ Mixer* MixerManager::create(utils::Optional<uint32_t> optionalLastN,
 
 void MixerManager::remove(const std::string& id)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
-    auto findResult = _mixers.find(id);
-    if (findResult == _mixers.cend() || findResult->second->isMarkedForDeletion())
+    const auto mixer = findMixer(id);
+    if (!mixer)
+    {
+        return;
+    }
+
+    // a request holding the lock may still use the mixer
+    std::lock_guard<std::mutex> locker(mixer->getRequestLock());
+    if (mixer->isMarkedForDeletion())
     {
         return;
     }
 
-    findResult->second->markForDeletion();
-    _engine.asyncRemoveMixer(findResult->second->getEngineMixer());
+    mixer->markForDeletion();
+    _engine.asyncRemoveMixer(mixer->getEngineMixer());
 }
 
 std::vector<std::string> MixerManager::getMixerIds()
@@ -254,19 +261,38 @@ std::vector<std::string> MixerManager::getMixerIds()
     return result;
 }
 
-std::unique_lock<std::mutex> MixerManager::getMixer(const std::string& id, Mixer*& outMixer)
+MixerManager::ScopedMixerLock::ScopedMixerLock(std::shared_ptr<Mixer> mixer) : _mixer(std::move(mixer)), _waitTime(0)
 {
-    std::unique_lock<std::mutex> locker(_configurationLock);
+    const auto start = utils::Time::getAbsoluteTime();
+    _lock = std::unique_lock<std::mutex>(_mixer->getRequestLock());
+    _waitTime = utils::Time::getAbsoluteTime() - start;
+}
 
+std::shared_ptr<Mixer> MixerManager::findMixer(const std::string& id)
+{
+    std::lock_guard<std::mutex> locker(_configurationLock);
     auto iterator = _mixers.find(id);
-    if (iterator != _mixers.cend() && !iterator->second->isMarkedForDeletion())
+    return iterator != _mixers.cend() ? iterator->second : nullptr;
+}
+
+MixerManager::ScopedMixerLock MixerManager::getMixer(const std::string& id, Mixer*& outMixer)
+{
+    outMixer = nullptr;
+    auto mixer = findMixer(id);
+    if (!mixer || mixer->isMarkedForDeletion())
     {
-        outMixer = iterator->second.get();
-        return locker;
+        return ScopedMixerLock();
     }
 
-    outMixer = nullptr;
-    return locker;
+    ScopedMixerLock mixerLock(std::move(mixer));
+    if (mixerLock.get()->isMarkedForDeletion())
+    {
+        // removed while waiting for the previous request
+        return ScopedMixerLock();
+    }
+
+    outMixer = mixerLock.get();
+    return mixerLock;
 }
 
 void MixerManager::stop()
@@ -277,16 +303,9 @@ void MixerManager::stop()
     }
 
     logger::info("stopping", "MixerManager");
+    for (const auto& mixerId : getMixerIds())
     {
-        std::lock_guard<std::mutex> locker(_configurationLock);
-        for (auto it = _mixers.begin(); it != _mixers.end(); ++it)
-        {
-            if (!it->second->isMarkedForDeletion())
-            {
-                it->second->markForDeletion();
-                _engine.asyncRemoveMixer(it->second->getEngineMixer());
-            }
-        }
+        remove(mixerId);
     }
 
     for (;; usleep(10000))
@@ -334,22 +353,28 @@ void MixerManager::maintenance(uint64_t timestamp)
 
 void MixerManager::engineMixerRemoved(EngineMixer& engineMixer)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
     std::string mixerId(engineMixer.getId()); // copy id string to have it after EngineMixer is deleted
-
-    auto findResult = _mixers.find(mixerId);
-    if (findResult != _mixers.end())
+    std::shared_ptr<Mixer> mixer;
     {
-        logger::info("Finalizing EngineMixer %s", "MixerManager", mixerId.c_str());
-        auto mixer = findResult->second;
-        _mixers.erase(mixerId);
-        mixer->stopTransports(); // this will stop new packets from coming in
-        _backgroundJobQueue.addJob<bridge::FinalizeEngineMixerRemoval>(*this, mixer);
+        std::lock_guard<std::mutex> locker(_configurationLock);
+        auto findResult = _mixers.find(mixerId);
+        if (findResult == _mixers.end())
+        {
+            logger::error("EngineMixer %s not found", "MixerManager", mixerId.c_str());
+            return;
+        }
+
+        mixer = findResult->second;
+        _mixers.erase(findResult);
     }
-    else
+
+    logger::info("Finalizing EngineMixer %s", "MixerManager", mixerId.c_str());
     {
-        logger::error("EngineMixer %s not found", "MixerManager", mixerId.c_str());
+        // the request lock is never taken while holding the configuration lock
+        std::lock_guard<std::mutex> locker(mixer->getRequestLock());
+        mixer->stopTransports(); // this will stop new packets from coming in
     }
+    _backgroundJobQueue.addJob<bridge::FinalizeEngineMixerRemoval>(*this, mixer);
 }
 
 void MixerManager::finalizeEngineMixerRemoval(const std::string& mixerId)
@@ -368,15 +393,13 @@ void MixerManager::finalizeEngineMixerRemoval(const std::string& mixerId)
 
 void MixerManager::audioStreamRemoved(EngineMixer& mixer, const EngineAudioStream& audioStream)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
-
     logger::info("Removing audioStream endpointId %s from mixer %s",
         "MixerManager",
         audioStream.endpointId.c_str(),
         mixer.getLoggableId().c_str());
 
-    const auto mixerIter = _mixers.find(mixer.getId());
-    if (mixerIter == _mixers.cend())
+    const auto mixerPtr = findMixer(mixer.getId());
+    if (!mixerPtr)
     {
         logger::info("Mixer %s (id=%s) does not exist",
             "MixerManager",
@@ -385,20 +408,19 @@ void MixerManager::audioStreamRemoved(EngineMixer& mixer, const EngineAudioStrea
         return;
     }
 
-    mixerIter->second->engineAudioStreamRemoved(audioStream);
+    std::lock_guard<std::mutex> locker(mixerPtr->getRequestLock());
+    mixerPtr->engineAudioStreamRemoved(audioStream);
 }
 
 void MixerManager::videoStreamRemoved(EngineMixer& engineMixer, const EngineVideoStream& videoStream)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
-
     logger::info("Removing videoStream endpointId %s from mixer %s",
         "MixerManager",
         videoStream.endpointId.c_str(),
         engineMixer.getLoggableId().c_str());
 
-    const auto mixerIter = _mixers.find(engineMixer.getId());
-    if (mixerIter == _mixers.cend())
+    const auto mixerPtr = findMixer(engineMixer.getId());
+    if (!mixerPtr)
     {
         logger::info("Mixer %s (id=%s) does not exist",
             "MixerManager",
@@ -407,20 +429,19 @@ void MixerManager::videoStreamRemoved(EngineMixer& engineMixer, const EngineVide
         return;
     }
 
-    mixerIter->second->engineVideoStreamRemoved(videoStream);
+    std::lock_guard<std::mutex> locker(mixerPtr->getRequestLock());
+    mixerPtr->engineVideoStreamRemoved(videoStream);
 }
 
 void MixerManager::recordingStreamRemoved(EngineMixer& mixer, const EngineRecordingStream& recordingStream)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
-
     logger::info("Removing recordingStream  %s from mixer %s",
         "MixerManager",
         recordingStream.id.c_str(),
         mixer.getLoggableId().c_str());
 
-    const auto mixerIter = _mixers.find(mixer.getId());
-    if (mixerIter == _mixers.cend())
+    const auto mixerPtr = findMixer(mixer.getId());
+    if (!mixerPtr)
     {
         logger::info("Mixer %s (id=%s) does not exist",
             "MixerManager",
@@ -429,20 +450,19 @@ void MixerManager::recordingStreamRemoved(EngineMixer& mixer, const EngineRecord
         return;
     }
 
-    mixerIter->second->engineRecordingStreamRemoved(recordingStream);
+    std::lock_guard<std::mutex> locker(mixerPtr->getRequestLock());
+    mixerPtr->engineRecordingStreamRemoved(recordingStream);
 }
 
 void MixerManager::dataStreamRemoved(EngineMixer& mixer, const EngineDataStream& dataStream)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
-
     logger::info("Removing dataStream endpointId %s from mixer %s",
         "MixerManager",
         dataStream.endpointId.c_str(),
         mixer.getLoggableId().c_str());
 
-    const auto mixerIter = _mixers.find(mixer.getId());
-    if (mixerIter == _mixers.cend())
+    const auto mixerPtr = findMixer(mixer.getId());
+    if (!mixerPtr)
     {
         logger::info("Mixer %s (id=%s) does not exist",
             "MixerManager",
@@ -451,7 +471,8 @@ void MixerManager::dataStreamRemoved(EngineMixer& mixer, const EngineDataStream&
         return;
     }
 
-    mixerIter->second->engineDataStreamRemoved(dataStream);
+    std::lock_guard<std::mutex> locker(mixerPtr->getRequestLock());
+    mixerPtr->engineDataStreamRemoved(dataStream);
 }
 
 void MixerManager::mixerTimedOut(EngineMixer& mixer)
@@ -468,28 +489,37 @@ void MixerManager::inboundSsrcContextRemoved(EngineMixer& mixer, uint32_t ssrc,
 
 void MixerManager::allocateVideoPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
+    const auto mixerPtr = findMixer(mixer.getId());
+    if (!mixerPtr)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> locker(mixerPtr->getRequestLock());
+    mixerPtr->allocateVideoPacketCache(ssrc, endpointIdHash);
+}
 
-    const auto mixerItr = _mixers.find(mixer.getId());
-    if (mixerItr == _mixers.cend())
+void MixerManager::allocateInboundPacketCache(EngineMixer& mixer, uint32_t ssrc)
+{
+    const auto mixerPtr = findMixer(mixer.getId());
+    if (!mixerPtr)
     {
         return;
     }
 
-    mixerItr->second->allocateVideoPacketCache(ssrc, endpointIdHash);
+    mixerPtr->allocateInboundPacketCache(ssrc);
 }
 
 void MixerManager::freeVideoPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
-
-    const auto mixerItr = _mixers.find(mixer.getId());
-    if (mixerItr == _mixers.cend())
+    const auto mixerPtr = findMixer(mixer.getId());
+    if (!mixerPtr)
     {
         return;
     }
 
-    mixerItr->second->freeVideoPacketCache(ssrc, endpointIdHash);
+    std::lock_guard<std::mutex> locker(mixerPtr->getRequestLock());
+    mixerPtr->freeVideoPacketCache(ssrc, endpointIdHash);
 }
 
 void MixerManager::sctpReceived(EngineMixer& mixer, memory::UniquePacket msgPacket, size_t endpointIdHash)
@@ -514,27 +544,28 @@ void MixerManager::sctpReceived(EngineMixer& mixer, memory::UniquePacket msgPack
             if (api::DataChannelMessageParser::isPinnedEndpointsChanged(json))
             {
                 logger::debug("received pin msg %s", "MixerManager", body.c_str());
-                auto mixerIt = _mixers.find(mixer.getId());
-                if (mixerIt != _mixers.end())
+                const auto mixerPtr = findMixer(mixer.getId());
+                if (mixerPtr)
                 {
+                    std::lock_guard<std::mutex> locker(mixerPtr->getRequestLock());
                     const auto pinnedEndpoints = api::DataChannelMessageParser::getPinnedEndpoint(json);
                     if (pinnedEndpoints.isNone())
                     {
-                        mixerIt->second->unpinEndpoint(endpointIdHash);
+                        mixerPtr->unpinEndpoint(endpointIdHash);
                     }
                     else
                     {
                         auto endpoints = pinnedEndpoints.getArray();
                         char endpointId[45];
                         endpoints.front().getString(endpointId);
-                        mixerIt->second->pinEndpoint(endpointIdHash, endpointId);
+                        mixerPtr->pinEndpoint(endpointIdHash, endpointId);
                     }
                 }
             }
             else if (api::DataChannelMessageParser::isEndpointMessage(json))
             {
-                auto mixerIt = _mixers.find(mixer.getId());
-                if (mixerIt == _mixers.end())
+                const auto mixerPtr = findMixer(mixer.getId());
+                if (!mixerPtr)
                 {
                     return;
                 }
@@ -548,7 +579,8 @@ void MixerManager::sctpReceived(EngineMixer& mixer, memory::UniquePacket msgPack
                 }
 
                 auto toEndpoint = toJson.getString();
-                mixerIt->second->sendEndpointMessage(toEndpoint, endpointIdHash, payloadJson);
+                std::lock_guard<std::mutex> locker(mixerPtr->getRequestLock());
+                mixerPtr->sendEndpointMessage(toEndpoint, endpointIdHash, payloadJson);
             }
             else
             {
@@ -579,15 +611,13 @@ void MixerManager::sctpReceived(EngineMixer& mixer, memory::UniquePacket msgPack
 
 void MixerManager::engineRecordingStopped(EngineMixer& mixer, const RecordingDescription& recordingDesc)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
-
     logger::info("Stopping recording %s from mixer %s",
         "MixerManager",
         recordingDesc.recordingId.c_str(),
         mixer.getLoggableId().c_str());
 
-    const auto mixerIter = _mixers.find(mixer.getId());
-    if (mixerIter == _mixers.cend())
+    const auto mixerPtr = findMixer(mixer.getId());
+    if (!mixerPtr)
     {
         logger::info("Mixer %s (id=%s) does not exist",
             "MixerManager",
@@ -596,56 +626,53 @@ void MixerManager::engineRecordingStopped(EngineMixer& mixer, const RecordingDes
         return;
     }
 
-    mixerIter->second->engineRecordingDescStopped(recordingDesc);
+    std::lock_guard<std::mutex> locker(mixerPtr->getRequestLock());
+    mixerPtr->engineRecordingDescStopped(recordingDesc);
 }
 
 void MixerManager::allocateRecordingRtpPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
-
-    const auto mixerItr = _mixers.find(mixer.getId());
-    if (mixerItr == _mixers.cend())
+    const auto mixerPtr = findMixer(mixer.getId());
+    if (!mixerPtr)
     {
         return;
     }
 
-    mixerItr->second->allocateRecordingRtpPacketCache(ssrc, endpointIdHash);
+    std::lock_guard<std::mutex> locker(mixerPtr->getRequestLock());
+    mixerPtr->allocateRecordingRtpPacketCache(ssrc, endpointIdHash);
 }
 
 void MixerManager::freeRecordingRtpPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
-
-    const auto mixerItr = _mixers.find(mixer.getId());
-    if (mixerItr == _mixers.cend())
+    const auto mixerPtr = findMixer(mixer.getId());
+    if (!mixerPtr)
     {
         return;
     }
 
-    mixerItr->second->freeRecordingRtpPacketCache(ssrc, endpointIdHash);
+    std::lock_guard<std::mutex> locker(mixerPtr->getRequestLock());
+    mixerPtr->freeRecordingRtpPacketCache(ssrc, endpointIdHash);
 }
 
 void MixerManager::removeRecordingTransport(EngineMixer& mixer, EndpointIdString streamId, size_t endpointIdHash)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
-
-    const auto mixerItr = _mixers.find(mixer.getId());
-    if (mixerItr == _mixers.cend())
+    const auto mixerPtr = findMixer(mixer.getId());
+    if (!mixerPtr)
     {
         return;
     }
 
-    mixerItr->second->removeRecordingTransport(streamId.c_str(), endpointIdHash);
+    std::lock_guard<std::mutex> locker(mixerPtr->getRequestLock());
+    mixerPtr->removeRecordingTransport(streamId.c_str(), endpointIdHash);
 }
 
 void MixerManager::barbellRemoved(EngineMixer& mixer, const EngineBarbell& barbell)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
-
-    auto mixerIt = _mixers.find(mixer.getId());
-    if (mixerIt != _mixers.end())
+    const auto mixerPtr = findMixer(mixer.getId());
+    if (mixerPtr)
     {
-        mixerIt->second->engineBarbellRemoved(barbell);
+        std::lock_guard<std::mutex> locker(mixerPtr->getRequestLock());
+        mixerPtr->engineBarbellRemoved(barbell);
     }
 }
 
@@ -676,34 +703,69 @@ Stats::MixerManagerStats MixerManager::getStats()
     result.udpSharedEndpointsReceiveKbps = static_cast<uint32_t>(udpMetrics.receiveKbps);
     result.udpSharedEndpointsSendKbps = static_cast<uint32_t>(udpMetrics.sendKbps);
     result.udpSharedEndpointsSendDrops = udpMetrics.sendQueueDrops;
+    result.udpSharedEndpointsUnknownFlowDrops = udpMetrics.unknownFlowDrops;
+    result.udpSharedEndpointsStunFastPathResponses = udpMetrics.stunFastPathResponses;
+    result.udpSharedEndpointsStunFastPathFallbacks = udpMetrics.stunFastPathFallbacks;
 
     return result;
 }
 
-void MixerManager::updateStats()
+// OpenMetrics text exposition of latency histograms and pool occupancy. Does not block on engine or mixers.
+std::string MixerManager::getMetrics()
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
+    std::string result;
+    utils::metrics::describe(result);
+
+    const char* poolItems = "smb_pool_allocated_items";
+    utils::metrics::describeGauge(result, poolItems, "Number of items allocated from the pool.");
+    utils::metrics::appendGaugeValue(result, poolItems, "pool", "main", _mainAllocator.countAllocatedItems());
+    utils::metrics::appendGaugeValue(result, poolItems, "pool", "send", _sendAllocator.countAllocatedItems());
+    utils::metrics::appendGaugeValue(result, poolItems, "pool", "audio", _audioAllocator.countAllocatedItems());
+    utils::metrics::appendGaugeValue(result, poolItems, "pool", "rtJobs", _rtJobManager.getCount());
+    utils::metrics::appendGaugeValue(result, poolItems, "pool", "backgroundJobs", _backgroundJobQueue.getCount());
+
+    result.append("# EOF\n");
+    return result;
+}
 
-    _stats.conferences = _mixers.size();
-    _stats.videoStreams = 0;
-    _stats.audioStreams = 0;
-    _stats.dataStreams = 0;
-    _stats.largestConference = 0;
+void MixerManager::updateStats()
+{
+    // mixers lock their own configuration while gathering, so only the list is copied under the manager lock
+    std::vector<std::shared_ptr<Mixer>> mixers;
+    {
+        std::lock_guard<std::mutex> locker(_configurationLock);
+        mixers.reserve(_mixers.size());
+        for (const auto& mixer : _mixers)
+        {
+            mixers.push_back(mixer.second);
+        }
+    }
 
-    for (const auto& mixer : _mixers)
+    MixerStats stats;
+    stats.conferences = mixers.size();
+    EngineStats::MixerStats activeMixers;
+    const auto timestamp = utils::Time::getAbsoluteTime();
+    for (const auto& mixer : mixers)
     {
-        const auto stats = mixer.second->getStats();
-        _stats.videoStreams += stats.videoStreams;
-        _stats.audioStreams += stats.audioStreams;
-        _stats.dataStreams += stats.videoStreams;
-        _stats.largestConference = std::max(stats.transports, _stats.largestConference);
+        const auto mixerStats = mixer->getStats();
+        stats.videoStreams += mixerStats.videoStreams;
+        stats.audioStreams += mixerStats.audioStreams;
+        stats.dataStreams += mixerStats.videoStreams;
+        stats.largestConference = std::max(mixerStats.transports, stats.largestConference);
+        activeMixers += mixer->gatherStats(timestamp);
     }
 
-    _stats.engine = _engine.getStats();
+    stats.engine = _engine.getStats();
+    stats.engine.activeMixers = activeMixers;
+
+    {
+        std::lock_guard<std::mutex> locker(_configurationLock);
+        _stats = stats;
+    }
 
     if (_mainAllocator.size() < 512)
     {
-        logger::warn("stats main pool %zu, mixers %zu", "MixerManager", _mainAllocator.size(), _mixers.size());
+        logger::warn("stats main pool %zu, mixers %zu", "MixerManager", _mainAllocator.size(), mixers.size());
     }
 }
 
@@ -724,4 +786,14 @@ Stats::AggregatedBarbellStats MixerManager::getBarbellStats()
     return result;
 }
 
+Stats::SharedUdpFlowStats MixerManager::getSharedUdpFlowStats()
+{
+    const size_t maxReportedFlows = 4096;
+
+    Stats::SharedUdpFlowStats result;
+    result.flows.reserve(maxReportedFlows);
+    _transportFactory.getSharedUdpEndpointsFlows(result.flows, maxReportedFlows);
+    return result;
+}
+
 } // namespace bridge
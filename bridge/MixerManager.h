@@ -48,6 +48,26 @@ class Mixer;
 class MixerManager : public MixerManagerAsync
 {
 public:
+    /**
+     * Exclusive access to one conference for the duration of an API request. Holds a reference to the Mixer, so
+     * the MixerManager lock is only needed for the lookup and requests on other conferences can run concurrently.
+     */
+    class ScopedMixerLock
+    {
+    public:
+        ScopedMixerLock() : _waitTime(0) {}
+        explicit ScopedMixerLock(std::shared_ptr<Mixer> mixer);
+
+        Mixer* get() const { return _mixer.get(); }
+        bool owns_lock() const { return _lock.owns_lock(); }
+        uint64_t getWaitTime() const { return _waitTime; }
+
+    private:
+        std::shared_ptr<Mixer> _mixer;
+        std::unique_lock<std::mutex> _lock;
+        uint64_t _waitTime;
+    };
+
     MixerManager(utils::IdGenerator& idGenerator,
         utils::SsrcGenerator& ssrcGenerator,
         jobmanager::JobManager& rtJobManager,
@@ -67,14 +87,16 @@ public:
         VideoCodecSpec videoCodecs = VideoCodecSpec());
     void remove(const std::string& id);
     std::vector<std::string> getMixerIds();
-    std::unique_lock<std::mutex> getMixer(const std::string& id, Mixer*& outMixer);
+    ScopedMixerLock getMixer(const std::string& id, Mixer*& outMixer);
 
     void stop();
     void maintenance(uint64_t timestamp);
 
     Stats::MixerManagerStats getStats();
+    std::string getMetrics();
 
     Stats::AggregatedBarbellStats getBarbellStats();
+    Stats::SharedUdpFlowStats getSharedUdpFlowStats();
     void finalizeEngineMixerRemoval(const std::string& mixerId);
 
     // Protected for unit test spies to extend and have access to the variables
@@ -112,6 +134,7 @@ protected:
     memory::AudioPacketPoolAllocator& _audioAllocator;
 
     void updateStats();
+    std::shared_ptr<Mixer> findMixer(const std::string& id);
 
     // Async interface
     bool post(utils::Function&& task) override { return _backgroundJobQueue.post(std::move(task)); }
@@ -120,6 +143,7 @@ protected:
     void engineMixerRemoved(EngineMixer& mixer) override;
     void freeVideoPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash) override;
     void allocateVideoPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash) override;
+    void allocateInboundPacketCache(EngineMixer& mixer, uint32_t ssrc) override;
     void allocateRecordingRtpPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash) override;
     void videoStreamRemoved(EngineMixer& engineMixer, const EngineVideoStream& videoStream) override;
     void sctpReceived(EngineMixer& mixer, memory::UniquePacket msgPacket, size_t endpointIdHash) override;
@@ -40,6 +40,11 @@ bool MixerManagerAsync::asyncAllocateVideoPacketCache(EngineMixer& mixer, uint32
     return post(utils::bind(&MixerManagerAsync::allocateVideoPacketCache, this, std::ref(mixer), ssrc, endpointIdHash));
 }
 
+bool MixerManagerAsync::asyncAllocateInboundPacketCache(EngineMixer& mixer, uint32_t ssrc)
+{
+    return post(utils::bind(&MixerManagerAsync::allocateInboundPacketCache, this, std::ref(mixer), ssrc));
+}
+
 bool MixerManagerAsync::asyncAllocateRecordingRtpPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash)
 {
     return post(
@@ -42,6 +42,7 @@ protected:
     virtual void engineMixerRemoved(EngineMixer& mixer) = 0;
     virtual void freeVideoPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash) = 0;
     virtual void allocateVideoPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash) = 0;
+    virtual void allocateInboundPacketCache(EngineMixer& mixer, uint32_t ssrc) = 0;
     virtual void allocateRecordingRtpPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash) = 0;
     virtual void videoStreamRemoved(EngineMixer& engineMixer, const EngineVideoStream& videoStream) = 0;
     virtual void sctpReceived(EngineMixer& mixer, memory::UniquePacket msgPacket, size_t endpointIdHash) = 0;
@@ -59,6 +60,7 @@ public:
     bool asyncEngineMixerRemoved(EngineMixer& mixer);
     bool asyncFreeVideoPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash);
     bool asyncAllocateVideoPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash);
+    bool asyncAllocateInboundPacketCache(EngineMixer& mixer, uint32_t ssrc);
     bool asyncAllocateRecordingRtpPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash);
     bool asyncVideoStreamRemoved(EngineMixer& engineMixer, const EngineVideoStream& videoStream);
     bool asyncSctpReceived(EngineMixer& mixer, memory::UniquePacket& msgPacket, size_t endpointIdHash);
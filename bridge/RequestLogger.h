@@ -4,8 +4,10 @@
 #include "httpd/Response.h"
 #include "logger/Logger.h"
 #include "utils/StdExtensions.h"
+#include "utils/Time.h"
 #include <algorithm>
 #include <atomic>
+#include <cinttypes>
 #include <cstdint>
 #include <numeric>
 #include <string>
@@ -19,7 +21,8 @@ class RequestLogger
 public:
     RequestLogger(const httpd::Request& request, std::atomic<uint32_t>& lastAutoRequestId)
         : _request(request),
-          _responseStatusCode(0)
+          _responseStatusCode(0),
+          _lockWaitTime(0)
     {
         if (shouldLog(request.url))
         {
@@ -42,6 +45,7 @@ public:
     }
 
     void setErrorMessage(const std::string& message) { _errorMessages = message; }
+    void setLockWaitTime(uint64_t lockWaitTime) { _lockWaitTime = lockWaitTime; }
 
     ~RequestLogger()
     {
@@ -49,15 +53,20 @@ public:
         {
             if (!_requestId.empty())
             {
-                logger::info("Outgoing response [%s] %u", "RequestHandler", _requestId.c_str(), _responseStatusCode);
+                logger::info("Outgoing response [%s] %u, conference lock wait %" PRIu64 "us",
+                    "RequestHandler",
+                    _requestId.c_str(),
+                    _responseStatusCode,
+                    _lockWaitTime / utils::Time::us);
             }
         }
         else if (!_requestId.empty())
         {
-            logger::warn("Outgoing response [%s] %u. Error message: %s",
+            logger::warn("Outgoing response [%s] %u, conference lock wait %" PRIu64 "us. Error message: %s",
                 "RequestHandler",
                 _requestId.c_str(),
                 _responseStatusCode,
+                _lockWaitTime / utils::Time::us,
                 _errorMessages.c_str());
         }
         else
@@ -83,6 +92,7 @@ private:
     std::string _requestId;
     std::string _errorMessages;
     uint32_t _responseStatusCode;
+    uint64_t _lockWaitTime;
 
     const static std::vector<std::string> _logFilter;
 };
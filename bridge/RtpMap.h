@@ -107,7 +107,7 @@ struct RtpMap
         for (uint8_t id = 1; id < ExtHeaderIdentifiers::EOL; ++id)
         {
             if (absSendTimeExtId.valueOr(16) != id && c9infoExtId.valueOr(16) != id &&
-                audioLevelExtId.valueOr(16) != id)
+                audioLevelExtId.valueOr(16) != id && transportCcExtId.valueOr(16) != id)
             {
                 return id;
             }
@@ -124,6 +124,7 @@ struct RtpMap
     utils::Optional<uint8_t> audioLevelExtId;
     utils::Optional<uint8_t> absSendTimeExtId;
     utils::Optional<uint8_t> c9infoExtId;
+    utils::Optional<uint8_t> transportCcExtId;
 };
 
 } // namespace bridge
@@ -116,11 +116,16 @@ std::string MixerManagerStats::describe()
 
     result["pacing_queue"] = engineStats.activeMixers.pacingQueue;
     result["rtx_pacing_queue"] = engineStats.activeMixers.rtxPacingQueue;
+    result["ingress_queue_depth"] = engineStats.activeMixers.ingressQueueDepth;
+    result["ingress_drain_latency_us"] = engineStats.activeMixers.ingressDrainLatencyUs;
 
     result["shared_udp_send_queue"] = udpSharedEndpointsSendQueue;
     result["shared_udp_receive_rate"] = udpSharedEndpointsReceiveKbps;
     result["shared_udp_send_rate"] = udpSharedEndpointsSendKbps;
     result["shared_udp_end_drops"] = udpSharedEndpointsSendDrops;
+    result["shared_udp_unknown_flow_drops"] = udpSharedEndpointsUnknownFlowDrops;
+    result["shared_udp_stun_fast_path_responses"] = udpSharedEndpointsStunFastPathResponses;
+    result["shared_udp_stun_fast_path_fallbacks"] = udpSharedEndpointsStunFastPathFallbacks;
 
     result["send_pool"] = sendPoolSize;
     result["receive_pool"] = receivePoolSize;
@@ -512,6 +517,23 @@ std::string AggregatedBarbellStats::describe() const
     return result.dump(4);
 }
 
+std::string SharedUdpFlowStats::describe() const
+{
+    auto result = nlohmann::json::array();
+    for (const auto& flow : flows)
+    {
+        nlohmann::json flowJson;
+        flowJson["remote"] = flow.remote.toString();
+        flowJson["local_port"] = flow.localPort;
+        flowJson["class"] = transport::toString(flow.packetClass);
+        flowJson["packets"] = flow.packets;
+        flowJson["bytes"] = flow.bytes;
+        flowJson["drops"] = flow.drops;
+        result.push_back(flowJson);
+    }
+    return result.dump(4);
+}
+
 } // namespace Stats
 
 } // namespace bridge
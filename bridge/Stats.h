@@ -2,6 +2,7 @@
 
 #include "bridge/engine/EngineStats.h"
 #include "concurrency/MpmcPublish.h"
+#include "transport/FlowTable.h"
 #include <array>
 #include <inttypes.h>
 #include <unordered_map>
@@ -69,10 +70,20 @@ struct MixerManagerStats
     uint32_t udpSharedEndpointsReceiveKbps = 0;
     uint32_t udpSharedEndpointsSendKbps = 0;
     uint64_t udpSharedEndpointsSendDrops = 0;
+    uint64_t udpSharedEndpointsUnknownFlowDrops = 0;
+    uint64_t udpSharedEndpointsStunFastPathResponses = 0;
+    uint64_t udpSharedEndpointsStunFastPathFallbacks = 0;
 
     std::string describe();
 };
 
+// Flows on the shared UDP ports, as demultiplexed by the endpoints
+struct SharedUdpFlowStats
+{
+    std::vector<transport::FlowStats> flows;
+    std::string describe() const;
+};
+
 struct BarbellPayloadStats
 {
     int64_t octets = 0;
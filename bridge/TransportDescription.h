@@ -14,6 +14,7 @@ struct TransportDescription
     {
         std::vector<ice::IceCandidate> iceCandidates;
         std::pair<std::string, std::string> iceCredentials;
+        bool iceLite;
     };
 
     struct Dtls
@@ -25,10 +26,11 @@ struct TransportDescription
 
     TransportDescription(const std::vector<ice::IceCandidate>& iceCandidates,
         const std::pair<std::string, std::string>& iceCredentials,
+        const bool iceLite,
         const bool isDtlsClient,
         const std::vector<srtp::AesKey>& sdesKeys,
         srtp::Mode srtpMode)
-        : ice(Ice{iceCandidates, iceCredentials}),
+        : ice(Ice{iceCandidates, iceCredentials, iceLite}),
           dtls(Dtls{isDtlsClient}),
           sdesKeys(sdesKeys),
           srtpMode(srtpMode)
@@ -1,5 +1,6 @@
 #pragma once
 #include "ActionContext.h"
+#include "bridge/MixerManager.h"
 #include "httpd/Request.h"
 #include "httpd/Response.h"
 #include "utils/StringTokenizer.h"
@@ -11,7 +12,7 @@ namespace bridge
 class Mixer;
 
 class RequestLogger;
-std::unique_lock<std::mutex> getConferenceMixer(ActionContext*, const std::string&, Mixer*&);
+MixerManager::ScopedMixerLock getConferenceMixer(ActionContext*, RequestLogger&, const std::string&, Mixer*&);
 
 httpd::Response allocateConference(ActionContext*, RequestLogger&, const httpd::Request&);
 
@@ -30,6 +31,17 @@ httpd::Response processEndpointPutRequest(ActionContext* context,
     const std::string& conferenceId,
     const std::string& endpointId);
 
+httpd::Response processEndpointCaptureRequest(ActionContext* context,
+    RequestLogger& requestLogger,
+    const httpd::Request& request,
+    const std::string& conferenceId,
+    const std::string& endpointId);
+
+httpd::Response processEndpointBatchRequest(ActionContext* context,
+    RequestLogger& requestLogger,
+    const httpd::Request& request,
+    const std::string& conferenceId);
+
 httpd::Response getConferenceInfo(ActionContext*,
     RequestLogger&,
     const httpd::Request&,
@@ -40,6 +52,8 @@ httpd::Response getEndpointInfo(ActionContext*,
     const std::string& conferenceId,
     const std::string& endpointId);
 httpd::Response handleStats(ActionContext*, RequestLogger&, const httpd::Request&);
+httpd::Response handleMetrics(ActionContext*, RequestLogger&, const httpd::Request&);
+httpd::Response handleFlowStats(ActionContext*, RequestLogger&, const httpd::Request&);
 httpd::Response handleBarbellStats(ActionContext*, RequestLogger&, const httpd::Request&);
 httpd::Response handleBarbellStats(ActionContext*, RequestLogger&, const httpd::Request&, const std::string&);
 httpd::Response handleAbout(ActionContext*,
@@ -2,6 +2,7 @@
 #include "api/EndpointDescription.h"
 #include "bridge/Mixer.h"
 #include "bridge/MixerManager.h"
+#include "bridge/RequestLogger.h"
 #include "bridge/endpointActions/ActionContext.h"
 #include "codec/Opus.h"
 #include "codec/Vp8.h"
@@ -12,12 +13,13 @@
 
 namespace bridge
 {
-std::unique_lock<std::mutex> getConferenceMixer(ActionContext* context,
+MixerManager::ScopedMixerLock getConferenceMixer(ActionContext* context,
+    RequestLogger& requestLogger,
     const std::string& conferenceId,
     Mixer*& outMixer)
 {
     auto scopedMixerLock = context->mixerManager.getMixer(conferenceId, outMixer);
-    assert(scopedMixerLock.owns_lock());
+    requestLogger.setLockWaitTime(scopedMixerLock.getWaitTime());
     if (!outMixer)
     {
         throw httpd::RequestErrorException(httpd::StatusCode::NOT_FOUND,
@@ -26,7 +28,12 @@ std::unique_lock<std::mutex> getConferenceMixer(ActionContext* context,
     return scopedMixerLock;
 }
 
-void addDefaultAudioProperties(api::Audio& audio, bool includeTelephoneEvent)
+namespace
+{
+const char* transportCcUri = "http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01";
+}
+
+void addDefaultAudioProperties(api::Audio& audio, bool includeTelephoneEvent, bool includeTransportCc)
 {
     audio.payloadTypes.reserve(2);
     api::PayloadType& opus = audio.payloadTypes.emplace_back();
@@ -36,6 +43,10 @@ void addDefaultAudioProperties(api::Audio& audio, bool includeTelephoneEvent)
     opus.channels.set(codec::Opus::channelsPerFrame);
     opus.parameters.emplace_back("minptime", "10");
     opus.parameters.emplace_back("useinbandfec", "1");
+    if (includeTransportCc)
+    {
+        opus.rtcpFeedbacks.emplace_back("transport-cc", utils::Optional<std::string>());
+    }
 
     if (includeTelephoneEvent)
     {
@@ -48,6 +59,10 @@ void addDefaultAudioProperties(api::Audio& audio, bool includeTelephoneEvent)
     audio.rtpHeaderExtensions.emplace_back(1, "urn:ietf:params:rtp-hdrext:ssrc-audio-level");
     audio.rtpHeaderExtensions.emplace_back(3, "http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time");
     audio.rtpHeaderExtensions.emplace_back(8, "c9:params:rtp-hdrext:info");
+    if (includeTransportCc)
+    {
+        audio.rtpHeaderExtensions.emplace_back(5, transportCcUri);
+    }
 }
 
 void addVp8VideoProperties(api::Video& video)
@@ -97,8 +112,16 @@ void addH264VideoProperties(api::Video& video, const std::string& profileLevelId
     video.payloadTypes.push_back(h264);
 }
 
-void addDefaultVideoProperties(api::Video& video)
+void addDefaultVideoProperties(api::Video& video, bool includeTransportCc)
 {
+    if (includeTransportCc)
+    {
+        for (auto& payloadType : video.payloadTypes)
+        {
+            payloadType.rtcpFeedbacks.emplace_back("transport-cc", utils::Optional<std::string>());
+        }
+    }
+
     api::PayloadType vp8Rtx;
     vp8Rtx.id = 96;
     vp8Rtx.name = "rtx";
@@ -108,6 +131,10 @@ void addDefaultVideoProperties(api::Video& video)
 
     video.rtpHeaderExtensions.emplace_back(3, "http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time");
     video.rtpHeaderExtensions.emplace_back(4, "urn:ietf:params:rtp-hdrext:sdes:rtp-stream-id");
+    if (includeTransportCc)
+    {
+        video.rtpHeaderExtensions.emplace_back(5, transportCcUri);
+    }
 }
 
 ice::TransportType parseTransportType(const std::string& protocol)
@@ -251,6 +278,7 @@ bridge::RtpMap makeRtpMap(const api::Audio& audio, const api::PayloadType& paylo
     rtpMap.audioLevelExtId = findAudioLevelExtensionId(audio.rtpHeaderExtensions);
     rtpMap.absSendTimeExtId = findAbsSendTimeExtensionId(audio.rtpHeaderExtensions);
     rtpMap.c9infoExtId = findC9InfoExtensionId(audio.rtpHeaderExtensions);
+    rtpMap.transportCcExtId = findTransportCcExtensionId(audio.rtpHeaderExtensions);
 
     return rtpMap;
 }
@@ -283,6 +311,7 @@ bridge::RtpMap makeRtpMap(const api::Video& video, const api::PayloadType& paylo
     }
 
     rtpMap.absSendTimeExtId = findAbsSendTimeExtensionId(video.rtpHeaderExtensions);
+    rtpMap.transportCcExtId = findTransportCcExtensionId(video.rtpHeaderExtensions);
 
     return rtpMap;
 }
@@ -317,6 +346,12 @@ utils::Optional<uint8_t> findC9InfoExtensionId(const std::vector<std::pair<uint3
     return findExtensionId("c9:params:rtp-hdrext:info", rtpHeaderExtensions);
 }
 
+utils::Optional<uint8_t> findTransportCcExtensionId(
+    const std::vector<std::pair<uint32_t, std::string>>& rtpHeaderExtensions)
+{
+    return findExtensionId(transportCcUri, rtpHeaderExtensions);
+}
+
 std::vector<bridge::SimulcastStream> makeSimulcastStreams(const api::Video& video, const std::string& endpointId)
 {
     std::vector<bridge::SimulcastStream> simulcastStreams;
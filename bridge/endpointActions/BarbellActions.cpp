@@ -72,7 +72,7 @@ httpd::Response generateBarbellResponse(ActionContext* context,
         mixer.getAudioStreamDescription(streamDescription);
         responseAudio.ssrcs = streamDescription.ssrcs;
 
-        addDefaultAudioProperties(responseAudio, false);
+        addDefaultAudioProperties(responseAudio, false, false);
         channelsDescription.audio = std::move(responseAudio);
     }
 
@@ -104,7 +104,7 @@ httpd::Response generateBarbellResponse(ActionContext* context,
         {
             addVp8VideoProperties(responseVideo);
         }
-        addDefaultVideoProperties(responseVideo);
+        addDefaultVideoProperties(responseVideo, false);
         channelsDescription.video = std::move(responseVideo);
     }
 
@@ -128,7 +128,7 @@ httpd::Response allocateBarbell(ActionContext* context,
     const std::string& barbellId)
 {
     Mixer* mixer;
-    auto scopedMixerLock = getConferenceMixer(context, conferenceId, mixer);
+    auto scopedMixerLock = getConferenceMixer(context, requestLogger, conferenceId, mixer);
 
     const auto iceRole = iceControlling ? ice::IceRole::CONTROLLING : ice::IceRole::CONTROLLED;
     if (!mixer->addBarbell(barbellId, iceRole))
@@ -152,7 +152,7 @@ httpd::Response configureBarbell(ActionContext* context,
     const api::BarbellDescription& barbellDescription)
 {
     Mixer* mixer;
-    auto scopedMixerLock = getConferenceMixer(context, conferenceId, mixer);
+    auto scopedMixerLock = getConferenceMixer(context, requestLogger, conferenceId, mixer);
 
     if (!barbellDescription.transport.ice.isSet() || !barbellDescription.transport.dtls.isSet())
     {
@@ -242,7 +242,7 @@ httpd::Response deleteBarbell(ActionContext* context,
     const std::string& barbellId)
 {
     Mixer* mixer;
-    auto scopedMixerLock = getConferenceMixer(context, conferenceId, mixer);
+    auto scopedMixerLock = getConferenceMixer(context, requestLogger, conferenceId, mixer);
     mixer->removeBarbell(barbellId);
     auto response = httpd::Response(httpd::StatusCode::NO_CONTENT);
     return response;
@@ -0,0 +1,140 @@
+#include "ApiActions.h"
+#include "bridge/Mixer.h"
+#include "bridge/RequestLogger.h"
+#include "config/Config.h"
+#include "httpd/RequestErrorException.h"
+#include "logger/PacketCapture.h"
+#include "memory/Packet.h"
+#include "nlohmann/json.hpp"
+#include "utils/Format.h"
+#include "utils/Time.h"
+#include <atomic>
+#include <chrono>
+
+namespace bridge
+{
+
+namespace
+{
+const uint32_t headerSnapLength = 256;
+std::atomic_uint32_t captureSequenceNumber(0);
+
+// Throws if the endpoint has no bundle transport, or when starting a capture while one is running.
+void checkCaptureEndpoint(Mixer& mixer, const std::string& conferenceId, const std::string& endpointId, bool start)
+{
+    bool isActive = false;
+    if (!mixer.isPacketCaptureActive(endpointId, isActive))
+    {
+        throw httpd::RequestErrorException(httpd::StatusCode::NOT_FOUND,
+            utils::format("Bundle transport for endpoint '%s'/'%s' not found",
+                conferenceId.c_str(),
+                endpointId.c_str()));
+    }
+
+    if (start && isActive)
+    {
+        throw httpd::RequestErrorException(httpd::StatusCode::CONFLICT,
+            utils::format("Packet capture of endpoint '%s'/'%s' is already running",
+                conferenceId.c_str(),
+                endpointId.c_str()));
+    }
+}
+
+std::shared_ptr<logger::PacketCapture> createPacketCapture(const config::Config& config,
+    const nlohmann::json& requestBodyJson,
+    const std::string& conferenceId,
+    const std::string& endpointId)
+{
+    if (config.capture.directory.get().empty())
+    {
+        throw httpd::RequestErrorException(httpd::StatusCode::BAD_REQUEST, "Packet capture is not enabled");
+    }
+
+    const bool includePayload = requestBodyJson.value("payload", false);
+    const uint32_t maxFileSizeMB = std::min(requestBodyJson.value("max-size-mb", config.capture.maxFileSizeMB.get()),
+        config.capture.maxFileSizeMB.get());
+    const uint32_t maxPacketsPerSecond =
+        std::min(requestBodyJson.value("max-packets-per-second", config.capture.maxPacketsPerSecond.get()),
+            config.capture.maxPacketsPerSecond.get());
+
+    // the sequence number keeps names unique when a capture is restarted within the same second
+    const auto startTime =
+        std::chrono::duration_cast<std::chrono::seconds>(utils::Time::now().time_since_epoch()).count();
+    const auto fileName = utils::format("%s/%s-%s-%lld-%u.pcapng",
+        config.capture.directory.get().c_str(),
+        conferenceId.c_str(),
+        endpointId.c_str(),
+        static_cast<long long>(startTime),
+        captureSequenceNumber.fetch_add(1));
+
+    auto packetCapture = std::make_shared<logger::PacketCapture>(fileName,
+        static_cast<size_t>(maxFileSizeMB) * 1024 * 1024,
+        includePayload ? memory::Packet::size : headerSnapLength,
+        !includePayload,
+        maxPacketsPerSecond);
+
+    if (!packetCapture->isGood())
+    {
+        throw httpd::RequestErrorException(httpd::StatusCode::INTERNAL_SERVER_ERROR,
+            utils::format("Failed to create capture file '%s'", fileName.c_str()));
+    }
+
+    return packetCapture;
+}
+} // namespace
+
+httpd::Response processEndpointCaptureRequest(ActionContext* context,
+    RequestLogger& requestLogger,
+    const httpd::Request& request,
+    const std::string& conferenceId,
+    const std::string& endpointId)
+{
+    const auto requestBodyJson = nlohmann::json::parse(request.body.getSpan());
+    const bool start = requestBodyJson.value("action", std::string()) == "start-capture";
+
+    // Validate before the file is created, but allocate and populate it without holding the mixer lock. The
+    // endpoint is checked again when attaching as it may have been removed or started capture meanwhile.
+    std::shared_ptr<logger::PacketCapture> packetCapture;
+    if (start)
+    {
+        {
+            Mixer* mixer;
+            auto scopedMixerLock = getConferenceMixer(context, requestLogger, conferenceId, mixer);
+            checkCaptureEndpoint(*mixer, conferenceId, endpointId, start);
+        }
+        packetCapture = createPacketCapture(context->config, requestBodyJson, conferenceId, endpointId);
+    }
+
+    try
+    {
+        Mixer* mixer;
+        auto scopedMixerLock = getConferenceMixer(context, requestLogger, conferenceId, mixer);
+        checkCaptureEndpoint(*mixer, conferenceId, endpointId, start);
+        mixer->setPacketCapture(endpointId, packetCapture);
+    }
+    catch (httpd::RequestErrorException&)
+    {
+        if (packetCapture)
+        {
+            packetCapture->discard();
+        }
+        throw;
+    }
+
+    auto responseBody = nlohmann::json::object();
+    if (packetCapture)
+    {
+        responseBody["file"] = packetCapture->getFileName();
+        logger::info("Started packet capture of endpoint %s to %s",
+            "ApiRequestHandler",
+            endpointId.c_str(),
+            packetCapture->getFileName().c_str());
+    }
+
+    auto response = httpd::Response(httpd::StatusCode::OK, responseBody.dump());
+    response.headers["Content-type"] = "text/json";
+    requestLogger.setResponse(response);
+    return response;
+}
+
+} // namespace bridge
@@ -1,6 +1,7 @@
 #include "ApiActions.h"
 #include "api/Generator.h"
 #include "api/Parser.h"
+#include "api/StreamParser.h"
 #include "bridge/AudioStreamDescription.h"
 #include "bridge/DataStreamDescription.h"
 #include "bridge/Mixer.h"
@@ -26,8 +27,7 @@ const uint32_t GUUID_LENGTH = 36;
 namespace
 {
 
-httpd::Response generateAllocateEndpointResponse(ActionContext* context,
-    RequestLogger& requestLogger,
+api::EndpointDescription describeAllocatedEndpoint(ActionContext* context,
     const api::AllocateEndpoint& allocateChannel,
     const Mixer& mixer,
     const std::string& conferenceId,
@@ -59,6 +59,7 @@ httpd::Response generateAllocateEndpointResponse(ActionContext* context,
         api::Ice responseIce;
         responseIce.ufrag = transportDescriptionIce.iceCredentials.first;
         responseIce.pwd = transportDescriptionIce.iceCredentials.second;
+        responseIce.lite = transportDescriptionIce.iceLite;
         for (const auto& iceCandidate : transportDescriptionIce.iceCandidates)
         {
             if (iceCandidate.type != ice::IceCandidate::Type::PRFLX)
@@ -113,6 +114,7 @@ httpd::Response generateAllocateEndpointResponse(ActionContext* context,
                 const auto& transportDescriptionIce = transportDescription.ice.get();
                 responseIce.ufrag = transportDescriptionIce.iceCredentials.first;
                 responseIce.pwd = transportDescriptionIce.iceCredentials.second;
+                responseIce.lite = transportDescriptionIce.iceLite;
                 for (const auto& iceCandidate : transportDescriptionIce.iceCandidates)
                 {
                     if (iceCandidate.type != ice::IceCandidate::Type::PRFLX)
@@ -152,7 +154,7 @@ httpd::Response generateAllocateEndpointResponse(ActionContext* context,
             responseAudio.transport.set(responseTransport);
         }
 
-        addDefaultAudioProperties(responseAudio, true);
+        addDefaultAudioProperties(responseAudio, true, context->config.bwe.transportCc);
         channelsDescription.audio.set(responseAudio);
     }
 
@@ -206,6 +208,7 @@ httpd::Response generateAllocateEndpointResponse(ActionContext* context,
                 const auto& transportDescriptionIce = transportDescription.ice.get();
                 responseIce.ufrag = transportDescriptionIce.iceCredentials.first;
                 responseIce.pwd = transportDescriptionIce.iceCredentials.second;
+                responseIce.lite = transportDescriptionIce.iceLite;
                 for (const auto& iceCandidate : transportDescriptionIce.iceCandidates)
                 {
                     if (iceCandidate.type != ice::IceCandidate::Type::PRFLX)
@@ -256,7 +259,7 @@ httpd::Response generateAllocateEndpointResponse(ActionContext* context,
             addVp8VideoProperties(responseVideo);
         }
 
-        addDefaultVideoProperties(responseVideo);
+        addDefaultVideoProperties(responseVideo, context->config.bwe.transportCc);
         channelsDescription.video.set(responseVideo);
     }
 
@@ -275,29 +278,47 @@ httpd::Response generateAllocateEndpointResponse(ActionContext* context,
         channelsDescription.data.set(responseData);
     }
 
-    const auto responseBody = api::Generator::generateAllocateEndpointResponse(channelsDescription);
-    auto response = httpd::Response(httpd::StatusCode::OK, responseBody.dump());
-    response.headers["Content-type"] = "text/json";
-    logger::debug("POST response %s", "RequestHandler", response.body.c_str());
-    requestLogger.setResponse(response);
-    return response;
+    return channelsDescription;
 }
 
-httpd::Response allocateEndpoint(ActionContext* context,
+httpd::Response generateAllocateEndpointResponse(ActionContext* context,
     RequestLogger& requestLogger,
     const api::AllocateEndpoint& allocateChannel,
+    const Mixer& mixer,
     const std::string& conferenceId,
     const std::string& endpointId)
 {
-    Mixer* mixer;
+    const auto channelsDescription =
+        describeAllocatedEndpoint(context, allocateChannel, mixer, conferenceId, endpointId);
+    auto response =
+        httpd::Response(httpd::StatusCode::OK, api::Generator::writeAllocateEndpointResponse(channelsDescription));
+    response.headers["Content-type"] = "text/json";
+    logger::debug("POST response %s", "RequestHandler", response.body.c_str());
+    requestLogger.setResponse(response);
+    return response;
+}
+
+struct AllocatedChannelIds
+{
+    utils::Optional<std::string> audio;
+    utils::Optional<std::string> video;
+    utils::Optional<std::string> data;
+};
+
+void validateEndpointId(const std::string& endpointId)
+{
     if (endpointId.size() > GUUID_LENGTH)
     {
         throw httpd::RequestErrorException(httpd::StatusCode::BAD_REQUEST,
             "Endpoint id must be less in length than a GUUID excluding curly braces");
     }
+}
 
-    auto scopedMixerLock = getConferenceMixer(context, conferenceId, mixer);
-
+// Creates transports and streams for the endpoint. Candidate gathering is started but not awaited.
+AllocatedChannelIds addEndpointStreams(Mixer& mixer,
+    const api::AllocateEndpoint& allocateChannel,
+    const std::string& endpointId)
+{
     utils::Optional<std::string> audioChannelId;
     utils::Optional<std::string> videoChannelId;
     utils::Optional<std::string> dataChannelId;
@@ -316,14 +337,14 @@ httpd::Response allocateEndpoint(ActionContext* context,
 
         const bool hasVideoEnabled = allocateChannel.video.isSet();
 
-        mixer->addBundleTransportIfNeeded(endpointId, iceRole, hasVideoEnabled);
+        mixer.addBundleTransportIfNeeded(endpointId, iceRole, hasVideoEnabled);
 
         if (allocateChannel.audio.isSet())
         {
             const auto& audio = allocateChannel.audio.get();
 
             std::string outChannelId;
-            if (!mixer->addBundledAudioStream(outChannelId,
+            if (!mixer.addBundledAudioStream(outChannelId,
                     endpointId,
                     audio.getMediaMode(),
                     allocateChannel.idleTimeoutSeconds))
@@ -341,11 +362,11 @@ httpd::Response allocateEndpoint(ActionContext* context,
             const auto ssrcRewrite = video.relayType.compare("ssrc-rewrite") == 0;
 
             std::string outChannelId;
-            if (mixer->addBundledVideoStream(outChannelId, endpointId, ssrcRewrite, allocateChannel.idleTimeoutSeconds))
+            if (mixer.addBundledVideoStream(outChannelId, endpointId, ssrcRewrite, allocateChannel.idleTimeoutSeconds))
             {
                 videoChannelId.set(outChannelId);
             }
-            else if (mixer->hasVideoEnabled())
+            else if (mixer.hasVideoEnabled())
             {
                 throw httpd::RequestErrorException(httpd::StatusCode::INTERNAL_SERVER_ERROR,
                     "Add bundled video stream has failed");
@@ -355,7 +376,7 @@ httpd::Response allocateEndpoint(ActionContext* context,
         if (allocateChannel.data.isSet())
         {
             std::string outChannelId;
-            if (!mixer->addBundledDataStream(outChannelId, endpointId, allocateChannel.idleTimeoutSeconds))
+            if (!mixer.addBundledDataStream(outChannelId, endpointId, allocateChannel.idleTimeoutSeconds))
             {
                 throw httpd::RequestErrorException(httpd::StatusCode::INTERNAL_SERVER_ERROR,
                     "Add bundled data channel has failed");
@@ -384,7 +405,7 @@ httpd::Response allocateEndpoint(ActionContext* context,
             }
 
             std::string outChannelId;
-            if (!mixer->addAudioStream(outChannelId,
+            if (!mixer.addAudioStream(outChannelId,
                     endpointId,
                     iceRole,
                     audio.getMediaMode(),
@@ -417,7 +438,7 @@ httpd::Response allocateEndpoint(ActionContext* context,
             std::string outChannelId;
             const auto ssrcRewrite = video.relayType.compare("ssrc-rewrite") == 0;
 
-            if (mixer->addVideoStream(outChannelId,
+            if (mixer.addVideoStream(outChannelId,
                     endpointId,
                     iceRole,
                     ssrcRewrite,
@@ -425,7 +446,7 @@ httpd::Response allocateEndpoint(ActionContext* context,
             {
                 videoChannelId.set(outChannelId);
             }
-            else if (mixer->hasVideoEnabled())
+            else if (mixer.hasVideoEnabled())
             {
                 throw httpd::RequestErrorException(httpd::StatusCode::INTERNAL_SERVER_ERROR,
                     "Adding video stream has failed");
@@ -439,6 +460,50 @@ httpd::Response allocateEndpoint(ActionContext* context,
         }
     }
 
+    return AllocatedChannelIds{audioChannelId, videoChannelId, dataChannelId};
+}
+
+bool isEndpointGatheringComplete(Mixer& mixer,
+    const api::AllocateEndpoint& allocateChannel,
+    const std::string& endpointId)
+{
+    return (!allocateChannel.audio.isSet() || mixer.isAudioStreamGatheringComplete(endpointId)) &&
+        (!allocateChannel.video.isSet() || !mixer.hasVideoEnabled() ||
+            mixer.isVideoStreamGatheringComplete(endpointId)) &&
+        (!allocateChannel.data.isSet() || mixer.isDataStreamGatheringComplete(endpointId));
+}
+
+void removeEndpointStreams(Mixer& mixer, const AllocatedChannelIds& channelIds)
+{
+    if (channelIds.audio.isSet())
+    {
+        mixer.removeAudioStream(channelIds.audio.get());
+    }
+
+    if (channelIds.video.isSet())
+    {
+        mixer.removeVideoStream(channelIds.video.get());
+    }
+
+    if (channelIds.data.isSet())
+    {
+        mixer.removeDataStream(channelIds.data.get());
+    }
+}
+
+httpd::Response allocateEndpoint(ActionContext* context,
+    RequestLogger& requestLogger,
+    const api::AllocateEndpoint& allocateChannel,
+    const std::string& conferenceId,
+    const std::string& endpointId)
+{
+    Mixer* mixer;
+    validateEndpointId(endpointId);
+
+    auto scopedMixerLock = getConferenceMixer(context, requestLogger, conferenceId, mixer);
+
+    const auto channelIds = addEndpointStreams(*mixer, allocateChannel, endpointId);
+
     uint32_t totalSleepTimeMs = 0;
 
     if (allocateChannel.audio.isSet())
@@ -475,21 +540,7 @@ httpd::Response allocateEndpoint(ActionContext* context,
             endpointId.c_str(),
             conferenceId.c_str());
 
-        if (audioChannelId.isSet())
-        {
-            mixer->removeAudioStream(audioChannelId.get());
-        }
-
-        if (videoChannelId.isSet())
-        {
-            mixer->removeVideoStream(videoChannelId.get());
-        }
-
-        if (dataChannelId.isSet())
-        {
-            mixer->removeDataStream(dataChannelId.get());
-        }
-
+        removeEndpointStreams(*mixer, channelIds);
         throw httpd::RequestErrorException(httpd::StatusCode::INTERNAL_SERVER_ERROR, "Candidates gathering timeout");
     }
 
@@ -780,28 +831,23 @@ void configureDataEndpoint(const api::EndpointDescription& endpointDescription,
     }
 }
 
-httpd::Response configureEndpoint(ActionContext* context,
-    RequestLogger& requestLogger,
-    const api::EndpointDescription& endpointDescription,
-    const std::string& conferenceId,
+void configureEndpointStreams(const api::EndpointDescription& endpointDescription,
+    Mixer& mixer,
     const std::string& endpointId)
 {
-    Mixer* mixer;
-    auto scopedMixerLock = getConferenceMixer(context, conferenceId, mixer);
-
     if (endpointDescription.audio.isSet())
     {
-        configureAudioEndpoint(endpointDescription, *mixer, endpointId);
+        configureAudioEndpoint(endpointDescription, mixer, endpointId);
     }
 
     if (endpointDescription.video.isSet())
     {
-        configureVideoEndpoint(endpointDescription, *mixer, endpointId);
+        configureVideoEndpoint(endpointDescription, mixer, endpointId);
     }
 
     if (endpointDescription.data.isSet())
     {
-        configureDataEndpoint(endpointDescription, *mixer, endpointId);
+        configureDataEndpoint(endpointDescription, mixer, endpointId);
     }
 
     if (endpointDescription.bundleTransport.isSet())
@@ -811,7 +857,7 @@ httpd::Response configureEndpoint(ActionContext* context,
         if (transport.ice.isSet())
         {
             const auto candidatesAndCredentials = getIceCandidatesAndCredentials(transport);
-            if (!mixer->configureBundleTransportIce(endpointId,
+            if (!mixer.configureBundleTransportIce(endpointId,
                     candidatesAndCredentials.second,
                     candidatesAndCredentials.first))
             {
@@ -825,7 +871,7 @@ httpd::Response configureEndpoint(ActionContext* context,
             const auto& dtls = transport.dtls.get();
             const bool isRemoteSideDtlsClient = dtls.isClient();
 
-            if (!mixer->configureBundleTransportDtls(endpointId, dtls.type, dtls.hash, !isRemoteSideDtlsClient))
+            if (!mixer.configureBundleTransportDtls(endpointId, dtls.type, dtls.hash, !isRemoteSideDtlsClient))
             {
                 throw httpd::RequestErrorException(httpd::StatusCode::INTERNAL_SERVER_ERROR,
                     "Bundled transport DTLS configuration has failed");
@@ -833,23 +879,35 @@ httpd::Response configureEndpoint(ActionContext* context,
         }
         else if (!transport.sdesKeys.empty())
         {
-            mixer->configureBundleTransportSdes(endpointId, transport.sdesKeys[0]);
+            mixer.configureBundleTransportSdes(endpointId, transport.sdesKeys[0]);
         }
         else
         {
-            if (!mixer->getConfig().enableSrtpNullCipher)
+            if (!mixer.getConfig().enableSrtpNullCipher)
             {
                 throw httpd::RequestErrorException(httpd::StatusCode::BAD_REQUEST, "Null cipher not allowed");
             }
-            mixer->configureBundleTransportSdes(endpointId, srtp::AesKey());
+            mixer.configureBundleTransportSdes(endpointId, srtp::AesKey());
         }
 
-        if (!mixer->startBundleTransport(endpointId))
+        if (!mixer.startBundleTransport(endpointId))
         {
             throw httpd::RequestErrorException(httpd::StatusCode::INTERNAL_SERVER_ERROR,
                 "Start bundled transport has failed");
         }
     }
+}
+
+httpd::Response configureEndpoint(ActionContext* context,
+    RequestLogger& requestLogger,
+    const api::EndpointDescription& endpointDescription,
+    const std::string& conferenceId,
+    const std::string& endpointId)
+{
+    Mixer* mixer;
+    auto scopedMixerLock = getConferenceMixer(context, requestLogger, conferenceId, mixer);
+
+    configureEndpointStreams(endpointDescription, *mixer, endpointId);
 
     const auto responseBody = nlohmann::json::object();
     auto response = httpd::Response(httpd::StatusCode::OK, responseBody.dump());
@@ -858,32 +916,27 @@ httpd::Response configureEndpoint(ActionContext* context,
     return response;
 }
 
-httpd::Response reconfigureEndpoint(ActionContext* context,
-    RequestLogger& requestLogger,
-    const api::EndpointDescription& endpointDescription,
-    const std::string& conferenceId,
+void reconfigureEndpointStreams(const api::EndpointDescription& endpointDescription,
+    Mixer& mixer,
     const std::string& endpointId)
 {
-    Mixer* mixer;
-    auto scopedMixerLock = getConferenceMixer(context, conferenceId, mixer);
-
     const bool isAudioSet = endpointDescription.audio.isSet();
     const bool isVideoSet = endpointDescription.video.isSet();
     const bool isNeighboursSet = endpointDescription.neighbours.isSet();
 
-    if (isAudioSet && !mixer->isAudioStreamConfigured(endpointId))
+    if (isAudioSet && !mixer.isAudioStreamConfigured(endpointId))
     {
         throw httpd::RequestErrorException(httpd::StatusCode::BAD_REQUEST,
             "Can't reconfigure audio because it was not configured in first place");
     }
 
-    if (isNeighboursSet && !mixer->isAudioStreamConfigured(endpointId))
+    if (isNeighboursSet && !mixer.isAudioStreamConfigured(endpointId))
     {
         throw httpd::RequestErrorException(httpd::StatusCode::BAD_REQUEST,
             "Can't reconfigure neighbours because audio stream was not configured in first place");
     }
 
-    if (isVideoSet && !mixer->isVideoStreamConfigured(endpointId))
+    if (isVideoSet && !mixer.isVideoStreamConfigured(endpointId))
     {
         throw httpd::RequestErrorException(httpd::StatusCode::BAD_REQUEST,
             "Can't reconfigure video because it was not configured in first place");
@@ -898,7 +951,7 @@ httpd::Response reconfigureEndpoint(ActionContext* context,
             remoteSsrc.set(audio.ssrcs.front());
         }
 
-        if (!mixer->reconfigureAudioStream(endpointId, remoteSsrc))
+        if (!mixer.reconfigureAudioStream(endpointId, remoteSsrc))
         {
             throw httpd::RequestErrorException(httpd::StatusCode::INTERNAL_SERVER_ERROR,
                 "Fail to reconfigure audio stream");
@@ -908,7 +961,7 @@ httpd::Response reconfigureEndpoint(ActionContext* context,
     if (isNeighboursSet)
     {
         auto neighbours = convertGroupIds(endpointDescription.neighbours.get());
-        if (!mixer->reconfigureAudioStreamNeighbours(endpointId, neighbours))
+        if (!mixer.reconfigureAudioStreamNeighbours(endpointId, neighbours))
         {
             throw httpd::RequestErrorException(httpd::StatusCode::INTERNAL_SERVER_ERROR,
                 "Fail to reconfigure audio stream's neighbours setting");
@@ -938,12 +991,24 @@ httpd::Response reconfigureEndpoint(ActionContext* context,
         }
 
         const auto ssrcWhitelist = makeWhitelistedSsrcsArray(video);
-        if (!mixer->reconfigureVideoStream(endpointId, simulcastStreams[0], secondarySimulcastStream, ssrcWhitelist))
+        if (!mixer.reconfigureVideoStream(endpointId, simulcastStreams[0], secondarySimulcastStream, ssrcWhitelist))
         {
             throw httpd::RequestErrorException(httpd::StatusCode::INTERNAL_SERVER_ERROR,
                 "Fail to reconfigure video stream");
         }
     }
+}
+
+httpd::Response reconfigureEndpoint(ActionContext* context,
+    RequestLogger& requestLogger,
+    const api::EndpointDescription& endpointDescription,
+    const std::string& conferenceId,
+    const std::string& endpointId)
+{
+    Mixer* mixer;
+    auto scopedMixerLock = getConferenceMixer(context, requestLogger, conferenceId, mixer);
+
+    reconfigureEndpointStreams(endpointDescription, *mixer, endpointId);
 
     const auto responseBody = nlohmann::json::object();
     auto response = httpd::Response(httpd::StatusCode::OK, responseBody.dump());
@@ -958,7 +1023,7 @@ httpd::Response recordEndpoint(ActionContext* context,
     const std::string& conferenceId)
 {
     Mixer* mixer;
-    auto scopedMixerLock = getConferenceMixer(context, conferenceId, mixer);
+    auto scopedMixerLock = getConferenceMixer(context, requestLogger, conferenceId, mixer);
 
     const bool isRecordingStart =
         recording.isAudioEnabled || recording.isVideoEnabled || recording.isScreenshareEnabled;
@@ -1002,17 +1067,22 @@ httpd::Response recordEndpoint(ActionContext* context,
     return response;
 }
 
+void removeEndpoint(Mixer& mixer, const std::string& endpointId)
+{
+    mixer.removeAudioStream(endpointId);
+    mixer.removeVideoStream(endpointId);
+    mixer.removeDataStream(endpointId);
+}
+
 httpd::Response expireEndpoint(ActionContext* context,
     RequestLogger& requestLogger,
     const std::string& conferenceId,
     const std::string& endpointId)
 {
     Mixer* mixer;
-    auto scopedMixerLock = getConferenceMixer(context, conferenceId, mixer);
+    auto scopedMixerLock = getConferenceMixer(context, requestLogger, conferenceId, mixer);
 
-    mixer->removeAudioStream(endpointId);
-    mixer->removeVideoStream(endpointId);
-    mixer->removeDataStream(endpointId);
+    removeEndpoint(*mixer, endpointId);
 
     const auto responseBody = nlohmann::json::object();
     auto response = httpd::Response(httpd::StatusCode::OK, responseBody.dump());
@@ -1021,20 +1091,16 @@ httpd::Response expireEndpoint(ActionContext* context,
     return response;
 }
 
-httpd::Response processEndpointPutRequest(ActionContext* context,
+namespace
+{
+// Requests not handled by api::StreamParser
+httpd::Response processEndpointJsonRequest(ActionContext* context,
     RequestLogger& requestLogger,
-    const httpd::Request& request,
+    const nlohmann::json& requestBodyJson,
+    const std::string& action,
     const std::string& conferenceId,
     const std::string& endpointId)
 {
-    const auto requestBodyJson = nlohmann::json::parse(request.body.getSpan());
-    const auto actionJsonItr = requestBodyJson.find("action");
-    if (actionJsonItr == requestBodyJson.end())
-    {
-        throw httpd::RequestErrorException(httpd::StatusCode::BAD_REQUEST, "Missing required json property: action");
-    }
-    const auto& action = actionJsonItr->get<std::string>();
-
     if (action.compare("configure") == 0)
     {
         const auto endpointDescription = api::Parser::parsePatchEndpoint(requestBodyJson, endpointId);
@@ -1055,19 +1121,69 @@ httpd::Response processEndpointPutRequest(ActionContext* context,
         utils::format("Action '%s' is not supported", action.c_str()));
 }
 
-httpd::Response processEndpointPostRequest(ActionContext* context,
+// configure and reconfigure parsed by api::StreamParser
+httpd::Response patchEndpoint(ActionContext* context,
     RequestLogger& requestLogger,
-    const httpd::Request& request,
+    const std::string& action,
+    const api::EndpointDescription& endpointDescription,
     const std::string& conferenceId,
     const std::string& endpointId)
 {
-    const auto requestBodyJson = nlohmann::json::parse(request.body.getSpan());
+    if (action.compare("configure") == 0)
+    {
+        return configureEndpoint(context, requestLogger, endpointDescription, conferenceId, endpointId);
+    }
+    return reconfigureEndpoint(context, requestLogger, endpointDescription, conferenceId, endpointId);
+}
+
+const std::string& getAction(const nlohmann::json& requestBodyJson)
+{
     const auto actionJsonItr = requestBodyJson.find("action");
     if (actionJsonItr == requestBodyJson.end())
     {
         throw httpd::RequestErrorException(httpd::StatusCode::BAD_REQUEST, "Missing required json property: action");
     }
-    const auto& action = actionJsonItr->get<std::string>();
+    return actionJsonItr->get_ref<const std::string&>();
+}
+} // namespace
+
+httpd::Response processEndpointPutRequest(ActionContext* context,
+    RequestLogger& requestLogger,
+    const httpd::Request& request,
+    const std::string& conferenceId,
+    const std::string& endpointId)
+{
+    std::string action;
+    api::EndpointDescription endpointDescription;
+    if (api::StreamParser::parsePatchEndpoint(request.body.getSpan(), endpointId, action, endpointDescription))
+    {
+        return patchEndpoint(context, requestLogger, action, endpointDescription, conferenceId, endpointId);
+    }
+
+    const auto requestBodyJson = nlohmann::json::parse(request.body.getSpan());
+    return processEndpointJsonRequest(context,
+        requestLogger,
+        requestBodyJson,
+        getAction(requestBodyJson),
+        conferenceId,
+        endpointId);
+}
+
+httpd::Response processEndpointPostRequest(ActionContext* context,
+    RequestLogger& requestLogger,
+    const httpd::Request& request,
+    const std::string& conferenceId,
+    const std::string& endpointId)
+{
+    std::string action;
+    api::EndpointDescription endpointDescription;
+    if (api::StreamParser::parsePatchEndpoint(request.body.getSpan(), endpointId, action, endpointDescription))
+    {
+        return patchEndpoint(context, requestLogger, action, endpointDescription, conferenceId, endpointId);
+    }
+
+    const auto requestBodyJson = nlohmann::json::parse(request.body.getSpan());
+    action = getAction(requestBodyJson);
 
     if (action.compare("allocate") == 0)
     {
@@ -1078,10 +1194,171 @@ httpd::Response processEndpointPostRequest(ActionContext* context,
     {
         return expireEndpoint(context, requestLogger, conferenceId, endpointId);
     }
+    else if (action.compare("start-capture") == 0 || action.compare("stop-capture") == 0)
+    {
+        return processEndpointCaptureRequest(context, requestLogger, request, conferenceId, endpointId);
+    }
+    else
+    {
+        return processEndpointJsonRequest(context, requestLogger, requestBodyJson, action, conferenceId, endpointId);
+    }
+}
+
+namespace
+{
+struct BatchEndpointResult
+{
+    std::string endpointId;
+    std::string action;
+    api::AllocateEndpoint allocation;
+    AllocatedChannelIds channelIds;
+    bool isGathering = false;
+    httpd::StatusCode statusCode = httpd::StatusCode::OK;
+    nlohmann::json body = nlohmann::json::object();
+};
+
+void setBatchEndpointError(BatchEndpointResult& result, httpd::StatusCode statusCode, const std::string& message)
+{
+    result.statusCode = statusCode;
+    result.body = nlohmann::json::object();
+    result.body["message"] = message;
+}
+
+void applyBatchEndpointAction(Mixer& mixer, const nlohmann::json& endpointJson, BatchEndpointResult& result)
+{
+    if (result.endpointId.empty())
+    {
+        throw httpd::RequestErrorException(httpd::StatusCode::BAD_REQUEST, "Missing required json property: id");
+    }
+
+    if (result.action.compare("allocate") == 0)
+    {
+        validateEndpointId(result.endpointId);
+        result.allocation = api::Parser::parseAllocateEndpoint(endpointJson);
+        result.channelIds = addEndpointStreams(mixer, result.allocation, result.endpointId);
+        result.isGathering = true;
+    }
+    else if (result.action.compare("configure") == 0)
+    {
+        const auto endpointDescription = api::Parser::parsePatchEndpoint(endpointJson, result.endpointId);
+        configureEndpointStreams(endpointDescription, mixer, result.endpointId);
+    }
+    else if (result.action.compare("reconfigure") == 0)
+    {
+        const auto endpointDescription = api::Parser::parsePatchEndpoint(endpointJson, result.endpointId);
+        reconfigureEndpointStreams(endpointDescription, mixer, result.endpointId);
+    }
+    else if (result.action.compare("expire") == 0)
+    {
+        removeEndpoint(mixer, result.endpointId);
+    }
     else
     {
-        return processEndpointPutRequest(context, requestLogger, request, conferenceId, endpointId);
+        throw httpd::RequestErrorException(httpd::StatusCode::BAD_REQUEST,
+            utils::format("Action '%s' is not supported", result.action.c_str()));
+    }
+}
+} // namespace
+
+// Allocates, configures or expires many endpoints of one conference under a single conference lock. Transports of
+// all allocated endpoints are created first so that their candidate gathering runs concurrently. A failing endpoint
+// does not fail the others, each gets its own status in the response.
+httpd::Response processEndpointBatchRequest(ActionContext* context,
+    RequestLogger& requestLogger,
+    const httpd::Request& request,
+    const std::string& conferenceId)
+{
+    const auto requestBodyJson = nlohmann::json::parse(request.body.getSpan());
+    const auto endpointsJsonItr = requestBodyJson.find("endpoints");
+    if (endpointsJsonItr == requestBodyJson.end() || !endpointsJsonItr->is_array())
+    {
+        throw httpd::RequestErrorException(httpd::StatusCode::BAD_REQUEST,
+            "Missing required json property: endpoints");
+    }
+
+    const auto& endpointsJson = *endpointsJsonItr;
+    std::vector<BatchEndpointResult> results(endpointsJson.size());
+
+    Mixer* mixer;
+    auto scopedMixerLock = getConferenceMixer(context, requestLogger, conferenceId, mixer);
+
+    for (size_t i = 0; i < endpointsJson.size(); ++i)
+    {
+        const auto& endpointJson = endpointsJson[i];
+        auto& result = results[i];
+        try
+        {
+            result.endpointId = endpointJson.value("id", std::string());
+            result.action = endpointJson.value("action", std::string());
+            applyBatchEndpointAction(*mixer, endpointJson, result);
+        }
+        catch (httpd::RequestErrorException& e)
+        {
+            setBatchEndpointError(result, e.getStatusCode(), e.getMessage());
+        }
+        catch (nlohmann::detail::exception& e)
+        {
+            setBatchEndpointError(result, httpd::StatusCode::BAD_REQUEST, e.what());
+        }
+    }
+
+    uint32_t totalSleepTimeMs = 0;
+    for (const auto& result : results)
+    {
+        while (result.isGathering && !isEndpointGatheringComplete(*mixer, result.allocation, result.endpointId) &&
+            totalSleepTimeMs < gatheringCompleteMaxWaitMs)
+        {
+            totalSleepTimeMs += gatheringCompleteWaitMs;
+            usleep(gatheringCompleteWaitMs * 1000);
+        }
+    }
+
+    for (auto& result : results)
+    {
+        if (!result.isGathering)
+        {
+            continue;
+        }
+
+        if (!isEndpointGatheringComplete(*mixer, result.allocation, result.endpointId))
+        {
+            logger::error("Allocate endpoint id %s, mixer %s, gathering did not complete in time",
+                "RequestHandler",
+                result.endpointId.c_str(),
+                conferenceId.c_str());
+
+            removeEndpointStreams(*mixer, result.channelIds);
+            setBatchEndpointError(result, httpd::StatusCode::INTERNAL_SERVER_ERROR, "Candidates gathering timeout");
+            continue;
+        }
+
+        try
+        {
+            const auto channelsDescription =
+                describeAllocatedEndpoint(context, result.allocation, *mixer, conferenceId, result.endpointId);
+            result.body = api::Generator::generateAllocateEndpointResponse(channelsDescription);
+        }
+        catch (httpd::RequestErrorException& e)
+        {
+            removeEndpointStreams(*mixer, result.channelIds);
+            setBatchEndpointError(result, e.getStatusCode(), e.getMessage());
+        }
+    }
+
+    nlohmann::json responseBodyJson = nlohmann::json::object();
+    auto& responseEndpoints = responseBodyJson["endpoints"] = nlohmann::json::array();
+    for (const auto& result : results)
+    {
+        nlohmann::json endpointJson = {{"id", result.endpointId},
+            {"status", static_cast<uint32_t>(result.statusCode)},
+            {"body", result.body}};
+        responseEndpoints.push_back(endpointJson);
     }
+
+    auto response = httpd::Response(httpd::StatusCode::OK, responseBodyJson.dump());
+    response.headers["Content-type"] = "text/json";
+    requestLogger.setResponse(response);
+    return response;
 }
 
 } // namespace bridge
@@ -13,7 +13,7 @@ httpd::Response getConferenceInfo(ActionContext* context,
     const std::string& conferenceId)
 {
     bridge::Mixer* mixer;
-    auto scopedMixerLock = getConferenceMixer(context, conferenceId, mixer);
+    auto scopedMixerLock = getConferenceMixer(context, requestLogger, conferenceId, mixer);
     nlohmann::json responseBodyJson = nlohmann::json::array();
 
     const auto activeTalkers = mixer->getActiveTalkers();
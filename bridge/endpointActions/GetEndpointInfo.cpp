@@ -16,7 +16,7 @@ httpd::Response getEndpointInfo(ActionContext* context,
     const std::string& endpointId)
 {
     bridge::Mixer* mixer;
-    auto scopedMixerLock = getConferenceMixer(context, conferenceId, mixer);
+    auto scopedMixerLock = getConferenceMixer(context, requestLogger, conferenceId, mixer);
 
     const auto activeTalkers = mixer->getActiveTalkers();
 
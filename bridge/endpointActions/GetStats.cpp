@@ -14,6 +14,21 @@ httpd::Response handleStats(ActionContext* context, RequestLogger&, const httpd:
     return response;
 }
 
+httpd::Response handleMetrics(ActionContext* context, RequestLogger&, const httpd::Request& request)
+{
+    httpd::Response response(httpd::StatusCode::OK, context->mixerManager.getMetrics());
+    response.headers["Content-type"] = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+    return response;
+}
+
+httpd::Response handleFlowStats(ActionContext* context, RequestLogger&, const httpd::Request& request)
+{
+    const auto statsDescription = context->mixerManager.getSharedUdpFlowStats().describe();
+    httpd::Response response(httpd::StatusCode::OK, statsDescription);
+    response.headers["Content-type"] = "text/json";
+    return response;
+}
+
 httpd::Response handleBarbellStats(ActionContext* context, RequestLogger&, const httpd::Request& request)
 {
     auto barbellStats = context->mixerManager.getBarbellStats();
@@ -24,12 +39,12 @@ httpd::Response handleBarbellStats(ActionContext* context, RequestLogger&, const
 }
 
 httpd::Response handleBarbellStats(ActionContext* context,
-    RequestLogger&,
+    RequestLogger& requestLogger,
     const httpd::Request& request,
     const std::string& confId)
 {
     Mixer* mixer;
-    auto scopedMixerLock = getConferenceMixer(context, confId, mixer);
+    auto scopedMixerLock = getConferenceMixer(context, requestLogger, confId, mixer);
 
     Stats::AggregatedBarbellStats barbellStats;
     barbellStats._stats.emplace(confId, mixer->gatherBarbellStats(utils::Time::getAbsoluteTime()));
@@ -11,6 +11,11 @@
 #include "transport/RtcTransport.h"
 #include "utils/CheckedCast.h"
 
+namespace
+{
+const uint32_t levelDecoderSampleRate = 8000;
+}
+
 namespace bridge
 {
 
@@ -20,42 +25,20 @@ AudioForwarderReceiveJob::AudioForwarderReceiveJob(memory::UniquePacket packet,
     bridge::SsrcInboundContext& ssrcContext,
     ActiveMediaList& activeMediaList,
     const uint8_t silenceThresholdLevel,
+    const uint32_t levelDecodeInterval,
     const bool hasMixedAudioStreams,
     const bool needAudioLevel,
     const uint32_t extendedSequenceNumber)
     : RtpForwarderReceiveBaseJob(std::move(packet), sender, engineMixer, ssrcContext, extendedSequenceNumber),
       _activeMediaList(activeMediaList),
       _silenceThresholdLevel(silenceThresholdLevel),
+      _levelDecodeInterval(std::max(1u, levelDecodeInterval)),
       _hasMixedAudioStreams(hasMixedAudioStreams),
       _needAudioLevel(needAudioLevel)
 {
 }
 
-void AudioForwarderReceiveJob::decode(const memory::Packet& opusPacket, memory::AudioPacket& pcmPacket)
-{
-    const auto framesInPacketBuffer =
-        memory::AudioPacket::size / codec::Opus::channelsPerFrame / codec::Opus::bytesPerSample;
-
-    codec::OpusDecoder& decoder = *_ssrcContext.opusDecoder;
-    auto pcmHeader = rtp::RtpHeader::fromPacket(pcmPacket);
-    const auto opusHeader = rtp::RtpHeader::fromPacket(opusPacket);
-    const auto decodedFrames = decoder.decode(_extendedSequenceNumber,
-        opusHeader->getPayload(),
-        opusPacket.getLength() - opusHeader->headerLength(),
-        pcmHeader->getPayload(),
-        framesInPacketBuffer);
-
-    if (decodedFrames > 0)
-    {
-        const auto decodedPayloadLength = decodedFrames * codec::Opus::channelsPerFrame * codec::Opus::bytesPerSample;
-        pcmPacket.setLength(pcmHeader->headerLength() + decodedPayloadLength);
-    }
-    else
-    {
-        pcmPacket.setLength(0);
-    }
-}
-
+// The level only decoder runs at narrowband mono. Levels of skipped packets repeat the last decoded level.
 int AudioForwarderReceiveJob::computeOpusAudioLevel(const memory::Packet& opusPacket)
 {
     if (!_ssrcContext.opusDecoder)
@@ -65,22 +48,29 @@ int AudioForwarderReceiveJob::computeOpusAudioLevel(const memory::Packet& opusPa
             _ssrcContext.ssrc,
             _engineMixer.getLoggableId().c_str(),
             _sender->getLoggableId().c_str());
-        _ssrcContext.opusDecoder.reset(new codec::OpusDecoder());
+        _ssrcContext.opusDecoder.reset(new codec::OpusDecoder(levelDecoderSampleRate, 1));
         _ssrcContext.opusPacketRate.reset(new utils::AvgRateTracker(0.1));
+        _ssrcContext.audioLevelPacketCount = 0;
+    }
+
+    if (_ssrcContext.audioLevelPacketCount++ % _levelDecodeInterval != 0 && _ssrcContext.calculatedAudioLevel >= 0)
+    {
+        return _ssrcContext.calculatedAudioLevel;
     }
 
     const auto rtpHeader = rtp::RtpHeader::fromPacket(opusPacket);
-    memory::AudioPacket pcmPacket;
-    pcmPacket.append(_packet->get(), rtpHeader->headerLength());
-    decode(opusPacket, pcmPacket);
-    if (pcmPacket.getLength() == 0)
+    _ssrcContext.calculatedAudioLevel = codec::computeAudioLevel(*_ssrcContext.opusDecoder,
+        _extendedSequenceNumber,
+        rtpHeader->getPayload(),
+        opusPacket.getLength() - rtpHeader->headerLength());
+    if (_ssrcContext.calculatedAudioLevel < 0)
     {
         logger::warn("opus decode failed for ssrc %u", "AudioForwarderReceiveJob", _ssrcContext.ssrc);
         return -1;
     }
 
-    _ssrcContext.opusPacketRate->update(1, utils::Time::getAbsoluteTime());
-    return codec::computeAudioLevel(pcmPacket);
+    _ssrcContext.opusPacketRate->update(1, utils::Time::getApproximateTime());
+    return _ssrcContext.calculatedAudioLevel;
 }
 
 void AudioForwarderReceiveJob::run()
@@ -138,7 +128,7 @@ void AudioForwarderReceiveJob::run()
                         memory::makeUniquePacket(_engineMixer.getMainAllocator(),
                             _packet->get(),
                             rtpHeader->headerLength()),
-                        utils::Time::getAbsoluteTime());
+                        utils::Time::getApproximateTime());
                 }
                 return;
             }
@@ -149,7 +139,7 @@ void AudioForwarderReceiveJob::run()
     else if (!_ssrcContext.opusDecoder)
     {
         // will touch the atomic only once. Reduces contention
-        if (_ssrcContext.hasAudioLevelExtension.load())
+        if (_ssrcContext.hasAudioLevelExtension.load() && _engineMixer.clearAudioLevelExtension(_ssrcContext))
         {
             logger::info("endpoint %zu does not send audio level RTP header extension. ssrc %u, %s ",
                 "AudioForwarderReceiveJob",
@@ -157,7 +147,6 @@ void AudioForwarderReceiveJob::run()
                 _ssrcContext.ssrc,
                 _sender->getLoggableId().c_str());
         }
-        _ssrcContext.hasAudioLevelExtension = false;
     }
 
     if (!tryUnprotectRtpPacket("AudioForwarderReceiveJob"))
@@ -176,14 +165,16 @@ void AudioForwarderReceiveJob::run()
                     std::make_unique<codec::AudioReceivePipeline>(_ssrcContext.rtpMap.sampleRate,
                         20,
                         100,
-                        _ssrcContext.rtpMap.audioLevelExtId.valueOr(255));
-                _ssrcContext.hasAudioReceivePipe = true;
+                        _ssrcContext.rtpMap.audioLevelExtId.valueOr(255),
+                        _engineMixer.getMixSampleRate(),
+                        _engineMixer.getMixChannels());
+                _engineMixer.setAudioReceivePipeCreated(_ssrcContext);
             }
             if (isSsrcUsed)
             {
                 _ssrcContext.audioReceivePipe->onRtpPacket(_extendedSequenceNumber,
                     memory::makeUniquePacket(_engineMixer.getMainAllocator(), *_packet),
-                    utils::Time::getAbsoluteTime());
+                    utils::Time::getApproximateTime());
             }
             else
             {
@@ -191,7 +182,7 @@ void AudioForwarderReceiveJob::run()
                     memory::makeUniquePacket(_engineMixer.getMainAllocator(),
                         _packet->get(),
                         rtpHeader->headerLength()),
-                    utils::Time::getAbsoluteTime());
+                    utils::Time::getApproximateTime());
             }
         }
 
@@ -28,6 +28,7 @@ public:
         SsrcInboundContext& ssrcContext,
         ActiveMediaList& activeMediaList,
         uint8_t silenceThresholdLevel,
+        uint32_t levelDecodeInterval,
         bool hasMixedAudioStreams,
         bool needAudioLevel,
         uint32_t extendedSequenceNumber);
@@ -35,11 +36,11 @@ public:
     void run() override;
 
 private:
-    void decode(const memory::Packet& opusPacket, memory::AudioPacket& pcmPacket);
     int computeOpusAudioLevel(const memory::Packet& opusPacket);
 
     ActiveMediaList& _activeMediaList;
     const uint8_t _silenceThresholdLevel;
+    const uint32_t _levelDecodeInterval;
     const bool _hasMixedAudioStreams;
     const bool _needAudioLevel;
 };
@@ -44,7 +44,7 @@ void AudioForwarderRewriteAndSendJob::run()
     }
 
     if (!_outboundContext
-             .rewriteAudio(*header, _senderInboundContext, _extendedSequenceNumber, _timestamp, isTelephoneEvent))
+             .rewriteAudio(*_packet, _senderInboundContext, _extendedSequenceNumber, _timestamp, isTelephoneEvent))
     {
         logger::warn("%s dropping packet ssrc %u, seq %u, timestamp %u, last sent seq %u, offset %d",
             "AudioForwarderRewriteAndSendJob",
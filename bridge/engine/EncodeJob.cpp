@@ -12,12 +12,16 @@ namespace bridge
 EncodeJob::EncodeJob(memory::UniqueAudioPacket packet,
     SsrcOutboundContext& outboundContext,
     transport::Transport& transport,
-    const uint64_t rtpTimestamp)
+    const uint64_t rtpTimestamp,
+    const uint32_t sampleRate,
+    const uint32_t channels)
     : jobmanager::CountedJob(transport.getJobCounter()),
       _packet(std::move(packet)),
       _outboundContext(outboundContext),
       _transport(transport),
-      _rtpTimestamp(rtpTimestamp)
+      _rtpTimestamp(rtpTimestamp),
+      _sampleRate(sampleRate),
+      _channels(channels)
 {
     assert(_packet);
     assert(_packet->getLength() > 0);
@@ -40,7 +44,7 @@ void EncodeJob::run()
 
     if (!_outboundContext.opusEncoder)
     {
-        _outboundContext.opusEncoder = std::make_unique<codec::OpusEncoder>();
+        _outboundContext.opusEncoder = std::make_unique<codec::OpusEncoder>(_sampleRate, _channels);
     }
 
     auto opusPacket = memory::makeUniquePacket(_outboundContext.allocator);
@@ -65,6 +69,12 @@ void EncodeJob::run()
         audioLevel.data[0] = codec::computeAudioLevel(*_packet);
         extensionHead.addExtension(cursor, audioLevel);
     }
+    if (_outboundContext.rtpMap.transportCcExtId.isSet())
+    {
+        // sequence number is stamped by transport
+        rtp::GeneralExtension1Byteheader transportSequenceNumber(_outboundContext.rtpMap.transportCcExtId.get(), 2);
+        extensionHead.addExtension(cursor, transportSequenceNumber);
+    }
     if (!extensionHead.empty())
     {
         opusHeader->setExtensions(extensionHead);
@@ -72,7 +82,7 @@ void EncodeJob::run()
     }
 
     const uint32_t payloadLength = _packet->getLength() - pcm16Header->headerLength();
-    const size_t frames = payloadLength / EngineMixer::bytesPerSample / EngineMixer::channelsPerFrame;
+    const size_t frames = payloadLength / EngineMixer::bytesPerSample / _channels;
     const auto* pcm16Data = reinterpret_cast<int16_t*>(pcm16Header->getPayload());
 
     const auto encodedBytes = _outboundContext.opusEncoder->encode(pcm16Data,
@@ -20,7 +20,9 @@ public:
     EncodeJob(memory::UniqueAudioPacket packet,
         SsrcOutboundContext& outboundContext,
         transport::Transport& transport,
-        const uint64_t rtpTimestamp);
+        const uint64_t rtpTimestamp,
+        const uint32_t sampleRate,
+        const uint32_t channels);
 
     void run() override;
 
@@ -29,6 +31,8 @@ private:
     SsrcOutboundContext& _outboundContext;
     transport::Transport& _transport;
     uint64_t _rtpTimestamp;
+    uint32_t _sampleRate; // of pcm packet
+    uint32_t _channels;
 };
 
 } // namespace bridge
@@ -9,6 +9,7 @@
 #include "concurrency/ThreadUtils.h"
 #include "logger/Logger.h"
 #include "utils/CheckedCast.h"
+#include "utils/Metrics.h"
 #include "utils/Pacer.h"
 #include <cassert>
 
@@ -22,11 +23,12 @@ const auto intervalNs = 1000000UL * bridge::EngineMixer::iterationDurationMs;
 namespace bridge
 {
 
-Engine::Engine(jobmanager::JobManager& backgroundJobQueue)
+Engine::Engine(jobmanager::JobManager& backgroundJobQueue, const concurrency::PollConfig& pollConfig)
     : _messageListener(nullptr),
       _running(true),
       _tickCounter(0),
       _tasks(1024),
+      _pollConfig(pollConfig),
       _thread([this] { this->run(); })
 {
     if (concurrency::setPriority(_thread, concurrency::Priority::RealTime))
@@ -61,12 +63,13 @@ void Engine::run()
 {
     logger::debug("Engine started", "Engine");
     concurrency::setThreadName("Engine");
+    concurrency::setAffinity(_pollConfig);
     utils::Pacer pacer(intervalNs);
     EngineStats::EngineStats currentStatSample;
 
     const int64_t TICK_TOLERANCE = utils::Time::ms * 2;
     const int64_t IDLE_MARGIN = utils::Time::us * 50;
-    uint64_t timestamp = utils::Time::getAbsoluteTime();
+    uint64_t timestamp = utils::Time::refreshApproximateTime();
     uint64_t statsPollTime = timestamp - utils::Time::sec * 2;
     while (_running)
     {
@@ -82,6 +85,7 @@ void Engine::run()
             assert(mixerEntry->_data);
             mixerEntry->_data->run(timestamp);
         }
+        utils::metrics::engineTickDuration.observe(utils::Time::getAbsoluteTime() - timestamp);
 
         if (++_tickCounter % STATS_UPDATE_TICKS == 0)
         {
@@ -89,7 +93,7 @@ void Engine::run()
         }
 
         // process tasks and forward packets until next tick is near
-        timestamp = utils::Time::getAbsoluteTime();
+        timestamp = utils::Time::refreshApproximateTime();
         int64_t toSleep = pacer.timeToNextTick(timestamp);
         int64_t nextForwardCycle = toSleep - utils::Time::ms;
         while (toSleep > IDLE_MARGIN)
@@ -106,20 +110,36 @@ void Engine::run()
             }
 
             const auto pendingTasks = processTasks(128);
-            timestamp = utils::Time::getAbsoluteTime();
+            timestamp = utils::Time::refreshApproximateTime();
             toSleep = pacer.timeToNextTick(timestamp);
             if (!pendingTasks && toSleep > 0)
             {
-                utils::Time::nanoSleep(std::min(utils::checkedCast<uint64_t>(toSleep), utils::Time::us * 2000));
-                timestamp = utils::Time::getAbsoluteTime();
+                if (_pollConfig.busyPoll)
+                {
+                    concurrency::cpuRelax();
+                }
+                else
+                {
+                    utils::Time::nanoSleep(std::min(utils::checkedCast<uint64_t>(toSleep), utils::Time::us * 2000));
+                }
+                timestamp = utils::Time::refreshApproximateTime();
                 toSleep = pacer.timeToNextTick(timestamp);
             }
         }
 
-        if (toSleep > 0)
+        if (toSleep > 0 && _pollConfig.busyPoll)
+        {
+            // spin the last part of the tick to start next tick without wake up delay
+            while (pacer.timeToNextTick(timestamp) > 0)
+            {
+                concurrency::cpuRelax();
+                timestamp = utils::Time::refreshApproximateTime();
+            }
+        }
+        else if (toSleep > 0)
         {
             utils::Time::nanoSleep(utils::checkedCast<uint64_t>(toSleep));
-            timestamp = utils::Time::getAbsoluteTime();
+            timestamp = utils::Time::refreshApproximateTime();
         }
     }
 }
@@ -146,11 +166,11 @@ bool Engine::processTasks(uint32_t maxCount)
 void Engine::updateStats(uint64_t& statsPollTime, EngineStats::EngineStats& currentStatSample, const uint64_t timestamp)
 {
     uint64_t pollTime = utils::Time::getAbsoluteTime();
-    currentStatSample.activeMixers = EngineStats::MixerStats();
 
+    // mixer stats are aggregated by MixerManager from published counters
     for (auto mixerEntry = _mixers.head(); mixerEntry; mixerEntry = mixerEntry->_next)
     {
-        currentStatSample.activeMixers += mixerEntry->_data->gatherStats(timestamp);
+        mixerEntry->_data->publishStats();
     }
 
     currentStatSample.pollPeriodMs =
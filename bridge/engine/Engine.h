@@ -4,6 +4,7 @@
 #include "concurrency/MpmcPublish.h"
 #include "concurrency/MpmcQueue.h"
 #include "concurrency/SynchronizationContext.h"
+#include "concurrency/ThreadUtils.h"
 #include "config/Config.h"
 #include "memory/List.h"
 #include "utils/Trackers.h"
@@ -26,7 +27,8 @@ struct RecordingDescription;
 class Engine
 {
 public:
-    Engine(jobmanager::JobManager& backgroundJobQueue);
+    explicit Engine(jobmanager::JobManager& backgroundJobQueue,
+        const concurrency::PollConfig& pollConfig = concurrency::PollConfig());
     Engine(jobmanager::JobManager& backgroundJobQueue, std::thread&& externalThread);
 
     void setMessageListener(MixerManagerAsync* messageListener);
@@ -55,6 +57,7 @@ private:
     uint32_t _tickCounter;
 
     concurrency::MpmcQueue<utils::Function> _tasks;
+    const concurrency::PollConfig _pollConfig;
 
     std::thread _thread; // must be last member
 
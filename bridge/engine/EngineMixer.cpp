@@ -8,11 +8,13 @@
 #include "bridge/engine/EngineStreamDirector.h"
 #include "bridge/engine/EngineVideoStream.h"
 #include "bridge/engine/VideoNackReceiveJob.h"
+#include "codec/Opus.h"
 #include "config/Config.h"
 #include "logger/Logger.h"
 #include "rtp/RtcpFeedback.h"
 #include "rtp/RtpHeader.h"
 #include "transport/Transport.h"
+#include <cmath>
 
 using namespace bridge;
 
@@ -47,6 +49,7 @@ EngineMixer::EngineMixer(const std::string& id,
       _incomingForwarderAudioRtp(maxPendingPackets),
       _incomingRtcp(videoSsrcs.empty() ? maxPendingRtcpPacketsVideoDisabled : maxPendingRtcpPackets),
       _incomingForwarderVideoRtp(videoSsrcs.empty() ? 0 : maxPendingPackets),
+      _ingressRings(maxStreamsPerModality + maxNumBarbells),
       _engineAudioStreams(maxStreamsPerModality),
       _engineVideoStreams(videoSsrcs.empty() ? 0 : maxStreamsPerModality),
       _engineDataStreams(maxStreamsPerModality),
@@ -57,6 +60,14 @@ EngineMixer::EngineMixer(const std::string& id,
       _allSsrcInboundContexts(videoSsrcs.empty() ? maxSsrcsVideoDisabled : maxSsrcs),
       _audioSsrcToUserIdMap(ActiveMediaList::maxParticipants),
       _localVideoSsrc(localVideoSsrc),
+      // unsupported formats are reported by Bridge at start and fall back to full rate stereo
+      _mixSampleRate(codec::Opus::isSupportedMixFormat(config.audio.mixSampleRate, config.audio.mixChannels)
+              ? config.audio.mixSampleRate.get()
+              : codec::Opus::sampleRate),
+      _mixChannels(codec::Opus::isSupportedMixFormat(config.audio.mixSampleRate, config.audio.mixChannels)
+              ? config.audio.mixChannels.get()
+              : codec::Opus::channelsPerFrame),
+      _mixSamplesPerFrame(_mixSampleRate * 20 / 1000),
       _rtpTimestampSource(1000),
       _mainAllocator(mainAllocator),
       _sendAllocator(sendAllocator),
@@ -95,11 +106,28 @@ EngineMixer::EngineMixer(const std::string& id,
     assert(videoSsrcs.size() <= SsrcRewrite::ssrcArraySize);
 
     std::memset(_mixedData, 0, sizeof(_mixedData));
+    if (_config.audio.parallelMixThreshold > 0)
+    {
+        _mixContributors.reserve(maxStreamsPerModality);
+        _mixRecipients.reserve(maxStreamsPerModality);
+        _partialMixes.resize(maxPartialMixes * samplesPerFrame20ms * channelsPerFrame);
+    }
     _iceReceivedOnRegularTransport.test_and_set();
     _iceReceivedOnBarbellTransport.test_and_set();
+    _retiredIngressRings.reserve(maxNumBarbells);
 }
 
-EngineMixer::~EngineMixer() {}
+EngineMixer::~EngineMixer()
+{
+    for (auto& ingressRingsEntry : _ingressRings)
+    {
+        delete ingressRingsEntry.second;
+    }
+    for (auto* ingressRings : _retiredIngressRings)
+    {
+        delete ingressRings;
+    }
+}
 
 bool EngineMixer::isIdle(const uint64_t timestamp) const
 {
@@ -184,6 +212,169 @@ void EngineMixer::flush()
     _incomingForwarderAudioRtp.clear();
     _incomingForwarderVideoRtp.clear();
     _incomingRtcp.clear();
+    clearIngressRings();
+}
+
+// executed on engine thread when a stream using the transport is added
+void EngineMixer::addIngressRings(const transport::RtcTransport& transport)
+{
+    auto* ingressRings = _ingressRings.getItem(transport.getId());
+    if (ingressRings)
+    {
+        ++ingressRings->streamCount;
+        return;
+    }
+
+    auto* newIngressRings = new IngressRings();
+    newIngressRings->streamCount = 1;
+    if (!_ingressRings.emplace(transport.getId(), newIngressRings).second)
+    {
+        logger::warn("Failed to add ingress rings, transport %s",
+            _loggableId.c_str(),
+            transport.getLoggableId().c_str());
+        delete newIngressRings;
+    }
+}
+
+// executed on engine thread when a stream using the transport is removed
+void EngineMixer::releaseIngressRings(transport::RtcTransport& transport)
+{
+    auto* ingressRings = _ingressRings.getItem(transport.getId());
+    if (!ingressRings)
+    {
+        return;
+    }
+
+    if (--ingressRings->streamCount > 0)
+    {
+        return;
+    }
+
+    // new packets go to the shared queues. The rings are deleted once drained and after a job on the transport queue
+    // has shown that the transport no longer pushes to them.
+    _ingressRings.erase(transport.getId());
+    _retiredIngressRings.push_back(ingressRings);
+    if (!transport.postOnQueue([ingressRings]() { ingressRings->producerReleased = true; }))
+    {
+        logger::warn("Failed to release ingress rings, transport %s",
+            _loggableId.c_str(),
+            transport.getLoggableId().c_str());
+    }
+}
+
+void EngineMixer::reclaimIngressRings()
+{
+    for (auto it = _retiredIngressRings.begin(); it != _retiredIngressRings.end();)
+    {
+        auto* ingressRings = *it;
+        if (ingressRings->producerReleased.load(std::memory_order_acquire) && ingressRings->empty())
+        {
+            delete ingressRings;
+            it = _retiredIngressRings.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+bool EngineMixer::pushIncoming(IngressRing ring,
+    const transport::RtcTransport* sender,
+    concurrency::MpmcQueue<IncomingPacketInfo>& sharedQueue,
+    IncomingPacketInfo&& packetInfo)
+{
+    // the ring only moves from packetInfo if there is room, so it is intact for the shared queue otherwise
+    auto* ingressRings = sender ? _ingressRings.getItem(sender->getId()) : nullptr;
+    if (ingressRings && (ingressRings->*ring).push(std::move(packetInfo)))
+    {
+        return true;
+    }
+
+    return sharedQueue.push(std::move(packetInfo));
+}
+
+/**
+ * Drains the packets queued on each transport ring in turn, retired rings first, then the shared queue. Only the
+ * packets present when a ring is visited are taken, so a busy transport cannot starve the others. A packet goes to the
+ * shared queue only when its transport ring is full or gone, and as the shared queue is drained last it is not handled
+ * ahead of earlier packets from the same transport.
+ */
+template <typename PacketHandler>
+void EngineMixer::drainIncoming(IngressRing ring,
+    concurrency::MpmcQueue<IncomingPacketInfo>& sharedQueue,
+    const uint64_t timestamp,
+    PacketHandler&& onPacket)
+{
+    IncomingPacketInfo packetInfo;
+    auto drainRing = [&](concurrency::SpscQueue<IncomingPacketInfo>& transportRing) {
+        for (auto count = transportRing.size(); count > 0 && transportRing.pop(packetInfo); --count)
+        {
+            const auto* next = transportRing.front();
+            if (next && next->packet())
+            {
+                __builtin_prefetch(next->packet()->get());
+            }
+
+            updateIngressDrainLatency(packetInfo, timestamp);
+            onPacket(packetInfo);
+        }
+    };
+
+    for (auto* ingressRings : _retiredIngressRings)
+    {
+        drainRing(ingressRings->*ring);
+    }
+    for (auto& ingressRingsEntry : _ingressRings)
+    {
+        drainRing(ingressRingsEntry.second->*ring);
+    }
+
+    while (sharedQueue.pop(packetInfo))
+    {
+        updateIngressDrainLatency(packetInfo, timestamp);
+        onPacket(packetInfo);
+    }
+}
+
+void EngineMixer::updateIngressDrainLatency(const IncomingPacketInfo& packetInfo, const uint64_t timestamp)
+{
+    const auto receiveTimestamp = packetInfo.packet() ? packetInfo.packet()->receiveTimestamp : 0;
+    if (receiveTimestamp != 0 && utils::Time::diffGT(receiveTimestamp, timestamp, _ingressStats.maxDrainLatency))
+    {
+        _ingressStats.maxDrainLatency = utils::Time::diff(receiveTimestamp, timestamp);
+    }
+}
+
+void EngineMixer::updateIngressQueueDepth()
+{
+    uint32_t depth = _incomingForwarderAudioRtp.size() + _incomingForwarderVideoRtp.size() + _incomingRtcp.size();
+    for (auto& ingressRingsEntry : _ingressRings)
+    {
+        auto* ingressRings = ingressRingsEntry.second;
+        depth += ingressRings->audio.size() + ingressRings->video.size() + ingressRings->rtcp.size();
+    }
+    for (auto* ingressRings : _retiredIngressRings)
+    {
+        depth += ingressRings->audio.size() + ingressRings->video.size() + ingressRings->rtcp.size();
+    }
+    _ingressStats.maxQueueDepth = std::max(_ingressStats.maxQueueDepth, depth);
+}
+
+void EngineMixer::clearIngressRings()
+{
+    for (auto& ingressRingsEntry : _ingressRings)
+    {
+        ingressRingsEntry.second->audio.clear();
+        ingressRingsEntry.second->video.clear();
+        ingressRingsEntry.second->rtcp.clear();
+    }
+    for (auto* ingressRings : _retiredIngressRings)
+    {
+        ingressRings->audio.clear();
+        ingressRings->video.clear();
+        ingressRings->rtcp.clear();
+    }
 }
 
 void EngineMixer::forwardPackets(const uint64_t engineTimestamp)
@@ -200,6 +391,7 @@ void EngineMixer::run(const uint64_t engineIterationStartTimestamp)
     processBarbellSctp(engineIterationStartTimestamp);
     processIncomingRtpPackets(engineIterationStartTimestamp);
     processIncomingRtcpPackets(engineIterationStartTimestamp);
+    reclaimIngressRings();
     processIceActivity(engineIterationStartTimestamp);
 
     // 2. Check for stale streams
@@ -334,6 +526,7 @@ void EngineMixer::internalRemoveInboundSsrc(uint32_t ssrc)
     {
         logger::info("Removing inbound context ssrc %u", _loggableId.c_str(), ssrc);
 
+        removeInboundAudioCounters(*context);
         auto decoder = context->opusDecoder.release();
         _allSsrcInboundContexts.erase(ssrc);
         if (decoder)
@@ -370,15 +563,15 @@ void EngineMixer::checkInboundPacketCounters(const uint64_t timestamp)
         {
             if (inboundContext.hasRecentActivity(utils::Time::sec, timestamp))
             {
-                inboundContext.sender->postOnQueue([&inboundContext]() {
-                    inboundContext.opusDecodePacketRate =
-                        inboundContext.opusPacketRate ? inboundContext.opusPacketRate->get() : 0;
+                inboundContext.sender->postOnQueue([this, &inboundContext]() {
+                    setOpusDecodePacketRate(inboundContext,
+                        inboundContext.opusPacketRate ? inboundContext.opusPacketRate->get() : 0);
                 });
             }
             else
             {
                 inboundContext.activeMedia = false;
-                inboundContext.opusDecodePacketRate = 0;
+                setOpusDecodePacketRate(inboundContext, 0);
             }
         }
 
@@ -438,78 +631,79 @@ void EngineMixer::checkInboundPacketCounters(const uint64_t timestamp)
     }
 }
 
-EngineStats::MixerStats EngineMixer::gatherStats(const uint64_t iterationStartTime)
+// Engine thread. Stream and transport counters are aggregated by the Mixer on a background thread.
+void EngineMixer::publishStats()
 {
-    EngineStats::MixerStats stats;
-    uint64_t idleTimestamp = iterationStartTime - utils::Time::sec * 2;
+    _publishedIngressStats.write(_ingressStats);
+    _ingressStats.maxQueueDepth = 0;
+    _ingressStats.maxDrainLatency = 0;
+}
 
-    stats.audioInQueues = 0;
-    stats.audioInQueueSamples = 0;
-    stats.maxAudioInQueueSamples = 0;
+// Any thread. Reads the inbound audio counters and the ingress snapshot published by the engine thread.
+void EngineMixer::gatherInboundStats(EngineStats::MixerStats& stats) const
+{
+    stats.opusDecodePacketsPerSecond += std::max(int64_t(0), _inboundAudioCounters.opusDecodePacketsPerSecond.load());
+    stats.audioLevelExtensionStreamCount += _inboundAudioCounters.audioLevelExtensionStreams.load();
+    // fetching JB sizes would require more atomics in audio pipeline.
+    stats.audioInQueues += _inboundAudioCounters.audioInQueues.load();
 
-    for (auto& audioStreamEntry : _engineAudioStreams)
+    IngressStats ingressStats;
+    if (_publishedIngressStats.read(ingressStats))
     {
-        const auto* audioStream = audioStreamEntry.second;
-        const auto audioRecvCounters = audioStream->transport.getAudioReceiveCounters(idleTimestamp);
-        const auto audioSendCounters = audioStream->transport.getAudioSendCounters(idleTimestamp);
-        const auto videoRecvCounters = audioStream->transport.getVideoReceiveCounters(idleTimestamp);
-        const auto videoSendCounters = audioStream->transport.getVideoSendCounters(idleTimestamp);
-        const auto pacingQueueCount = audioStream->transport.getPacingQueueCount();
-        const auto rtxPacingQueueCount = audioStream->transport.getRtxPacingQueueCount();
+        stats.ingressQueueDepth = std::max(stats.ingressQueueDepth, ingressStats.maxQueueDepth);
+        stats.ingressDrainLatencyUs =
+            std::max(stats.ingressDrainLatencyUs, ingressStats.maxDrainLatency / utils::Time::us);
+    }
+}
 
-        stats.inbound.audio += audioRecvCounters;
-        stats.outbound.audio += audioSendCounters;
-        stats.inbound.video += videoRecvCounters;
-        stats.outbound.video += videoSendCounters;
-        stats.inbound.transport.addBandwidthGroup(audioStream->transport.getDownlinkEstimateKbps());
-        stats.inbound.transport.addRttGroup(audioStream->transport.getRtt() / utils::Time::ms);
-        stats.inbound.transport.addLossGroup((audioRecvCounters + videoRecvCounters).getReceiveLossRatio());
-        stats.outbound.transport.addLossGroup((audioSendCounters + videoSendCounters).getSendLossRatio());
-        stats.pacingQueue += pacingQueueCount;
-        stats.rtxPacingQueue += rtxPacingQueueCount;
+void EngineMixer::setOpusDecodePacketRate(SsrcInboundContext& inboundContext, const double packetRate)
+{
+    const auto previousRate = inboundContext.opusDecodePacketRate.exchange(packetRate);
+    if (inboundContext.rtpMap.format == RtpMap::Format::OPUS)
+    {
+        _inboundAudioCounters.opusDecodePacketsPerSecond += std::llround(packetRate) - std::llround(previousRate);
+    }
+}
 
-        if (audioStream->detectedAudioSsrc.isSet())
-        {
-            auto inboundSsrcContext = _ssrcInboundContexts.getItem(audioStream->detectedAudioSsrc.get());
-            if (inboundSsrcContext)
-            {
-                stats.opusDecodePacketsPerSecond += inboundSsrcContext->opusDecodePacketRate.load();
-                stats.audioLevelExtensionStreamCount += inboundSsrcContext->hasAudioLevelExtension.load() ? 1 : 0;
-            }
-        }
+bool EngineMixer::clearAudioLevelExtension(SsrcInboundContext& inboundContext)
+{
+    if (!inboundContext.hasAudioLevelExtension.exchange(false))
+    {
+        return false;
+    }
 
-        if (_numMixedAudioStreams > 0 && audioStream->remoteSsrc.isSet())
-        {
-            auto* ssrcContext = _ssrcInboundContexts.getItem(audioStream->remoteSsrc.get());
-            if (ssrcContext && ssrcContext->hasAudioReceivePipe.load())
-            {
-                ++stats.audioInQueues;
-                // fetching JB sizes would require more atomics in audio pipeline.
-            }
-        }
+    if (inboundContext.rtpMap.format == RtpMap::Format::OPUS)
+    {
+        --_inboundAudioCounters.audioLevelExtensionStreams;
     }
+    return true;
+}
 
-    for (auto& videoStreamEntry : _engineVideoStreams)
+void EngineMixer::setAudioReceivePipeCreated(SsrcInboundContext& inboundContext)
+{
+    if (!inboundContext.hasAudioReceivePipe.exchange(true) && inboundContext.rtpMap.format == RtpMap::Format::OPUS)
     {
-        if (!_engineAudioStreams.contains(videoStreamEntry.first))
-        {
-            const auto videoRecvCounters = videoStreamEntry.second->transport.getVideoReceiveCounters(idleTimestamp);
-            const auto videoSendCounters = videoStreamEntry.second->transport.getVideoSendCounters(idleTimestamp);
-            const auto pacingQueueCount = videoStreamEntry.second->transport.getPacingQueueCount();
-            const auto rtxPacingQueueCount = videoStreamEntry.second->transport.getRtxPacingQueueCount();
+        ++_inboundAudioCounters.audioInQueues;
+    }
+}
 
-            stats.inbound.video += videoRecvCounters;
-            stats.outbound.video += videoSendCounters;
-            stats.inbound.transport.addBandwidthGroup(videoStreamEntry.second->transport.getDownlinkEstimateKbps());
-            stats.inbound.transport.addRttGroup(videoStreamEntry.second->transport.getRtt() / utils::Time::ms);
-            stats.inbound.transport.addLossGroup(videoRecvCounters.getReceiveLossRatio());
-            stats.outbound.transport.addLossGroup(videoSendCounters.getSendLossRatio());
-            stats.pacingQueue += pacingQueueCount;
-            stats.rtxPacingQueue += rtxPacingQueueCount;
-        }
+void EngineMixer::addInboundAudioCounters(SsrcInboundContext& inboundContext)
+{
+    if (inboundContext.rtpMap.format == RtpMap::Format::OPUS && inboundContext.hasAudioLevelExtension.load())
+    {
+        ++_inboundAudioCounters.audioLevelExtensionStreams;
     }
+}
 
-    return stats;
+// The context is no longer used by any transport job
+void EngineMixer::removeInboundAudioCounters(SsrcInboundContext& inboundContext)
+{
+    setOpusDecodePacketRate(inboundContext, 0);
+    clearAudioLevelExtension(inboundContext);
+    if (inboundContext.hasAudioReceivePipe.exchange(false) && inboundContext.rtpMap.format == RtpMap::Format::OPUS)
+    {
+        --_inboundAudioCounters.audioInQueues;
+    }
 }
 
 void EngineMixer::onConnected(transport::RtcTransport* sender)
@@ -746,7 +940,7 @@ void EngineMixer::onRtcpPacketDecoded(transport::RtcTransport* sender,
     const uint64_t timestamp)
 {
     assert(packet);
-    if (!_incomingRtcp.push(IncomingPacketInfo(std::move(packet), sender, 0)))
+    if (!pushIncoming(&IngressRings::rtcp, sender, _incomingRtcp, IncomingPacketInfo(std::move(packet), sender, 0)))
     {
         logger::warn("rtcp queue full", _loggableId.c_str());
     }
@@ -919,6 +1113,10 @@ SsrcInboundContext* EngineMixer::emplaceInboundSsrcContext(const uint32_t ssrc,
             logger::error("Failed to create inbound context for ssrc %u", _loggableId.c_str(), ssrc);
             return nullptr;
         }
+        if (emplaceResult.second)
+        {
+            addInboundAudioCounters(emplaceResult.first->second);
+        }
 
         auto emplaceIt = _ssrcInboundContexts.emplace(ssrc, &emplaceResult.first->second);
         if (emplaceIt.second)
@@ -975,6 +1173,12 @@ SsrcInboundContext* EngineMixer::emplaceInboundSsrcContext(const uint32_t ssrc,
         }
 
         auto& inboundContext = emplaceResult.first->second;
+        if (_config.inboundNackCache && emplaceResult.second)
+        {
+            // allocated off the receive path. Retransmissions are not served until the cache is published
+            inboundContext.packetCacheRequested = true;
+            _messageListener.asyncAllocateInboundPacketCache(*this, ssrc);
+        }
 
         auto emplaceIt = _ssrcInboundContexts.emplace(ssrc, &emplaceResult.first->second);
         if (emplaceIt.second)
@@ -1049,8 +1253,9 @@ void EngineMixer::processIncomingRtpPackets(const uint64_t timestamp)
         }
     }
 
-    for (IncomingPacketInfo packetInfo; _incomingForwarderAudioRtp.pop(packetInfo);)
-    {
+    updateIngressQueueDepth();
+
+    drainIncoming(&IngressRings::audio, _incomingForwarderAudioRtp, timestamp, [&](IncomingPacketInfo& packetInfo) {
         ++numRtpPackets;
         if (EngineBarbell::isFromBarbell(packetInfo.transport()->getTag()))
         {
@@ -1060,7 +1265,7 @@ void EngineMixer::processIncomingRtpPackets(const uint64_t timestamp)
         const auto rtpHeader = rtp::RtpHeader::fromPacket(*packetInfo.packet());
         if (!rtpHeader)
         {
-            continue;
+            return;
         }
 
         auto ssrcContext = packetInfo.inboundContext();
@@ -1072,10 +1277,9 @@ void EngineMixer::processIncomingRtpPackets(const uint64_t timestamp)
         forwardAudioRtpPacket(packetInfo, timestamp);
         forwardAudioRtpPacketRecording(packetInfo, timestamp);
         forwardAudioRtpPacketOverBarbell(packetInfo, timestamp);
-    }
+    });
 
-    for (IncomingPacketInfo packetInfo; _incomingForwarderVideoRtp.pop(packetInfo);)
-    {
+    drainIncoming(&IngressRings::video, _incomingForwarderVideoRtp, timestamp, [&](IncomingPacketInfo& packetInfo) {
         ++numRtpPackets;
         if (EngineBarbell::isFromBarbell(packetInfo.transport()->getTag()))
         {
@@ -1094,7 +1298,7 @@ void EngineMixer::processIncomingRtpPackets(const uint64_t timestamp)
         forwardVideoRtpPacket(packetInfo, timestamp);
         forwardVideoRtpPacketOverBarbell(packetInfo, timestamp);
         forwardVideoRtpPacketRecording(packetInfo, timestamp);
-    }
+    });
 
     if (numBarbellRtpPackets > 0)
     {
@@ -1109,8 +1313,7 @@ void EngineMixer::processIncomingRtpPackets(const uint64_t timestamp)
 
 void EngineMixer::processIncomingRtcpPackets(const uint64_t timestamp)
 {
-    for (IncomingPacketInfo packetInfo; _incomingRtcp.pop(packetInfo);)
-    {
+    drainIncoming(&IngressRings::rtcp, _incomingRtcp, timestamp, [&](IncomingPacketInfo& packetInfo) {
         rtp::CompoundRtcpPacket compoundPacket(packetInfo.packet()->get(), packetInfo.packet()->getLength());
         for (const auto& rtcpPacket : compoundPacket)
         {
@@ -1140,7 +1343,7 @@ void EngineMixer::processIncomingRtcpPackets(const uint64_t timestamp)
         {
             _lastReceiveTimeOnRegularTransports = timestamp;
         }
-    }
+    });
 }
 
 void EngineMixer::processIceActivity(const uint64_t timestamp)
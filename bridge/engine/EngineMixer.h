@@ -8,11 +8,15 @@
 #include "bridge/engine/SimulcastStream.h"
 #include "bridge/engine/SsrcInboundContext.h"
 #include "concurrency/MpmcHashmap.h"
+#include "concurrency/MpmcPublish.h"
+#include "concurrency/MpmcQueue.h"
+#include "concurrency/SpscQueue.h"
 #include "concurrency/SynchronizationContext.h"
 #include "memory/AudioPacketPoolAllocator.h"
 #include "memory/Map.h"
 #include "memory/PacketPoolAllocator.h"
 #include "transport/RtcTransport.h"
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <map>
@@ -49,6 +53,7 @@ namespace bridge
 class EngineStreamDirector;
 class ActiveMediaList;
 class PacketCache;
+class InboundPacketCache;
 struct SsrcWhitelist;
 struct RecordingDescription;
 class SsrcOutboundContext;
@@ -77,8 +82,12 @@ public:
     static constexpr size_t maxNumBarbells = 16;
 
     static constexpr size_t samplesPerFrame20ms = sampleRate * 20 / 1000;
+    static constexpr size_t maxPartialMixes = 16;
 
     static constexpr size_t maxPendingPackets = 8192;
+    static constexpr uint32_t audioIngressRingCapacity = 64;
+    static constexpr uint32_t videoIngressRingCapacity = 256;
+    static constexpr uint32_t rtcpIngressRingCapacity = 64;
     static constexpr size_t maxPendingRtcpPackets = 2048;
     static constexpr size_t maxPendingRtcpPacketsVideoDisabled = 512;
     static constexpr size_t maxSsrcs = 8192;
@@ -110,12 +119,22 @@ public:
 public:
     void forwardPackets(const uint64_t engineTimestamp);
     void clear();
-    EngineStats::MixerStats gatherStats(const uint64_t engineIterationStartTimestamp);
+    void publishStats();
+    // May be called from any thread. Adds stats of inbound ssrc contexts and the last published ingress stats.
+    void gatherInboundStats(EngineStats::MixerStats& stats) const;
+
+    // Keep the inbound audio counters in step with the context state. Called on the thread that owns the context.
+    void setOpusDecodePacketRate(SsrcInboundContext& inboundContext, double packetRate);
+    bool clearAudioLevelExtension(SsrcInboundContext& inboundContext);
+    void setAudioReceivePipeCreated(SsrcInboundContext& inboundContext);
 
     void run(const uint64_t engineIterationStartTimestamp);
     // --
 
     memory::PacketPoolAllocator& getMainAllocator() { return _mainAllocator; }
+    memory::PacketPoolAllocator& getSendAllocator() { return _sendAllocator; }
+    uint32_t getMixSampleRate() const { return _mixSampleRate; }
+    uint32_t getMixChannels() const { return _mixChannels; }
     memory::AudioPacketPoolAllocator& getAudioAllocator() { return _audioAllocator; }
     size_t getDominantSpeakerId() const;
     std::map<size_t, ActiveTalker> getActiveTalkers() const;
@@ -158,6 +177,8 @@ public:
     void onRecordingOutboundContextFinalized(size_t recordingStreamIdHash, uint32_t ssrc);
     void internalRemoveBarbell(size_t idHash);
     void internalRemoveInboundSsrc(uint32_t ssrc);
+    void addInboundAudioCounters(SsrcInboundContext& inboundContext);
+    void removeInboundAudioCounters(SsrcInboundContext& inboundContext);
     // --
 
     jobmanager::JobManager& getJobManager() { return _jobManager; }
@@ -173,6 +194,7 @@ public: // EngineMixer async interface. Will execute on engine thread
     bool asyncRemoveStream(const EngineVideoStream* stream);
     bool asyncRemoveStream(const EngineDataStream* stream);
     bool asyncAddVideoPacketCache(const uint32_t ssrc, const size_t endpointIdHash, PacketCache* videoPacketCache);
+    bool asyncAddInboundPacketCache(const uint32_t ssrc, const std::shared_ptr<InboundPacketCache>& packetCache);
     bool asyncReconfigureAudioStream(const transport::RtcTransport& transport, const uint32_t remoteSsrc);
     bool asyncReconfigureNeighbours(const transport::RtcTransport& transport, const std::vector<uint32_t>& neighbours);
     bool asyncStartTransport(transport::RtcTransport& transport);
@@ -218,6 +240,7 @@ private: // impl async interface
     void reconfigureAudioStream(const transport::RtcTransport& transport, const uint32_t remoteSsrc);
     void reconfigureNeighbours(const transport::RtcTransport& transport, const std::vector<uint32_t>& neighbours);
     void addVideoPacketCache(const uint32_t ssrc, const size_t endpointIdHash, PacketCache* videoPacketCache);
+    void addInboundPacketCache(const uint32_t ssrc, const std::shared_ptr<InboundPacketCache>& packetCache);
     void pinEndpoint(const size_t endpointIdHash, const size_t targetEndpointIdHash);
     void sendEndpointMessage(const size_t toEndpointIdHash,
         const size_t fromEndpointIdHash,
@@ -355,6 +378,32 @@ protected:
 
     using IncomingPacketInfo = IncomingPacketAggregate<memory::UniquePacket>;
 
+    /**
+     * Single producer rings for packets pushed by one transport. A transport feeds the engine from its serial job
+     * queue, so it is the only producer of its rings whichever worker thread runs the job, and its packets stay in
+     * order. The shared queues are used when a ring is full or the transport has no rings.
+     */
+    struct IngressRings
+    {
+        IngressRings()
+            : audio(audioIngressRingCapacity),
+              video(videoIngressRingCapacity),
+              rtcp(rtcpIngressRingCapacity),
+              streamCount(0),
+              producerReleased(false)
+        {
+        }
+
+        bool empty() const { return audio.empty() && video.empty() && rtcp.empty(); }
+
+        concurrency::SpscQueue<IncomingPacketInfo> audio;
+        concurrency::SpscQueue<IncomingPacketInfo> video;
+        concurrency::SpscQueue<IncomingPacketInfo> rtcp;
+        uint32_t streamCount; // engine thread only
+        std::atomic_bool producerReleased;
+    };
+    using IngressRing = concurrency::SpscQueue<IncomingPacketInfo> IngressRings::*;
+
     std::string _id;
     logger::LoggableId _loggableId;
 
@@ -366,6 +415,24 @@ protected:
     concurrency::MpmcQueue<IncomingPacketInfo> _incomingForwarderAudioRtp;
     concurrency::MpmcQueue<IncomingPacketInfo> _incomingRtcp;
     concurrency::MpmcQueue<IncomingPacketInfo> _incomingForwarderVideoRtp;
+    concurrency::MpmcHashmap32<size_t, IngressRings*> _ingressRings;
+    std::vector<IngressRings*> _retiredIngressRings;
+    struct IngressStats
+    {
+        uint32_t maxQueueDepth = 0;
+        uint64_t maxDrainLatency = 0;
+    } _ingressStats;
+    concurrency::MpmcPublish<IngressStats, 4> _publishedIngressStats;
+    // Opus inbound context counters. Updated when contexts are added, removed or change state, so stats never
+    // have to iterate the contexts. The decode rate is summed as whole packets per second to avoid drift.
+    struct InboundAudioCounters
+    {
+        InboundAudioCounters() : opusDecodePacketsPerSecond(0), audioLevelExtensionStreams(0), audioInQueues(0) {}
+
+        std::atomic_int64_t opusDecodePacketsPerSecond;
+        std::atomic_uint32_t audioLevelExtensionStreams;
+        std::atomic_uint32_t audioInQueues;
+    } _inboundAudioCounters;
 
     concurrency::MpmcHashmap32<size_t, EngineAudioStream*> _engineAudioStreams;
     concurrency::MpmcHashmap32<size_t, EngineVideoStream*> _engineVideoStreams;
@@ -383,7 +450,21 @@ protected:
 
     uint32_t _localVideoSsrc;
 
+    // mix format is at most sampleRate and channelsPerFrame
+    const uint32_t _mixSampleRate;
+    const uint32_t _mixChannels;
+    const uint32_t _mixSamplesPerFrame;
     int16_t _mixedData[samplesPerFrame20ms * channelsPerFrame];
+
+    struct MixRecipient
+    {
+        EngineAudioStream* audioStream;
+        SsrcOutboundContext* outboundContext;
+    };
+    // Engine thread scratch for parallel mixing. Partial mixes are only allocated if parallel mixing is enabled.
+    std::vector<SsrcInboundContext*> _mixContributors;
+    std::vector<MixRecipient> _mixRecipients;
+    std::vector<int16_t> _partialMixes;
     uint64_t _rtpTimestampSource; // 1kHz. it works with wrapping since it is truncated to uint32.
 
     memory::PacketPoolAllocator& _mainAllocator;
@@ -430,6 +511,21 @@ protected:
 
     void processBarbellSctp(const uint64_t timestamp);
     void processIncomingRtpPackets(const uint64_t timestamp);
+    void addIngressRings(const transport::RtcTransport& transport);
+    void releaseIngressRings(transport::RtcTransport& transport);
+    void reclaimIngressRings();
+    bool pushIncoming(IngressRing ring,
+        const transport::RtcTransport* sender,
+        concurrency::MpmcQueue<IncomingPacketInfo>& sharedQueue,
+        IncomingPacketInfo&& packetInfo);
+    template <typename PacketHandler>
+    void drainIncoming(IngressRing ring,
+        concurrency::MpmcQueue<IncomingPacketInfo>& sharedQueue,
+        const uint64_t timestamp,
+        PacketHandler&& onPacket);
+    void updateIngressDrainLatency(const IncomingPacketInfo& packetInfo, const uint64_t timestamp);
+    void updateIngressQueueDepth();
+    void clearIngressRings();
     void forwardVideoRtpPacket(IncomingPacketInfo& packetInfo, const uint64_t timestamp);
     void forwardVideoRtpPacketRecording(IncomingPacketInfo& packetInfo, const uint64_t timestamp);
     void forwardVideoRtpPacketOverBarbell(IncomingPacketInfo& packetInfo, const uint64_t timestamp);
@@ -455,6 +551,10 @@ protected:
     void removeIdleStreams(const uint64_t timestamp);
 
     void processAudioStreams();
+    void processAudioStreamsParallel(const size_t payloadBytesPerPacket);
+    bool sendMixedAudio(EngineAudioStream& audioStream,
+        SsrcOutboundContext& outboundContext,
+        const size_t payloadBytesPerPacket);
     void runDominantSpeakerCheck(const uint64_t engineIterationStartTimestamp);
     void updateDirectorUplinkEstimates(const uint64_t engineIterationStartTimestamp);
     void processMissingPackets(const uint64_t timestamp);
@@ -10,7 +10,11 @@
 #include "bridge/engine/TelephoneEventForwardReceiveJob.h"
 #include "codec/AudioTools.h"
 #include "codec/Opus.h"
+#include "concurrency/ThreadUtils.h"
 #include "config/Config.h"
+#include "jobmanager/JobManager.h"
+#include <functional>
+#include <thread>
 
 namespace
 {
@@ -62,6 +66,79 @@ bool isContributingToMix(const bridge::SsrcInboundContext* inboundAudioContext)
         inboundAudioContext->audioReceivePipe->getAudioSampleCount() > 0;
 }
 
+const uint32_t maxMixHelperJobs = 7;
+const uint32_t maxCompletionSpins = 1000;
+
+/**
+ * Batches of work shared by the engine thread and helper jobs. Each batch is claimed once. A helper job that
+ * starts after all batches are claimed returns without touching the work, so the engine only waits for batches
+ * in progress and never for jobs that are still queued.
+ */
+class ParallelBatches
+{
+public:
+    ParallelBatches(uint32_t batchCount, std::function<void(uint32_t)>&& work)
+        : _nextBatch(0),
+          _completedBatches(0),
+          _batchCount(batchCount),
+          _work(std::move(work))
+    {
+    }
+
+    void run()
+    {
+        for (auto batch = _nextBatch.fetch_add(1); batch < _batchCount; batch = _nextBatch.fetch_add(1))
+        {
+            _work(batch);
+            _completedBatches.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    bool isComplete() const { return _completedBatches.load(std::memory_order_acquire) >= _batchCount; }
+
+private:
+    std::atomic_uint32_t _nextBatch;
+    std::atomic_uint32_t _completedBatches;
+    const uint32_t _batchCount;
+    const std::function<void(uint32_t)> _work;
+};
+
+void runParallelBatches(jobmanager::JobManager& jobManager,
+    const uint32_t batchCount,
+    std::function<void(uint32_t)>&& work)
+{
+    if (batchCount == 0)
+    {
+        return;
+    }
+
+    auto batches = std::make_shared<ParallelBatches>(batchCount, std::move(work));
+    const auto helperJobs = std::min(batchCount - 1, maxMixHelperJobs);
+    for (uint32_t i = 0; i < helperJobs; ++i)
+    {
+        if (!jobManager.post([batches]() { batches->run(); }))
+        {
+            break;
+        }
+    }
+
+    batches->run();
+
+    // Only batches already claimed by helpers remain. Each is a handful of fetches or recipients, so a short spin
+    // normally covers it. A helper preempted in the middle of a batch is awaited by yielding the core instead.
+    for (uint32_t spins = 0; !batches->isComplete(); ++spins)
+    {
+        if (spins < maxCompletionSpins)
+        {
+            concurrency::cpuRelax();
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
 } // namespace
 
 namespace bridge
@@ -81,7 +158,10 @@ void EngineMixer::addAudioStream(EngineAudioStream* engineAudioStream)
         endpointIdHash,
         engineAudioStream->isMixed() ? 't' : 'f');
 
-    _engineAudioStreams.emplace(endpointIdHash, engineAudioStream);
+    if (_engineAudioStreams.emplace(endpointIdHash, engineAudioStream).second)
+    {
+        addIngressRings(engineAudioStream->transport);
+    }
     if (engineAudioStream->isMixed())
     {
         _numMixedAudioStreams++;
@@ -176,7 +256,10 @@ void EngineMixer::removeStream(const EngineAudioStream* engineAudioStream)
         sendAudioStreamToRecording(*engineAudioStream, false);
     }
 
-    _engineAudioStreams.erase(endpointIdHash);
+    if (_engineAudioStreams.erase(endpointIdHash))
+    {
+        releaseIngressRings(engineAudioStream->transport);
+    }
 
     engineAudioStream->transport.postOnQueue(
         [this, engineAudioStream]() { _messageListener.asyncAudioStreamRemoved(*this, *engineAudioStream); });
@@ -257,6 +340,7 @@ void EngineMixer::onAudioRtpPacketReceived(SsrcInboundContext& ssrcContext,
             ssrcContext,
             *_activeMediaList,
             _config.audio.silenceThresholdLevel,
+            _config.audio.levelDecodeInterval,
             _numMixedAudioStreams != 0,
             !_engineBarbells.empty() || _engineAudioStreams.size() > 2,
             extendedSequenceNumber);
@@ -284,7 +368,9 @@ void EngineMixer::onForwarderAudioRtpPacketDecrypted(SsrcInboundContext& inbound
     const uint32_t extendedSequenceNumber)
 {
     assert(packet);
-    if (!_incomingForwarderAudioRtp.push(
+    if (!pushIncoming(&IngressRings::audio,
+            inboundContext.sender,
+            _incomingForwarderAudioRtp,
             IncomingPacketInfo(std::move(packet), &inboundContext, extendedSequenceNumber)))
     {
         logger::error("Failed to push incoming forwarder audio packet onto queue", getLoggableId().c_str());
@@ -389,8 +475,13 @@ void EngineMixer::processAudioStreams()
         return;
     }
 
-    const auto payloadBytesPerPacket =
-        samplesPerFrame20ms * codec::Opus::channelsPerFrame * codec::Opus::bytesPerSample;
+    const auto payloadBytesPerPacket = _mixSamplesPerFrame * _mixChannels * bytesPerSample;
+
+    if (_config.audio.parallelMixThreshold > 0 && _numMixedAudioStreams >= _config.audio.parallelMixThreshold)
+    {
+        processAudioStreamsParallel(payloadBytesPerPacket);
+        return;
+    }
 
     std::memset(_mixedData, 0, payloadBytesPerPacket);
 
@@ -399,12 +490,12 @@ void EngineMixer::processAudioStreams()
         if (ssrcContext.second->rtpMap.isAudio() && ssrcContext.second->hasAudioReceivePipe.load())
         {
             auto& rcvPipe = *ssrcContext.second->audioReceivePipe;
-            const auto readySamples = rcvPipe.fetchStereo(samplesPerFrame20ms);
+            const auto readySamples = rcvPipe.fetch(_mixSamplesPerFrame);
             if (readySamples > 0)
             {
                 codec::addToMix(rcvPipe.getAudio(),
                     _mixedData,
-                    readySamples * codec::Opus::channelsPerFrame,
+                    readySamples * _mixChannels,
                     mixSampleScaleFactor);
             }
         }
@@ -419,48 +510,76 @@ void EngineMixer::processAudioStreams()
             continue;
         }
 
-        auto audioPacket = memory::makeUniquePacket(_audioAllocator);
-        if (!audioPacket)
+        auto* ssrcContext = obtainOutboundSsrcContext(audioStream->endpointIdHash,
+            audioStream->ssrcOutboundContexts,
+            audioStream->localSsrc,
+            audioStream->rtpMap,
+            audioStream->telephoneEventRtpMap);
+
+        if (ssrcContext && !sendMixedAudio(*audioStream, *ssrcContext, payloadBytesPerPacket))
         {
             return;
         }
+    }
+}
 
-        auto rtpHeader = rtp::RtpHeader::create(*audioPacket);
-        rtpHeader->ssrc = audioStream->localSsrc;
-
-        auto payloadStart = reinterpret_cast<int16_t*>(rtpHeader->getPayload());
-        const auto headerLength = rtpHeader->headerLength();
-        audioPacket->setLength(headerLength + payloadBytesPerPacket);
-        std::memcpy(payloadStart, _mixedData, payloadBytesPerPacket);
-
-        SsrcInboundContext* inboundAudioContext =
-            (audioStream->remoteSsrc.isSet() ? _ssrcInboundContexts.getItem(audioStream->remoteSsrc.get()) : nullptr);
+/**
+ * Contributors are split into at most maxPartialMixes groups that are fetched and summed into partial mixes on
+ * worker jobs. The engine adds the partial mixes together and then fans out the per recipient subtraction and
+ * packetization in batches. Outbound contexts are obtained on the engine thread before fan out as that may create
+ * them.
+ */
+void EngineMixer::processAudioStreamsParallel(const size_t payloadBytesPerPacket)
+{
+    const size_t samplesPerMix = _mixSamplesPerFrame * _mixChannels;
 
-        if (!audioStream->neighbours.empty())
+    _mixContributors.clear();
+    for (auto& ssrcContext : _ssrcInboundContexts)
+    {
+        if (ssrcContext.second->rtpMap.isAudio() && ssrcContext.second->hasAudioReceivePipe.load())
         {
-            for (auto& stream : _engineAudioStreams)
+            _mixContributors.push_back(ssrcContext.second);
+        }
+    }
+
+    const size_t batchSize = std::max(1u, _config.audio.parallelMixBatchSize.get());
+    const auto partialMixCount = std::min(maxPartialMixes, (_mixContributors.size() + batchSize - 1) / batchSize);
+    const auto contributorsPerPartial =
+        partialMixCount > 0 ? (_mixContributors.size() + partialMixCount - 1) / partialMixCount : 0;
+
+    std::memset(_partialMixes.data(), 0, partialMixCount * samplesPerMix * sizeof(int16_t));
+    runParallelBatches(_jobManager,
+        partialMixCount,
+        [this, samplesPerMix, contributorsPerPartial](uint32_t partialIndex) {
+            auto* partialMix = &_partialMixes[partialIndex * samplesPerMix];
+            const auto end = std::min(_mixContributors.size(), (partialIndex + 1) * contributorsPerPartial);
+            for (size_t i = partialIndex * contributorsPerPartial; i < end; ++i)
             {
-                auto& peerAudioStream = *stream.second;
-                if (peerAudioStream.remoteSsrc.isSet() &&
-                    areNeighbours(audioStream->neighbours, peerAudioStream.neighbours))
+                auto& rcvPipe = *_mixContributors[i]->audioReceivePipe;
+                const auto readySamples = rcvPipe.fetch(_mixSamplesPerFrame);
+                if (readySamples > 0)
                 {
-                    auto neighbourContext = _ssrcInboundContexts.getItem(peerAudioStream.remoteSsrc.get());
-                    if (isContributingToMix(neighbourContext))
-                    {
-                        codec::subtractFromMix(neighbourContext->audioReceivePipe->getAudio(),
-                            payloadStart,
-                            neighbourContext->audioReceivePipe->getAudioSampleCount() * codec::Opus::channelsPerFrame,
-                            mixSampleScaleFactor);
-                    }
+                    codec::addToMix(rcvPipe.getAudio(),
+                        partialMix,
+                        readySamples * _mixChannels,
+                        mixSampleScaleFactor);
                 }
             }
-        }
-        else if (inboundAudioContext && isContributingToMix(inboundAudioContext))
+        });
+
+    std::memset(_mixedData, 0, payloadBytesPerPacket);
+    for (size_t partialIndex = 0; partialIndex < partialMixCount; ++partialIndex)
+    {
+        codec::addToMix(&_partialMixes[partialIndex * samplesPerMix], _mixedData, samplesPerMix, 1.0);
+    }
+
+    _mixRecipients.clear();
+    for (auto& audioStreamEntry : _engineAudioStreams)
+    {
+        auto audioStream = audioStreamEntry.second;
+        if (!audioStream->isMixed())
         {
-            codec::subtractFromMix(inboundAudioContext->audioReceivePipe->getAudio(),
-                payloadStart,
-                inboundAudioContext->audioReceivePipe->getAudioSampleCount() * codec::Opus::channelsPerFrame,
-                mixSampleScaleFactor);
+            continue;
         }
 
         auto* ssrcContext = obtainOutboundSsrcContext(audioStream->endpointIdHash,
@@ -468,15 +587,82 @@ void EngineMixer::processAudioStreams()
             audioStream->localSsrc,
             audioStream->rtpMap,
             audioStream->telephoneEventRtpMap);
-
         if (ssrcContext)
         {
-            audioStream->transport.getJobQueue().addJob<EncodeJob>(std::move(audioPacket),
-                *ssrcContext,
-                audioStream->transport,
-                _rtpTimestampSource);
+            _mixRecipients.push_back({audioStream, ssrcContext});
         }
     }
+
+    const auto recipientBatchCount = (_mixRecipients.size() + batchSize - 1) / batchSize;
+    runParallelBatches(_jobManager, recipientBatchCount, [this, payloadBytesPerPacket, batchSize](uint32_t batchIndex) {
+        const auto end = std::min(_mixRecipients.size(), (batchIndex + 1) * batchSize);
+        for (size_t i = batchIndex * batchSize; i < end; ++i)
+        {
+            auto& recipient = _mixRecipients[i];
+            if (!sendMixedAudio(*recipient.audioStream, *recipient.outboundContext, payloadBytesPerPacket))
+            {
+                return;
+            }
+        }
+    });
+}
+
+// Copies the mix, removes the recipient's own audio or that of its neighbours and queues it for encoding.
+// Only reads shared mixer state, so it may run on worker threads for different recipients concurrently.
+bool EngineMixer::sendMixedAudio(EngineAudioStream& audioStream,
+    SsrcOutboundContext& outboundContext,
+    const size_t payloadBytesPerPacket)
+{
+    auto audioPacket = memory::makeUniquePacket(_audioAllocator);
+    if (!audioPacket)
+    {
+        return false;
+    }
+
+    auto rtpHeader = rtp::RtpHeader::create(*audioPacket);
+    rtpHeader->ssrc = audioStream.localSsrc;
+
+    auto payloadStart = reinterpret_cast<int16_t*>(rtpHeader->getPayload());
+    const auto headerLength = rtpHeader->headerLength();
+    audioPacket->setLength(headerLength + payloadBytesPerPacket);
+    std::memcpy(payloadStart, _mixedData, payloadBytesPerPacket);
+
+    SsrcInboundContext* inboundAudioContext =
+        (audioStream.remoteSsrc.isSet() ? _ssrcInboundContexts.getItem(audioStream.remoteSsrc.get()) : nullptr);
+
+    if (!audioStream.neighbours.empty())
+    {
+        for (auto& stream : _engineAudioStreams)
+        {
+            auto& peerAudioStream = *stream.second;
+            if (peerAudioStream.remoteSsrc.isSet() && areNeighbours(audioStream.neighbours, peerAudioStream.neighbours))
+            {
+                auto neighbourContext = _ssrcInboundContexts.getItem(peerAudioStream.remoteSsrc.get());
+                if (isContributingToMix(neighbourContext))
+                {
+                    codec::subtractFromMix(neighbourContext->audioReceivePipe->getAudio(),
+                        payloadStart,
+                        neighbourContext->audioReceivePipe->getAudioSampleCount() * _mixChannels,
+                        mixSampleScaleFactor);
+                }
+            }
+        }
+    }
+    else if (inboundAudioContext && isContributingToMix(inboundAudioContext))
+    {
+        codec::subtractFromMix(inboundAudioContext->audioReceivePipe->getAudio(),
+            payloadStart,
+            inboundAudioContext->audioReceivePipe->getAudioSampleCount() * _mixChannels,
+            mixSampleScaleFactor);
+    }
+
+    audioStream.transport.getJobQueue().addJob<EncodeJob>(std::move(audioPacket),
+        outboundContext,
+        audioStream.transport,
+        _rtpTimestampSource,
+        _mixSampleRate,
+        _mixChannels);
+    return true;
 }
 
 void EngineMixer::markAssociatedAudioOutboundContextsForDeletion(const EngineAudioStream* senderAudioStream)
@@ -109,7 +109,10 @@ void EngineMixer::addBarbell(EngineBarbell* barbell)
         barbell->transport.getLoggableId().c_str(),
         idHash);
 
-    _engineBarbells.emplace(idHash, barbell);
+    if (_engineBarbells.emplace(idHash, barbell).second)
+    {
+        addIngressRings(barbell->transport);
+    }
 }
 
 // executed on transport thread context
@@ -161,6 +164,7 @@ void EngineMixer::removeBarbell(size_t idHash)
         }
     }
 
+    releaseIngressRings(barbell->transport);
     barbell->transport.postOnQueue(utils::bind(&EngineMixer::internalRemoveBarbell, this, barbell->idHash));
 }
 
@@ -496,6 +500,10 @@ SsrcInboundContext* EngineMixer::emplaceBarbellInboundSsrcContext(const uint32_t
             logger::error("Failed to create barbell inbound audio context for ssrc %u", _loggableId.c_str(), ssrc);
             return nullptr;
         }
+        if (emplaceResult.second)
+        {
+            addInboundAudioCounters(emplaceResult.first->second);
+        }
         _ssrcInboundContexts.emplace(ssrc, &emplaceResult.first->second);
 
         logger::info("Created new barbell inbound audio context for stream ssrc %u, endpointIdHash %zu, %s",
@@ -838,7 +846,8 @@ void EngineMixer::forwardVideoRtpPacketOverBarbell(IncomingPacketInfo& packetInf
                 _messageListener,
                 barbell.idHash,
                 *this,
-                timestamp);
+                timestamp,
+                EngineStreamDirector::allTemporalLayers);
         }
         else
         {
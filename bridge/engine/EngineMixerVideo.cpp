@@ -8,6 +8,7 @@
 #include "bridge/engine/EngineStreamDirector.h"
 #include "bridge/engine/EngineVideoStream.h"
 #include "bridge/engine/FinalizeNonSsrcRewriteOutboundContextJob.h"
+#include "bridge/engine/InboundPacketCache.h"
 #include "bridge/engine/ProcessMissingVideoPacketsJob.h"
 #include "bridge/engine/RemovePacketCacheJob.h"
 #include "bridge/engine/SendRtcpJob.h"
@@ -67,7 +68,11 @@ void EngineMixer::addVideoStream(EngineVideoStream* engineVideoStream)
     }
     const auto mapRevision = _activeMediaList->getMapRevision();
     const auto it = _engineVideoStreams.emplace(endpointIdHash, engineVideoStream);
-    if (!it.second)
+    if (it.second)
+    {
+        addIngressRings(engineVideoStream->transport);
+    }
+    else
     {
         logger::error("Emplace video stream has failed, transport %s, endpointIdHash %lu",
             _loggableId.c_str(),
@@ -180,7 +185,11 @@ void EngineMixer::removeStream(const EngineVideoStream* engineVideoStream)
         endpointIdHash);
 
     const bool streamFound = _engineVideoStreams.erase(endpointIdHash);
-    if (!streamFound)
+    if (streamFound)
+    {
+        releaseIngressRings(engineVideoStream->transport);
+    }
+    else
     {
         logger::error("engineVideoStream has not been found, transport %s, endpointIdHash %lu",
             _loggableId.c_str(),
@@ -225,6 +234,19 @@ void EngineMixer::addVideoPacketCache(const uint32_t ssrc, const size_t endpoint
     }
 }
 
+void EngineMixer::addInboundPacketCache(const uint32_t ssrc, const std::shared_ptr<InboundPacketCache>& packetCache)
+{
+    auto* inboundContext = _allSsrcInboundContexts.getItem(ssrc);
+    if (!inboundContext || !inboundContext->packetCacheRequested || inboundContext->packetCacheOwner)
+    {
+        return;
+    }
+
+    packetCache->rtpMap = inboundContext->rtpMap;
+    inboundContext->packetCacheOwner = packetCache;
+    inboundContext->packetCache.store(packetCache.get(), std::memory_order_release);
+}
+
 void EngineMixer::reconfigureVideoStream(const transport::RtcTransport& transport,
     const SsrcWhitelist& ssrcWhitelist,
     const SimulcastStream& simulcastStream,
@@ -524,7 +546,15 @@ void EngineMixer::onForwarderVideoRtpPacketDecrypted(SsrcInboundContext& inbound
     const uint32_t extendedSequenceNumber)
 {
     assert(packet);
-    if (!_incomingForwarderVideoRtp.push(
+    auto* packetCache = inboundContext.packetCache.load(std::memory_order_acquire);
+    if (packetCache)
+    {
+        packetCache->add(*packet, extendedSequenceNumber);
+    }
+
+    if (!pushIncoming(&IngressRings::video,
+            inboundContext.sender,
+            _incomingForwarderVideoRtp,
             IncomingPacketInfo(std::move(packet), &inboundContext, extendedSequenceNumber)))
     {
         logger::error("Failed to push incoming forwarder video packet onto queue", getLoggableId().c_str());
@@ -588,6 +618,7 @@ void EngineMixer::forwardVideoRtpPacket(IncomingPacketInfo& packetInfo, const ui
         uint32_t ssrc = 0;
         const bool ssrcRewrite = videoStream->ssrcRewrite;
         SsrcOutboundContext* ssrcOutboundContext = nullptr;
+        auto pacingPriority = transport::PacingPriority::VIDEO;
         if (ssrcRewrite)
         {
             const auto& screenShareSsrcMapping = _activeMediaList->getVideoScreenShareSsrcMapping();
@@ -595,6 +626,7 @@ void EngineMixer::forwardVideoRtpPacket(IncomingPacketInfo& packetInfo, const ui
                 screenShareSsrcMapping.get().second.ssrc == packetInfo.inboundContext()->ssrc)
             {
                 ssrc = screenShareSsrcMapping.get().second.rewriteSsrc;
+                pacingPriority = transport::PacingPriority::SCREENSHARE;
             }
             else if (_engineStreamDirector->getPinTarget(endpointIdHash) == senderEndpointIdHash &&
                 !_activeMediaList->isInUserActiveVideoList(senderEndpointIdHash))
@@ -602,6 +634,7 @@ void EngineMixer::forwardVideoRtpPacket(IncomingPacketInfo& packetInfo, const ui
                 if (videoStream->pinSsrc.isSet())
                 {
                     ssrc = videoStream->pinSsrc.get().ssrc;
+                    pacingPriority = transport::PacingPriority::PINNED;
                 }
                 else
                 {
@@ -618,6 +651,11 @@ void EngineMixer::forwardVideoRtpPacket(IncomingPacketInfo& packetInfo, const ui
                     continue;
                 }
                 ssrc = (*rewriteMap)[0].main;
+                if (_engineStreamDirector->getUnpinnedQualityLevel(endpointIdHash) ==
+                    EngineStreamDirector::lowQuality)
+                {
+                    pacingPriority = transport::PacingPriority::THUMBNAIL;
+                }
             }
 
             ssrcOutboundContext = obtainOutboundSsrcContext(videoStream->endpointIdHash,
@@ -648,6 +686,23 @@ void EngineMixer::forwardVideoRtpPacket(IncomingPacketInfo& packetInfo, const ui
         }
 
         ssrcOutboundContext->onRtpSent(timestamp); // marks that we have active jobs on this ssrc context
+        // only cached when posted, so a full queue makes the next packet retry
+        if (ssrcOutboundContext->pacingPriority != pacingPriority &&
+            videoStream->transport.postOnQueue(utils::bind(&transport::RtcTransport::setPacingPriority,
+                &videoStream->transport,
+                ssrcOutboundContext->ssrc,
+                pacingPriority)))
+        {
+            ssrcOutboundContext->pacingPriority = pacingPriority;
+        }
+
+        if (ssrcOutboundContext->temporalLayerVersion != _engineStreamDirector->getTemporalLayerVersion())
+        {
+            ssrcOutboundContext->maxTemporalLayer = _engineStreamDirector->getMaxTemporalLayer(endpointIdHash,
+                packetInfo.inboundContext()->ssrc);
+            ssrcOutboundContext->temporalLayerVersion = _engineStreamDirector->getTemporalLayerVersion();
+        }
+
         auto packet = memory::makeUniquePacket(_sendAllocator, *packetInfo.packet());
         if (packet)
         {
@@ -659,7 +714,8 @@ void EngineMixer::forwardVideoRtpPacket(IncomingPacketInfo& packetInfo, const ui
                 _messageListener,
                 videoStream->endpointIdHash,
                 *this,
-                timestamp);
+                timestamp,
+                ssrcOutboundContext->maxTemporalLayer);
         }
         else
         {
@@ -926,6 +982,12 @@ bool EngineMixer::asyncAddVideoPacketCache(const uint32_t ssrc,
     return post(utils::bind(&EngineMixer::addVideoPacketCache, this, ssrc, endpointIdHash, videoPacketCache));
 }
 
+bool EngineMixer::asyncAddInboundPacketCache(const uint32_t ssrc,
+    const std::shared_ptr<InboundPacketCache>& packetCache)
+{
+    return post(utils::bind(&EngineMixer::addInboundPacketCache, this, ssrc, packetCache));
+}
+
 bool EngineMixer::asyncAddVideoStream(EngineVideoStream* engineVideoStream)
 {
     return post(utils::bind(&EngineMixer::addVideoStream, this, engineVideoStream));
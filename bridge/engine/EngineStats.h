@@ -32,6 +32,8 @@ struct MixerStats
 
     uint32_t pacingQueue = 0;
     uint32_t rtxPacingQueue = 0;
+    uint32_t ingressQueueDepth = 0; // max packets waiting for the engine
+    uint64_t ingressDrainLatencyUs = 0; // max time from network receive to engine processing
 
     double opusDecodePacketsPerSecond = 0;
     uint32_t audioLevelExtensionStreamCount = 0;
@@ -52,6 +54,8 @@ struct MixerStats
 
         pacingQueue += b.pacingQueue;
         rtxPacingQueue += b.rtxPacingQueue;
+        ingressQueueDepth = std::max(ingressQueueDepth, b.ingressQueueDepth);
+        ingressDrainLatencyUs = std::max(ingressDrainLatencyUs, b.ingressDrainLatencyUs);
         opusDecodePacketsPerSecond += b.opusDecodePacketsPerSecond;
         audioLevelExtensionStreamCount += b.audioLevelExtensionStreamCount;
 
@@ -67,7 +71,7 @@ struct EngineStats
 
     uint32_t pollPeriodMs = 1;
 
-    MixerStats activeMixers;
+    MixerStats activeMixers; // aggregated by MixerManager off the engine thread
 };
 
 } // namespace EngineStats
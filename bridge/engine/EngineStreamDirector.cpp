@@ -53,3 +53,7 @@ constexpr EngineStreamDirector::ConfigRow EngineStreamDirector::configLadder[6]
         calculateMaxBitrate(LOW_QUALITY_BITRATE, LOW_QUALITY_BITRATE)}, // 1440
     {LOW_QUALITY_BITRATE, lowQuality, dropQuality, 0, LOW_QUALITY_BITRATE, LOW_QUALITY_BITRATE},
     {0, dropQuality, dropQuality, 0, 0, 0}};
+
+// 3 temporal layers {40%, 20%, 40%}
+constexpr const uint32_t EngineStreamDirector::temporalLayerBitratePercent[EngineStreamDirector::maxTemporalLayers] =
+    {40, 60, 100};
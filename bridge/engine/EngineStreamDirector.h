@@ -35,6 +35,10 @@ public:
         dropQuality = 3
     };
 
+    /** VP8 temporal layers assumed in the sender streams. TL0 is the base layer. */
+    static constexpr uint8_t maxTemporalLayers = 3;
+    static constexpr uint8_t allTemporalLayers = maxTemporalLayers - 1;
+
     struct ParticipantStreams
     {
         ParticipantStreams(const SimulcastStream& primary,
@@ -46,7 +50,8 @@ public:
               unpinQualityLevel(lowQuality),
               lowEstimateTimestamp(lowQuality),
               defaultLevelBandwidthLimit(maxDefaultLevelBandwidthKbps),
-              estimatedUplinkBandwidth(0)
+              estimatedUplinkBandwidth(0),
+              maxTemporalLayer(allTemporalLayers)
         {
         }
         SimulcastStream primary;
@@ -58,6 +63,8 @@ public:
         uint32_t defaultLevelBandwidthLimit;
         /** Max of incoming estimate and defaultLevelBandwidthLimit */
         uint32_t estimatedUplinkBandwidth;
+        /** Highest VP8 temporal layer forwarded to this participant */
+        uint8_t maxTemporalLayer;
     };
 
     EngineStreamDirector(size_t logInstanceId, const config::Config& config, uint32_t lastN)
@@ -72,7 +79,9 @@ public:
           _maxDefaultLevelBandwidthKbps(config.maxDefaultLevelBandwidthKbps),
           _lastN(lastN),
           _slidesBitrateKbps(0),
-          _slidesSsrc(0)
+          _slidesSsrc(0),
+          _temporalLayerThinning(config.temporalLayerThinning),
+          _temporalLayerVersion(1)
     {
     }
 
@@ -88,7 +97,9 @@ public:
           _maxDefaultLevelBandwidthKbps(0),
           _lastN(0),
           _slidesBitrateKbps(0),
-          _slidesSsrc(0)
+          _slidesSsrc(0),
+          _temporalLayerThinning(false),
+          _temporalLayerVersion(1)
     {
     }
 
@@ -291,6 +302,18 @@ public:
         return pinMapItr->second;
     }
 
+    /** Quality level that unpinned video is forwarded at to this endpoint. */
+    QualityLevel getUnpinnedQualityLevel(const size_t endpointIdHash)
+    {
+        const auto viewer = _participantStreams.getItem(endpointIdHash);
+        if (!viewer)
+        {
+            return dropQuality;
+        }
+
+        return viewer->unpinQualityLevel;
+    }
+
     void updateBandwidthFloor(const uint32_t lastN, const uint32_t audioStreams, const uint32_t videoStreams)
     {
         if (_participantStreams.capacity())
@@ -323,9 +346,21 @@ public:
             std::max(uplinkEstimateKbps, participantStream.defaultLevelBandwidthLimit);
 
         QualityLevel desiredPinQuality, unpinnedQuality;
-        getVideoQualityLimits(endpointIdHash, participantStream, desiredPinQuality, unpinnedQuality);
+        uint8_t maxTemporalLayer = allTemporalLayers;
+        getVideoQualityLimits(endpointIdHash, participantStream, desiredPinQuality, unpinnedQuality, maxTemporalLayer);
 
         participantStream.unpinQualityLevel = unpinnedQuality;
+        if (maxTemporalLayer != participantStream.maxTemporalLayer)
+        {
+            logger::info("setUplinkEstimateKbps %u, endpointIdHash %zu, temporal layers %u -> %u",
+                _loggableId.c_str(),
+                uplinkEstimateKbps,
+                endpointIdHash,
+                participantStream.maxTemporalLayer,
+                maxTemporalLayer);
+            participantStream.maxTemporalLayer = maxTemporalLayer;
+            ++_temporalLayerVersion;
+        }
 
         if (desiredPinQuality == participantStream.pinQualityLevel)
         {
@@ -376,6 +411,23 @@ public:
         return false;
     }
 
+    /**
+     * @return highest VP8 temporal layer of ssrc to forward to the participant. Packets of higher layers are thinned
+     * out by the outbound ssrc context. Slides are never thinned.
+     */
+    inline uint8_t getMaxTemporalLayer(const size_t toEndpointIdHash, const uint32_t ssrc)
+    {
+        const auto viewer = _participantStreams.getItem(toEndpointIdHash);
+        if (!viewer || ssrc == _slidesSsrc)
+        {
+            return allTemporalLayers;
+        }
+        return viewer->maxTemporalLayer;
+    }
+
+    /** Changes whenever the result of getMaxTemporalLayer may have changed. Lets callers cache the result. */
+    uint32_t getTemporalLayerVersion() const { return _temporalLayerVersion; }
+
     inline QualityLevel getQualityLevel(const uint32_t ssrc)
     {
         return (_lowQualitySsrcs.contains(ssrc)   ? lowQuality
@@ -703,6 +755,10 @@ public:
 
     void setSlidesSsrcAndBitrate(size_t slidesSsrc, uint32_t bwKbps)
     {
+        if (slidesSsrc != _slidesSsrc)
+        {
+            ++_temporalLayerVersion;
+        }
         _slidesSsrc = slidesSsrc;
         _slidesBitrateKbps = bwKbps;
     }
@@ -758,6 +814,17 @@ private:
     /** SSRC for slides. */
     size_t _slidesSsrc;
 
+    /** Allow a higher config at reduced temporal layers when the full config does not fit the estimate. */
+    const bool _temporalLayerThinning;
+    uint32_t _temporalLayerVersion;
+
+    /** Cumulative share of the stream bitrate carried by temporal layers 0..n, in percent. From libwebrtc defaults. */
+    static const uint32_t temporalLayerBitratePercent[maxTemporalLayers];
+    /** Lowest temporal layer we thin down to. Below this the frame rate is not worth the resolution gain. */
+    static constexpr uint8_t minThinnedTemporalLayer = 1;
+    /** Extra headroom needed to start thinning, to not flip between configs on a fluctuating estimate. */
+    static constexpr uint32_t thinningHysteresisPercent = 15;
+
     inline QualityLevel highestActiveQuality(const size_t endpointIdHash, const uint32_t ssrc)
     {
         const auto participantStreamsItr = _participantStreams.find(endpointIdHash);
@@ -994,10 +1061,12 @@ private:
     inline void getVideoQualityLimits(const size_t endpointIdHash,
         const ParticipantStreams& participantStreams,
         QualityLevel& outPinnedQuality,
-        QualityLevel& outUnpinnedQuality) const
+        QualityLevel& outUnpinnedQuality,
+        uint8_t& outMaxTemporalLayer) const
     {
         outPinnedQuality = dropQuality;
         outUnpinnedQuality = dropQuality;
+        outMaxTemporalLayer = allTemporalLayers;
 
         // We need to divide available bitrate (minus bitrate for slides, if present) to "maxReceivingVideoStreams".
         // "maxReceivingVideoStreams" can be 0, if we are the only one sending video, or the very first one in that case
@@ -1042,14 +1111,41 @@ private:
             configId++;
         }
         assert(configId == 6);
+
+        if (_temporalLayerThinning)
+        {
+            // A better config may fit if the video it carries is thinned to fewer temporal layers. Once thinning,
+            // keep at it until the thinned cost no longer fits.
+            const auto hysteresisPercent =
+                participantStreams.maxTemporalLayer < allTemporalLayers ? 0 : thinningHysteresisPercent;
+            configId = 0;
+            for (const auto& config : configLadder)
+            {
+                const auto videoCost = config.baseRate + maxReceivingVideoStreams * config.overheadBitrate;
+                const auto thinnedCost = videoCost * temporalLayerBitratePercent[minThinnedTemporalLayer] *
+                        (100 + hysteresisPercent) / (100 * 100) +
+                    allocationBitrateKbpsForSlides;
+
+                if (videoCost + allocationBitrateKbpsForSlides > bestConfigCost &&
+                    thinnedCost <= estimatedUplinkBandwidth)
+                {
+                    bestConfigId = configId;
+                    outMaxTemporalLayer = minThinnedTemporalLayer;
+                    break;
+                }
+                configId++;
+            }
+        }
+
         outPinnedQuality = configLadder[bestConfigId].pinnedQuality;
         outUnpinnedQuality = configLadder[bestConfigId].unpinnedQuality;
 
-        DIRECTOR_LOG("VQ pinned: %c, unpinned %c, max streams %ld, estimated uplink %d, reserve for slides: %d "
-                     "(endpoint %zu)",
+        DIRECTOR_LOG("VQ pinned: %c, unpinned %c, temporal layers %u, max streams %ld, estimated uplink %d, reserve "
+                     "for slides: %d (endpoint %zu)",
             _loggableId.c_str(),
             (char)outPinnedQuality + '0',
             (char)outUnpinnedQuality + '0',
+            outMaxTemporalLayer,
             maxReceivingVideoStreams,
             estimatedUplinkBandwidth,
             _slidesBitrateKbps,
@@ -0,0 +1,44 @@
+#include "bridge/engine/InboundPacketCache.h"
+#include "concurrency/ScopedSpinLocker.h"
+
+namespace bridge
+{
+
+InboundPacketCache::InboundPacketCache(const char* loggableId,
+    const uint32_t ssrc,
+    memory::PacketPoolAllocator& allocator)
+    : ssrc(ssrc),
+      _loggableId(loggableId),
+      _allocator(allocator),
+      _slots(new Slot[maxPackets])
+{
+    logger::info("Creating inbound cache for ssrc %u", _loggableId.c_str(), ssrc);
+}
+
+void InboundPacketCache::add(const memory::Packet& packet, const uint32_t extendedSequenceNumber)
+{
+    // the replaced packet is released after the slot is unlocked
+    auto cachedPacket = memory::makeUniquePacket(_allocator, packet);
+    auto& slot = _slots[extendedSequenceNumber % maxPackets];
+    {
+        concurrency::ScopedSpinLocker locker(slot.lock);
+        std::swap(slot.packet, cachedPacket);
+        slot.extendedSequenceNumber = extendedSequenceNumber;
+    }
+}
+
+bool InboundPacketCache::get(const uint32_t extendedSequenceNumber, memory::Packet& target) const
+{
+    const auto& slot = _slots[extendedSequenceNumber % maxPackets];
+    concurrency::ScopedSpinLocker locker(slot.lock);
+    if (!slot.packet || slot.extendedSequenceNumber != extendedSequenceNumber)
+    {
+        return false;
+    }
+
+    std::memcpy(target.get(), slot.packet->get(), slot.packet->getLength());
+    target.setLength(slot.packet->getLength());
+    return true;
+}
+
+} // namespace bridge
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "bridge/RtpMap.h"
+#include "logger/Logger.h"
+#include "memory/PacketPoolAllocator.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace bridge
+{
+
+/**
+ * Keeps the latest inbound video packets of one ssrc, as received from the sender, so that retransmissions to all
+ * recipients can be served from a single copy. Packets are added on the sender's transport context and read from the
+ * recipients' transport contexts. Each slot is guarded by a spin lock, as contention is rare and copies are short.
+ * Cached packets are taken from the given pool, so they are bounded and accounted with the other packets. A packet
+ * that cannot be allocated is not cached, and a NACK for it is not served.
+ * The slots are allocated by MixerManager, off the engine thread, and the engine publishes the cache when complete.
+ */
+class InboundPacketCache : public std::enable_shared_from_this<InboundPacketCache>
+{
+public:
+    InboundPacketCache(const char* loggableId, const uint32_t ssrc, memory::PacketPoolAllocator& allocator);
+
+    void add(const memory::Packet& packet, const uint32_t extendedSequenceNumber);
+
+    /** Copies the cached packet into target. @return false if the packet is no longer in the cache. */
+    bool get(const uint32_t extendedSequenceNumber, memory::Packet& target) const;
+
+    constexpr static size_t maxPackets = 512;
+
+    const uint32_t ssrc;
+    bridge::RtpMap rtpMap; // set by engine before the cache is published
+
+private:
+    struct Slot
+    {
+        mutable std::atomic_flag lock = ATOMIC_FLAG_INIT;
+        uint32_t extendedSequenceNumber = 0;
+        memory::UniquePacket packet;
+    };
+
+    logger::LoggableId _loggableId;
+    memory::PacketPoolAllocator& _allocator;
+    std::unique_ptr<Slot[]> _slots;
+};
+
+} // namespace bridge
@@ -59,7 +59,7 @@ void RecordingAudioForwarderSendJob::run()
         return;
     }
 
-    if (!_outboundContext.rewriteAudio(*rtpHeader,
+    if (!_outboundContext.rewriteAudio(*_packet,
             _ssrcSenderInboundContext,
             _extendedSequenceNumber,
             _timestamp,
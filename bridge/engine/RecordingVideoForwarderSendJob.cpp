@@ -107,7 +107,7 @@ void RecordingVideoForwarderSendJob::run()
     }
 
     uint32_t rewrittenExtendedSequenceNumber = 0;
-    if (!_outboundContext.rewriteVideo(*rtpHeader,
+    if (!_outboundContext.rewriteVideo(*_packet,
             _senderInboundContext,
             _extendedSequenceNumber,
             _transport.getLoggableId().c_str(),
@@ -25,6 +25,7 @@ namespace bridge
 {
 
 struct RtpMap;
+class InboundPacketCache;
 
 /**
  * Maintains state and media graph for an inbound SSRC media stream
@@ -49,6 +50,8 @@ class SsrcInboundContext
           hasDecryptedPackets(false),
           lastUnprotectedExtendedSequenceNumber(0),
           rocOffset(0),
+          audioLevelPacketCount(0),
+          calculatedAudioLevel(-1),
           activeMedia(false),
           inactiveTransitionCount(0),
           isSsrcUsed(true),
@@ -56,6 +59,8 @@ class SsrcInboundContext
           shouldDropPackets(false),
           hasAudioLevelExtension(true),
           opusDecodePacketRate(0),
+          packetCacheRequested(false),
+          packetCache(nullptr),
           hasAudioReceivePipe(false),
           _lastRtpReceiveTime(timestamp)
     {
@@ -116,6 +121,8 @@ public:
     std::shared_ptr<VideoMissingPacketsTracker> videoMissingPacketsTracker;
     std::unique_ptr<codec::OpusDecoder> opusDecoder; // used for missing audio level
     std::unique_ptr<utils::AvgRateTracker> opusPacketRate; // pkt/s
+    uint32_t audioLevelPacketCount;
+    int calculatedAudioLevel; // latest level decoded for missing audio level
 
     // engine variables ==============================================
     bool activeMedia;
@@ -130,10 +137,17 @@ public:
     std::atomic_bool shouldDropPackets;
     std::atomic_bool hasAudioLevelExtension;
     std::atomic<double> opusDecodePacketRate;
+    // Requested on creation and allocated by MixerManager. Published by engine when complete, filled on transport
+    // thread and read by recipient transports on NACK
+    std::atomic_bool packetCacheRequested;
+    std::atomic<InboundPacketCache*> packetCache;
 
     std::unique_ptr<codec::AudioReceivePipeline> audioReceivePipe;
     std::atomic_bool hasAudioReceivePipe;
 
+    // engine thread only. Outbound contexts share the cache while they retransmit from it
+    std::shared_ptr<InboundPacketCache> packetCacheOwner;
+
 private:
     std::atomic_uint64_t _lastRtpReceiveTime;
 };
@@ -1,4 +1,5 @@
 #include "bridge/engine/SsrcOutboundContext.h"
+#include "bridge/engine/InboundPacketCache.h"
 #include "bridge/engine/SsrcInboundContext.h"
 #include "codec/Opus.h"
 #include "codec/Vp8.h"
@@ -39,60 +40,71 @@ constexpr uint16_t extractRolloverCounter(const uint32_t extendedSequenceNumber)
 
 } // namespace
 
-void SsrcOutboundContext::doRtpHeaderExtensionRewriteForAudio(rtp::RtpHeader& rtpHeader,
-    const bridge::SsrcInboundContext& senderInboundContext)
+namespace
 {
-    const bool needToRewriteLevelExtension = senderInboundContext.rtpMap.audioLevelExtId.isSet() &&
-        (!rtpMap.audioLevelExtId.isSet() ||
-            senderInboundContext.rtpMap.audioLevelExtId.get() != rtpMap.audioLevelExtId.get());
-
-    const bool needToRewriteAbsSendTimeExtension = senderInboundContext.rtpMap.absSendTimeExtId.isSet() &&
-        (!rtpMap.absSendTimeExtId.isSet() ||
-            senderInboundContext.rtpMap.absSendTimeExtId.get() != rtpMap.absSendTimeExtId.get());
+uint8_t getExtensionId(const utils::Optional<uint8_t>& extensionId)
+{
+    return extensionId.isSet() && extensionId.get() < rtp::ExtHeaderIdentifiers::EOL ? extensionId.get() : 0;
+}
+} // namespace
 
-    if (!(needToRewriteLevelExtension || needToRewriteAbsSendTimeExtension))
+/**
+ * Maps the sender's extension ids to ours. Audio level, abs-send-time and transport-cc are renumbered, or padded out
+ * if we did not negotiate them. For video abs-send-time is kept as is if we did not negotiate it. Other extensions
+ * are forwarded unchanged.
+ */
+void SsrcOutboundContext::updateHeaderTemplate(const bridge::RtpMap& senderRtpMap, const bool isAudio)
+{
+    const auto senderAudioLevelId = isAudio ? getExtensionId(senderRtpMap.audioLevelExtId) : 0;
+    const auto senderAbsSendTimeId = getExtensionId(senderRtpMap.absSendTimeExtId);
+    const auto senderTransportCcId = getExtensionId(senderRtpMap.transportCcExtId);
+    if (_headerTemplate.isSet && _headerTemplate.isAudio == isAudio &&
+        _headerTemplate.senderAudioLevelId == senderAudioLevelId &&
+        _headerTemplate.senderAbsSendTimeId == senderAbsSendTimeId &&
+        _headerTemplate.senderTransportCcId == senderTransportCcId)
     {
         return;
     }
 
-    const auto headerExtensions = rtpHeader.getExtensionHeader();
-    if (!headerExtensions)
+    _headerTemplate.isSet = true;
+    _headerTemplate.isAudio = isAudio;
+    _headerTemplate.senderAudioLevelId = senderAudioLevelId;
+    _headerTemplate.senderAbsSendTimeId = senderAbsSendTimeId;
+    _headerTemplate.senderTransportCcId = senderTransportCcId;
+    _headerTemplate.absSendTimeId = getExtensionId(rtpMap.absSendTimeExtId);
+    _headerTemplate.transportCcId = getExtensionId(rtpMap.transportCcExtId);
+
+    for (uint8_t id = 0; id < sizeof(_headerTemplate.extensionIds); ++id)
     {
-        return;
+        _headerTemplate.extensionIds[id] = id;
     }
 
-    for (auto& rtpHeaderExtension : headerExtensions->extensions())
+    // in reverse order of precedence if the sender uses the same id twice
+    if (senderTransportCcId)
     {
-        if (needToRewriteLevelExtension &&
-            rtpHeaderExtension.getId() == senderInboundContext.rtpMap.audioLevelExtId.get())
-        {
-            if (rtpMap.audioLevelExtId.isSet())
-            {
-                rtpHeaderExtension.setId(rtpMap.audioLevelExtId.get());
-            }
-            else
-            {
-                rtpHeaderExtension.fillWithPadding();
-            }
-        }
-        else if (needToRewriteAbsSendTimeExtension &&
-            rtpHeaderExtension.getId() == senderInboundContext.rtpMap.absSendTimeExtId.get())
-        {
-            if (rtpMap.absSendTimeExtId.isSet())
-            {
-                rtpHeaderExtension.setId(rtpMap.absSendTimeExtId.get());
-            }
-            else
-            {
-                rtpHeaderExtension.fillWithPadding();
-            }
-        }
+        _headerTemplate.extensionIds[senderTransportCcId] = _headerTemplate.transportCcId;
+    }
+    if (senderAbsSendTimeId && (isAudio || _headerTemplate.absSendTimeId))
+    {
+        _headerTemplate.extensionIds[senderAbsSendTimeId] = _headerTemplate.absSendTimeId;
+    }
+    if (senderAudioLevelId)
+    {
+        _headerTemplate.extensionIds[senderAudioLevelId] = getExtensionId(rtpMap.audioLevelExtId);
     }
 }
 
-void SsrcOutboundContext::doRtpHeaderExtensionRewriteForVideo(rtp::RtpHeader& rtpHeader,
-    const bridge::SsrcInboundContext& senderInboundContext)
+/**
+ * Renumbers the header extensions in one pass and locates abs-send-time and transport-cc for the transport to stamp
+ * at fixed offsets when the packet is sent.
+ */
+void SsrcOutboundContext::doRtpHeaderExtensionRewrite(memory::Packet& packet,
+    rtp::RtpHeader& rtpHeader,
+    const bridge::RtpMap& senderRtpMap,
+    const bool isAudio)
 {
+    packet.absSendTimeOffset = 0;
+    packet.transportSequenceNumberOffset = 0;
 
     const auto headerExtensions = rtpHeader.getExtensionHeader();
     if (!headerExtensions)
@@ -100,25 +112,41 @@ void SsrcOutboundContext::doRtpHeaderExtensionRewriteForVideo(rtp::RtpHeader& rt
         return;
     }
 
-    const bool senderHasAbsSendTimeEx = senderInboundContext.rtpMap.absSendTimeExtId.isSet();
-    const bool receiverHasAbsSendTimeEx = rtpMap.absSendTimeExtId.isSet();
-    const bool absSendTimeExNeedToBeRewritten = senderHasAbsSendTimeEx && receiverHasAbsSendTimeEx &&
-        senderInboundContext.rtpMap.absSendTimeExtId.get() != rtpMap.absSendTimeExtId.get();
-
-    if (absSendTimeExNeedToBeRewritten)
+    updateHeaderTemplate(senderRtpMap, isAudio);
+    for (auto& rtpHeaderExtension : headerExtensions->extensions())
     {
-        for (auto& rtpHeaderExtension : headerExtensions->extensions())
+        const auto senderId = rtpHeaderExtension.getId();
+        if (senderId == rtp::ExtHeaderIdentifiers::PADDING)
+        {
+            continue;
+        }
+        if (senderId == rtp::ExtHeaderIdentifiers::EOL)
+        {
+            break;
+        }
+
+        const auto id = _headerTemplate.extensionIds[senderId];
+        if (id == rtp::ExtHeaderIdentifiers::PADDING)
+        {
+            rtpHeaderExtension.fillWithPadding();
+            continue;
+        }
+
+        rtpHeaderExtension.setId(id);
+        const auto dataOffset = static_cast<uint16_t>(rtpHeaderExtension.data - packet.get());
+        if (id == _headerTemplate.absSendTimeId && rtpHeaderExtension.getDataLength() == 3)
         {
-            if (rtpHeaderExtension.getId() == senderInboundContext.rtpMap.absSendTimeExtId.get())
-            {
-                rtpHeaderExtension.setId(rtpMap.absSendTimeExtId.get());
-                return;
-            }
+            packet.absSendTimeOffset = dataOffset;
+        }
+        else if (id == _headerTemplate.transportCcId && rtpHeaderExtension.getDataLength() == 2)
+        {
+            packet.transportSequenceNumberOffset = dataOffset;
         }
     }
 }
 
-void SsrcOutboundContext::doRtpHeaderRewriteForAudio(rtp::RtpHeader& header,
+void SsrcOutboundContext::doRtpHeaderRewriteForAudio(memory::Packet& packet,
+    rtp::RtpHeader& header,
     const bridge::SsrcInboundContext& senderInboundContext,
     const uint32_t newSequenceNumber,
     const bool isTelephoneEvent)
@@ -129,10 +157,11 @@ void SsrcOutboundContext::doRtpHeaderRewriteForAudio(rtp::RtpHeader& header,
     header.ssrc = this->ssrc;
     header.timestamp = _rewrite.offset.timestamp + header.timestamp;
     header.payloadType = isTelephoneEvent ? telephoneEventRtpMap.payloadType : rtpMap.payloadType;
-    doRtpHeaderExtensionRewriteForAudio(header, senderInboundContext);
+    doRtpHeaderExtensionRewrite(packet, header, senderInboundContext.rtpMap, true);
 }
 
-void SsrcOutboundContext::doRtpHeaderRewriteForVideo(rtp::RtpHeader& header,
+void SsrcOutboundContext::doRtpHeaderRewriteForVideo(memory::Packet& packet,
+    rtp::RtpHeader& header,
     const bridge::SsrcInboundContext& senderInboundContext,
     const uint32_t newSequenceNumber)
 {
@@ -140,7 +169,7 @@ void SsrcOutboundContext::doRtpHeaderRewriteForVideo(rtp::RtpHeader& header,
     header.ssrc = this->ssrc;
     header.timestamp = _rewrite.offset.timestamp + header.timestamp;
     header.payloadType = rtpMap.payloadType;
-    doRtpHeaderExtensionRewriteForVideo(header, senderInboundContext);
+    doRtpHeaderExtensionRewrite(packet, header, senderInboundContext.rtpMap, false);
 }
 
 bool SsrcOutboundContext::isPacketTooOld(uint32_t sequenceNumber, int32_t rewindLimit) const
@@ -185,12 +214,18 @@ void SsrcOutboundContext::dropTelephoneEvent(const uint32_t sequenceNumber, cons
     }
 }
 
-bool SsrcOutboundContext::rewriteAudio(rtp::RtpHeader& header,
+bool SsrcOutboundContext::rewriteAudio(memory::Packet& packet,
     const bridge::SsrcInboundContext& senderInboundContext,
     const uint32_t sequenceNumber,
     const uint64_t timestamp,
     const bool isTelephoneEvent)
 {
+    auto* rtpHeader = rtp::RtpHeader::fromPacket(packet);
+    if (!rtpHeader)
+    {
+        return false;
+    }
+    auto& header = *rtpHeader;
     const uint32_t currentSsrc = header.ssrc;
 
     if (isTelephoneEvent && telephoneEventRtpMap.isEmpty())
@@ -239,7 +274,7 @@ bool SsrcOutboundContext::rewriteAudio(rtp::RtpHeader& header,
 
     if (static_cast<int32_t>(newSequenceNumber - _rewrite.lastSent.sequenceNumber) > 0)
     {
-        doRtpHeaderRewriteForAudio(header, senderInboundContext, newSequenceNumber, isTelephoneEvent);
+        doRtpHeaderRewriteForAudio(packet, header, senderInboundContext, newSequenceNumber, isTelephoneEvent);
         _rewrite.lastSent.sequenceNumber = newSequenceNumber;
         _rewrite.lastSent.timestamp = header.timestamp;
         _rewrite.lastSent.wallClock = timestamp;
@@ -265,7 +300,7 @@ bool SsrcOutboundContext::rewriteAudio(rtp::RtpHeader& header,
         if (canBeCalculated && projectedAdvance > 0 && projectedAdvance < 60)
         {
             const uint32_t correctedSeq = (_rewrite.lastSent.sequenceNumber + projectedAdvance);
-            doRtpHeaderRewriteForAudio(header, senderInboundContext, correctedSeq, isTelephoneEvent);
+            doRtpHeaderRewriteForAudio(packet, header, senderInboundContext, correctedSeq, isTelephoneEvent);
             _rewrite.lastSent.lastOriginalSequenceNumber = sequenceNumber;
             _rewrite.lastSent.sequenceNumber = correctedSeq;
             _rewrite.lastSent.timestamp = header.timestamp;
@@ -280,11 +315,11 @@ bool SsrcOutboundContext::rewriteAudio(rtp::RtpHeader& header,
     }
 
     // Late packet within safe limits
-    doRtpHeaderRewriteForAudio(header, senderInboundContext, newSequenceNumber, isTelephoneEvent);
+    doRtpHeaderRewriteForAudio(packet, header, senderInboundContext, newSequenceNumber, isTelephoneEvent);
     return true;
 }
 
-bool SsrcOutboundContext::rewriteVideo(rtp::RtpHeader& header,
+bool SsrcOutboundContext::rewriteVideo(memory::Packet& packet,
     const bridge::SsrcInboundContext& senderInboundContext,
     const uint32_t extendedSequenceNumber,
     const char* transportName,
@@ -292,6 +327,12 @@ bool SsrcOutboundContext::rewriteVideo(rtp::RtpHeader& header,
     const uint64_t timestamp,
     bool isKeyFrame)
 {
+    auto* rtpHeader = rtp::RtpHeader::fromPacket(packet);
+    if (!rtpHeader)
+    {
+        return false;
+    }
+    auto& header = *rtpHeader;
     const bool isVp8 = rtpMap.format == bridge::RtpMap::Format::VP8;
     const uint32_t sampleRate = isVp8 ? codec::Vp8::sampleRate : 90000;
 
@@ -374,7 +415,7 @@ bool SsrcOutboundContext::rewriteVideo(rtp::RtpHeader& header,
     }
 
     outExtendedSequenceNumber = extendedSequenceNumber + _rewrite.offset.sequenceNumber;
-    doRtpHeaderRewriteForVideo(header, senderInboundContext, outExtendedSequenceNumber);
+    doRtpHeaderRewriteForVideo(packet, header, senderInboundContext, outExtendedSequenceNumber);
 
     uint16_t newPicId = 0xFFFF;
     uint8_t newTl0PicIdx = 0xFF;
@@ -438,3 +479,172 @@ bool SsrcOutboundContext::rewriteVideo(rtp::RtpHeader& header,
 
     return true;
 }
+
+/**
+ * Remembers which inbound packet was sent on an outbound sequence number and the offsets it was rewritten with,
+ * so that a retransmission can be rebuilt from the sender's inbound packet cache. On a simulcast switch the previous
+ * source is kept until all outbound sequence numbers it was used for have been reused.
+ */
+void SsrcOutboundContext::storeRetransmissionSource(InboundPacketCache& sourcePacketCache,
+    const uint32_t outExtendedSequenceNumber,
+    const uint32_t extendedSequenceNumber)
+{
+    if (!_retransmission.records)
+    {
+        _retransmission.records.reset(new RetransmissionRecord[InboundPacketCache::maxPackets]);
+    }
+
+    if (_retransmission.sourcePacketCache.get() != &sourcePacketCache)
+    {
+        _retransmission.previousSourcePacketCache = std::move(_retransmission.sourcePacketCache);
+        _retransmission.previousSourceEndSequenceNumber = outExtendedSequenceNumber + InboundPacketCache::maxPackets;
+        _retransmission.sourcePacketCache = sourcePacketCache.shared_from_this();
+    }
+    else if (_retransmission.previousSourcePacketCache &&
+        static_cast<int32_t>(outExtendedSequenceNumber - _retransmission.previousSourceEndSequenceNumber) >= 0)
+    {
+        _retransmission.previousSourcePacketCache.reset();
+    }
+
+    auto& record = _retransmission.records[outExtendedSequenceNumber % InboundPacketCache::maxPackets];
+    record.isSet = true;
+    record.sequenceNumber = extractSequenceNumber(outExtendedSequenceNumber);
+    record.sourceSsrc = sourcePacketCache.ssrc;
+    record.sourceSequenceNumber = extendedSequenceNumber;
+    record.timestampOffset = _rewrite.offset.timestamp;
+    record.picIdOffset = _rewrite.offset.picId;
+    record.tl0PicIdxOffset = _rewrite.offset.tl0PicIdx;
+}
+
+/**
+ * Copies the inbound packet that was sent on sequenceNumber into packet and rewrites it the way it was forwarded.
+ * @return false if the packet is no longer available.
+ */
+bool SsrcOutboundContext::rewriteRetransmission(const uint16_t sequenceNumber, memory::Packet& packet)
+{
+    if (!_retransmission.sourcePacketCache || !_retransmission.records)
+    {
+        return false;
+    }
+
+    const auto& record = _retransmission.records[sequenceNumber % InboundPacketCache::maxPackets];
+    if (!record.isSet || record.sequenceNumber != sequenceNumber)
+    {
+        return false;
+    }
+
+    const auto* source = _retransmission.sourcePacketCache.get();
+    if (record.sourceSsrc != source->ssrc)
+    {
+        source = _retransmission.previousSourcePacketCache.get();
+        if (!source || record.sourceSsrc != source->ssrc)
+        {
+            return false;
+        }
+    }
+    const auto& sourcePacketCache = *source;
+
+    if (!sourcePacketCache.get(record.sourceSequenceNumber, packet))
+    {
+        return false;
+    }
+
+    auto header = rtp::RtpHeader::fromPacket(packet);
+    if (!header)
+    {
+        return false;
+    }
+
+    header->sequenceNumber = sequenceNumber;
+    header->ssrc = this->ssrc;
+    header->timestamp = record.timestampOffset + header->timestamp;
+    header->payloadType = rtpMap.payloadType;
+    doRtpHeaderExtensionRewrite(packet, *header, sourcePacketCache.rtpMap, false);
+
+    if (rtpMap.format == bridge::RtpMap::Format::VP8)
+    {
+        uint8_t* rtpPayload = header->getPayload();
+        const uint16_t picId = codec::Vp8Header::getPicId(rtpPayload) + record.picIdOffset;
+        const uint8_t tl0PicIdx = codec::Vp8Header::getTl0PicIdx(rtpPayload) + record.tl0PicIdxOffset;
+        codec::Vp8Header::setPicId(rtpPayload, picId);
+        codec::Vp8Header::setTl0PicIdx(rtpPayload, tl0PicIdx);
+    }
+
+    return true;
+}
+
+/**
+ * Decides whether a VP8 packet is above the temporal layer the recipient can currently receive.
+ * Dropped packets are hidden by shifting the sequence number and picture id offsets, so the recipient sees
+ * consecutive counters and will not NACK them. TL0PICIDX is unaffected since the base layer is never dropped.
+ * Switching up only happens on a key frame or a layer sync frame, as other frames may reference frames we dropped.
+ * @return true if the packet must not be forwarded.
+ */
+bool SsrcOutboundContext::dropTemporalLayer(const rtp::RtpHeader& header,
+    const uint32_t extendedSequenceNumber,
+    const uint8_t maxTemporalLayer,
+    const bool isKeyFrame)
+{
+    if (rtpMap.format != bridge::RtpMap::Format::VP8)
+    {
+        return false;
+    }
+
+    const uint8_t* rtpPayload = header.getPayload();
+    const uint8_t tid = codec::Vp8Header::getTid(rtpPayload);
+    if (tid == 0xFF)
+    {
+        // sender does not use temporal layers
+        return false;
+    }
+
+    auto& temporalLayers = _rewrite.temporalLayers;
+    if (_rewrite.empty() || header.ssrc.get() != _originalSsrc || isKeyFrame)
+    {
+        temporalLayers.current = maxTemporalLayer;
+        return false;
+    }
+
+    if (maxTemporalLayer < temporalLayers.current)
+    {
+        REWRITER_LOG("dropTemporalLayer: ssrc %u, temporal layer %u -> %u",
+            "SsrcOutboundContext",
+            ssrc,
+            temporalLayers.current,
+            maxTemporalLayer);
+        temporalLayers.current = maxTemporalLayer;
+    }
+    else if (tid > temporalLayers.current && tid <= maxTemporalLayer && codec::Vp8Header::isLayerSync(rtpPayload))
+    {
+        REWRITER_LOG("dropTemporalLayer: ssrc %u, temporal layer sync %u -> %u",
+            "SsrcOutboundContext",
+            ssrc,
+            temporalLayers.current,
+            tid);
+        temporalLayers.current = tid;
+    }
+
+    if (tid <= temporalLayers.current)
+    {
+        return false;
+    }
+
+    const int32_t seqAdvance = static_cast<int32_t>(
+        (extendedSequenceNumber + _rewrite.offset.sequenceNumber) - _rewrite.lastSent.sequenceNumber);
+    if (seqAdvance != 1)
+    {
+        // Reordered or preceded by loss. The gap cannot be hidden without confusing NACK so forward it anyway.
+        return false;
+    }
+
+    _rewrite.offset.sequenceNumber -= 1;
+    const uint16_t picId = codec::Vp8Header::getPicId(rtpPayload);
+    const uint16_t picIdAdvance = (picId + _rewrite.offset.picId - _rewrite.lastSent.picId) & 0x7FFF;
+    if (picIdAdvance == 1)
+    {
+        // first dropped packet of this frame
+        _rewrite.offset.picId -= 1;
+    }
+
+    return true;
+}
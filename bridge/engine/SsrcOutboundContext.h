@@ -3,6 +3,7 @@
 #include "bridge/RtpMap.h"
 #include "codec/OpusEncoder.h"
 #include "memory/PacketPoolAllocator.h"
+#include "transport/PacingQueue.h"
 #include "utils/Optional.h"
 #include "utils/Time.h"
 #include <atomic>
@@ -14,11 +15,17 @@ namespace rtp
 struct RtpHeader;
 } // namespace rtp
 
+namespace memory
+{
+class Packet;
+} // namespace memory
+
 namespace bridge
 {
 
 class SsrcInboundContext;
 class PacketCache;
+class InboundPacketCache;
 
 /**
  * Maintains state and media graph for an outbound SSRC stream.
@@ -40,6 +47,9 @@ public:
           lastRespondedNackBlp(0),
           lastRespondedNackTimestamp(0),
           lastSendTime(utils::Time::getAbsoluteTime()),
+          pacingPriority(transport::PacingPriority::VIDEO),
+          maxTemporalLayer(0xFF),
+          temporalLayerVersion(0),
           markedForDeletion(false),
           recordingOutboundDecommissioned(false),
           _originalSsrc(~0u)
@@ -47,18 +57,27 @@ public:
     }
 
     void dropTelephoneEvent(const uint32_t sequenceNumber, const uint32_t originSsrc);
-    bool rewriteAudio(rtp::RtpHeader& header,
+    bool rewriteAudio(memory::Packet& packet,
         const bridge::SsrcInboundContext& senderInboundContext,
         const uint32_t sequenceNumber,
         const uint64_t timestamp,
         const bool isTelephoneEvent);
-    bool rewriteVideo(rtp::RtpHeader& header,
+    bool rewriteVideo(memory::Packet& packet,
         const bridge::SsrcInboundContext& senderInboundContext,
         const uint32_t extendedSequenceNumber,
         const char* transportName,
         uint32_t& outExtendedSequenceNumber,
         const uint64_t timestamp,
         bool isKeyFrame);
+    void storeRetransmissionSource(InboundPacketCache& sourcePacketCache,
+        const uint32_t outExtendedSequenceNumber,
+        const uint32_t extendedSequenceNumber);
+    bool rewriteRetransmission(const uint16_t sequenceNumber, memory::Packet& packet);
+    bool hasRetransmissionSource() const { return _retransmission.sourcePacketCache != nullptr; }
+    bool dropTemporalLayer(const rtp::RtpHeader& header,
+        const uint32_t extendedSequenceNumber,
+        const uint8_t maxTemporalLayer,
+        const bool isKeyFrame);
 
     uint32_t getLastSentSequenceNumber() const { return _rewrite.lastSent.sequenceNumber; }
     int32_t getSequenceNumberOffset() const { return _rewrite.offset.sequenceNumber; }
@@ -88,6 +107,11 @@ public:
     /// ==== Accessed from Engine only!
     uint64_t lastSendTime;
     void onRtpSent(const uint64_t timestamp) { lastSendTime = timestamp; }
+    // last priority posted to the transport pacer
+    transport::PacingPriority pacingPriority;
+    // max VP8 temporal layer from the stream director, valid while temporalLayerVersion matches the director's
+    uint8_t maxTemporalLayer;
+    uint32_t temporalLayerVersion;
 
     // Stream owner is being removed. Stop outbound packets over this context
     bool markedForDeletion;
@@ -96,15 +120,18 @@ public:
     bool recordingOutboundDecommissioned;
 
 private:
-    void doRtpHeaderExtensionRewriteForAudio(rtp::RtpHeader& rtpHeader,
-        const bridge::SsrcInboundContext& senderInboundContext);
-    void doRtpHeaderExtensionRewriteForVideo(rtp::RtpHeader& rtpHeader,
-        const bridge::SsrcInboundContext& senderInboundContext);
-    void doRtpHeaderRewriteForAudio(rtp::RtpHeader& header,
+    void updateHeaderTemplate(const bridge::RtpMap& senderRtpMap, const bool isAudio);
+    void doRtpHeaderExtensionRewrite(memory::Packet& packet,
+        rtp::RtpHeader& rtpHeader,
+        const bridge::RtpMap& senderRtpMap,
+        const bool isAudio);
+    void doRtpHeaderRewriteForAudio(memory::Packet& packet,
+        rtp::RtpHeader& header,
         const bridge::SsrcInboundContext& senderInboundContext,
         const uint32_t newSequenceNumber,
         const bool isTelephoneEvent);
-    void doRtpHeaderRewriteForVideo(rtp::RtpHeader& header,
+    void doRtpHeaderRewriteForVideo(memory::Packet& packet,
+        rtp::RtpHeader& header,
         const bridge::SsrcInboundContext& senderInboundContext,
         const uint32_t newSequenceNumber);
     bool isPacketTooOld(uint32_t sequenceCount, int32_t rewindLimit) const;
@@ -150,8 +177,49 @@ private:
         {
             uint32_t lastDroppedSequenceNumber = 0;
         } telephoneEvents;
+
+        struct
+        {
+            // highest VP8 temporal layer currently forwarded
+            uint8_t current = 0xFF;
+        } temporalLayers;
     } _rewrite;
 
+    // Used instead of packetCache when the sender's inbound packets are cached. Transport Jobs only!
+    struct RetransmissionRecord
+    {
+        bool isSet = false;
+        uint16_t sequenceNumber = 0;
+        uint32_t sourceSsrc = 0;
+        uint32_t sourceSequenceNumber = 0;
+        int32_t timestampOffset = 0;
+        int16_t picIdOffset = 0;
+        int16_t tl0PicIdxOffset = 0;
+    };
+
+    struct
+    {
+        std::shared_ptr<InboundPacketCache> sourcePacketCache;
+        // source before the latest simulcast switch, kept until its records have been overwritten
+        std::shared_ptr<InboundPacketCache> previousSourcePacketCache;
+        uint32_t previousSourceEndSequenceNumber = 0;
+        std::unique_ptr<RetransmissionRecord[]> records;
+    } _retransmission;
+
+    // Outbound header extension ids for the current sender. Rebuilt when the sender's extension ids change, so the
+    // rewrite is a single pass over the extensions with table lookups. Transport Jobs only!
+    struct HeaderTemplate
+    {
+        bool isSet = false;
+        bool isAudio = false;
+        uint8_t senderAudioLevelId = 0;
+        uint8_t senderAbsSendTimeId = 0;
+        uint8_t senderTransportCcId = 0;
+        uint8_t absSendTimeId = 0;
+        uint8_t transportCcId = 0;
+        uint8_t extensionIds[16]; // outbound id by sender id, 0 to pad the extension out
+    } _headerTemplate;
+
     /// ==== both Engine and Transport
     std::atomic_uint32_t _originalSsrc;
 };
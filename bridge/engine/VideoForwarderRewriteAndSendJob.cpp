@@ -19,7 +19,8 @@ VideoForwarderRewriteAndSendJob::VideoForwarderRewriteAndSendJob(SsrcOutboundCon
     MixerManagerAsync& mixerManager,
     size_t endpointIdHash,
     EngineMixer& mixer,
-    uint64_t timestamp)
+    uint64_t timestamp,
+    uint8_t maxTemporalLayer)
     : jobmanager::CountedJob(transport.getJobCounter()),
       _outboundContext(outboundContext),
       _senderInboundContext(senderInboundContext),
@@ -29,7 +30,8 @@ VideoForwarderRewriteAndSendJob::VideoForwarderRewriteAndSendJob(SsrcOutboundCon
       _mixerManager(mixerManager),
       _endpointIdHash(endpointIdHash),
       _mixer(mixer),
-      _timestamp(timestamp)
+      _timestamp(timestamp),
+      _maxTemporalLayer(maxTemporalLayer)
 {
     assert(_packet);
     assert(_packet->getLength() > 0);
@@ -54,7 +56,9 @@ void VideoForwarderRewriteAndSendJob::run()
         return;
     }
 
-    if (!_outboundContext.packetCache.isSet())
+    // packets from senders with an inbound cache are retransmitted from there, once it has been allocated
+    auto* inboundPacketCache = _senderInboundContext.packetCache.load(std::memory_order_acquire);
+    if (!_senderInboundContext.packetCacheRequested && !_outboundContext.packetCache.isSet())
     {
         logger::debug("New ssrc %u seen on %s, sending request to add videoPacketCache to transport",
             "VideoForwarderRewriteAndSendJob",
@@ -103,9 +107,14 @@ void VideoForwarderRewriteAndSendJob::run()
         return;
     }
 
+    if (_outboundContext.dropTemporalLayer(*rtpHeader, _extendedSequenceNumber, _maxTemporalLayer, isKeyFrame))
+    {
+        return;
+    }
+
     uint32_t rewrittenExtendedSequenceNumber = 0;
 
-    if (!_outboundContext.rewriteVideo(*rtpHeader,
+    if (!_outboundContext.rewriteVideo(*_packet,
             _senderInboundContext,
             _extendedSequenceNumber,
             _transport.getLoggableId().c_str(),
@@ -122,7 +131,13 @@ void VideoForwarderRewriteAndSendJob::run()
         return;
     }
 
-    if (_outboundContext.packetCache.isSet() && _outboundContext.packetCache.get())
+    if (inboundPacketCache)
+    {
+        _outboundContext.storeRetransmissionSource(*inboundPacketCache,
+            rewrittenExtendedSequenceNumber,
+            _extendedSequenceNumber);
+    }
+    else if (_outboundContext.packetCache.isSet() && _outboundContext.packetCache.get())
     {
         if (!_outboundContext.packetCache.get()->add(*_packet, rtpHeader->sequenceNumber))
         {
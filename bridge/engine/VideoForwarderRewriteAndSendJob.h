@@ -26,7 +26,8 @@ public:
         MixerManagerAsync& mixerManager,
         size_t endpointIdHash,
         EngineMixer& mixer,
-        uint64_t timestamp);
+        uint64_t timestamp,
+        uint8_t maxTemporalLayer);
 
     void run() override;
 
@@ -40,6 +41,7 @@ private:
     size_t _endpointIdHash;
     EngineMixer& _mixer;
     const uint64_t _timestamp;
+    const uint8_t _maxTemporalLayer;
 };
 
 } // namespace bridge
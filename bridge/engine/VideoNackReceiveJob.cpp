@@ -37,7 +37,8 @@ void VideoNackReceiveJob::run()
         _sender.getLoggableId().c_str());
 
     // it may be that we post a few of these jobs before cache has been set, but that is ok
-    if (!_sender.isConnected() || !_mainOutboundContext.packetCache.isSet() || !_mainOutboundContext.packetCache.get())
+    const bool hasPacketCache = _mainOutboundContext.packetCache.isSet() && _mainOutboundContext.packetCache.get();
+    if (!_sender.isConnected() || !(hasPacketCache || _mainOutboundContext.hasRetransmissionSource()))
     {
         return;
     }
@@ -89,34 +90,31 @@ void VideoNackReceiveJob::sendIfCached(const uint16_t sequenceNumber)
         return;
     }
 
-    const auto cachedPacket = _mainOutboundContext.packetCache.get()->get(sequenceNumber);
-    if (!cachedPacket)
+    auto packet = memory::makeUniquePacket(_rtxSsrcOutboundContext.allocator);
+    if (!packet)
     {
         return;
     }
 
-    const auto cachedRtpHeader = rtp::RtpHeader::fromPacket(*cachedPacket);
-    if (!cachedRtpHeader)
+    if (!_mainOutboundContext.rewriteRetransmission(sequenceNumber, *packet) &&
+        !copyFromPacketCache(sequenceNumber, *packet))
     {
         return;
     }
 
-    auto packet = memory::makeUniquePacket(_rtxSsrcOutboundContext.allocator);
-    if (!packet)
+    auto rtpHeader = rtp::RtpHeader::fromPacket(*packet);
+    if (!rtpHeader || packet->getLength() + sizeof(uint16_t) > memory::Packet::size)
     {
         return;
     }
 
-    const auto cachedRtpHeaderLength = cachedRtpHeader->headerLength();
-    const auto cachedPayload = cachedRtpHeader->getPayload();
-    const auto cachedSequenceNumber = cachedRtpHeader->sequenceNumber.get();
-
-    memcpy(packet->get(), cachedPacket->get(), cachedRtpHeaderLength);
-    auto copyHead = packet->get() + cachedRtpHeaderLength;
-    reinterpret_cast<uint16_t*>(copyHead)[0] = hton<uint16_t>(cachedSequenceNumber);
-    copyHead += sizeof(uint16_t);
-    memcpy(copyHead, cachedPayload, cachedPacket->getLength() - cachedRtpHeaderLength);
-    packet->setLength(cachedPacket->getLength() + sizeof(uint16_t));
+    // insert original sequence number in front of payload
+    const auto rtpHeaderLength = rtpHeader->headerLength();
+    const auto originalSequenceNumber = rtpHeader->sequenceNumber.get();
+    auto payload = rtpHeader->getPayload();
+    std::memmove(payload + sizeof(uint16_t), payload, packet->getLength() - rtpHeaderLength);
+    reinterpret_cast<uint16_t*>(payload)[0] = hton<uint16_t>(originalSequenceNumber);
+    packet->setLength(packet->getLength() + sizeof(uint16_t));
 
     NACK_LOG("Sending cached packet seq %u, rtxSsrc %u, seq %u",
         "VideoNackReceiveJob",
@@ -124,12 +122,6 @@ void VideoNackReceiveJob::sendIfCached(const uint16_t sequenceNumber)
         _rtxSsrcOutboundContext.ssrc.get(),
         _rtxSsrcOutboundContext.sequenceCounter & 0xFFFFu);
 
-    auto rtpHeader = rtp::RtpHeader::fromPacket(*packet);
-    if (!rtpHeader)
-    {
-        return;
-    }
-
     rtpHeader->ssrc = _rtxSsrcOutboundContext.ssrc;
     rtpHeader->payloadType = _rtxSsrcOutboundContext.rtpMap.payloadType;
     rtpHeader->sequenceNumber = ++_rtxSsrcOutboundContext.getSequenceNumberReference() & 0xFFFF;
@@ -137,4 +129,22 @@ void VideoNackReceiveJob::sendIfCached(const uint16_t sequenceNumber)
     _sender.protectAndSend(std::move(packet));
 }
 
+bool VideoNackReceiveJob::copyFromPacketCache(const uint16_t sequenceNumber, memory::Packet& packet)
+{
+    if (!_mainOutboundContext.packetCache.isSet() || !_mainOutboundContext.packetCache.get())
+    {
+        return false;
+    }
+
+    const auto cachedPacket = _mainOutboundContext.packetCache.get()->get(sequenceNumber);
+    if (!cachedPacket)
+    {
+        return false;
+    }
+
+    std::memcpy(packet.get(), cachedPacket->get(), cachedPacket->getLength());
+    packet.setLength(cachedPacket->getLength());
+    return true;
+}
+
 } // namespace bridge
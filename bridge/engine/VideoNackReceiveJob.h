@@ -3,6 +3,11 @@
 #include "jobmanager/Job.h"
 #include <cstdint>
 
+namespace memory
+{
+class Packet;
+} // namespace memory
+
 namespace transport
 {
 class RtcTransport;
@@ -37,6 +42,7 @@ private:
     uint64_t _rtt;
 
     void sendIfCached(const uint16_t sequenceNumber);
+    bool copyFromPacketCache(const uint16_t sequenceNumber, memory::Packet& packet);
 };
 
 } // namespace bridge
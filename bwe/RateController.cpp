@@ -2,6 +2,7 @@
 #include "logger/Logger.h"
 #include "math/helpers.h"
 #include "rtp/RtcpHeader.h"
+#include "rtp/RtcpTransportFeedback.h"
 #include "rtp/RtpHeader.h"
 #include "utils/Time.h"
 #include <algorithm>
@@ -16,6 +17,9 @@ namespace
 {
 const uint32_t ntp32Second = 0x10000u;
 const uint64_t longIntervalWithoutValidProbes = utils::Time::sec * 30;
+// growth in arrival spread compared to send spread that indicates a building network queue
+const int64_t transportFeedbackQueueGrowthLimit = utils::Time::ms * 10;
+const uint32_t transportFeedbackMinPackets = 5;
 
 enum ProbeEvaluation
 {
@@ -739,6 +743,112 @@ void RateController::onReportReceived(uint64_t timestamp,
     }
 }
 
+void RateController::onTransportWideSequenceNumberSent(uint64_t timestamp,
+    uint16_t transportSequenceNumber,
+    uint16_t size)
+{
+    if (size == 0 || !_config.enabled)
+    {
+        return;
+    }
+
+    auto& record = _transportWideHistory[transportSequenceNumber % _transportWideHistory.size()];
+    record.transmissionTime = timestamp;
+    record.size = size + _config.ipOverhead;
+    record.sequenceNumber = transportSequenceNumber;
+    record.valid = true;
+}
+
+// Transport feedback reports the arrival time of each packet. The arrival spread of the packets reveals the receive
+// rate. If the arrival spread grows beyond the send spread, the network queue is building up.
+void RateController::onTransportFeedbackReceived(uint64_t timestamp, const rtp::RtcpTransportFeedback& feedback)
+{
+    if (!_config.enabled)
+    {
+        return;
+    }
+
+    rtp::TransportFeedbackReader reader(feedback);
+    uint16_t sequenceNumber = 0;
+    bool received = false;
+    int64_t receiveTime = 0;
+
+    uint32_t receivedCount = 0;
+    uint32_t lossCount = 0;
+    uint64_t receivedBytes = 0;
+    uint64_t firstSendTime = 0;
+    uint64_t lastSendTime = 0;
+    int64_t firstReceiveTime = 0;
+    int64_t lastReceiveTime = 0;
+    while (reader.getNext(sequenceNumber, received, receiveTime))
+    {
+        auto& record = _transportWideHistory[sequenceNumber % _transportWideHistory.size()];
+        if (!record.valid || record.sequenceNumber != sequenceNumber)
+        {
+            continue;
+        }
+        if (!received)
+        {
+            ++lossCount;
+            continue;
+        }
+
+        record.valid = false;
+        if (receivedCount == 0)
+        {
+            firstSendTime = record.transmissionTime;
+            firstReceiveTime = receiveTime;
+        }
+        else
+        {
+            receivedBytes += record.size;
+        }
+        lastSendTime = record.transmissionTime;
+        lastReceiveTime = receiveTime;
+        ++receivedCount;
+    }
+
+    const int64_t receivePeriod = lastReceiveTime - firstReceiveTime;
+    if (!reader.isValid() || receivedCount < transportFeedbackMinPackets ||
+        receivePeriod < static_cast<int64_t>(utils::Time::ms * 20))
+    {
+        return;
+    }
+
+    const int64_t queueGrowth = receivePeriod - utils::Time::diff(firstSendTime, lastSendTime);
+    const uint32_t receiveRateKbps = receivedBytes * 8 * utils::Time::ms / receivePeriod;
+    const double lossRatio = static_cast<double>(lossCount) / (lossCount + receivedCount);
+    const auto currentEstimate = _model.queue.getBandwidth();
+
+    if (lossCount > 2 && lossRatio > 0.02 && !hasRecentlyBackedOffDueToLoss(timestamp))
+    {
+        _model.queue.setBandwidth(std::max(_config.bandwidthFloorKbps, static_cast<uint32_t>(currentEstimate * 0.95)));
+        _lastLossBackoff = timestamp;
+    }
+    else if (queueGrowth > transportFeedbackQueueGrowthLimit && receiveRateKbps < currentEstimate)
+    {
+        _model.queue.setBandwidth(currentEstimate - 0.25 * (currentEstimate - receiveRateKbps));
+    }
+    else if (queueGrowth <= transportFeedbackQueueGrowthLimit / 2 && lossCount == 0 &&
+        receiveRateKbps > currentEstimate)
+    {
+        _model.queue.setBandwidth(std::min(currentEstimate + 1000, receiveRateKbps));
+    }
+
+    _model.queue.setBandwidth(
+        math::clamp(_model.queue.getBandwidth(), _config.bandwidthFloorKbps, _config.bandwidthCeilingKbps));
+    _model.targetQueue =
+        calculateTargetQueue(_model.queue.getBandwidth(), _minRttNtp == ~0u ? 1 : _minRttNtp, _config);
+
+    RCTL_LOG("transport feedback rx %u loss %u, rxRate %ukbps, queue growth %.1fms, model %ukbps",
+        _logId.c_str(),
+        receivedCount,
+        lossCount,
+        receiveRateKbps,
+        static_cast<double>(queueGrowth) / utils::Time::ms,
+        _model.queue.getBandwidth());
+}
+
 void RateController::onRtcpPaddingSent(uint64_t timestamp, uint32_t ssrc, uint16_t size)
 {
     if (size == 0 || !_config.enabled)
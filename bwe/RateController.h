@@ -3,12 +3,14 @@
 #include "logger/Logger.h"
 #include "memory/RandomAccessBacklog.h"
 #include "utils/Time.h"
+#include <array>
 #include <cstdint>
 
 namespace rtp
 {
 class ReportBlock;
-}
+struct RtcpTransportFeedback;
+} // namespace rtp
 namespace bwe
 {
 struct RateControllerConfig
@@ -119,6 +121,9 @@ public:
         uint32_t delaySinceSR);
     void onReportReceived(uint64_t timestamp, uint32_t count, const rtp::ReportBlock blocks[], uint32_t rttNtp);
 
+    void onTransportWideSequenceNumberSent(uint64_t timestamp, uint16_t transportSequenceNumber, uint16_t size);
+    void onTransportFeedbackReceived(uint64_t timestamp, const rtp::RtcpTransportFeedback& feedback);
+
     void onRtcpPaddingSent(uint64_t timestamp, uint32_t ssrc, uint16_t size);
     void onSctpSent(uint64_t timestamp, uint16_t size);
 
@@ -244,6 +249,16 @@ private:
 
         bool empty() const { return ntp == 0 && packetsReceived == 0; }
     } _lastProbe;
+
+    // Send history for packets stamped with transport wide sequence number. Indexed by sequence number.
+    struct TransportWideSendRecord
+    {
+        uint64_t transmissionTime = 0;
+        uint32_t size = 0;
+        uint16_t sequenceNumber = 0;
+        bool valid = false;
+    };
+    std::array<TransportWideSendRecord, 1024> _transportWideHistory;
 };
 
 } // namespace bwe
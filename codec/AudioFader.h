@@ -40,6 +40,32 @@ public:
 
     void fadeOutStereo(int16_t* data, size_t sampleCount) { fadeOutStereo(data, data, sampleCount); }
 
+    // interleaved samples with any number of channels
+    void fadeIn(int16_t* data, size_t sampleCount, uint32_t channels)
+    {
+        for (size_t i = 0; i < sampleCount; ++i)
+        {
+            _volume = std::min(1.0, _volume + _stepFactor);
+            for (uint32_t c = 0; c < channels; ++c)
+            {
+                data[i * channels + c] *= _volume;
+            }
+        }
+    }
+
+    void fadeOut(int16_t* data, size_t sampleCount, uint32_t channels)
+    {
+        for (size_t i = 0; i < sampleCount; ++i)
+        {
+            _volume = std::min(1.0, _volume + _stepFactor);
+            const auto amp = 1.0 - _volume;
+            for (uint32_t c = 0; c < channels; ++c)
+            {
+                data[i * channels + c] *= amp;
+            }
+        }
+    }
+
     double next()
     {
         if (_volume >= 1.0)
@@ -1,4 +1,5 @@
 #include "AudioLevel.h"
+#include "codec/OpusDecoder.h"
 #include "memory/AudioPacketPoolAllocator.h"
 #include "rtp/RtpHeader.h"
 #include <cmath>
@@ -36,4 +37,30 @@ int computeAudioLevel(const memory::AudioPacket& packet)
     return dBO;
 }
 
+int computeAudioLevel(OpusDecoder& decoder,
+    const uint32_t extendedSequenceNumber,
+    const uint8_t* payload,
+    const size_t length)
+{
+    const size_t dtxFrameMaxLength = 2; // TOC byte and possibly a frame count byte
+    if (length <= dtxFrameMaxLength)
+    {
+        return 127;
+    }
+
+    const size_t maxFrames = decoder.getSampleRate() * 120 / 1000; // longest Opus packet
+    int16_t pcmData[maxFrames * decoder.getChannels()];
+    const auto decodedFrames = decoder.decode(extendedSequenceNumber,
+        payload,
+        static_cast<int32_t>(length),
+        reinterpret_cast<unsigned char*>(pcmData),
+        maxFrames);
+    if (decodedFrames <= 0)
+    {
+        return -1;
+    }
+
+    return computeAudioLevel(pcmData, decodedFrames * decoder.getChannels());
+}
+
 } // namespace codec
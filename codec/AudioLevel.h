@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 
 namespace memory
@@ -11,8 +12,16 @@ class Packet;
 
 namespace codec
 {
+class OpusDecoder;
 
 int computeAudioLevel(const memory::AudioPacket& packet);
 int computeAudioLevel(const int16_t* payload, int count);
 
+/**
+ * Audio level of an Opus payload. Use a decoder at low sample rate and one channel, since the level is all that is
+ * needed. DTX frames carry no audio and are reported as silence without decoding.
+ * @return level 0-127, or -1 if decoding failed
+ */
+int computeAudioLevel(OpusDecoder& decoder, uint32_t extendedSequenceNumber, const uint8_t* payload, size_t length);
+
 } // namespace codec
@@ -43,16 +43,21 @@ AudioReceivePipeline::ReceiveBox::~ReceiveBox()
 AudioReceivePipeline::AudioReceivePipeline(uint32_t rtpFrequency,
     uint32_t ptime,
     uint32_t maxPackets,
-    int audioLevelExtensionId)
+    int audioLevelExtensionId,
+    uint32_t sampleRate,
+    uint32_t channels)
     : _ssrc(0),
       _rtpFrequency(rtpFrequency),
-      _samplesPerPacket(ptime * rtpFrequency / 1000),
+      _sampleRate(sampleRate),
+      _channels(channels),
+      _samplesPerPacket(ptime * sampleRate / 1000),
       _estimator(rtpFrequency),
       _audioLevelExtensionId(audioLevelExtensionId),
+      _decoder(sampleRate, channels),
       _targetDelay(0),
       _bufferAtTwoFrames(0),
-      _pcmData(7 * _config.channels * _samplesPerPacket, _config.channels * _samplesPerPacket),
-      _receiveBox(memory::page::alignedSpace(sizeof(int16_t) * _config.channels * _samplesPerPacket))
+      _pcmData(7 * _channels * _samplesPerPacket, _channels * _samplesPerPacket),
+      _receiveBox(memory::page::alignedSpace(sizeof(int16_t) * _channels * _samplesPerPacket))
 {
 }
 
@@ -61,20 +66,20 @@ bool AudioReceivePipeline::updateTargetDelay(double delay)
     const auto decodeTime = 3;
     const auto prevDelay = _targetDelay;
 
-    _targetDelay = (_estimator.getJitterMaxStable() + 1 + decodeTime) * _rtpFrequency / 1000;
+    _targetDelay = (_estimator.getJitterMaxStable() + 1 + decodeTime) * _sampleRate / 1000;
 
-    if (_targetDelay > prevDelay + _rtpFrequency / 100)
+    if (_targetDelay > prevDelay + _sampleRate / 100)
     {
         logger::info("%u jitter increase to %0.3fms",
             "AudioReceivePipeline",
             _ssrc,
-            _targetDelay * 1000.0 / _rtpFrequency);
+            _targetDelay * 1000.0 / _sampleRate);
     }
 
     return true;
 }
 
-// produces up to 4 packets of stereo pcm data
+// produces up to 4 packets of pcm data
 size_t AudioReceivePipeline::decodePacket(uint32_t extendedSequenceNumber,
     const uint64_t timestamp,
     const memory::Packet& packet,
@@ -108,7 +113,7 @@ size_t AudioReceivePipeline::decodePacket(uint32_t extendedSequenceNumber,
             const auto decodedFrames = _decoder.conceal(reinterpret_cast<uint8_t*>(audioData));
             if (decodedFrames > 0)
             {
-                audioData += _config.channels * decodedFrames;
+                audioData += _channels * decodedFrames;
             }
         }
 
@@ -117,7 +122,7 @@ size_t AudioReceivePipeline::decodePacket(uint32_t extendedSequenceNumber,
             _decoder.conceal(header->getPayload(), opusPayloadLength, reinterpret_cast<uint8_t*>(audioData));
         if (decodedFrames > 0)
         {
-            audioData += _config.channels * decodedFrames;
+            audioData += _channels * decodedFrames;
         }
     }
 
@@ -129,10 +134,10 @@ size_t AudioReceivePipeline::decodePacket(uint32_t extendedSequenceNumber,
 
     if (decodedFrames > 0)
     {
-        audioData += _config.channels * decodedFrames;
+        audioData += _channels * decodedFrames;
     }
 
-    const size_t samplesProduced = (audioData - originalAudioStart) / _config.channels;
+    const size_t samplesProduced = (audioData - originalAudioStart) / _channels;
     if (samplesProduced < _samplesPerPacket / 2)
     {
         logger::warn("%u failed to decode opus %zu", "AudioReceivePipeline", _ssrc, samplesProduced);
@@ -170,7 +175,7 @@ size_t AudioReceivePipeline::reduce(const memory::Packet& packet,
     int audioLevel = 0;
     if (!rtp::getAudioLevel(packet, _audioLevelExtensionId, audioLevel))
     {
-        audioLevel = codec::computeAudioLevel(audioData, samples * _config.channels);
+        audioLevel = codec::computeAudioLevel(audioData, samples * _channels);
     }
     _noiseFloor.update(audioLevel);
 
@@ -195,7 +200,7 @@ size_t AudioReceivePipeline::reduce(const memory::Packet& packet,
                 _metrics.shrunkPackets,
                 _metrics.eliminatedSamples,
                 _metrics.eliminatedPackets,
-                _pcmData.size() / _config.channels,
+                _pcmData.size() / _channels,
                 jitterBufferSize(_head.nextRtpTimestamp),
                 _targetDelay,
                 _estimator.getJitterMaxStable());
@@ -218,8 +223,9 @@ size_t AudioReceivePipeline::reduce(const memory::Packet& packet,
         }
         else
         {
-            const auto newSampleCount = codec::compactStereoTroughs(audioData,
+            const auto newSampleCount = codec::compactTroughs(audioData,
                 samples,
+                _channels,
                 allowedReduction,
                 _config.reduction.silenceZone,
                 _elimination.deltaThreshold);
@@ -240,7 +246,7 @@ void AudioReceivePipeline::init(uint32_t extendedSequenceNumber, const rtp::RtpH
 {
     _estimator.update(receiveTime, header.timestamp);
     _ssrc = header.ssrc.get();
-    _targetDelay = 25 * _rtpFrequency / 1000;
+    _targetDelay = 25 * _sampleRate / 1000;
     _head.nextRtpTimestamp = header.timestamp;
     _head.extendedSequenceNumber = header.sequenceNumber - 1;
     _pcmData.appendSilence(_samplesPerPacket);
@@ -253,7 +259,8 @@ double AudioReceivePipeline::analysePacketJitter(uint32_t extendedSequenceNumber
     const double delay = _estimator.update(receiveTime, header.timestamp);
     const auto delayInRtpCycles = delay * _rtpFrequency / 1000;
 
-    if (_targetDelay < delayInRtpCycles && delayInRtpCycles > _metrics.receivedRtpCyclesPerPacket && _pcmData.empty())
+    if (_targetDelay < delay * _sampleRate / 1000 && delayInRtpCycles > _metrics.receivedRtpCyclesPerPacket &&
+        _pcmData.empty())
     {
         if (!_jitterEmergency.counter)
         {
@@ -276,7 +283,7 @@ double AudioReceivePipeline::analysePacketJitter(uint32_t extendedSequenceNumber
             _ssrc,
             extendedSequenceNumber - _jitterEmergency.sequenceStart,
             delay,
-            _targetDelay * 1000 / _rtpFrequency,
+            _targetDelay * 1000 / _sampleRate,
             _jitterBuffer.count());
         _jitterEmergency.counter = 0;
     }
@@ -339,11 +346,11 @@ bool AudioReceivePipeline::onSilencedRtpPacket(uint32_t extendedSequenceNumber,
 }
 
 // Fetch audio and suppress pops after underruns as well as resume
-size_t AudioReceivePipeline::fetchStereo(size_t sampleCount)
+size_t AudioReceivePipeline::fetch(size_t sampleCount)
 {
-    codec::clearStereo(_receiveBox.audio, _samplesPerPacket);
+    std::memset(_receiveBox.audio, 0, _samplesPerPacket * _channels * sizeof(int16_t));
     _receiveBox.audioSampleCount = 0;
-    const uint32_t bufferLevel = _pcmData.size() / _config.channels;
+    const uint32_t bufferLevel = _pcmData.size() / _channels;
     if (bufferLevel < sampleCount)
     {
         ++_receiveBox.underrunCount;
@@ -358,22 +365,22 @@ size_t AudioReceivePipeline::fetchStereo(size_t sampleCount)
 
         if (bufferLevel > 0)
         {
-            _pcmData.fetch(_receiveBox.audio, sampleCount * _config.channels);
+            _pcmData.fetch(_receiveBox.audio, sampleCount * _channels);
             codec::AudioLinearFade fader(bufferLevel);
-            fader.fadeOutStereo(_receiveBox.audio, bufferLevel);
+            fader.fadeOut(_receiveBox.audio, bufferLevel, _channels);
             logger::debug("%u fade out %u, requested %zu, pcm %zu",
                 "AudioReceivePipeline",
                 _ssrc,
                 bufferLevel,
                 sampleCount,
-                _pcmData.size() / _config.channels);
+                _pcmData.size() / _channels);
             _receiveBox.audioSampleCount = sampleCount;
             return sampleCount;
         }
         else if (_receiveBox.underrunCount == 1)
         {
-            _pcmData.replay(_receiveBox.audio, sampleCount * _config.channels);
-            codec::swingTail(_receiveBox.audio, 48000, sampleCount);
+            _pcmData.replay(_receiveBox.audio, sampleCount * _channels);
+            codec::swingTail(_receiveBox.audio, _sampleRate, sampleCount, _channels);
             logger::debug("%u appended tail", "AudioReceivePipeline", _ssrc);
             _receiveBox.audioSampleCount = sampleCount;
             return sampleCount;
@@ -382,14 +389,14 @@ size_t AudioReceivePipeline::fetchStereo(size_t sampleCount)
     }
 
     // JBLOG("fetched %zu", "AudioReceivePipeline", sampleCount);
-    _pcmData.fetch(_receiveBox.audio, sampleCount * _config.channels);
+    _pcmData.fetch(_receiveBox.audio, sampleCount * _channels);
     _receiveBox.audioSampleCount = sampleCount;
 
     if (_receiveBox.underrunCount > 0)
     {
         logger::debug("%u fade in after %u underruns", "AudioReceivePipeline", _ssrc, _receiveBox.underrunCount);
         codec::AudioLinearFade fader(sampleCount);
-        fader.fadeInStereo(_receiveBox.audio, sampleCount);
+        fader.fadeIn(_receiveBox.audio, sampleCount, _channels);
         _receiveBox.underrunCount = 0;
         _receiveBox.audioSampleCount = sampleCount;
     }
@@ -398,14 +405,16 @@ size_t AudioReceivePipeline::fetchStereo(size_t sampleCount)
 
 uint32_t AudioReceivePipeline::jitterBufferSize(uint32_t rtpTimestamp) const
 {
-    return (_jitterBuffer.empty() ? 0 : _jitterBuffer.getRtpDelay(rtpTimestamp) + _metrics.receivedRtpCyclesPerPacket);
+    return (_jitterBuffer.empty()
+            ? 0
+            : toSamples(_jitterBuffer.getRtpDelay(rtpTimestamp) + _metrics.receivedRtpCyclesPerPacket));
 }
 
 // If it is less than 10ms since data was still not fetched from pcm buffer
 // we can wait another cycle before assuming packet is lost rather than re-ordered.
 bool AudioReceivePipeline::shouldWaitForMissingPacket(uint64_t timestamp) const
 {
-    const int32_t halfPtime = _samplesPerPacket * utils::Time::sec / (2 * _rtpFrequency);
+    const int32_t halfPtime = _samplesPerPacket * utils::Time::sec / (2 * _sampleRate);
     return static_cast<int32_t>(timestamp - _head.readyPcmTimestamp) <= halfPtime;
 }
 
@@ -418,15 +427,16 @@ bool AudioReceivePipeline::dtxHandler(const int16_t sequenceAdvance,
     const bool isDTX =
         sequenceAdvance == 1 && timestampAdvance > static_cast<int32_t>(_metrics.receivedRtpCyclesPerPacket);
 
-    if (isDTX && timestampAdvance <= static_cast<int32_t>(3 * _samplesPerPacket))
+    if (isDTX && timestampAdvance <= static_cast<int32_t>(3 * toRtpCycles(_samplesPerPacket)))
     {
         const auto allowedReduction =
             static_cast<int32_t>(totalJitterBufferSize - math::roundUpMultiple(_targetDelay, _samplesPerPacket));
+        const auto samplesPerReceivedPacket = static_cast<int32_t>(toSamples(_metrics.receivedRtpCyclesPerPacket));
 
-        if (allowedReduction < static_cast<int32_t>(_metrics.receivedRtpCyclesPerPacket))
+        if (allowedReduction < samplesPerReceivedPacket)
         {
             JBLOG("%u DTX silence", "AudioReceivePipeline", _ssrc);
-            _pcmData.appendSilence(_metrics.receivedRtpCyclesPerPacket - std::max(allowedReduction, 0));
+            _pcmData.appendSilence(samplesPerReceivedPacket - std::max(allowedReduction, 0));
             _head.nextRtpTimestamp += _metrics.receivedRtpCyclesPerPacket;
         }
         return true;
@@ -436,10 +446,10 @@ bool AudioReceivePipeline::dtxHandler(const int16_t sequenceAdvance,
 
 void AudioReceivePipeline::process(const uint64_t timestamp)
 {
-    size_t bufferLevel = _pcmData.size() / _config.channels;
+    size_t bufferLevel = _pcmData.size() / _channels;
 
     for (; _jitterEmergency.counter == 0 && !_jitterBuffer.empty() && bufferLevel < _samplesPerPacket;
-         bufferLevel = _pcmData.size() / _config.channels)
+         bufferLevel = _pcmData.size() / _channels)
     {
         const auto header = _jitterBuffer.getFrontRtp();
         const int16_t sequenceAdvance =
@@ -476,33 +486,33 @@ void AudioReceivePipeline::process(const uint64_t timestamp)
         const uint32_t extendedSequenceNumber = _head.extendedSequenceNumber + sequenceAdvance;
         auto packet = _jitterBuffer.pop();
 
-        int16_t audioData[_samplesPerPacket * 4 * _config.channels];
+        int16_t audioData[_samplesPerPacket * 4 * _channels];
         size_t decodedSamples = 0;
 
         if (isDiscardedPacket(*packet))
         {
-            decodedSamples = std::max(480u, _metrics.receivedRtpCyclesPerPacket);
+            decodedSamples = std::max(_samplesPerPacket / 2, toSamples(_metrics.receivedRtpCyclesPerPacket));
             _decoder.onUnusedPacketReceived(extendedSequenceNumber);
-            std::memset(audioData, 0, decodedSamples);
+            std::memset(audioData, 0, decodedSamples * _channels * sizeof(int16_t));
         }
         else
         {
             decodedSamples = decodePacket(extendedSequenceNumber, timestamp, *packet, audioData);
             if (decodedSamples > 0 && sequenceAdvance == 1)
             {
-                _metrics.receivedRtpCyclesPerPacket = decodedSamples;
+                _metrics.receivedRtpCyclesPerPacket = toRtpCycles(decodedSamples);
             }
         }
 
         _head.extendedSequenceNumber = extendedSequenceNumber;
         _head.nextRtpTimestamp = header->timestamp + _metrics.receivedRtpCyclesPerPacket;
         const auto remainingSamples = reduce(*packet, audioData, decodedSamples, totalJitterBufferSize);
-        if (_pcmData.append(audioData, remainingSamples * _config.channels))
+        if (_pcmData.append(audioData, remainingSamples * _channels))
         {
             JBLOG("ssrc %u added pcm %zu, JB %u (%u), TD %u, eliminated %zu, tstmp %u",
                 "AudioReceivePipeline",
                 _ssrc,
-                _pcmData.size() / _config.channels,
+                _pcmData.size() / _channels,
                 jitterBufferSize(_head.nextRtpTimestamp),
                 _jitterBuffer.count(),
                 _targetDelay,
@@ -524,7 +534,7 @@ void AudioReceivePipeline::process(const uint64_t timestamp)
             JBLOG("%u pcm %zu JB %u",
                 "AudioReceivePipeline",
                 _ssrc,
-                _pcmData.size() / _config.channels,
+                _pcmData.size() / _channels,
                 jitterBufferSize(_head.nextRtpTimestamp));
         }
     }
@@ -1,5 +1,6 @@
 #pragma once
 #include "codec/NoiseFloor.h"
+#include "codec/Opus.h"
 #include "codec/OpusDecoder.h"
 #include "codec/SpscAudioBuffer.h"
 #include "rtp/JitterBufferList.h"
@@ -13,6 +14,8 @@ namespace codec
 /**
  * Audio receive pipe line that performs adaptive jitter buffering and cut off concealment.
  * PCM data buffer is single produce single consumer thread safe. The rest shall run on a single thread context.
+ * Audio is decoded at sampleRate with the given number of channels. Jitter is tracked in RTP cycles and converted
+ * to samples where it is compared to the amount of buffered audio.
  *
  * Mechanisms:
  * - If buffers run empty, the tail of the audio is faded out to avoid pops and clicks.
@@ -37,7 +40,6 @@ class AudioReceivePipeline
 {
     struct Config
     {
-        uint32_t channels = 2;
         uint32_t safeZoneCountBeforeReducingJB = 150;
 
         struct
@@ -53,7 +55,12 @@ class AudioReceivePipeline
     const Config _config;
 
 public:
-    AudioReceivePipeline(uint32_t rtpFrequency, uint32_t ptime, uint32_t maxPackets, int audioLevelExtensionId = 255);
+    AudioReceivePipeline(uint32_t rtpFrequency,
+        uint32_t ptime,
+        uint32_t maxPackets,
+        int audioLevelExtensionId = 255,
+        uint32_t sampleRate = Opus::sampleRate,
+        uint32_t channels = Opus::channelsPerFrame);
 
     // called from same thread context
     bool onRtpPacket(uint32_t extendedSequenceNumber, memory::UniquePacket packet, uint64_t receiveTime);
@@ -63,11 +70,13 @@ public:
     void flush();
 
     // called from mix consumer
-    bool needProcess() const { return _pcmData.size() < _samplesPerPacket * _config.channels; }
-    size_t fetchStereo(size_t sampleCount);
+    bool needProcess() const { return _pcmData.size() < _samplesPerPacket * _channels; }
+    size_t fetch(size_t sampleCount);
 
     const int16_t* getAudio() const { return _receiveBox.audio; }
     uint32_t getAudioSampleCount() const { return _receiveBox.audioSampleCount; }
+    uint32_t getSampleRate() const { return _sampleRate; }
+    uint32_t getChannels() const { return _channels; }
 
 private:
     void init(uint32_t extendedSequenceNumber, const rtp::RtpHeader& header, uint64_t receiveTime);
@@ -84,8 +93,16 @@ private:
     bool shouldWaitForMissingPacket(uint64_t timestamp) const;
     bool dtxHandler(int16_t seqAdvance, int64_t timestampAdvance,uint32_t totalJitterBufferSize);
 
+    uint32_t toSamples(uint32_t rtpCycles) const
+    {
+        return static_cast<uint64_t>(rtpCycles) * _sampleRate / _rtpFrequency;
+    }
+    uint32_t toRtpCycles(uint32_t samples) const { return static_cast<uint64_t>(samples) * _rtpFrequency / _sampleRate; }
+
     uint32_t _ssrc;
     const uint32_t _rtpFrequency;
+    const uint32_t _sampleRate;
+    const uint32_t _channels;
     const uint32_t _samplesPerPacket;
 
     rtp::JitterBufferList _jitterBuffer;
@@ -123,7 +140,7 @@ private:
         uint32_t shrunkPackets = 0;
         uint32_t eliminatedPackets = 0;
         uint32_t eliminatedSamples = 0;
-        uint32_t receivedRtpCyclesPerPacket = 960; // 480, 960, 1440
+        uint32_t receivedRtpCyclesPerPacket = 960; // 480, 960, 1440 at 48kHz rtp clock
     } _metrics;
 
     SpscAudioBuffer<int16_t> _pcmData;
@@ -41,10 +41,12 @@ void swingTailMono(int16_t* data, const uint32_t sampleRate, const size_t count,
     }
 }
 
-void swingTail(int16_t* data, const uint32_t sampleRate, const size_t count)
+void swingTail(int16_t* data, const uint32_t sampleRate, const size_t count, const uint32_t channels)
 {
-    swingTailMono(data, sampleRate, count, 2);
-    swingTailMono(data + 1, sampleRate, count, 2);
+    for (uint32_t channel = 0; channel < channels; ++channel)
+    {
+        swingTailMono(data + channel, sampleRate, count, channels);
+    }
 }
 
 void addToMix(const int16_t* srcAudio, int16_t* mixAudio, size_t count, double amplification)
@@ -55,6 +57,7 @@ void addToMix(const int16_t* srcAudio, int16_t* mixAudio, size_t count, double a
         {
             mixAudio[i] += srcAudio[i];
         }
+        return;
     }
 
     for (size_t i = 0; i < count; ++i)
@@ -73,23 +76,23 @@ void subtractFromMix(const int16_t* srcAudio, int16_t* mixAudio, size_t count, d
 
 /**
  * Eliminate samples at times where energy is low which makes it less audible.
+ * Samples are interleaved and the first channel decides which samples are removed.
  */
-size_t compactStereoTroughs(int16_t* pcmData,
+size_t compactTroughs(int16_t* pcmData,
     size_t samples,
+    const uint32_t channels,
     size_t maxReduction,
     const int16_t silenceThreshold,
     const int16_t deltaThreshold)
 {
-    pcmData[0] = pcmData[0];
-    pcmData[1] = pcmData[1];
     size_t produced = 1;
 
     size_t removedSamples = 0;
     int keepSamples = 0;
     for (size_t i = 1; i < samples - 1; ++i)
     {
-        const int16_t a = pcmData[i * 2 - 2];
-        const int16_t c = pcmData[i * 2 + 2];
+        const int16_t a = pcmData[(i - 1) * channels];
+        const int16_t c = pcmData[(i + 1) * channels];
 
         if (removedSamples < maxReduction && !keepSamples && std::abs(a - c) < deltaThreshold)
         {
@@ -107,15 +110,12 @@ size_t compactStereoTroughs(int16_t* pcmData,
         }
         keepSamples = std::max(0, keepSamples - 1);
 
-        pcmData[produced * 2] = pcmData[i * 2];
-        pcmData[produced * 2 + 1] = pcmData[i * 2 + 1];
-
+        std::memmove(&pcmData[produced * channels], &pcmData[i * channels], channels * sizeof(int16_t));
         ++produced;
     }
 
     const size_t i = samples - 1;
-    pcmData[produced * 2] = pcmData[i * 2];
-    pcmData[produced * 2 + 1] = pcmData[i * 2 + 1];
+    std::memmove(&pcmData[produced * channels], &pcmData[i * channels], channels * sizeof(int16_t));
     ++produced;
 
     return produced;
@@ -26,11 +26,21 @@ void makeStereo(T* data, size_t count)
 }
 
 size_t compactStereo(int16_t* pcmData, size_t size);
-size_t compactStereoTroughs(int16_t* pcmData,
+size_t compactTroughs(int16_t* pcmData,
+    size_t samples,
+    uint32_t channels,
+    size_t maxReduction,
+    int16_t silenceThreshold,
+    int16_t deltaThreshold);
+
+inline size_t compactStereoTroughs(int16_t* pcmData,
     size_t samples,
     size_t maxReduction = 1000,
     int16_t silenceThreshold = 10,
-    int16_t deltaThreshold = 10);
+    int16_t deltaThreshold = 10)
+{
+    return compactTroughs(pcmData, samples, 2, maxReduction, silenceThreshold, deltaThreshold);
+}
 
 template <typename T>
 void clearStereo(T* data, size_t count)
@@ -44,7 +54,7 @@ void copyStereo(const T* srcData, T* data, size_t count)
     std::memcpy(data, srcData, count * 2 * sizeof(T));
 }
 
-void swingTail(int16_t* data, uint32_t sampleRate, size_t count);
+void swingTail(int16_t* data, uint32_t sampleRate, size_t count, uint32_t channels = 2);
 
 void addToMix(const int16_t* srcAudio, int16_t* mixAudio, size_t count, double amplification);
 void subtractFromMix(const int16_t* srcAudio, int16_t* mixAudio, size_t count, double amplification);
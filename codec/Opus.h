@@ -14,6 +14,18 @@ constexpr uint32_t bytesPerSample = sizeof(int16_t);
 constexpr uint32_t payloadType = 111;
 constexpr uint32_t packetsPerSecond = 50; // default ptime
 
+// Sample rates the Opus encoder and decoder can operate at internally
+inline bool isSupportedSampleRate(uint32_t rate)
+{
+    return rate == 8000 || rate == 12000 || rate == 16000 || rate == 24000 || rate == 48000;
+}
+
+// Formats audio can be decoded, mixed and encoded at
+inline bool isSupportedMixFormat(uint32_t rate, uint32_t channels)
+{
+    return isSupportedSampleRate(rate) && channels > 0 && channels <= channelsPerFrame;
+}
+
 } // namespace Opus
 
 } // namespace codec
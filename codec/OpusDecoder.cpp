@@ -13,14 +13,16 @@ struct OpusDecoder::OpaqueDecoderState
     ::OpusDecoder* _state;
 };
 
-OpusDecoder::OpusDecoder()
+OpusDecoder::OpusDecoder(uint32_t sampleRate, uint32_t channels)
     : _initialized(false),
+      _sampleRate(sampleRate),
+      _channels(channels),
       _state(new OpaqueDecoderState{nullptr}),
       _sequenceNumber(0),
       _hasDecodedPacket(false)
 {
     int32_t opusError = 0;
-    _state->_state = opus_decoder_create(Opus::sampleRate, Opus::channelsPerFrame, &opusError);
+    _state->_state = opus_decoder_create(sampleRate, channels, &opusError);
     if (opusError != OPUS_OK)
     {
         return;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "codec/Opus.h"
 #include <cstdint>
 #include <stddef.h>
 
@@ -9,11 +10,13 @@ namespace codec
 class OpusDecoder
 {
 public:
-    OpusDecoder();
+    OpusDecoder(uint32_t sampleRate = Opus::sampleRate, uint32_t channels = Opus::channelsPerFrame);
     ~OpusDecoder();
 
     bool isInitialized() const { return _initialized; }
     bool hasDecoded() const { return _hasDecodedPacket; }
+    uint32_t getSampleRate() const { return _sampleRate; }
+    uint32_t getChannels() const { return _channels; }
 
     uint32_t getExpectedSequenceNumber() const { return _sequenceNumber + 1; }
 
@@ -34,6 +37,8 @@ private:
     struct OpaqueDecoderState;
 
     bool _initialized;
+    const uint32_t _sampleRate;
+    const uint32_t _channels;
     OpaqueDecoderState* _state;
     uint32_t _sequenceNumber;
     bool _hasDecodedPacket;
@@ -11,10 +11,12 @@ struct OpusEncoder::OpaqueEncoderState
     ::OpusEncoder* _state;
 };
 
-OpusEncoder::OpusEncoder() : _initialized(false), _state(new OpaqueEncoderState{nullptr})
+OpusEncoder::OpusEncoder(uint32_t sampleRate, uint32_t channels)
+    : _initialized(false),
+      _state(new OpaqueEncoderState{nullptr})
 {
     int32_t opusError = 0;
-    _state->_state = opus_encoder_create(Opus::sampleRate, Opus::channelsPerFrame, OPUS_APPLICATION_VOIP, &opusError);
+    _state->_state = opus_encoder_create(sampleRate, channels, OPUS_APPLICATION_VOIP, &opusError);
     if (opusError != OPUS_OK)
     {
         return;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "codec/Opus.h"
 #include <cstddef>
 #include <cstdint>
 
@@ -9,7 +10,7 @@ namespace codec
 class OpusEncoder
 {
 public:
-    OpusEncoder();
+    OpusEncoder(uint32_t sampleRate = Opus::sampleRate, uint32_t channels = Opus::channelsPerFrame);
     OpusEncoder(const OpusEncoder&) = delete;
     ~OpusEncoder();
 
@@ -156,6 +156,16 @@ constexpr uint8_t getTid(const uint8_t* payload)
     return (payload[5] >> 0x6) & 0x3;
 }
 
+// Y bit. The frame only depends on the base temporal layer, so a receiver can switch up to this layer here
+constexpr bool isLayerSync(const uint8_t* payload)
+{
+    if (getPayloadDescriptorSize(payload, 6) != 6)
+    {
+        return false;
+    }
+    return ((payload[5] >> 0x5) & 0x1) == 0x1;
+}
+
 constexpr uint16_t getPicId(const uint8_t* payload)
 {
     if (getPayloadDescriptorSize(payload, 6) != 6)
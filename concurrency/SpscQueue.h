@@ -0,0 +1,125 @@
+#pragma once
+#include "memory/Allocator.h"
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <new>
+
+namespace concurrency
+{
+
+// Bounded Single Producer, Single Consumer queue. Only one thread may push and only one thread may pop.
+// Capacity is rounded up to a power of two. Push leaves the value untouched if the queue is full.
+template <typename T>
+class SpscQueue
+{
+    struct Entry
+    {
+        T& value() { return reinterpret_cast<T&>(data); }
+        const T& value() const { return reinterpret_cast<const T&>(data); }
+        alignas(alignof(T)) uint8_t data[sizeof(T)];
+    };
+
+    static uint32_t roundUpToPowerOfTwo(uint32_t value)
+    {
+        uint32_t result = 8;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    static size_t calculateBlockSize(uint32_t capacity) { return memory::page::alignedSpace(capacity * sizeof(Entry)); }
+
+public:
+    typedef T value_type;
+
+    explicit SpscQueue(uint32_t capacity)
+        : _capacity(roundUpToPowerOfTwo(capacity)),
+          _elements(reinterpret_cast<Entry*>(memory::page::allocate(calculateBlockSize(_capacity)))),
+          _writeCursor(0),
+          _readCursor(0)
+    {
+        assert(capacity < 0x80000000u);
+    }
+
+    ~SpscQueue()
+    {
+        clear();
+        memory::page::free(_elements, calculateBlockSize(_capacity));
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // producer only
+    bool push(T&& value)
+    {
+        const auto writePos = _writeCursor.load(std::memory_order_relaxed);
+        if (writePos - _readCursor.load(std::memory_order_acquire) >= _capacity)
+        {
+            return false;
+        }
+
+        new (&_elements[writePos & (_capacity - 1)].value()) T(std::move(value));
+        _writeCursor.store(writePos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only
+    bool pop(T& target)
+    {
+        const auto readPos = _readCursor.load(std::memory_order_relaxed);
+        if (readPos == _writeCursor.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        auto& value = _elements[readPos & (_capacity - 1)].value();
+        target = std::move(value);
+        value.~T();
+        _readCursor.store(readPos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only. Next element to be popped or nullptr if empty
+    const T* front() const
+    {
+        const auto readPos = _readCursor.load(std::memory_order_relaxed);
+        if (readPos == _writeCursor.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+        return &_elements[readPos & (_capacity - 1)].value();
+    }
+
+    // consumer only
+    void clear()
+    {
+        auto readPos = _readCursor.load(std::memory_order_relaxed);
+        for (const auto writePos = _writeCursor.load(std::memory_order_acquire); readPos != writePos; ++readPos)
+        {
+            _elements[readPos & (_capacity - 1)].value().~T();
+        }
+        _readCursor.store(readPos, std::memory_order_release);
+    }
+
+    uint32_t size() const
+    {
+        return _writeCursor.load(std::memory_order_acquire) - _readCursor.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+    bool full() const { return size() >= _capacity; }
+    uint32_t capacity() const { return _capacity; }
+
+private:
+    const uint32_t _capacity;
+    Entry* const _elements;
+
+    alignas(64) std::atomic_uint32_t _writeCursor;
+    alignas(64) std::atomic_uint32_t _readCursor;
+};
+
+} // namespace concurrency
@@ -6,8 +6,12 @@
 #include <pthread.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
+#include <unistd.h>
 #endif
 #include "logger/Logger.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 namespace concurrency
 {
 bool setPriority(std::thread& thread, Priority priority)
@@ -122,4 +126,151 @@ void getThreadName(pthread_t threadId, char* name, size_t& length)
     }
     length = rc;
 }
+
+bool setCpuAffinity(int cpuCore)
+{
+    if (cpuCore < 0)
+    {
+        return true;
+    }
+#ifdef __APPLE__
+    logger::warn("cpu affinity is not supported on this platform", "");
+    return false;
+#else
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpuCore, &cpuSet);
+    const auto rc = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+    if (rc != 0)
+    {
+        logger::warn("Failed to pin thread to cpu %d, err %d", "", cpuCore, rc);
+        return false;
+    }
+    return true;
+#endif
+}
+
+bool setNodeAffinity(int numaNode)
+{
+    if (numaNode < 0)
+    {
+        return true;
+    }
+#ifdef __APPLE__
+    logger::warn("NUMA node affinity is not supported on this platform", "");
+    return false;
+#else
+    const auto cpus = getNodeCpus(numaNode);
+    if (cpus.empty())
+    {
+        logger::warn("NUMA node %d has no cpus", "", numaNode);
+        return false;
+    }
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (auto cpu : cpus)
+    {
+        CPU_SET(cpu, &cpuSet);
+    }
+    const auto rc = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+    if (rc != 0)
+    {
+        logger::warn("Failed to confine thread to NUMA node %d, err %d", "", numaNode, rc);
+        return false;
+    }
+    return true;
+#endif
+}
+
+bool setAffinity(const PollConfig& pollConfig)
+{
+    if (pollConfig.cpuCore >= 0)
+    {
+        return setCpuAffinity(pollConfig.cpuCore);
+    }
+    return setNodeAffinity(pollConfig.numaNode);
+}
+
+std::vector<int> getNodeCpus(int numaNode)
+{
+#ifdef __APPLE__
+    return std::vector<int>();
+#else
+    char fileName[64];
+    snprintf(fileName, sizeof(fileName), "/sys/devices/system/node/node%d/cpulist", numaNode);
+    FILE* file = fopen(fileName, "r");
+    if (!file)
+    {
+        return std::vector<int>();
+    }
+
+    char cpuList[512];
+    const bool isRead = fgets(cpuList, sizeof(cpuList), file) != nullptr;
+    fclose(file);
+    if (!isRead)
+    {
+        return std::vector<int>();
+    }
+    cpuList[strcspn(cpuList, "\n")] = '\0';
+    return parseCpuList(cpuList);
+#endif
+}
+
+int getCurrentNumaNode()
+{
+#ifdef __APPLE__
+    return 0;
+#else
+    unsigned int cpu = 0;
+    unsigned int node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+    {
+        return 0;
+    }
+    return static_cast<int>(node);
+#endif
+}
+
+std::vector<int> parseCpuList(const std::string& cpuList)
+{
+    std::vector<int> cpus;
+    const char* p = cpuList.c_str();
+    while (*p)
+    {
+        char* end = nullptr;
+        const auto first = std::strtol(p, &end, 10);
+        if (end == p || first < 0)
+        {
+            return std::vector<int>();
+        }
+        auto last = first;
+        p = end;
+        if (*p == '-')
+        {
+            ++p;
+            last = std::strtol(p, &end, 10);
+            if (end == p || last < first)
+            {
+                return std::vector<int>();
+            }
+            p = end;
+        }
+
+        for (auto cpu = first; cpu <= last; ++cpu)
+        {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+
+        if (*p == ',')
+        {
+            ++p;
+        }
+        else if (*p != '\0')
+        {
+            return std::vector<int>();
+        }
+    }
+    return cpus;
+}
 } // namespace concurrency
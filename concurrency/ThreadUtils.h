@@ -1,5 +1,7 @@
 #pragma once
+#include <string>
 #include <thread>
+#include <vector>
 namespace concurrency
 {
 enum class Priority
@@ -12,4 +14,41 @@ void setThreadName(const char* name);
 
 void getThreadName(char* name, size_t& length);
 void getThreadName(pthread_t threadId, char* name, size_t& length);
+
+// How a latency critical thread waits for work. A busy polling thread spins instead of sleeping and should be pinned
+// to an isolated core.
+struct PollConfig
+{
+    bool busyPoll = false;
+    int cpuCore = -1; // -1 leaves placement to the scheduler
+    int numaNode = -1; // threads without a core run on the cpus of this node. -1 for any node
+};
+
+// pins the calling thread to a cpu core
+bool setCpuAffinity(int cpuCore);
+
+// confines the calling thread to the cpus of a NUMA node
+bool setNodeAffinity(int numaNode);
+
+// pins the calling thread to the core of the poll config, or else to its NUMA node
+bool setAffinity(const PollConfig& pollConfig);
+
+// cpus of a NUMA node as listed in sysfs. Empty if there is no such node
+std::vector<int> getNodeCpus(int numaNode);
+
+// NUMA node of the cpu the calling thread currently runs on. 0 if unknown
+int getCurrentNumaNode();
+
+// parses cpu lists like "2,4-7". Returns empty vector on malformed input
+std::vector<int> parseCpuList(const std::string& cpuList);
+
+// hint to the cpu that we are spinning
+inline void cpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
 } // namespace concurrency
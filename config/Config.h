@@ -15,6 +15,8 @@ public:
     CFG_PROP(bool, logStdOut, true);
     CFG_PROP(bool, logStdErr, true);
     CFG_PROP(std::string, logLevel, "INFO");
+    // format log messages on the logger thread instead of the logging thread
+    CFG_PROP(bool, logDeferredFormatting, false);
     CFG_PROP(bool, enableSrtpNullCipher, false);
 
     // If mixer does not receive any packets during this timeout, it's considered abandoned and is garbage collected...
@@ -22,11 +24,34 @@ public:
     // ...unless it has barbell connections, and 'deleteEmptyConferencesWithBarbells' is false.
     CFG_PROP(bool, deleteEmptyConferencesWithBarbells, false);
     CFG_PROP(int, numWorkerTreads, 0);
+
+    CFG_GROUP()
+    // Threads are pinned to the listed cores. With busyPoll the pinned threads spin on job queues and sockets instead
+    // of sleeping, which removes wake up jitter but occupies the cores fully. Use cores isolated from the scheduler.
+    CFG_PROP(bool, busyPoll, false);
+    CFG_PROP(std::string, workerCores, ""); // cpu list for RT workers, e.g. "2-5,8". Unlisted workers are not pinned
+    CFG_PROP(int, engineCore, -1);
+    CFG_PROP(int, networkCore, -1);
+    CFG_PROP(uint32_t, socketBusyPollUs, 50); // SO_BUSY_POLL on UDP sockets in busy poll mode, 0 to disable
+    // Workers, engine and network threads not pinned to a core run on the cpus of this NUMA node and the packet pools
+    // are placed on it. On multi socket hosts run one bridge per node. -1 leaves placement to the OS
+    CFG_PROP(int, numaNode, -1);
+    CFG_GROUP_END(threads)
+    CFG_GROUP()
+    // Measure how long jobs wait in the worker job queue. Costs two clock reads per job
+    CFG_PROP(bool, jobQueueWait, false);
+    CFG_GROUP_END(metrics)
+    // read time from the invariant TSC instead of clock_gettime, if the CPU has one
+    CFG_PROP(bool, tscClock, false);
     CFG_PROP(std::string, logFile, "/tmp/smb.log");
 
     CFG_PROP(uint32_t, defaultLastN, 5);
 
     CFG_PROP(uint32_t, maxDefaultLevelBandwidthKbps, 3000);
+    // Let receivers between two simulcast levels get the higher level at reduced VP8 frame rate
+    CFG_PROP(bool, temporalLayerThinning, false);
+    // Cache inbound video once per sender and rebuild retransmissions per recipient, instead of one cache per recipient
+    CFG_PROP(bool, inboundNackCache, false);
     CFG_PROP(uint32_t, rtpForwardInterval, 10); // ms
 
     CFG_GROUP()
@@ -43,6 +68,16 @@ public:
     CFG_PROP(uint32_t, lastN, 3);
     CFG_PROP(uint32_t, lastNextra, 2);
     CFG_PROP(uint32_t, activeTalkerSilenceThresholdDb, 18);
+    // Mixed audio streams in a conference from which the mix is computed in parallel on worker jobs. 0 disables.
+    CFG_PROP(uint32_t, parallelMixThreshold, 0);
+    // Contributors per partial mix and recipients per batch on the parallel mix path
+    CFG_PROP(uint32_t, parallelMixBatchSize, 16);
+    // Internal format of decode, mix and encode for mixed audio. The encoder is limited to narrowband, so
+    // 16000 Hz mono gives the same output for a fraction of the work. Opus rates 8000-48000 Hz.
+    CFG_PROP(uint32_t, mixSampleRate, 48000);
+    CFG_PROP(uint32_t, mixChannels, 2);
+    // When the audio level extension is missing, the level is decoded from every n:th packet and reused in between
+    CFG_PROP(uint32_t, levelDecodeInterval, 2);
     CFG_GROUP_END(audio);
 
     CFG_GROUP()
@@ -62,6 +97,10 @@ public:
     CFG_PROP(uint16_t, udpPortRangeHigh, 26000);
     CFG_PROP(uint32_t, sharedPorts, 1);
     CFG_PROP(uint32_t, maxCandidateCount, 5 * 3);
+    // answer binding requests of connected sessions on the receive thread of shared ports
+    CFG_PROP(bool, stunFastPath, false);
+    // ICE-lite for client transports on shared ports. Only answers checks, clients must run full ICE
+    CFG_PROP(bool, lite, false);
 
     CFG_GROUP()
     CFG_PROP(bool, enable, false);
@@ -77,6 +116,8 @@ public:
     CFG_PROP(std::string, packetLogLocation, "");
     CFG_PROP(double, packetOverhead, 0.1);
     CFG_PROP(bool, enable, true);
+    // offer transport wide sequence numbers and transport-cc feedback to clients
+    CFG_PROP(bool, transportCc, false);
     CFG_GROUP_END(bwe);
 
     CFG_GROUP() // rate control
@@ -87,13 +128,28 @@ public:
     CFG_PROP(bool, debugLog, false);
     CFG_PROP(uint64_t, cooldownInterval, 30); // Time until rtcl inactivates after last received video
     CFG_PROP(bool, useUplinkEstimate, true);
+    // video that waited longer than this in the pacing queue is dropped a frame at a time. 0 disables
+    CFG_PROP(uint32_t, pacingDeadlineMs, 0);
     CFG_GROUP_END(rctl)
 
     CFG_GROUP()
     CFG_PROP(uint16_t, singlePort, 10500);
     CFG_PROP(uint32_t, sharedPorts, 1);
+    // When set, recordings are written to segmented rtpdump files in this directory instead of sent to recorders
+    CFG_PROP(std::string, localDirectory, "");
+    CFG_PROP(uint64_t, localSegmentSize, 256 * 1024 * 1024);
+    CFG_PROP(uint32_t, localWriteBufferSize, 1024 * 1024);
+    // Write buffers shared by all recorded streams, bounds buffer memory to localWriteBuffers * localWriteBufferSize
+    CFG_PROP(uint32_t, localWriteBuffers, 16);
+    CFG_PROP(uint64_t, localFlushInterval, utils::Time::ms * 500);
     CFG_GROUP_END(recording)
 
+    CFG_GROUP()
+    CFG_PROP(std::string, directory, ""); // packet capture requests are rejected unless set
+    CFG_PROP(uint32_t, maxFileSizeMB, 64);
+    CFG_PROP(uint32_t, maxPacketsPerSecond, 5000);
+    CFG_GROUP_END(capture)
+
     CFG_GROUP()
     CFG_PROP(uint32_t, minBitrate, 900);
     // CFG_PROP(uint32_t, maxBitrate, 7500);
@@ -135,6 +191,8 @@ public:
 
     CFG_GROUP()
     CFG_PROP(uint32_t, sendPool, 128 * 1024); // # packets in send pool. Receive pool will have /4 as many
+    // Back packet pools with 2MB pages, reserved in vm.nr_hugepages or else transparent huge pages
+    CFG_PROP(bool, hugePages, false);
     CFG_GROUP_END(mem);
 
     CFG_GROUP()
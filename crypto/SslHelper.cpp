@@ -1,3 +1,5 @@
+// SHA1 block functions are deprecated in OpenSSL 3 but are the only way to copy a digest state without allocation
+#define OPENSSL_SUPPRESS_DEPRECATED
 #include "crypto/SslHelper.h"
 #include <array>
 #include <cassert>
@@ -151,6 +153,81 @@ void HMAC::compute(uint8_t* sha) const
     assert(outLen == 20);
 }
 
+// without a key, the MAC is computed with an empty key and will not match a peer's MAC
+HmacSha1::HmacSha1()
+{
+    setKey(nullptr, 0);
+}
+
+HmacSha1::HmacSha1(const void* key, int keyLength)
+{
+    setKey(nullptr, 0);
+    init(key, keyLength);
+}
+
+bool HmacSha1::init(const void* key, int keyLength)
+{
+    assert(keyLength >= 0);
+    if (key == nullptr || keyLength <= 0)
+    {
+        setKey(nullptr, 0);
+        assert(false);
+        return false;
+    }
+
+    setKey(key, keyLength);
+    return true;
+}
+
+void HmacSha1::setKey(const void* key, int keyLength)
+{
+    uint8_t keyBlock[SHA_CBLOCK];
+    std::memset(keyBlock, 0, sizeof(keyBlock));
+    if (keyLength > SHA_CBLOCK)
+    {
+        SHA1(reinterpret_cast<const uint8_t*>(key), keyLength, keyBlock);
+    }
+    else if (keyLength > 0)
+    {
+        std::memcpy(keyBlock, key, keyLength);
+    }
+
+    uint8_t pad[SHA_CBLOCK];
+    for (size_t i = 0; i < sizeof(pad); ++i)
+    {
+        pad[i] = keyBlock[i] ^ 0x36;
+    }
+    SHA1_Init(&_inner);
+    SHA1_Update(&_inner, pad, sizeof(pad));
+
+    for (size_t i = 0; i < sizeof(pad); ++i)
+    {
+        pad[i] = keyBlock[i] ^ 0x5C;
+    }
+    SHA1_Init(&_outer);
+    SHA1_Update(&_outer, pad, sizeof(pad));
+}
+
+HmacSha1::Digest::Digest(const HmacSha1& key) : _key(key), _ctx(key._inner) {}
+
+void HmacSha1::Digest::add(const void* data, int length)
+{
+    assert(length > 0);
+    SHA1_Update(&_ctx, data, length);
+}
+
+/**
+ * @brief computes 20B output
+ */
+void HmacSha1::Digest::compute(uint8_t* sha)
+{
+    uint8_t innerHash[SHA_DIGEST_LENGTH];
+    SHA1_Final(innerHash, &_ctx);
+    _ctx = _key._outer;
+    SHA1_Update(&_ctx, innerHash, sizeof(innerHash));
+    SHA1_Final(sha, &_ctx);
+}
+
 MD5::MD5() : _ctx(EVP_MD_CTX_new())
 {
     reset();
@@ -5,6 +5,7 @@
 #include <openssl/evp.h>
 #include <openssl/hmac.h>
 #include <openssl/opensslv.h>
+#include <openssl/sha.h>
 #include <string>
 #include <vector>
 
@@ -47,6 +48,39 @@ private:
 #endif
 };
 
+/**
+ * HMAC-SHA1 with the inner and outer key pads hashed once in init. A MAC is computed by copying the two
+ * precomputed SHA1 states, which avoids the key schedule and context reset of HMAC on short messages.
+ * Immutable after init and may be shared between threads. Each computation uses its own Digest.
+ */
+class HmacSha1
+{
+public:
+    HmacSha1();
+    HmacSha1(const void* key, int keyLength);
+
+    bool init(const void* key, int keyLength);
+
+    class Digest
+    {
+    public:
+        explicit Digest(const HmacSha1& key);
+
+        void add(const void* data, int length);
+        void compute(uint8_t* sha);
+
+    private:
+        const HmacSha1& _key;
+        SHA_CTX _ctx;
+    };
+
+private:
+    void setKey(const void* key, int keyLength);
+
+    SHA_CTX _inner;
+    SHA_CTX _outer;
+};
+
 class MD5
 {
 public:
@@ -15,7 +15,8 @@ enum class StatusCode : uint32_t
     INTERNAL_SERVER_ERROR = 500,
     BAD_REQUEST = 400,
     NOT_FOUND = 404,
-    METHOD_NOT_ALLOWED = 405
+    METHOD_NOT_ALLOWED = 405,
+    CONFLICT = 409
 };
 
 struct Response
@@ -3,6 +3,7 @@
 #include "TimerQueue.h"
 #include "jobmanager/Job.h"
 #include "memory/PoolAllocator.h"
+#include "utils/Metrics.h"
 #include "utils/Trackers.h"
 #include <list>
 #include <memory>
@@ -32,10 +33,12 @@ namespace jobmanager
 class JobManager // TODO rename to MainJobQueue or MpmcJobQueue
 {
 public:
-    JobManager(TimerQueue& timerQueue, size_t poolSize = 4096 * 8)
+    /** @param measureQueueWait observe the job queue wait time in utils::metrics::jobQueueWait. */
+    JobManager(TimerQueue& timerQueue, size_t poolSize = 4096 * 8, bool measureQueueWait = false)
         : _jobQueue(poolSize),
           _jobPool(poolSize, "JobManagerPool"),
           _running(true),
+          _measureQueueWait(measureQueueWait),
           _timers(timerQueue)
     {
     }
@@ -102,7 +105,7 @@ public:
 
     bool addJobItem(MultiStepJob* job)
     {
-        if (!_jobQueue.push(job))
+        if (!_jobQueue.push(QueuedJob{job, _measureQueueWait ? utils::Time::getAbsoluteTime() : 0}))
         {
             assert(false);
             freeJob(job);
@@ -132,10 +135,14 @@ public:
 
     MultiStepJob* pop()
     {
-        MultiStepJob* job;
-        if (_running.load(std::memory_order::memory_order_relaxed) && _jobQueue.pop(job))
+        QueuedJob queuedJob;
+        if (_running.load(std::memory_order::memory_order_relaxed) && _jobQueue.pop(queuedJob))
         {
-            return job;
+            if (_measureQueueWait)
+            {
+                utils::metrics::jobQueueWait.observe(utils::Time::getAbsoluteTime() - queuedJob.enqueueTimestamp);
+            }
+            return queuedJob.job;
         }
         else
         {
@@ -153,9 +160,16 @@ public:
     static const auto maxJobSize = 26 * sizeof(uint64_t);
 
 private:
-    concurrency::MpmcQueue<MultiStepJob*> _jobQueue;
+    struct QueuedJob
+    {
+        MultiStepJob* job;
+        uint64_t enqueueTimestamp;
+    };
+
+    concurrency::MpmcQueue<QueuedJob> _jobQueue;
     memory::PoolAllocator<maxJobSize> _jobPool;
     std::atomic<bool> _running;
+    const bool _measureQueueWait;
 
     TimerQueue& _timers;
 };
@@ -12,12 +12,16 @@ thread_local jobmanager::WorkerThread* workerThreadHandler = nullptr;
 namespace jobmanager
 {
 
-WorkerThread::WorkerThread(jobmanager::JobManager& jobManager, bool yieldEnabled, const char* name)
+WorkerThread::WorkerThread(jobmanager::JobManager& jobManager,
+    bool yieldEnabled,
+    const char* name,
+    const concurrency::PollConfig& pollConfig)
     : _running(true),
       _jobManager(jobManager),
       _backgroundJobCount(0),
       _yieldEnabled(yieldEnabled),
       _name(name ? name : "Worker"),
+      _pollConfig(pollConfig),
       _thread([this] { this->run(); })
 {
 }
@@ -48,6 +52,7 @@ uint32_t WorkerThread::processBackgroundJobs()
         if (backgroundJob.job && !backgroundJob.running)
         {
             backgroundJob.running = true;
+            utils::Time::invalidateApproximateTime();
             const bool runAgain = backgroundJob.job->runStep();
             if (runAgain)
             {
@@ -73,6 +78,7 @@ uint32_t WorkerThread::processBackgroundJobs()
 void WorkerThread::run()
 {
     concurrency::setThreadName(_name.c_str());
+    concurrency::setAffinity(_pollConfig);
     workerThreadHandler = this;
     _backgroundJobs.reserve(512);
 
@@ -88,6 +94,10 @@ void WorkerThread::run()
             {
                 pollInterval = 64;
             }
+            else if (_pollConfig.busyPoll)
+            {
+                concurrency::cpuRelax();
+            }
             else
             {
                 utils::Time::nanoSleep(pollInterval);
@@ -118,6 +128,7 @@ bool WorkerThread::processJobs()
             break;
         }
 
+        utils::Time::invalidateApproximateTime();
         bool runAgain = job->runStep();
         if (!runAgain)
         {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "concurrency/ThreadUtils.h"
 #include "jobmanager/Job.h"
 #include <thread>
 #include <vector>
@@ -11,7 +12,10 @@ class JobManager;
 class WorkerThread
 {
 public:
-    explicit WorkerThread(jobmanager::JobManager& jobManager, bool yieldEnabled, const char* name = nullptr);
+    explicit WorkerThread(jobmanager::JobManager& jobManager,
+        bool yieldEnabled,
+        const char* name = nullptr,
+        const concurrency::PollConfig& pollConfig = concurrency::PollConfig());
     ~WorkerThread();
 
     void stop();
@@ -43,6 +47,7 @@ private:
 
     bool _yieldEnabled;
     std::string _name;
+    const concurrency::PollConfig _pollConfig;
     std::thread _thread; // must be last
 };
 
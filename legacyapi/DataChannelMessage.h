@@ -44,7 +44,7 @@ inline void addUserMediaMapStart(utils::StringBuilder<1024>& outMessage)
 
 inline void addUserMediaEndpointStart(utils::StringBuilder<1024>& outMessage, const char* endpointId)
 {
-    if (!outMessage.endsWidth('['))
+    if (!outMessage.endsWith('['))
     {
         outMessage.append(",");
     }
@@ -60,7 +60,7 @@ inline void addUserMediaEndpointEnd(utils::StringBuilder<1024>& outMessage)
 
 inline void addUserMediaSsrc(utils::StringBuilder<1024>& outMessage, uint32_t ssrc)
 {
-    if (!outMessage.endsWidth('['))
+    if (!outMessage.endsWith('['))
     {
         outMessage.append(",");
     }
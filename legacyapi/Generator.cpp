@@ -20,6 +20,7 @@ nlohmann::json generateTransport(const legacyapi::Transport& transport)
     setIfExists(transportJson, "xmlns", transport._xmlns);
     setIfExists(transportJson, "ufrag", transport._ufrag);
     setIfExists(transportJson, "pwd", transport._pwd);
+    setIfExists(transportJson, "ice-lite", transport._iceLite);
     transportJson["rtcp-mux"] = transport._rtcpMux;
 
     if (!transport._fingerprints.empty())
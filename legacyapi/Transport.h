@@ -15,6 +15,7 @@ struct Transport
     bool _rtcpMux;
     utils::Optional<std::string> _ufrag;
     utils::Optional<std::string> _pwd;
+    utils::Optional<bool> _iceLite;
     std::vector<Fingerprint> _fingerprints;
     std::vector<Candidate> _candidates;
     utils::Optional<Connection> _connection;
@@ -0,0 +1,441 @@
+#include "logger/DeferredFormat.h"
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+namespace logger
+{
+namespace deferred
+{
+
+namespace
+{
+
+enum class ArgType
+{
+    NONE,
+    INT,
+    LONG,
+    LONGLONG,
+    INTMAX,
+    SIZE,
+    PTRDIFF,
+    DOUBLE,
+    LONGDOUBLE,
+    POINTER,
+    STRING,
+    UNSUPPORTED
+};
+
+struct ConversionSpec
+{
+    size_t length; // from '%' to and including the conversion character
+    int starCount; // number of int arguments for '*' width and precision
+    ArgType type;
+};
+
+// format points at '%'
+ConversionSpec parseSpec(const char* format)
+{
+    ConversionSpec spec{1, 0, ArgType::NONE};
+    const char* p = format + 1;
+    if (*p == '%')
+    {
+        spec.length = 2;
+        return spec;
+    }
+
+    while (*p && std::strchr("-+ #0'", *p))
+    {
+        ++p;
+    }
+
+    if (*p == '*')
+    {
+        ++spec.starCount;
+        ++p;
+    }
+    while (std::isdigit(*p))
+    {
+        ++p;
+    }
+
+    if (*p == '.')
+    {
+        ++p;
+        if (*p == '*')
+        {
+            ++spec.starCount;
+            ++p;
+        }
+        while (std::isdigit(*p))
+        {
+            ++p;
+        }
+    }
+
+    int longCount = 0;
+    char lengthModifier = 0;
+    if (*p == 'h')
+    {
+        ++p;
+        if (*p == 'h')
+        {
+            ++p;
+        }
+    }
+    else if (*p == 'l')
+    {
+        ++p;
+        longCount = 1;
+        if (*p == 'l')
+        {
+            ++p;
+            longCount = 2;
+        }
+    }
+    else if (*p == 'j' || *p == 'z' || *p == 't' || *p == 'L')
+    {
+        lengthModifier = *p;
+        ++p;
+    }
+
+    switch (*p)
+    {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+        if (longCount == 2)
+        {
+            spec.type = ArgType::LONGLONG;
+        }
+        else if (longCount == 1)
+        {
+            spec.type = ArgType::LONG;
+        }
+        else if (lengthModifier == 'j')
+        {
+            spec.type = ArgType::INTMAX;
+        }
+        else if (lengthModifier == 'z')
+        {
+            spec.type = ArgType::SIZE;
+        }
+        else if (lengthModifier == 't')
+        {
+            spec.type = ArgType::PTRDIFF;
+        }
+        else
+        {
+            spec.type = ArgType::INT;
+        }
+        break;
+    case 'c':
+        spec.type = longCount ? ArgType::UNSUPPORTED : ArgType::INT;
+        break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        spec.type = lengthModifier == 'L' ? ArgType::LONGDOUBLE : ArgType::DOUBLE;
+        break;
+    case 'p':
+        spec.type = ArgType::POINTER;
+        break;
+    case 's':
+        spec.type = longCount ? ArgType::UNSUPPORTED : ArgType::STRING;
+        break;
+    default:
+        spec.type = ArgType::UNSUPPORTED;
+        break;
+    }
+
+    if (*p)
+    {
+        ++p;
+    }
+    spec.length = p - format;
+    return spec;
+}
+
+class ArgumentWriter
+{
+public:
+    ArgumentWriter(uint8_t* buffer, size_t capacity) : _buffer(buffer), _capacity(capacity), _position(0) {}
+
+    template <typename T>
+    bool write(T value)
+    {
+        return write(&value, sizeof(T));
+    }
+
+    bool write(const void* data, size_t length)
+    {
+        if (_position + length > _capacity)
+        {
+            return false;
+        }
+        std::memcpy(_buffer + _position, data, length);
+        _position += length;
+        return true;
+    }
+
+    size_t size() const { return _position; }
+
+private:
+    uint8_t* _buffer;
+    const size_t _capacity;
+    size_t _position;
+};
+
+class ArgumentReader
+{
+public:
+    ArgumentReader(const uint8_t* buffer, size_t length) : _buffer(buffer), _length(length), _position(0) {}
+
+    template <typename T>
+    bool read(T& value)
+    {
+        if (_position + sizeof(T) > _length)
+        {
+            return false;
+        }
+        std::memcpy(&value, _buffer + _position, sizeof(T));
+        _position += sizeof(T);
+        return true;
+    }
+
+    const char* readString()
+    {
+        const char* str = reinterpret_cast<const char*>(_buffer + _position);
+        const size_t remaining = _length - _position;
+        const size_t length = strnlen(str, remaining);
+        if (length == remaining)
+        {
+            return nullptr;
+        }
+        _position += length + 1;
+        return str;
+    }
+
+private:
+    const uint8_t* _buffer;
+    const size_t _length;
+    size_t _position;
+};
+
+template <typename T>
+int formatValue(char* output,
+    size_t length,
+    const char* spec,
+    const ConversionSpec& conversion,
+    const int* stars,
+    T value)
+{
+    switch (conversion.starCount)
+    {
+    case 0:
+        return snprintf(output, length, spec, value);
+    case 1:
+        return snprintf(output, length, spec, stars[0], value);
+    default:
+        return snprintf(output, length, spec, stars[0], stars[1], value);
+    }
+}
+
+template <typename T>
+int formatCaptured(char* output,
+    size_t length,
+    const char* spec,
+    const ConversionSpec& conversion,
+    const int* stars,
+    ArgumentReader& reader)
+{
+    T value;
+    if (!reader.read(value))
+    {
+        return -1;
+    }
+    return formatValue(output, length, spec, conversion, stars, value);
+}
+
+} // namespace
+
+int capture(uint8_t* buffer, size_t capacity, const char* format, va_list args)
+{
+    ArgumentWriter writer(buffer, capacity);
+    for (const char* p = std::strchr(format, '%'); p;)
+    {
+        const auto conversion = parseSpec(p);
+        p = std::strchr(p + conversion.length, '%');
+        if (conversion.type == ArgType::NONE)
+        {
+            continue;
+        }
+
+        for (int i = 0; i < conversion.starCount; ++i)
+        {
+            if (!writer.write(va_arg(args, int)))
+            {
+                return -1;
+            }
+        }
+
+        bool captured = false;
+        switch (conversion.type)
+        {
+        case ArgType::INT:
+            captured = writer.write(va_arg(args, int));
+            break;
+        case ArgType::LONG:
+            captured = writer.write(va_arg(args, long));
+            break;
+        case ArgType::LONGLONG:
+            captured = writer.write(va_arg(args, long long));
+            break;
+        case ArgType::INTMAX:
+            captured = writer.write(va_arg(args, intmax_t));
+            break;
+        case ArgType::SIZE:
+            captured = writer.write(va_arg(args, size_t));
+            break;
+        case ArgType::PTRDIFF:
+            captured = writer.write(va_arg(args, ptrdiff_t));
+            break;
+        case ArgType::DOUBLE:
+            captured = writer.write(va_arg(args, double));
+            break;
+        case ArgType::LONGDOUBLE:
+            captured = writer.write(va_arg(args, long double));
+            break;
+        case ArgType::POINTER:
+            captured = writer.write(va_arg(args, void*));
+            break;
+        case ArgType::STRING:
+        {
+            const char* str = va_arg(args, const char*);
+            if (!str)
+            {
+                str = "(null)";
+            }
+            captured = writer.write(str, std::strlen(str) + 1);
+            break;
+        }
+        default:
+            return -1;
+        }
+
+        if (!captured)
+        {
+            return -1;
+        }
+    }
+
+    return static_cast<int>(writer.size());
+}
+
+int format(char* output, size_t length, const char* format, const uint8_t* arguments, size_t argumentsLength)
+{
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    ArgumentReader reader(arguments, argumentsLength);
+    const size_t maxLength = length - 1;
+    size_t position = 0;
+    const char* p = format;
+    while (*p && position < maxLength)
+    {
+        if (*p != '%')
+        {
+            output[position++] = *p++;
+            continue;
+        }
+
+        const auto conversion = parseSpec(p);
+        char spec[32];
+        if (conversion.type == ArgType::NONE || conversion.length >= sizeof(spec))
+        {
+            output[position++] = '%';
+            p += conversion.length;
+            continue;
+        }
+
+        std::memcpy(spec, p, conversion.length);
+        spec[conversion.length] = '\0';
+        p += conversion.length;
+
+        int stars[2] = {0, 0};
+        for (int i = 0; i < conversion.starCount; ++i)
+        {
+            reader.read(stars[i]);
+        }
+
+        char* out = output + position;
+        const size_t outLength = length - position;
+        int written = -1;
+        switch (conversion.type)
+        {
+        case ArgType::INT:
+            written = formatCaptured<int>(out, outLength, spec, conversion, stars, reader);
+            break;
+        case ArgType::LONG:
+            written = formatCaptured<long>(out, outLength, spec, conversion, stars, reader);
+            break;
+        case ArgType::LONGLONG:
+            written = formatCaptured<long long>(out, outLength, spec, conversion, stars, reader);
+            break;
+        case ArgType::INTMAX:
+            written = formatCaptured<intmax_t>(out, outLength, spec, conversion, stars, reader);
+            break;
+        case ArgType::SIZE:
+            written = formatCaptured<size_t>(out, outLength, spec, conversion, stars, reader);
+            break;
+        case ArgType::PTRDIFF:
+            written = formatCaptured<ptrdiff_t>(out, outLength, spec, conversion, stars, reader);
+            break;
+        case ArgType::DOUBLE:
+            written = formatCaptured<double>(out, outLength, spec, conversion, stars, reader);
+            break;
+        case ArgType::LONGDOUBLE:
+            written = formatCaptured<long double>(out, outLength, spec, conversion, stars, reader);
+            break;
+        case ArgType::POINTER:
+            written = formatCaptured<void*>(out, outLength, spec, conversion, stars, reader);
+            break;
+        case ArgType::STRING:
+        {
+            const char* str = reader.readString();
+            if (str)
+            {
+                written = formatValue(out, outLength, spec, conversion, stars, str);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+
+        if (written < 0)
+        {
+            break;
+        }
+        position += std::min(static_cast<size_t>(written), maxLength - position);
+    }
+
+    output[position] = '\0';
+    return static_cast<int>(position);
+}
+
+} // namespace deferred
+} // namespace logger
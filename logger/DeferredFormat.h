@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+
+namespace logger
+{
+namespace deferred
+{
+
+/**
+ * Copies the arguments of a printf style call into buffer as raw bytes, so the formatting can be done later on
+ * another thread. Strings are copied. The format string itself is not copied and must outlive the captured
+ * arguments, which holds for string literals.
+ * Returns the number of bytes used, or -1 if the format has conversions that cannot be captured (%n, wide strings)
+ * or the arguments do not fit. args is consumed in either case.
+ */
+int capture(uint8_t* buffer, size_t capacity, const char* format, va_list args);
+
+/**
+ * Formats arguments captured by capture() into output, with the same result as snprintf on the original arguments.
+ * Returns the length of the produced string, truncated to fit length - 1.
+ */
+int format(char* output, size_t length, const char* format, const uint8_t* arguments, size_t argumentsLength);
+
+} // namespace deferred
+} // namespace logger
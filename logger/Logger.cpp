@@ -47,6 +47,14 @@ void disableStdErr()
     }
 }
 
+void setDeferredFormatting(bool enabled)
+{
+    if (_logThread)
+    {
+        _logThread->setDeferredFormatting(enabled);
+    }
+}
+
 void logv(const char* logLevel, const char* logGroup, const bool immediate, const char* format, va_list args)
 {
     if (_logThread)
@@ -100,6 +100,8 @@ __attribute__((format(printf, 1, 3))) inline void errorImmediate(const char* for
 
 void disableStdOut();
 void disableStdErr();
+// Format log messages on the logger thread instead of the calling thread. Format strings must be string literals.
+void setDeferredFormatting(bool enabled);
 
 inline void logStack(const char* logGroup)
 {
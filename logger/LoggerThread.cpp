@@ -1,4 +1,5 @@
 #include "LoggerThread.h"
+#include "DeferredFormat.h"
 #include "concurrency/ThreadUtils.h"
 #include "utils/Time.h"
 #include <execinfo.h>
@@ -10,6 +11,8 @@ namespace logger
 {
 
 const auto timeStringLength = 32;
+const size_t maxDeferredArgumentsLength = 1024;
+const size_t maxDeferredMessageLength = 4096;
 
 LoggerThread::LoggerThread(const char* logFileName, bool logStdOut, bool logStdErr, size_t backlogSize)
     : _running(true),
@@ -17,6 +20,7 @@ LoggerThread::LoggerThread(const char* logFileName, bool logStdOut, bool logStdE
       _logFile(nullptr),
       _logStdOut(logStdOut),
       _logStdErr(logStdErr),
+      _deferredFormatting(false),
       _logFileName(logFileName && std::strlen(logFileName) > 0 ? logFileName : ""),
       _droppedLogs(0),
       _lastMaintenanceTime(0),
@@ -49,6 +53,7 @@ void LoggerThread::run()
 {
     concurrency::setThreadName("Logger");
     char localTime[timeStringLength];
+    char deferredMessage[maxDeferredMessageLength + 1];
     bool gotLogItem = false;
     _reOpenLog.test_and_set();
     reopenLogFile();
@@ -61,17 +66,30 @@ void LoggerThread::run()
             gotLogItem = true;
             formatTime(item->timestamp, localTime);
 
+            const char* message = item->message;
+            if (item->format)
+            {
+                const size_t prefixLength = item->argumentsOffset - 1;
+                std::memcpy(deferredMessage, item->message, prefixLength);
+                deferred::format(deferredMessage + prefixLength,
+                    sizeof(deferredMessage) - prefixLength,
+                    item->format,
+                    reinterpret_cast<const uint8_t*>(item->message + item->argumentsOffset),
+                    item->argumentsLength);
+                message = deferredMessage;
+            }
+
             if (_logStdOut)
             {
-                formatTo(stdout, localTime, item->logLevel, item->threadId, item->message);
+                formatTo(stdout, localTime, item->logLevel, item->threadId, message);
             }
             if (_logStdErr && !std::strcmp(item->logLevel, "ERROR"))
             {
-                formatTo(stderr, localTime, item->logLevel, item->threadId, item->message);
+                formatTo(stderr, localTime, item->logLevel, item->threadId, message);
             }
             if (_logFile)
             {
-                formatTo(_logFile, localTime, item->logLevel, item->threadId, item->message);
+                formatTo(_logFile, localTime, item->logLevel, item->threadId, message);
             }
             _logQueue.pop();
         }
@@ -162,6 +180,57 @@ bool LoggerThread::isLogFileReopenNeeded()
     return (!_logFile || stat(_logFileName.c_str(), &logFileStat) != 0 || logFileStat.st_ino != _logFileINode);
 }
 
+/**
+ * Captures the raw arguments instead of formatting on the calling thread. The logger thread does the formatting.
+ * Returns false if the arguments cannot be captured and the message must be formatted by the caller.
+ * format must be a string literal, or otherwise outlive the log item.
+ */
+bool LoggerThread::postDeferred(std::chrono::system_clock::time_point timestamp,
+    const char* logLevel,
+    const char* logGroup,
+    void* threadId,
+    const char* format,
+    va_list args)
+{
+    uint8_t arguments[maxDeferredArgumentsLength];
+    va_list argsCopy;
+    va_copy(argsCopy, args);
+    const int argumentsLength = deferred::capture(arguments, sizeof(arguments), format, argsCopy);
+    va_end(argsCopy);
+    if (argumentsLength < 0)
+    {
+        return false;
+    }
+
+    const size_t groupLength = std::strlen(logGroup);
+    const size_t prefixLength = groupLength + 3; // "[group] "
+    if (prefixLength + 1 > maxDeferredMessageLength)
+    {
+        return false;
+    }
+
+    concurrency::ScopedAllocCommit<LogItem> memBlock(_logQueue,
+        sizeof(LogItem) + prefixLength + 1 + argumentsLength);
+    if (!memBlock)
+    {
+        ++_droppedLogs;
+        return true;
+    }
+
+    LogItem& log = *memBlock;
+    log.logLevel = logLevel;
+    log.threadId = threadId;
+    log.timestamp = timestamp;
+    log.format = format;
+    log.argumentsOffset = prefixLength + 1;
+    log.argumentsLength = argumentsLength;
+    log.message[0] = '[';
+    std::memcpy(log.message + 1, logGroup, groupLength);
+    std::memcpy(log.message + 1 + groupLength, "] ", 3);
+    std::memcpy(log.message + log.argumentsOffset, arguments, argumentsLength);
+    return true;
+}
+
 /**
  * logLevel must be static eternal const string in memory.
  */
@@ -172,6 +241,12 @@ void LoggerThread::post(std::chrono::system_clock::time_point timestamp,
     const char* format,
     va_list args)
 {
+    if (_deferredFormatting.load(std::memory_order_relaxed) &&
+        postDeferred(timestamp, logLevel, logGroup, threadId, format, args))
+    {
+        return;
+    }
+
     va_list args2ndSprintf;
 
     const int maxMessageLength = 300;
@@ -200,6 +275,7 @@ void LoggerThread::post(std::chrono::system_clock::time_point timestamp,
         log.logLevel = logLevel;
         log.threadId = threadId;
         log.timestamp = timestamp;
+        log.format = nullptr;
         if (logLength <= maxMessageLength)
         {
             std::strncpy(log.message, smallMessage, logLength + 1);
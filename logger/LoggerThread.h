@@ -16,6 +16,9 @@ class LoggerThread
         std::chrono::system_clock::time_point timestamp;
         const char* logLevel;
         void* threadId;
+        const char* format; // set if message holds "[group] " and captured arguments to format on logger thread
+        uint16_t argumentsOffset;
+        uint16_t argumentsLength;
         char message[];
     };
 
@@ -47,9 +50,16 @@ public:
 
     void disableStdOut() { _logStdOut = false; }
     void disableStdErr() { _logStdErr = false; }
+    void setDeferredFormatting(bool enabled) { _deferredFormatting = enabled; }
 
 private:
     void run();
+    bool postDeferred(std::chrono::system_clock::time_point timestamp,
+        const char* logLevel,
+        const char* logGroup,
+        void* threadId,
+        const char* format,
+        va_list args);
     void reopenLogFile();
     void ensureLogFileExists();
     bool isTimeForMaintenance();
@@ -62,6 +72,7 @@ private:
     ino_t _logFileINode;
     bool _logStdOut;
     bool _logStdErr;
+    std::atomic_bool _deferredFormatting;
     std::string _logFileName;
     uint32_t _droppedLogs;
     uint64_t _lastMaintenanceTime;
@@ -0,0 +1,316 @@
+#include "logger/PacketCapture.h"
+#include "logger/Logger.h"
+#include "memory/Packet.h"
+#include "rtp/RtpHeader.h"
+#include "utils/Time.h"
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace logger
+{
+
+namespace
+{
+const uint32_t blockTypeSectionHeader = 0x0A0D0D0A;
+const uint32_t blockTypeInterfaceDescription = 0x00000001;
+const uint32_t blockTypeEnhancedPacket = 0x00000006;
+const uint32_t byteOrderMagic = 0x1A2B3C4D;
+const uint16_t linkTypeRaw = 101;
+const uint16_t optionEnd = 0;
+const uint16_t optionInterfaceName = 2;
+const uint16_t optionCustomNoCopy = 2989;
+
+const size_t ipUdpHeaderSize = 28;
+const size_t enhancedPacketHeaderSize = 28;
+// custom option header with private enterprise number, end of options and trailing block length
+const size_t enhancedPacketTrailerSize = 4 + 4 + 4 + 4;
+
+constexpr size_t align4(size_t size)
+{
+    return (size + 3) & ~size_t(3);
+}
+
+class BlockWriter
+{
+public:
+    explicit BlockWriter(uint8_t* data) : _data(data), _position(0) {}
+
+    template <typename T>
+    void write(T value)
+    {
+        std::memcpy(_data + _position, &value, sizeof(T));
+        _position += sizeof(T);
+    }
+
+    void write(const void* data, size_t length)
+    {
+        std::memcpy(_data + _position, data, length);
+        _position += length;
+    }
+
+    void pad()
+    {
+        const size_t padding = align4(_position) - _position;
+        std::memset(_data + _position, 0, padding);
+        _position += padding;
+    }
+
+    size_t size() const { return _position; }
+
+private:
+    uint8_t* _data;
+    size_t _position;
+};
+
+size_t writeSectionHeader(uint8_t* data)
+{
+    BlockWriter writer(data);
+    writer.write(blockTypeSectionHeader);
+    writer.write(uint32_t(28));
+    writer.write(byteOrderMagic);
+    writer.write(uint16_t(1));
+    writer.write(uint16_t(0));
+    writer.write(int64_t(-1));
+    writer.write(uint32_t(28));
+    return writer.size();
+}
+
+size_t writeInterfaceDescription(uint8_t* data, const char* name, uint32_t snapLength)
+{
+    const uint16_t nameLength = std::strlen(name);
+    const uint32_t blockLength = 20 + 4 + align4(nameLength) + 4;
+
+    BlockWriter writer(data);
+    writer.write(blockTypeInterfaceDescription);
+    writer.write(blockLength);
+    writer.write(linkTypeRaw);
+    writer.write(uint16_t(0));
+    writer.write(snapLength);
+    writer.write(optionInterfaceName);
+    writer.write(nameLength);
+    writer.write(name, nameLength);
+    writer.pad();
+    writer.write(optionEnd);
+    writer.write(uint16_t(0));
+    writer.write(blockLength);
+    return writer.size();
+}
+
+void writeIpUdpHeader(uint8_t* data, PacketCapture::Direction direction, size_t packetLength)
+{
+    const uint32_t local = 0x0A000001; // 10.0.0.1
+    const uint32_t remote = 0x0A000002;
+    const uint16_t port = 5000;
+    const uint16_t ipLength = std::min(packetLength + ipUdpHeaderSize, size_t(0xFFFF));
+    const bool isInbound = direction == PacketCapture::Direction::Inbound;
+
+    uint8_t* ip = data;
+    std::memset(ip, 0, ipUdpHeaderSize);
+    ip[0] = 0x45;
+    ip[2] = ipLength >> 8;
+    ip[3] = ipLength & 0xFF;
+    ip[8] = 64;
+    ip[9] = 17;
+    const uint32_t source = isInbound ? remote : local;
+    const uint32_t destination = isInbound ? local : remote;
+    for (int i = 0; i < 4; ++i)
+    {
+        ip[12 + i] = source >> (24 - 8 * i);
+        ip[16 + i] = destination >> (24 - 8 * i);
+    }
+
+    uint32_t checksum = 0;
+    for (int i = 0; i < 20; i += 2)
+    {
+        checksum += (ip[i] << 8) | ip[i + 1];
+    }
+    checksum = (checksum & 0xFFFF) + (checksum >> 16);
+    checksum = ~(checksum + (checksum >> 16)) & 0xFFFF;
+    ip[10] = checksum >> 8;
+    ip[11] = checksum & 0xFF;
+
+    uint8_t* udp = data + 20;
+    const uint16_t udpLength = ipLength - 20;
+    udp[0] = port >> 8;
+    udp[1] = port & 0xFF;
+    udp[2] = port >> 8;
+    udp[3] = port & 0xFF;
+    udp[4] = udpLength >> 8;
+    udp[5] = udpLength & 0xFF;
+}
+
+} // namespace
+
+PacketCapture::PacketCapture(const std::string& fileName,
+    size_t maxFileSize,
+    uint32_t snapLength,
+    bool headersOnly,
+    uint32_t maxPacketsPerSecond)
+    : _fileName(fileName),
+      _snapLength(snapLength),
+      _headersOnly(headersOnly),
+      _maxPacketsPerSecond(maxPacketsPerSecond),
+      _slotSize(enhancedPacketHeaderSize + align4(ipUdpHeaderSize + snapLength) + enhancedPacketTrailerSize),
+      _fd(-1),
+      _data(nullptr),
+      _headerSize(0),
+      _fileSize(0),
+      _slotCount(0),
+      _startTimestamp(utils::Time::getAbsoluteTime()),
+      _wallClockStartUs(
+          std::chrono::duration_cast<std::chrono::microseconds>(utils::Time::now().time_since_epoch()).count()),
+      _packetCount(0),
+      _skippedCount(0),
+      _windowStart(_startTimestamp),
+      _windowCount(0)
+{
+    uint8_t header[256];
+    _headerSize = writeSectionHeader(header);
+    _headerSize += writeInterfaceDescription(header + _headerSize, "inbound", ipUdpHeaderSize + snapLength);
+    _headerSize += writeInterfaceDescription(header + _headerSize, "outbound", ipUdpHeaderSize + snapLength);
+
+    _slotCount = maxFileSize > _headerSize ? (maxFileSize - _headerSize) / _slotSize : 0;
+    if (_slotCount == 0)
+    {
+        logger::error("capture file size %zu is too small", "PacketCapture", maxFileSize);
+        return;
+    }
+    _fileSize = _headerSize + _slotCount * _slotSize;
+
+    // never reuse an existing file, it may be mapped by a capture that is still running
+    _fd = ::open(fileName.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (_fd == -1)
+    {
+        logger::error("failed to create capture file %s, err %d", "PacketCapture", fileName.c_str(), errno);
+        return;
+    }
+
+    // reserve the disk blocks up front so the hot path only touches mapped memory
+    if (::posix_fallocate(_fd, 0, _fileSize) != 0)
+    {
+        logger::error("failed to allocate %zu bytes for capture file %s", "PacketCapture", _fileSize, fileName.c_str());
+        return;
+    }
+
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#endif
+    void* data = ::mmap(nullptr, _fileSize, PROT_READ | PROT_WRITE, flags, _fd, 0);
+    if (data == MAP_FAILED)
+    {
+        logger::error("failed to map capture file %s, err %d", "PacketCapture", fileName.c_str(), errno);
+        return;
+    }
+
+    _data = reinterpret_cast<uint8_t*>(data);
+    std::memcpy(_data, header, _headerSize);
+}
+
+// Removes the file of a capture that was never attached. The mapping is released by the destructor.
+void PacketCapture::discard()
+{
+    if (::unlink(_fileName.c_str()) != 0)
+    {
+        logger::warn("failed to remove capture file %s, err %d", "PacketCapture", _fileName.c_str(), errno);
+    }
+}
+
+PacketCapture::~PacketCapture()
+{
+    if (_data)
+    {
+        ::munmap(_data, _fileSize);
+
+        // cut unused slots so the file ends with a complete block
+        const uint64_t usedSlots = std::min(_packetCount.load(), static_cast<uint64_t>(_slotCount));
+        if (::ftruncate(_fd, _headerSize + usedSlots * _slotSize) != 0)
+        {
+            logger::warn("failed to truncate capture file %s", "PacketCapture", _fileName.c_str());
+        }
+
+        logger::info("closed %s, %" PRIu64 " packets captured, %" PRIu64 " skipped",
+            "PacketCapture",
+            _fileName.c_str(),
+            _packetCount.load(),
+            _skippedCount.load());
+    }
+
+    if (_fd != -1)
+    {
+        ::close(_fd);
+    }
+}
+
+bool PacketCapture::isRateLimited(const uint64_t timestamp)
+{
+    auto windowStart = _windowStart.load(std::memory_order_relaxed);
+    if (utils::Time::diffGE(windowStart, timestamp, utils::Time::sec) &&
+        _windowStart.compare_exchange_strong(windowStart, timestamp))
+    {
+        _windowCount = 0;
+    }
+
+    return _windowCount.fetch_add(1, std::memory_order_relaxed) >= _maxPacketsPerSecond;
+}
+
+void PacketCapture::capture(const memory::Packet& packet, const Direction direction, const uint64_t timestamp)
+{
+    if (!_data)
+    {
+        return;
+    }
+
+    if (isRateLimited(timestamp))
+    {
+        ++_skippedCount;
+        return;
+    }
+
+    size_t captureLength = std::min(packet.getLength(), static_cast<size_t>(_snapLength));
+    if (_headersOnly && rtp::isRtpPacket(packet))
+    {
+        captureLength = std::min(captureLength, rtp::RtpHeader::fromPacket(packet)->headerLength());
+    }
+
+    const uint64_t index = _packetCount.fetch_add(1);
+    uint8_t* slot = _data + _headerSize + (index % _slotCount) * _slotSize;
+
+    const uint64_t wallClockUs = _wallClockStartUs + (timestamp - _startTimestamp) / utils::Time::us;
+    const uint32_t capturedLength = ipUdpHeaderSize + captureLength;
+
+    BlockWriter writer(slot);
+    writer.write(blockTypeEnhancedPacket);
+    writer.write(static_cast<uint32_t>(_slotSize));
+    writer.write(static_cast<uint32_t>(direction));
+    writer.write(static_cast<uint32_t>(wallClockUs >> 32));
+    writer.write(static_cast<uint32_t>(wallClockUs & 0xFFFFFFFFu));
+    writer.write(capturedLength);
+    writer.write(static_cast<uint32_t>(ipUdpHeaderSize + packet.getLength()));
+    writeIpUdpHeader(slot + writer.size(), direction, packet.getLength());
+    std::memcpy(slot + writer.size() + ipUdpHeaderSize, packet.get(), captureLength);
+
+    // Every block fills its slot. The space after the packet data is a custom option that readers skip.
+    const size_t dataEnd = enhancedPacketHeaderSize + capturedLength;
+    const size_t optionStart = align4(dataEnd);
+    const size_t customOptionLength = _slotSize - optionStart - 12;
+    std::memset(slot + dataEnd, 0, optionStart - dataEnd);
+
+    BlockWriter optionWriter(slot + optionStart);
+    optionWriter.write(optionCustomNoCopy);
+    optionWriter.write(static_cast<uint16_t>(customOptionLength));
+    std::memset(slot + optionStart + 4, 0, customOptionLength);
+
+    BlockWriter trailerWriter(slot + _slotSize - 8);
+    trailerWriter.write(optionEnd);
+    trailerWriter.write(uint16_t(0));
+    trailerWriter.write(static_cast<uint32_t>(_slotSize));
+}
+
+} // namespace logger
@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace memory
+{
+class Packet;
+}
+
+namespace logger
+{
+
+/**
+ * Captures plain text RTP and RTCP into a pcapng file of fixed size that is memory mapped and used as a ring.
+ * The file is divided into slots of equal size and every captured packet fills one slot with an enhanced packet
+ * block, so capture is a copy of at most snapLength bytes without allocation or system calls. When the ring is full
+ * the oldest packets are overwritten. Packets are wrapped in IPv4/UDP headers on interface "inbound" or "outbound".
+ * The file must not exist, it is created exclusively so a running capture is never truncated under its mapping.
+ * capture may be called from multiple threads, but the PacketCapture must outlive all calls.
+ */
+class PacketCapture
+{
+public:
+    enum class Direction : uint32_t
+    {
+        Inbound = 0,
+        Outbound = 1
+    };
+
+    PacketCapture(const std::string& fileName,
+        size_t maxFileSize,
+        uint32_t snapLength,
+        bool headersOnly,
+        uint32_t maxPacketsPerSecond);
+    ~PacketCapture();
+
+    bool isGood() const { return _data != nullptr; }
+
+    void capture(const memory::Packet& packet, Direction direction, uint64_t timestamp);
+    void discard();
+
+    const std::string& getFileName() const { return _fileName; }
+    uint64_t getCapturedCount() const { return _packetCount; }
+    uint64_t getSkippedCount() const { return _skippedCount; }
+    size_t getSlotCount() const { return _slotCount; }
+
+private:
+    bool isRateLimited(uint64_t timestamp);
+
+    const std::string _fileName;
+    const uint32_t _snapLength;
+    const bool _headersOnly;
+    const uint32_t _maxPacketsPerSecond;
+    const size_t _slotSize;
+    int _fd;
+    uint8_t* _data;
+    size_t _headerSize;
+    size_t _fileSize;
+    size_t _slotCount;
+
+    const uint64_t _startTimestamp;
+    const uint64_t _wallClockStartUs;
+    std::atomic_uint64_t _packetCount;
+    std::atomic_uint64_t _skippedCount;
+    std::atomic_uint64_t _windowStart;
+    std::atomic_uint32_t _windowCount;
+};
+
+} // namespace logger
@@ -147,7 +147,18 @@ int main(int argc, char** argv)
     }
 
     utils::Time::initialize();
+    if (config->tscClock)
+    {
+        utils::Time::enableTscClock(); // before any other thread reads the time
+    }
     logger::setup(config->logFile.get().c_str(), config->logStdOut, config->logStdErr, parseLogLevel(config->logLevel), 4 * 1024 * 1024);
+    logger::setDeferredFormatting(config->logDeferredFormatting);
+    if (config->tscClock)
+    {
+        logger::info("TSC clock %s",
+            "main",
+            utils::Time::isTscClockEnabled() ? "enabled" : "not available, using clock_gettime");
+    }
     logger::info("Starting httpd on port %u", "main", config->port.get());
     logger::info("Configured udp port range: %s  %u - %u",
         "main",
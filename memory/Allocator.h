@@ -17,6 +17,15 @@
 #include <string.h>
 #endif
 
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(__linux__) && !defined(MAP_HUGE_2MB)
+#define MAP_HUGE_2MB (21 << 26)
+#endif
+
 namespace memory
 {
 
@@ -60,6 +69,106 @@ inline size_t alignedSpace(size_t space)
     return (space + pageSize - 1) & ~(pageSize - 1);
 }
 
+const size_t hugePageSize = 2 * 1024 * 1024;
+
+/**
+ * Backing of large allocations like packet pools. Huge pages cut the TLB misses of touching a pool at random.
+ * MAP_HUGETLB takes pages reserved in vm.nr_hugepages and if there are none, transparent huge pages are requested with
+ * madvise. A numaNode >= 0 places the pages on that node before first touch. The node is preferred rather than
+ * required so allocation still succeeds when the node runs out of memory. Only available on Linux.
+ */
+struct Placement
+{
+    bool hugePages = false;
+    int numaNode = -1;
+};
+
+// What allocate with a Placement actually got
+enum class Backing
+{
+    Pages,
+    HugeTlb, // reserved huge pages, MAP_HUGETLB
+    TransparentHugePages // regular pages with madvise(MADV_HUGEPAGE)
+};
+
+inline const char* toString(const Backing backing)
+{
+    switch (backing)
+    {
+    case Backing::HugeTlb:
+        return "MAP_HUGETLB";
+    case Backing::TransparentHugePages:
+        return "madvise huge pages";
+    default:
+        return "pages";
+    }
+}
+
+inline size_t alignedSpace(size_t space, const Placement& placement)
+{
+    if (!placement.hugePages)
+    {
+        return alignedSpace(space);
+    }
+    return (space + hugePageSize - 1) & ~(hugePageSize - 1);
+}
+
+inline void* allocate(size_t size, const Placement& placement, Backing& outBacking)
+{
+    outBacking = Backing::Pages;
+#if !DISABLE_MMAP && defined(__linux__)
+    assert((size & ~(getPageSize() - 1)) == size);
+    void* mem = MAP_FAILED;
+    if (placement.hugePages)
+    {
+        assert((size & ~(hugePageSize - 1)) == size);
+        mem = mmap(nullptr,
+            size,
+            (PROT_READ | PROT_WRITE),
+            (MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB),
+            -1,
+            0);
+        if (mem != MAP_FAILED)
+        {
+            outBacking = Backing::HugeTlb;
+        }
+    }
+    if (mem == MAP_FAILED)
+    {
+        mem = mmap(nullptr, size, (PROT_READ | PROT_WRITE), (MAP_PRIVATE | MAP_ANONYMOUS), -1, 0);
+        if (mem != MAP_FAILED && placement.hugePages && madvise(mem, size, MADV_HUGEPAGE) == 0)
+        {
+            outBacking = Backing::TransparentHugePages;
+        }
+    }
+    assert(mem != MAP_FAILED);
+
+    if (mem != MAP_FAILED && placement.numaNode >= 0 && placement.numaNode < 64)
+    {
+        const unsigned long nodeMask = 1ul << placement.numaNode;
+        syscall(SYS_mbind, mem, size, MPOL_PREFERRED, &nodeMask, sizeof(nodeMask) * 8, 0);
+    }
+    return mem;
+#else
+    return allocate(size);
+#endif
+}
+
+// NUMA node holding the page at address mem. -1 if unknown
+inline int getNumaNode(const void* mem)
+{
+#ifdef __linux__
+    int node = -1;
+    if (syscall(SYS_get_mempolicy, &node, nullptr, 0, mem, MPOL_F_NODE | MPOL_F_ADDR) != 0)
+    {
+        return -1;
+    }
+    return node;
+#else
+    return -1;
+#endif
+}
+
 } // namespace page
 
 } // namespace memory
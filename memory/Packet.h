@@ -2,6 +2,7 @@
 
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 
 namespace memory
@@ -34,6 +35,9 @@ public:
         std::memcpy(dst.get(), get(), getLength());
         dst.setLength(getLength());
         dst.endpointIdHash = endpointIdHash;
+        dst.receiveTimestamp = receiveTimestamp;
+        dst.absSendTimeOffset = absSendTimeOffset;
+        dst.transportSequenceNumberOffset = transportSequenceNumberOffset;
     }
 
     void append(const void* data, size_t length)
@@ -50,6 +54,11 @@ public:
     void clear() { std::memset(_data, 0, size); }
 
     size_t endpointIdHash = 0;
+    uint64_t receiveTimestamp = 0; // when received from network, 0 if created locally
+    // Offsets to the data of the RTP header extensions stamped at send time, 0 if not known. Located when the
+    // outbound header is rewritten so the transport can stamp them without walking the extensions.
+    uint16_t absSendTimeOffset = 0;
+    uint16_t transportSequenceNumberOffset = 0;
 
 private:
     unsigned char _data[size];
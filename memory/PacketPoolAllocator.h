@@ -12,7 +12,12 @@ const size_t packetPoolSize = 2048 * 4;
 class PacketPoolAllocator : public PoolAllocator<sizeof(Packet)>
 {
 public:
-    PacketPoolAllocator(size_t elementCount, const std::string&& name) : PoolAllocator(elementCount, std::move(name)) {}
+    PacketPoolAllocator(size_t elementCount,
+        const std::string&& name,
+        const page::Placement& placement = page::Placement())
+        : PoolAllocator(elementCount, std::move(name), placement)
+    {
+    }
 
     static bool isCorrupt(Packet* p) { return PoolAllocator<sizeof(Packet)>::isCorrupt(p); }
     static bool isCorrupt(Packet& p) { return PoolAllocator<sizeof(Packet)>::isCorrupt(&p); }
@@ -66,7 +71,14 @@ inline UniquePacket makeUniquePacket(PacketPoolAllocator& allocator, const void*
 
 inline UniquePacket makeUniquePacket(PacketPoolAllocator& allocator, const Packet& packet)
 {
-    return makeUniquePacket(allocator, packet.get(), packet.getLength());
+    auto copy = makeUniquePacket(allocator, packet.get(), packet.getLength());
+    if (copy)
+    {
+        copy->receiveTimestamp = packet.receiveTimestamp;
+        copy->absSendTimeOffset = packet.absSendTimeOffset;
+        copy->transportSequenceNumberOffset = packet.transportSequenceNumberOffset;
+    }
+    return copy;
 }
 
 } // namespace memory
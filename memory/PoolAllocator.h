@@ -51,13 +51,15 @@ public:
         PoolAllocator<ELEMENT_SIZE>* _allocator;
     };
 
-    PoolAllocator(size_t elementCount, const std::string&& name)
+    PoolAllocator(size_t elementCount,
+        const std::string&& name,
+        const memory::page::Placement& placement = memory::page::Placement())
         : _deleter(this),
           _name(std::move(name)),
           _elements(nullptr),
           _popIndex(0),
           _pushIndex(0),
-          _size(memory::page::alignedSpace(elementCount * sizeof(Entry))),
+          _size(memory::page::alignedSpace(elementCount * sizeof(Entry), placement)),
           _originalElementCount(_size / sizeof(Entry)),
           _count(_originalElementCount)
     {
@@ -65,7 +67,17 @@ public:
         _cacheLineSeparator2[0] = 0;
         _cacheLineSeparator3[0] = 0;
 
-        _elements = reinterpret_cast<Entry*>(memory::page::allocate(_size));
+        memory::page::Backing backing;
+        _elements = reinterpret_cast<Entry*>(memory::page::allocate(_size, placement, backing));
+        if (placement.hugePages || placement.numaNode >= 0)
+        {
+            logger::info("%zu elements, %zu MB, backed by %s, NUMA node %d",
+                _name.c_str(),
+                _originalElementCount,
+                _size / (1024 * 1024),
+                memory::page::toString(backing),
+                placement.numaNode);
+        }
         assert(memory::isAligned<uint64_t>(_elements));
 
         static_assert(sizeof(Entry) % alignof(std::max_align_t) == 0, "ELEMENT_SIZE must be multiple of alignment");
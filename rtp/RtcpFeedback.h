@@ -25,7 +25,8 @@ enum PayloadSpecificFeedbackType
 enum TransportLayerFeedbackType
 {
     PacketNack = 1,
-    TemporaryMaxMediaBitrate = 3
+    TemporaryMaxMediaBitrate = 3,
+    TransportCc = 15
 };
 
 RtcpFeedback* createPLI(void* buffer, const uint32_t fromSsrc, const uint32_t aboutSsrc);
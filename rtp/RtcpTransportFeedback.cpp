@@ -0,0 +1,386 @@
+#include "rtp/RtcpTransportFeedback.h"
+#include "rtp/RtcpFeedback.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <new>
+
+namespace
+{
+const uint64_t notReceived = ~0ull;
+const uint32_t maxRunLength = 0x1FFF;
+const uint32_t oneBitSymbolsPerChunk = 14;
+const uint32_t twoBitSymbolsPerChunk = 7;
+
+enum Symbol : uint8_t
+{
+    NotReceived = 0,
+    SmallDelta = 1,
+    LargeDelta = 2
+};
+
+uint8_t* writeChunk(uint8_t* cursor, uint16_t chunk)
+{
+    cursor[0] = chunk >> 8;
+    cursor[1] = chunk & 0xFFu;
+    return cursor + 2;
+}
+
+uint16_t readChunk(const uint8_t* cursor)
+{
+    return (static_cast<uint16_t>(cursor[0]) << 8) | cursor[1];
+}
+
+uint32_t getSymbolCount(uint16_t chunk)
+{
+    if ((chunk & 0x8000u) == 0)
+    {
+        return chunk & maxRunLength;
+    }
+    return (chunk & 0x4000u) ? twoBitSymbolsPerChunk : oneBitSymbolsPerChunk;
+}
+
+uint32_t getSymbol(uint16_t chunk, uint32_t index)
+{
+    if ((chunk & 0x8000u) == 0)
+    {
+        return (chunk >> 13) & 0x3u;
+    }
+    if (chunk & 0x4000u)
+    {
+        return (chunk >> (2 * (twoBitSymbolsPerChunk - 1 - index))) & 0x3u;
+    }
+    return (chunk >> (oneBitSymbolsPerChunk - 1 - index)) & 0x1u;
+}
+
+uint32_t getRunLength(const uint8_t* symbols, uint32_t count)
+{
+    uint32_t run = 1;
+    while (run < count && run < maxRunLength && symbols[run] == symbols[0])
+    {
+        ++run;
+    }
+    return run;
+}
+
+} // namespace
+
+namespace rtp
+{
+
+RtcpTransportFeedback::RtcpTransportFeedback()
+    : reporterSsrc(0),
+      mediaSsrc(0),
+      baseSequenceNumber(0),
+      packetStatusCount(0),
+      feedbackPacketCount(0)
+{
+    header.length = 4;
+    header.packetType = RtcpPacketType::RTPTRANSPORT_FB;
+    header.fmtCount = TransportLayerFeedbackType::TransportCc;
+    std::memset(_referenceTime, 0, 3);
+}
+
+RtcpTransportFeedback& RtcpTransportFeedback::create(void* area, uint32_t reporterSsrc, uint32_t mediaSsrc)
+{
+    auto& feedback = *new (area) RtcpTransportFeedback();
+    feedback.reporterSsrc = reporterSsrc;
+    feedback.mediaSsrc = mediaSsrc;
+    return feedback;
+}
+
+uint32_t RtcpTransportFeedback::getReferenceTime() const
+{
+    return (static_cast<uint32_t>(_referenceTime[0]) << 16) | (static_cast<uint32_t>(_referenceTime[1]) << 8) |
+        _referenceTime[2];
+}
+
+void RtcpTransportFeedback::setReferenceTime(uint32_t referenceTime)
+{
+    _referenceTime[0] = (referenceTime >> 16) & 0xFFu;
+    _referenceTime[1] = (referenceTime >> 8) & 0xFFu;
+    _referenceTime[2] = referenceTime & 0xFFu;
+}
+
+bool isTransportFeedback(const void* p)
+{
+    auto& header = *reinterpret_cast<const RtcpHeader*>(p);
+    return header.packetType == RtcpPacketType::RTPTRANSPORT_FB &&
+        header.fmtCount == TransportLayerFeedbackType::TransportCc && header.size() >= sizeof(RtcpTransportFeedback);
+}
+
+TransportFeedbackReader::TransportFeedbackReader(const RtcpTransportFeedback& feedback)
+    : _chunk(feedback.data),
+      _delta(nullptr),
+      _end(reinterpret_cast<const uint8_t*>(&feedback) + feedback.header.size() - feedback.header.getPaddingSize()),
+      _symbolIndex(0),
+      _remainingCount(feedback.packetStatusCount),
+      _sequenceNumber(feedback.baseSequenceNumber),
+      _receiveTime(static_cast<int64_t>(feedback.getReferenceTime()) * RtcpTransportFeedback::referenceTimeUnit),
+      _valid(false)
+{
+    // locate receive deltas after the status chunks
+    uint32_t statusCount = 0;
+    const uint8_t* cursor = _chunk;
+    while (statusCount < _remainingCount)
+    {
+        if (cursor + 2 > _end)
+        {
+            return;
+        }
+        const auto symbolCount = getSymbolCount(readChunk(cursor));
+        if (symbolCount == 0)
+        {
+            return;
+        }
+        statusCount += symbolCount;
+        cursor += 2;
+    }
+    _delta = cursor;
+    _valid = true;
+}
+
+uint32_t TransportFeedbackReader::readSymbol()
+{
+    const auto chunk = readChunk(_chunk);
+    const auto symbol = getSymbol(chunk, _symbolIndex);
+    if (++_symbolIndex == getSymbolCount(chunk))
+    {
+        _symbolIndex = 0;
+        _chunk += 2;
+    }
+    return symbol;
+}
+
+bool TransportFeedbackReader::getNext(uint16_t& sequenceNumber, bool& received, int64_t& receiveTime)
+{
+    if (!_valid || _remainingCount == 0)
+    {
+        return false;
+    }
+
+    const auto symbol = readSymbol();
+    int64_t delta = 0;
+    if (symbol == Symbol::SmallDelta)
+    {
+        if (_delta + 1 > _end)
+        {
+            _valid = false;
+            return false;
+        }
+        delta = _delta[0];
+        _delta += 1;
+    }
+    else if (symbol == Symbol::LargeDelta)
+    {
+        if (_delta + 2 > _end)
+        {
+            _valid = false;
+            return false;
+        }
+        delta = static_cast<int16_t>(readChunk(_delta));
+        _delta += 2;
+    }
+    else if (symbol != Symbol::NotReceived)
+    {
+        _valid = false;
+        return false;
+    }
+
+    --_remainingCount;
+    sequenceNumber = _sequenceNumber++;
+    received = (symbol != Symbol::NotReceived);
+    _receiveTime += delta * static_cast<int64_t>(RtcpTransportFeedback::deltaUnit);
+    receiveTime = _receiveTime;
+    return true;
+}
+
+TransportFeedbackBuilder::TransportFeedbackBuilder()
+    : _nextToReport(0),
+      _highestReceived(0),
+      _pendingCount(0),
+      _feedbackPacketCount(0),
+      _initialized(false)
+{
+    _arrivals.fill(notReceived);
+}
+
+void TransportFeedbackBuilder::onPacketReceived(uint16_t sequenceNumber, uint64_t receiveTime)
+{
+    if (!_initialized)
+    {
+        _nextToReport = sequenceNumber;
+        _highestReceived = sequenceNumber;
+        _initialized = true;
+    }
+
+    const int16_t advance = sequenceNumber - static_cast<uint16_t>(_highestReceived & 0xFFFFu);
+    const uint32_t extendedSequenceNumber = _highestReceived + advance;
+    if (static_cast<int32_t>(extendedSequenceNumber - _nextToReport) < 0)
+    {
+        return;
+    }
+
+    if (extendedSequenceNumber - _nextToReport >= windowSize)
+    {
+        // unreported packets are about to be overwritten, skip them
+        const uint32_t newNextToReport = extendedSequenceNumber - windowSize + 1;
+        for (uint32_t i = _nextToReport; i != newNextToReport && _pendingCount > 0; ++i)
+        {
+            auto& slot = arrival(i);
+            if (slot != notReceived)
+            {
+                slot = notReceived;
+                --_pendingCount;
+            }
+        }
+        _nextToReport = newNextToReport;
+    }
+
+    if (advance > 0)
+    {
+        _highestReceived = extendedSequenceNumber;
+    }
+
+    auto& slot = arrival(extendedSequenceNumber);
+    if (slot == notReceived)
+    {
+        ++_pendingCount;
+    }
+    slot = receiveTime;
+}
+
+size_t TransportFeedbackBuilder::build(void* area, uint32_t reporterSsrc, uint32_t mediaSsrc)
+{
+    if (_pendingCount == 0)
+    {
+        return 0;
+    }
+
+    const uint32_t endSequenceNumber = _highestReceived + 1;
+    const uint64_t unitsPerReference = RtcpTransportFeedback::referenceTimeUnit / RtcpTransportFeedback::deltaUnit;
+
+    uint64_t referenceTime = 0;
+    for (uint32_t i = _nextToReport; i != endSequenceNumber; ++i)
+    {
+        if (arrival(i) != notReceived)
+        {
+            referenceTime = arrival(i) / RtcpTransportFeedback::referenceTimeUnit;
+            break;
+        }
+    }
+
+    uint8_t symbols[maxPacketsPerFeedback];
+    int16_t deltas[maxPacketsPerFeedback];
+    uint32_t count = 0;
+    int64_t previousUnits = referenceTime * unitsPerReference;
+    for (uint32_t i = _nextToReport; i != endSequenceNumber && count < maxPacketsPerFeedback; ++i)
+    {
+        const auto receiveTime = arrival(i);
+        if (receiveTime == notReceived)
+        {
+            symbols[count++] = Symbol::NotReceived;
+            continue;
+        }
+
+        const int64_t units = receiveTime / RtcpTransportFeedback::deltaUnit;
+        const int64_t delta = units - previousUnits;
+        if (delta >= 0 && delta <= 0xFF)
+        {
+            symbols[count] = Symbol::SmallDelta;
+        }
+        else if (delta >= std::numeric_limits<int16_t>::min() && delta <= std::numeric_limits<int16_t>::max())
+        {
+            symbols[count] = Symbol::LargeDelta;
+        }
+        else
+        {
+            break; // report in next feedback with new reference time
+        }
+
+        deltas[count++] = static_cast<int16_t>(delta);
+        previousUnits = units;
+    }
+
+    auto& feedback = RtcpTransportFeedback::create(area, reporterSsrc, mediaSsrc);
+    feedback.baseSequenceNumber = _nextToReport & 0xFFFFu;
+    feedback.packetStatusCount = count;
+    feedback.setReferenceTime(referenceTime & 0xFFFFFFu);
+    feedback.feedbackPacketCount = _feedbackPacketCount++;
+
+    uint8_t* cursor = feedback.data;
+    for (uint32_t i = 0; i < count;)
+    {
+        const auto runLength = getRunLength(&symbols[i], count - i);
+        if (runLength >= oneBitSymbolsPerChunk)
+        {
+            cursor = writeChunk(cursor, (symbols[i] << 13) | runLength);
+            i += runLength;
+            continue;
+        }
+
+        const uint32_t vectorLength = std::min(oneBitSymbolsPerChunk, count - i);
+        bool fitsOneBit = true;
+        for (uint32_t j = 0; j < vectorLength; ++j)
+        {
+            fitsOneBit &= (symbols[i + j] != Symbol::LargeDelta);
+        }
+
+        uint16_t chunk = 0x8000u;
+        if (fitsOneBit)
+        {
+            for (uint32_t j = 0; j < vectorLength; ++j)
+            {
+                chunk |= symbols[i + j] << (oneBitSymbolsPerChunk - 1 - j);
+            }
+            i += oneBitSymbolsPerChunk;
+        }
+        else
+        {
+            chunk |= 0x4000u;
+            for (uint32_t j = 0; j < twoBitSymbolsPerChunk && i + j < count; ++j)
+            {
+                chunk |= symbols[i + j] << (2 * (twoBitSymbolsPerChunk - 1 - j));
+            }
+            i += twoBitSymbolsPerChunk;
+        }
+        cursor = writeChunk(cursor, chunk);
+    }
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (symbols[i] == Symbol::SmallDelta)
+        {
+            *cursor++ = static_cast<uint8_t>(deltas[i]);
+        }
+        else if (symbols[i] == Symbol::LargeDelta)
+        {
+            cursor = writeChunk(cursor, static_cast<uint16_t>(deltas[i]));
+        }
+    }
+
+    size_t size = cursor - reinterpret_cast<uint8_t*>(&feedback);
+    while (size % 4 != 0)
+    {
+        *cursor++ = 0;
+        ++size;
+    }
+    assert(size <= maxFeedbackSize);
+    feedback.header.length = size / 4 - 1;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        auto& slot = arrival(_nextToReport + i);
+        if (slot != notReceived)
+        {
+            slot = notReceived;
+            --_pendingCount;
+        }
+    }
+    _nextToReport += count;
+
+    return size;
+}
+
+} // namespace rtp
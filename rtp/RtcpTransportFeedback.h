@@ -0,0 +1,104 @@
+#pragma once
+
+#include "rtp/RtcpHeader.h"
+#include "utils/ByteOrder.h"
+#include "utils/Time.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace rtp
+{
+
+/**
+ * Transport wide congestion control feedback, RTPFB FMT 15 from
+ * draft-holmer-rmcat-transport-wide-cc-extensions-01.
+ * Reports arrival status of every packet carrying the transport wide sequence number header extension.
+ * The fixed part is followed by packet status chunks and then receive deltas, padded to 32 bit.
+ */
+struct RtcpTransportFeedback
+{
+    static constexpr uint64_t referenceTimeUnit = utils::Time::ms * 64;
+    static constexpr uint64_t deltaUnit = utils::Time::us * 250;
+
+    RtcpTransportFeedback();
+    static RtcpTransportFeedback& create(void* area, uint32_t reporterSsrc, uint32_t mediaSsrc);
+
+    uint32_t getReferenceTime() const;
+    void setReferenceTime(uint32_t referenceTime);
+
+    RtcpHeader header;
+    nwuint32_t reporterSsrc;
+    nwuint32_t mediaSsrc;
+    nwuint16_t baseSequenceNumber;
+    nwuint16_t packetStatusCount;
+
+private:
+    uint8_t _referenceTime[3]; // 24 bit in units of 64ms
+public:
+    uint8_t feedbackPacketCount;
+    uint8_t data[];
+};
+
+bool isTransportFeedback(const void* header);
+
+/**
+ * Iterates the packet statuses in a transport feedback.
+ * Receive time is in ns in the reporter's clock domain and only differences within the same feedback are meaningful.
+ */
+class TransportFeedbackReader
+{
+public:
+    explicit TransportFeedbackReader(const RtcpTransportFeedback& feedback);
+
+    bool isValid() const { return _valid; }
+    bool getNext(uint16_t& sequenceNumber, bool& received, int64_t& receiveTime);
+
+private:
+    uint32_t readSymbol();
+
+    const uint8_t* _chunk;
+    const uint8_t* _delta;
+    const uint8_t* _end;
+    uint32_t _symbolIndex;
+    uint32_t _remainingCount;
+    uint16_t _sequenceNumber;
+    int64_t _receiveTime;
+    bool _valid;
+};
+
+/**
+ * Collects arrival times of packets with transport wide sequence numbers and builds feedback for them.
+ * Packets arriving after their sequence number has been reported are ignored.
+ */
+class TransportFeedbackBuilder
+{
+public:
+    static const size_t maxPacketsPerFeedback = 256;
+    // fixed part, one chunk per 7 statuses, 2 byte deltas, padding
+    static const size_t maxFeedbackSize =
+        sizeof(RtcpTransportFeedback) + 2 * (maxPacketsPerFeedback / 7 + 1) + 2 * maxPacketsPerFeedback + 3;
+
+    TransportFeedbackBuilder();
+
+    void onPacketReceived(uint16_t sequenceNumber, uint64_t receiveTime);
+    bool hasPendingFeedback() const { return _pendingCount > 0; }
+    uint32_t getPendingCount() const { return _pendingCount; }
+
+    /** @return size of feedback written to area or 0 if there is nothing to report */
+    size_t build(void* area, uint32_t reporterSsrc, uint32_t mediaSsrc);
+
+private:
+    static const size_t windowSize = 1024;
+
+    uint64_t& arrival(uint32_t extendedSequenceNumber) { return _arrivals[extendedSequenceNumber % windowSize]; }
+
+    std::array<uint64_t, windowSize> _arrivals; // 0 if not received
+    uint32_t _nextToReport;
+    uint32_t _highestReceived;
+    uint32_t _pendingCount;
+    uint8_t _feedbackPacketCount;
+    bool _initialized;
+};
+
+} // namespace rtp
@@ -252,8 +252,29 @@ uint32_t nsToSecondsFp6_18(uint64_t timestampNs)
     return ((timestampNs * NOMINATOR) / DENOMINATOR) & 0xFFFFFFu;
 }
 
+namespace
+{
+// true if the one byte header extension with id and data length has its data at dataOffset
+bool isExtensionAt(const memory::Packet& packet, uint16_t dataOffset, uint8_t extensionId, uint8_t dataLength)
+{
+    return dataOffset > MIN_RTP_HEADER_SIZE + RtpHeaderExtension::minSize() &&
+        dataOffset + dataLength <= packet.getLength() &&
+        packet.get()[dataOffset - 1] == ((extensionId << 4) | (dataLength - 1));
+}
+} // namespace
+
 void setTransmissionTimestamp(memory::Packet& packet, uint8_t extensionId, uint64_t timestamp)
 {
+    if (isExtensionAt(packet, packet.absSendTimeOffset, extensionId, 3))
+    {
+        const auto ntpTimestamp = nsToSecondsFp6_18(timestamp);
+        auto* data = packet.get() + packet.absSendTimeOffset;
+        data[0] = ntpTimestamp >> 16;
+        data[1] = (ntpTimestamp >> 8) & 0xFFu;
+        data[2] = ntpTimestamp & 0xFFu;
+        return;
+    }
+
     if (!rtp::isRtpPacket(packet))
     {
         return;
@@ -316,6 +337,69 @@ bool getTransmissionTimestamp(const memory::Packet& packet, uint8_t extensionId,
     return false;
 }
 
+// Transport wide sequence number is only overwritten. The forwarded packet must carry the extension.
+bool setTransportWideSequenceNumber(memory::Packet& packet, uint8_t extensionId, uint16_t sequenceNumber)
+{
+    if (isExtensionAt(packet, packet.transportSequenceNumberOffset, extensionId, 2))
+    {
+        auto* data = packet.get() + packet.transportSequenceNumberOffset;
+        data[0] = sequenceNumber >> 8;
+        data[1] = sequenceNumber & 0xFFu;
+        return true;
+    }
+
+    if (!rtp::isRtpPacket(packet))
+    {
+        return false;
+    }
+
+    auto* rtpHeader = RtpHeader::fromPacket(packet);
+    if (!rtpHeader)
+    {
+        return false;
+    }
+
+    auto* extensionHeader = rtpHeader->getExtensionHeader();
+    if (extensionHeader)
+    {
+        for (auto& extension : extensionHeader->extensions())
+        {
+            if (extension.getId() == extensionId && extension.getDataLength() == 2)
+            {
+                extension.data[0] = sequenceNumber >> 8;
+                extension.data[1] = sequenceNumber & 0xFFu;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool getTransportWideSequenceNumber(const memory::Packet& packet, uint8_t extensionId, uint16_t& sequenceNumber)
+{
+    auto* rtpHeader = RtpHeader::fromPacket(packet);
+    if (!rtpHeader)
+    {
+        return false;
+    }
+
+    auto* extensionHeader = rtpHeader->getExtensionHeader();
+    if (extensionHeader)
+    {
+        for (auto& extension : extensionHeader->extensions())
+        {
+            if (extension.getId() == extensionId && extension.getDataLength() == 2)
+            {
+                sequenceNumber = (static_cast<uint16_t>(extension.data[0]) << 8) | extension.data[1];
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 bool getAudioLevel(const memory::Packet& packet, uint8_t extensionId, int& level)
 {
     assert(rtp::isRtpPacket(packet));
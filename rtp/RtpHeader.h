@@ -139,6 +139,12 @@ inline bool isRtpPacket(const memory::Packet& packet)
 
 void setTransmissionTimestamp(memory::Packet& packet, uint8_t extensionId, uint64_t timestamp);
 bool getTransmissionTimestamp(const memory::Packet& packet, uint8_t extensionId, uint32_t& sendTime);
+/**
+ * Overwrites the transport wide sequence number in an existing extension element. The element is never added.
+ * @return false if the packet does not carry the extension
+ */
+bool setTransportWideSequenceNumber(memory::Packet& packet, uint8_t extensionId, uint16_t sequenceNumber);
+bool getTransportWideSequenceNumber(const memory::Packet& packet, uint8_t extensionId, uint16_t& sequenceNumber);
 
 template <typename PacketT>
 void addAudioLevel(PacketT& packet, uint8_t extensionId, uint8_t level)
@@ -0,0 +1,202 @@
+#include "api/StreamParser.h"
+#include "api/Generator.h"
+#include "api/Parser.h"
+#include "logger/Logger.h"
+#include "test/ResourceLoader.h"
+#include "utils/Time.h"
+#include <gtest/gtest.h>
+
+namespace
+{
+
+bool streamParse(const std::string& body, api::EndpointDescription& description)
+{
+    std::string action;
+    return api::StreamParser::parsePatchEndpoint(utils::Span<const char>(body.data(), body.size()),
+        "endpointId-0",
+        action,
+        description);
+}
+
+void expectSameDescription(const api::EndpointDescription& expected, const api::EndpointDescription& actual)
+{
+    EXPECT_EQ(expected.endpointId, actual.endpointId);
+    EXPECT_EQ(api::Generator::generateAllocateEndpointResponse(expected),
+        api::Generator::generateAllocateEndpointResponse(actual));
+
+    ASSERT_EQ(expected.video.isSet(), actual.video.isSet());
+    if (expected.video.isSet())
+    {
+        ASSERT_EQ(expected.video.get().ssrcWhitelist.isSet(), actual.video.get().ssrcWhitelist.isSet());
+        if (expected.video.get().ssrcWhitelist.isSet())
+        {
+            EXPECT_EQ(expected.video.get().ssrcWhitelist.get(), actual.video.get().ssrcWhitelist.get());
+        }
+    }
+
+    ASSERT_EQ(expected.neighbours.isSet(), actual.neighbours.isSet());
+    if (expected.neighbours.isSet())
+    {
+        EXPECT_EQ(expected.neighbours.get(), actual.neighbours.get());
+    }
+}
+
+} // namespace
+
+TEST(StreamParserTest, patchMatchesParser)
+{
+    for (auto resource :
+        {"api-patch-full.json", "api-patch-no-ice-candidates.json", "api-patch-empty-ice-candidates.json"})
+    {
+        const auto body = ResourceLoader::loadAsString(resource);
+        std::string action;
+        api::EndpointDescription description;
+        ASSERT_TRUE(api::StreamParser::parsePatchEndpoint(utils::Span<const char>(body.data(), body.size()),
+            "endpointId-0",
+            action,
+            description))
+            << resource;
+        EXPECT_EQ("configure", action);
+
+        const auto expected = api::Parser::parsePatchEndpoint(nlohmann::json::parse(body), "endpointId-0");
+        expectSameDescription(expected, description);
+    }
+}
+
+TEST(StreamParserTest, patchFull)
+{
+    api::EndpointDescription description;
+    ASSERT_TRUE(streamParse(ResourceLoader::loadAsString("api-patch-full.json"), description));
+
+    const auto& candidates = description.bundleTransport.get().ice.get().candidates;
+    ASSERT_EQ(3, candidates.size());
+    EXPECT_EQ(1, candidates[0].network);
+    EXPECT_EQ(0, candidates[1].network);
+    EXPECT_EQ(49370, candidates[1].relPort.get());
+    EXPECT_EQ("192.168.1.10", candidates[1].relAddr.get());
+    EXPECT_EQ("tcp", candidates[2].protocol);
+
+    const auto& audio = description.audio.get();
+    ASSERT_EQ(1, audio.rtpHeaderExtensions.size());
+    EXPECT_EQ(2, audio.payloadTypes[0].channels.get());
+
+    const auto& video = description.video.get();
+    ASSERT_EQ(2, video.streams.size());
+    ASSERT_EQ(3, video.streams[0].sources.size());
+    EXPECT_EQ(0, video.streams[0].sources[2].feedback);
+    EXPECT_TRUE(video.streams[1].isSlides());
+    EXPECT_EQ(4, video.payloadTypes[0].rtcpFeedbacks.size());
+    EXPECT_EQ("pli", video.payloadTypes[0].rtcpFeedbacks[3].second.get());
+    EXPECT_EQ(5000, description.data.get().port);
+}
+
+TEST(StreamParserTest, leavesOtherRequestsToParser)
+{
+    const char* bodies[] = {R"({"bundle-transport": {"ice": true}, "action": "configure"})",
+        R"({"action": "expire"})",
+        R"({"action": "allocate", "bundle-transport": {"ice": true}})",
+        R"({"action": 1})",
+        R"({)",
+        R"({})",
+        R"([])"};
+
+    for (auto body : bodies)
+    {
+        api::EndpointDescription description;
+        EXPECT_FALSE(streamParse(body, description)) << body;
+    }
+}
+
+TEST(StreamParserTest, throwsOnInvalidPatch)
+{
+    const char* bodies[] = {R"({"action": "configure", "data": {}})",
+        R"({"action": "configure", "audio": {"ssrcs": ["1"]}})",
+        R"({"action": "configure", "audio": {"payload-types": [{"id": 8, "name": "PCMA"}]}})",
+        R"({"action": "configure", "bundle-transport": {"ice": {"ufrag": "u", "pwd": "p", "candidates": [{}]}}})",
+        R"({"action": "configure", "bundle-transport": {"sdes": {"key": "AAAA", "profile": "AES_128_CM_SHA1_80"}}})",
+        R"({"action": "configure", "video": {"streams": [{"sources": [{"main": 1}]}]}})",
+        R"({"action": "reconfigure", "neighbours": {"groups": [1]}})"};
+
+    for (auto body : bodies)
+    {
+        api::EndpointDescription description;
+        EXPECT_THROW(streamParse(body, description), nlohmann::detail::other_error) << body;
+    }
+
+    for (auto body : {R"({"action": "configure", "audio": {}}})", R"({"action": "configure", "audio": {})"})
+    {
+        api::EndpointDescription description;
+        EXPECT_THROW(streamParse(body, description), nlohmann::detail::parse_error) << body;
+    }
+}
+
+TEST(StreamParserTest, writerMatchesGenerator)
+{
+    api::EndpointDescription description;
+    ASSERT_TRUE(streamParse(ResourceLoader::loadAsString("api-patch-full.json"), description));
+    srtp::AesKey sdesKey;
+    std::memset(sdesKey.keySalt, 7, sizeof(sdesKey.keySalt));
+    sdesKey.profile = srtp::Profile::AES128_CM_SHA1_80;
+    description.bundleTransport.get().sdesKeys.push_back(sdesKey);
+    description.bundleTransport.get().connection.set(api::Connection{10000, "10.0.0.1"});
+    description.bundleTransport.get().ice.get().lite = true;
+    description.video.get().transport.set(description.bundleTransport.get());
+
+    const auto written = api::Generator::writeAllocateEndpointResponse(description);
+    EXPECT_EQ(api::Generator::generateAllocateEndpointResponse(description), nlohmann::json::parse(written));
+    EXPECT_EQ(std::string::npos, written.find('\n'));
+
+    EXPECT_EQ("{}", api::Generator::writeAllocateEndpointResponse(api::EndpointDescription()));
+}
+
+TEST(StreamParserTest, perfParseAndGenerate)
+{
+#ifdef NOPERF_TEST
+    GTEST_SKIP();
+#endif
+    const auto body = ResourceLoader::loadAsString("api-patch-full.json");
+    const int count = 5000;
+
+    auto start = utils::Time::getAbsoluteTime();
+    for (int i = 0; i < count; ++i)
+    {
+        const auto description = api::Parser::parsePatchEndpoint(nlohmann::json::parse(body), "endpointId-0");
+        ASSERT_TRUE(description.audio.isSet());
+    }
+    const auto domParseTime = utils::Time::getAbsoluteTime() - start;
+
+    start = utils::Time::getAbsoluteTime();
+    api::EndpointDescription description;
+    for (int i = 0; i < count; ++i)
+    {
+        description = api::EndpointDescription();
+        ASSERT_TRUE(streamParse(body, description));
+    }
+    const auto streamParseTime = utils::Time::getAbsoluteTime() - start;
+
+    start = utils::Time::getAbsoluteTime();
+    size_t totalSize = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        totalSize += api::Generator::generateAllocateEndpointResponse(description).dump().size();
+    }
+    const auto domGenerateTime = utils::Time::getAbsoluteTime() - start;
+
+    start = utils::Time::getAbsoluteTime();
+    for (int i = 0; i < count; ++i)
+    {
+        totalSize += api::Generator::writeAllocateEndpointResponse(description).size();
+    }
+    const auto writeTime = utils::Time::getAbsoluteTime() - start;
+
+    logger::info("patch parse %" PRIu64 "ns dom, %" PRIu64 "ns stream. response %" PRIu64 "ns dom, %" PRIu64
+                 "ns writer, %zu",
+        "StreamParserTest",
+        domParseTime / count,
+        streamParseTime / count,
+        domGenerateTime / count,
+        writeTime / count,
+        totalSize);
+    EXPECT_LT(streamParseTime, domParseTime);
+    EXPECT_LT(writeTime, domGenerateTime);
+}
@@ -749,3 +749,94 @@ TEST_F(ActiveMediaListTest, mutedOutage)
 
     EXPECT_EQ(5, audioRewriteMap.size());
 }
+
+// Streams without the audio level extension are decoded on every levelDecodeInterval:th packet only, and the last
+// level is reused in between. The speakers picked must be the same as with a level for every packet.
+TEST_F(ActiveMediaListTest, rankingUnchangedWithLevelsFromAlternatePackets)
+{
+    const uint32_t levelDecodeInterval = 2;
+    const size_t numParticipants = 10;
+    const size_t speakers[] = {1, 6, 8};
+    auto decimatedList =
+        std::make_unique<bridge::ActiveMediaList>(1, _audioSsrcs, _videoSsrcs, defaultLastN, audioLastN, 18);
+
+    // the level tables end with a 0 entry that is not part of the recording
+    const auto feedLevels = [&](const size_t endpointIdHash, const uint8_t* levels, const size_t tableSize) {
+        uint8_t heldLevel = levels[0];
+        for (size_t i = 0; i + 1 < tableSize; ++i)
+        {
+            if (i % levelDecodeInterval == 0)
+            {
+                heldLevel = levels[i];
+            }
+            _activeMediaList->onNewAudioLevel(endpointIdHash, levels[i], false);
+            decimatedList->onNewAudioLevel(endpointIdHash, heldLevel, false);
+        }
+    };
+
+    const auto feedRound = [&](const size_t longSpeaker, const size_t shortSpeaker) {
+        for (size_t i = 1; i <= numParticipants; ++i)
+        {
+            if (i == longSpeaker)
+            {
+                feedLevels(i,
+                    ActiveMediaListTestLevels::longUtterance,
+                    sizeof(ActiveMediaListTestLevels::longUtterance));
+            }
+            else if (i == shortSpeaker)
+            {
+                feedLevels(i,
+                    ActiveMediaListTestLevels::shortUtterance,
+                    sizeof(ActiveMediaListTestLevels::shortUtterance));
+            }
+            else
+            {
+                feedLevels(i, ActiveMediaListTestLevels::silence, sizeof(ActiveMediaListTestLevels::silence));
+            }
+        }
+    };
+
+    uint64_t timestamp = 1000;
+    const auto processAndCompare = [&]() {
+        timestamp += 1000;
+        bool dominantSpeakerChanged = false;
+        bool videoMapChanged = false;
+        bool audioMapChanged = false;
+        _activeMediaList->process(timestamp * utils::Time::ms,
+            dominantSpeakerChanged,
+            videoMapChanged,
+            audioMapChanged);
+        decimatedList->process(timestamp * utils::Time::ms, dominantSpeakerChanged, videoMapChanged, audioMapChanged);
+
+        EXPECT_EQ(_activeMediaList->getDominantSpeaker(), decimatedList->getDominantSpeaker());
+        const auto& audioRewriteMap = _activeMediaList->getAudioSsrcRewriteMap();
+        const auto& decimatedAudioRewriteMap = decimatedList->getAudioSsrcRewriteMap();
+        EXPECT_EQ(audioRewriteMap.size(), decimatedAudioRewriteMap.size());
+        for (const auto speaker : speakers)
+        {
+            EXPECT_EQ(audioRewriteMap.contains(speaker), decimatedAudioRewriteMap.contains(speaker))
+                << "endpoint " << speaker;
+        }
+    };
+
+    for (size_t i = 1; i <= numParticipants; ++i)
+    {
+        _activeMediaList->addAudioParticipant(i, std::to_string(i).c_str());
+        decimatedList->addAudioParticipant(i, std::to_string(i).c_str());
+    }
+    feedRound(0, 0);
+    processAndCompare();
+
+    feedRound(1, 6);
+    processAndCompare();
+    EXPECT_EQ(1, decimatedList->getDominantSpeaker());
+    EXPECT_TRUE(decimatedList->getAudioSsrcRewriteMap().contains(6));
+
+    for (int i = 0; i < 10 && decimatedList->getDominantSpeaker() != 8; ++i)
+    {
+        feedRound(8, 0);
+        processAndCompare();
+    }
+    EXPECT_EQ(8, _activeMediaList->getDominantSpeaker());
+    EXPECT_EQ(8, decimatedList->getDominantSpeaker());
+}
@@ -1,12 +1,14 @@
 
 #include "bridge/ApiRequestHandler.h"
 #include "bridge/Mixer.h"
+#include "concurrency/Semaphore.h"
 #include "mocks/EngineMixerSpy.h"
 #include "mocks/MixerManagerSpy.h"
 #include "mocks/RtcTransportMock.h"
 #include "transport/ProbeServer.h"
 #include "transport/dtls/SslDtls.h"
 #include <gtest/gtest.h>
+#include <future>
 
 using namespace bridge;
 using namespace test;
@@ -384,3 +386,48 @@ TEST_F(ApiRequestHandlerTest, allocateEndpointWithVideoFieldWhenVideoIsEnableSho
     EXPECT_NE(responseJson.end(), responseJson.find("video"));
     EXPECT_NE(responseJson.end(), responseJson.find("data"));
 }
+
+TEST_F(ApiRequestHandlerTest, conferenceLockDoesNotBlockOtherConferences)
+{
+    auto requestHandler = createApiRequestHandler();
+    const auto conferenceA = createConference(requestHandler, R"({"last-n": 9})");
+    const auto conferenceB = createConference(requestHandler, R"({"last-n": 9})");
+
+    Mixer* mixerA = nullptr;
+    auto lockA = std::make_unique<MixerManager::ScopedMixerLock>(_mixerManagerSpy->getMixer(conferenceA, mixerA));
+    ASSERT_NE(nullptr, mixerA);
+    EXPECT_TRUE(lockA->owns_lock());
+
+    auto otherConference = std::async(std::launch::async, [this, &conferenceB]() {
+        Mixer* mixer = nullptr;
+        auto lock = _mixerManagerSpy->getMixer(conferenceB, mixer);
+        return mixer != nullptr && lock.owns_lock();
+    });
+    ASSERT_EQ(std::future_status::ready, otherConference.wait_for(std::chrono::seconds(5)));
+    EXPECT_TRUE(otherConference.get());
+
+    // a request on the same conference cannot take the lock until lockA is released
+    auto tryLockA = std::async(std::launch::async, [mixerA]() {
+        const bool locked = mixerA->getRequestLock().try_lock();
+        if (locked)
+        {
+            mixerA->getRequestLock().unlock();
+        }
+        return locked;
+    });
+    EXPECT_FALSE(tryLockA.get());
+
+    concurrency::Semaphore requestStarted;
+    auto sameConference = std::async(std::launch::async, [this, &conferenceA, &requestStarted]() {
+        requestStarted.post();
+        Mixer* mixer = nullptr;
+        auto lock = _mixerManagerSpy->getMixer(conferenceA, mixer);
+        return mixer != nullptr && lock.owns_lock();
+    });
+    requestStarted.wait();
+    EXPECT_EQ(std::future_status::timeout, sameConference.wait_for(std::chrono::milliseconds(100)));
+
+    lockA.reset();
+    ASSERT_EQ(std::future_status::ready, sameConference.wait_for(std::chrono::seconds(5)));
+    EXPECT_TRUE(sameConference.get());
+}
@@ -22,6 +22,7 @@ public:
     bool setSrtpRemoteRolloverCounter(const uint32_t ssrc, const uint32_t rolloverCounter) override { return true; }
     bool isGatheringComplete() const override { return true; }
     ice::IceCandidates getLocalCandidates() override { return ice::IceCandidates(); }
+    bool isIceLite() const override { return false; }
     std::pair<std::string, std::string> getLocalIceCredentials() override
     {
         return std::pair<std::string, std::string>();
@@ -52,6 +53,7 @@ public:
     {
     }
     void setAbsSendTimeExtensionId(uint8_t extensionId) override {}
+    void setTransportCcExtensionId(uint8_t extensionId) override {}
     bool start() override { return true; }
     bool isIceEnabled() const override { return true; }
 
@@ -98,6 +100,7 @@ public:
     const transport::SocketAddress& getRemotePeer() const override { return _socketAddress; }
 
     void setRtxProbeSource(const uint32_t ssrc, uint32_t* sequenceCounter, const uint16_t payloadType) override {}
+    void setPacingPriority(uint32_t ssrc, transport::PacingPriority priority) override {}
 
     ice::IceSession::State getIceState() const override { return ice::IceSession::State::CONNECTED; };
 
@@ -106,6 +109,7 @@ public:
     {
         return utils::Optional<ice::TransportType>();
     }
+    uint64_t getIceFastPathResponseCount() const override { return 0; }
 
     void setTag(const char* tag) override{};
     const char* getTag() const override { return nullptr; };
@@ -113,6 +117,7 @@ public:
     uint64_t getLastReceivedPacketTimestamp() const override { return 0; }
     void getSdesKeys(std::vector<srtp::AesKey>& sdesKeys) const override {}
     void asyncSetRemoteSdesKey(const srtp::AesKey& key) override {}
+    void asyncSetPacketCapture(std::shared_ptr<logger::PacketCapture> packetCapture) override {}
 
     logger::LoggableId _loggableId;
     size_t _endpointIdHash;
@@ -1330,4 +1330,96 @@ TEST_F(EngineStreamDirectorTest, bitrate1200UnpinnedMiddleQuality)
     EXPECT_FALSE(_engineStreamDirector->shouldForwardSsrc(2, 1));
     EXPECT_TRUE(_engineStreamDirector->shouldForwardSsrc(2, 3));
     EXPECT_FALSE(_engineStreamDirector->shouldForwardSsrc(2, 5));
-}
\ No newline at end of file
+}
+
+TEST_F(EngineStreamDirectorTest, temporalLayersAreNotThinnedByDefault)
+{
+    _engineStreamDirector->addParticipant(1, makeSimulcastStream(1, 2, 3, 4, 5, 6));
+    _engineStreamDirector->addParticipant(2);
+    _engineStreamDirector->pin(2, 0);
+
+    _engineStreamDirector->setUplinkEstimateKbps(2, 400, 60 * utils::Time::sec);
+    EXPECT_EQ(bridge::EngineStreamDirector::allTemporalLayers, _engineStreamDirector->getMaxTemporalLayer(2, 3));
+    EXPECT_TRUE(_engineStreamDirector->shouldForwardSsrc(2, 1));
+    EXPECT_FALSE(_engineStreamDirector->shouldForwardSsrc(2, 3));
+}
+
+TEST_F(EngineStreamDirectorTest, temporalLayerThinningBetweenLevels)
+{
+    config::Config config;
+    ASSERT_TRUE(config.readFromString("{\"temporalLayerThinning\": true}"));
+    _engineStreamDirector =
+        std::make_unique<bridge::EngineStreamDirector>(logger::LoggableId::nextInstanceId(), config, 9);
+
+    _engineStreamDirector->addParticipant(1, makeSimulcastStream(1, 2, 3, 4, 5, 6));
+    _engineStreamDirector->addParticipant(2);
+    _engineStreamDirector->pin(2, 0);
+
+    // mid level does not fit at full rate, but does at half frame rate
+    _engineStreamDirector->setUplinkEstimateKbps(2, 400, 60 * utils::Time::sec);
+    EXPECT_EQ(1, _engineStreamDirector->getMaxTemporalLayer(2, 3));
+    EXPECT_FALSE(_engineStreamDirector->shouldForwardSsrc(2, 1));
+    EXPECT_TRUE(_engineStreamDirector->shouldForwardSsrc(2, 3));
+    EXPECT_FALSE(_engineStreamDirector->shouldForwardSsrc(2, 5));
+
+    _engineStreamDirector->setUplinkEstimateKbps(2, 1200, 61 * utils::Time::sec);
+    EXPECT_EQ(bridge::EngineStreamDirector::allTemporalLayers, _engineStreamDirector->getMaxTemporalLayer(2, 3));
+    EXPECT_TRUE(_engineStreamDirector->shouldForwardSsrc(2, 3));
+
+    _engineStreamDirector->setUplinkEstimateKbps(2, 120, 62 * utils::Time::sec);
+    EXPECT_EQ(1, _engineStreamDirector->getMaxTemporalLayer(2, 3));
+    EXPECT_TRUE(_engineStreamDirector->shouldForwardSsrc(2, 1));
+
+    _engineStreamDirector->setUplinkEstimateKbps(2, 50, 63 * utils::Time::sec);
+    EXPECT_EQ(bridge::EngineStreamDirector::allTemporalLayers, _engineStreamDirector->getMaxTemporalLayer(2, 3));
+    EXPECT_FALSE(_engineStreamDirector->shouldForwardSsrc(2, 1));
+}
+
+TEST_F(EngineStreamDirectorTest, temporalLayerThinningHysteresis)
+{
+    config::Config config;
+    ASSERT_TRUE(config.readFromString("{\"temporalLayerThinning\": true}"));
+    _engineStreamDirector =
+        std::make_unique<bridge::EngineStreamDirector>(logger::LoggableId::nextInstanceId(), config, 9);
+
+    _engineStreamDirector->addParticipant(1, makeSimulcastStream(1, 2, 3, 4, 5, 6));
+    _engineStreamDirector->addParticipant(2);
+    _engineStreamDirector->pin(2, 0);
+
+    // thinned mid level fits, but without headroom to start thinning
+    _engineStreamDirector->setUplinkEstimateKbps(2, 340, 60 * utils::Time::sec);
+    EXPECT_EQ(bridge::EngineStreamDirector::allTemporalLayers, _engineStreamDirector->getMaxTemporalLayer(2, 3));
+
+    _engineStreamDirector->setUplinkEstimateKbps(2, 400, 61 * utils::Time::sec);
+    EXPECT_EQ(1, _engineStreamDirector->getMaxTemporalLayer(2, 3));
+
+    // keeps thinning as long as the thinned cost fits
+    _engineStreamDirector->setUplinkEstimateKbps(2, 340, 62 * utils::Time::sec);
+    EXPECT_EQ(1, _engineStreamDirector->getMaxTemporalLayer(2, 3));
+    EXPECT_TRUE(_engineStreamDirector->shouldForwardSsrc(2, 3));
+
+    _engineStreamDirector->setUplinkEstimateKbps(2, 300, 63 * utils::Time::sec);
+    EXPECT_EQ(bridge::EngineStreamDirector::allTemporalLayers, _engineStreamDirector->getMaxTemporalLayer(2, 3));
+    EXPECT_TRUE(_engineStreamDirector->shouldForwardSsrc(2, 1));
+}
+
+TEST_F(EngineStreamDirectorTest, slidesAreNotThinned)
+{
+    config::Config config;
+    ASSERT_TRUE(config.readFromString("{\"temporalLayerThinning\": true}"));
+    _engineStreamDirector =
+        std::make_unique<bridge::EngineStreamDirector>(logger::LoggableId::nextInstanceId(), config, 9);
+
+    _engineStreamDirector->addParticipant(1, makeSimulcastStream(1, 2, 3, 4, 5, 6));
+    _engineStreamDirector->addParticipant(2);
+    _engineStreamDirector->pin(2, 0);
+
+    _engineStreamDirector->setUplinkEstimateKbps(2, 400, 60 * utils::Time::sec);
+    EXPECT_EQ(1, _engineStreamDirector->getMaxTemporalLayer(2, 3));
+
+    const auto version = _engineStreamDirector->getTemporalLayerVersion();
+    _engineStreamDirector->setSlidesSsrcAndBitrate(7, 0);
+    EXPECT_NE(version, _engineStreamDirector->getTemporalLayerVersion());
+    EXPECT_EQ(bridge::EngineStreamDirector::allTemporalLayers, _engineStreamDirector->getMaxTemporalLayer(2, 7));
+    EXPECT_EQ(1, _engineStreamDirector->getMaxTemporalLayer(2, 3));
+}
@@ -1,8 +1,10 @@
 
 #include "bridge/engine/SsrcOutboundContext.h"
+#include "bridge/engine/InboundPacketCache.h"
 #include "bridge/engine/SsrcInboundContext.h"
 #include "codec/Vp8Header.h"
 #include "memory/PacketPoolAllocator.h"
+#include "rtp/RtpHeader.h"
 #include "utils/SsrcGenerator.h"
 #include <gtest/gtest.h>
 #include <memory>
@@ -54,7 +56,7 @@ void examineVp8(bridge::SsrcOutboundContext& outboundContext,
 
     uint32_t sequenceNumberAfterRewrite = 0;
     ASSERT_TRUE(outboundContext
-                    .rewriteVideo(*rtpHeader, inboundContext, seqNo, "", sequenceNumberAfterRewrite, wallClock, false));
+                    .rewriteVideo(packet, inboundContext, seqNo, "", sequenceNumberAfterRewrite, wallClock, false));
     EXPECT_EQ(outboundContext.ssrc, rtpHeader->ssrc.get());
     EXPECT_EQ(expectedSeqNo & 0xFFFFu, rtpHeader->sequenceNumber.get());
     EXPECT_EQ(expectedSeqNo, sequenceNumberAfterRewrite);
@@ -85,7 +87,7 @@ void examineVp8(bridge::SsrcOutboundContext& outboundContext,
 
     uint32_t sequenceNumberAfterRewrite = 0;
     ASSERT_TRUE(outboundContext
-                    .rewriteVideo(*rtpHeader, inboundContext, seqNo, "", sequenceNumberAfterRewrite, wallClock, false));
+                    .rewriteVideo(packet, inboundContext, seqNo, "", sequenceNumberAfterRewrite, wallClock, false));
 
     EXPECT_EQ(outboundContext.ssrc, rtpHeader->ssrc.get());
     EXPECT_EQ(expectedSeqNo & 0xFFFFu, rtpHeader->sequenceNumber.get());
@@ -115,7 +117,26 @@ void expectVideoPacketDrop(bridge::SsrcOutboundContext& outboundContext,
     uint32_t sequenceNumberAfterRewrite = 0;
     ASSERT_FALSE(
         outboundContext
-            .rewriteVideo(*rtpHeader, inboundContext, seqNo, "", sequenceNumberAfterRewrite, wallClock, false));
+            .rewriteVideo(packet, inboundContext, seqNo, "", sequenceNumberAfterRewrite, wallClock, false));
+}
+
+bool dropTemporalLayerVp8(bridge::SsrcOutboundContext& outboundContext,
+    bridge::SsrcInboundContext& inboundContext,
+    memory::Packet& packet,
+    uint32_t seqNo,
+    uint16_t picId,
+    uint8_t tid,
+    bool layerSync,
+    uint8_t maxTemporalLayer)
+{
+    auto rtpHeader = rtp::RtpHeader::create(packet);
+    auto payload = rtpHeader->getPayload();
+    rtpHeader->ssrc = inboundContext.ssrc;
+    rtpHeader->sequenceNumber = seqNo & 0xFFFFu;
+    codec::Vp8Header::setPicId(payload, picId);
+    payload[5] = (tid << 6) | (layerSync ? 0x20 : 0);
+
+    return outboundContext.dropTemporalLayer(*rtpHeader, seqNo, maxTemporalLayer, false);
 }
 
 void examineH264(bridge::SsrcOutboundContext& outboundContext,
@@ -133,7 +154,7 @@ void examineH264(bridge::SsrcOutboundContext& outboundContext,
 
     uint32_t sequenceNumberAfterRewrite = 0;
     ASSERT_TRUE(outboundContext
-                    .rewriteVideo(*rtpHeader, inboundContext, seqNo, "", sequenceNumberAfterRewrite, wallClock, false));
+                    .rewriteVideo(packet, inboundContext, seqNo, "", sequenceNumberAfterRewrite, wallClock, false));
 
     EXPECT_EQ(outboundContext.ssrc, rtpHeader->ssrc.get());
     EXPECT_EQ(expectedSeqNo & 0xFFFFu, rtpHeader->sequenceNumber.get());
@@ -159,6 +180,8 @@ public:
     void SetUp() override
     {
         _allocator = std::make_unique<memory::PacketPoolAllocator>(16, "SsrcOutboundContextTest");
+        _cacheAllocator = std::make_unique<memory::PacketPoolAllocator>(2 * bridge::InboundPacketCache::maxPackets,
+            "SsrcOutboundContextTestCache");
         _wallClock = 4000;
     }
 
@@ -166,6 +189,7 @@ public:
     {
         ssrcOutboundContexts.clear();
         _allocator = nullptr;
+        _cacheAllocator = nullptr;
     }
 
     bridge::SsrcOutboundContext* createOutboundContext(uint32_t ssrc,
@@ -260,6 +284,7 @@ private:
 protected:
     utils::SsrcGenerator _ssrcGenerator;
     std::unique_ptr<memory::PacketPoolAllocator> _allocator;
+    std::unique_ptr<memory::PacketPoolAllocator> _cacheAllocator;
     std::vector<std::unique_ptr<bridge::SsrcInboundContext>> _ssrcInboundContext;
     std::vector<std::unique_ptr<bridge::SsrcOutboundContext>> ssrcOutboundContexts;
     uint64_t _wallClock;
@@ -276,13 +301,13 @@ TEST_F(SsrcOutboundContextTest, audioRewrite)
     rtpHeader->sequenceNumber = 12;
     rtpHeader->timestamp = 5000;
 
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 12, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 12, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 12, 5000));
 
     rtpHeader = initializePacket(packet, *ssrcInboundContext);
     rtpHeader->sequenceNumber = 13;
     rtpHeader->timestamp = 5000 + 960;
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 13, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 13, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 13, 5000 + 960));
 }
 
@@ -300,13 +325,13 @@ TEST_F(SsrcOutboundContextTest, audioRewriteAdvTimestamp)
     const auto seqCount = 12;
     const auto curTimestamp = 5000;
 
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 12, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 12, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, seqCount, curTimestamp));
 
     rtpHeader = initializePacket(packet, *ssrcInboundContext);
     rtpHeader->sequenceNumber = 13;
     rtpHeader->timestamp = 5000 + 5 * 960;
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 13, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 13, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, seqCount + 1, curTimestamp + 960 * 5));
 }
 
@@ -321,26 +346,26 @@ TEST_F(SsrcOutboundContextTest, audioRewritePrevSequenceNumber)
 
     rtpHeader->sequenceNumber = 3;
     rtpHeader->timestamp = 5000;
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 3, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 3, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 3, 5000));
 
     rtpHeader = initializePacket(packet, *ssrcInboundContext);
     rtpHeader->sequenceNumber = 10;
     rtpHeader->timestamp = 5000 + 7 * 960;
 
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 10, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 10, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 10, 5000 + 7 * 960));
 
     rtpHeader = initializePacket(packet, *ssrcInboundContext);
     rtpHeader->sequenceNumber = 5;
     rtpHeader->timestamp = 5000 + 2 * 960;
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 5, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 5, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 5, 5000 + 2 * 960));
 
     rtpHeader = initializePacket(packet, *ssrcInboundContext);
     rtpHeader->sequenceNumber = 4;
     rtpHeader->timestamp = 5000 + 960;
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 4, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 4, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 4, 5000 + 960));
 }
 
@@ -359,7 +384,7 @@ TEST_F(SsrcOutboundContextTest, audioRewriteShouldReturnFalseWhenPacketIsOlderTh
 
     const auto curTimestamp = 5000;
 
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, extSeqNo, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, extSeqNo, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, extSeqNo, curTimestamp));
 
     rtpHeader = initializePacket(packet, *ssrcInboundContext);
@@ -368,7 +393,7 @@ TEST_F(SsrcOutboundContextTest, audioRewriteShouldReturnFalseWhenPacketIsOlderTh
     rtpHeader->timestamp = 5000 - 2 * 960;
 
     // Before switch
-    ASSERT_FALSE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, extSeqNo, _wallClock, false));
+    ASSERT_FALSE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, extSeqNo, _wallClock, false));
 }
 
 TEST_F(SsrcOutboundContextTest, audioRewriteSmallGap)
@@ -387,14 +412,14 @@ TEST_F(SsrcOutboundContextTest, audioRewriteSmallGap)
     const auto seqCount = extSeqNo;
     const auto curTimestamp = 5000;
 
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 12, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 12, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, seqCount, curTimestamp));
 
     rtpHeader = initializePacket(packet, *ssrcInboundContext);
     extSeqNo = 201;
     rtpHeader->sequenceNumber = extSeqNo;
     rtpHeader->timestamp = 5000 + 189 * 960;
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, extSeqNo, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, extSeqNo, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, seqCount + 189, curTimestamp + 189 * 960));
 }
 
@@ -414,7 +439,7 @@ TEST_F(SsrcOutboundContextTest, audioRewriteLargeGap)
     const auto seqCount = 12;
     const auto curTimestamp = 5000;
 
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, extSeqNo, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, extSeqNo, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, extSeqNo, curTimestamp));
 
     rtpHeader = initializePacket(packet, *ssrcInboundContext);
@@ -422,7 +447,7 @@ TEST_F(SsrcOutboundContextTest, audioRewriteLargeGap)
     extSeqNo = 312;
     rtpHeader->sequenceNumber = extSeqNo;
     rtpHeader->timestamp = 5000 + 300 * 960;
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, extSeqNo, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, extSeqNo, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, seqCount + 1, curTimestamp + 300 * 960));
 }
 
@@ -445,14 +470,14 @@ TEST_F(SsrcOutboundContextTest, audioRewriteSsrcSwitchAfterMute)
     rtpHeaderSsrc0->timestamp = curTimestamp;
 
     const uint32_t outSsrc = ssrcOutboundContext->ssrc;
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeaderSsrc0, *ssrcInboundContext0, extSeqNo, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet0, *ssrcInboundContext0, extSeqNo, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeaderSsrc0, outSsrc, extSeqNo, curTimestamp));
 
     _wallClock += 6 * utils::Time::sec;
     extSeqNo = 0x123A890;
     rtpHeaderSsrc1->sequenceNumber = 0xA890;
     rtpHeaderSsrc1->timestamp = 1235000;
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeaderSsrc1, *ssrcInboundContext1, extSeqNo, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet1, *ssrcInboundContext1, extSeqNo, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeaderSsrc1, outSsrc, 13, curTimestamp + 300 * 960));
 }
 
@@ -468,7 +493,7 @@ TEST_F(SsrcOutboundContextTest, audioRewriteRewriteAfterDropTelephoneEvents)
     rtpHeader->sequenceNumber = 12;
     rtpHeader->timestamp = 5000;
 
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 12, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 12, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 12, 5000));
 
     ssrcOutboundContext->dropTelephoneEvent(13, ssrcInboundContext->ssrc);
@@ -479,7 +504,7 @@ TEST_F(SsrcOutboundContextTest, audioRewriteRewriteAfterDropTelephoneEvents)
     rtpHeader = initializePacket(packet, *ssrcInboundContext);
     rtpHeader->sequenceNumber = 17;
     rtpHeader->timestamp = 5000 + 960;
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 17, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 17, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 13, 5000 + 960));
 }
 
@@ -494,7 +519,7 @@ TEST_F(SsrcOutboundContextTest, audioRewriteRewriteAfterOutOfOrderedDropTelephon
     rtpHeader->sequenceNumber = 12;
     rtpHeader->timestamp = 5000;
 
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 12, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 12, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 12, 5000));
 
     ssrcOutboundContext->dropTelephoneEvent(16, ssrcInboundContext->ssrc);
@@ -505,7 +530,7 @@ TEST_F(SsrcOutboundContextTest, audioRewriteRewriteAfterOutOfOrderedDropTelephon
     rtpHeader = initializePacket(packet, *ssrcInboundContext);
     rtpHeader->sequenceNumber = 17;
     rtpHeader->timestamp = 5000 + 960;
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 17, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 17, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 13, 5000 + 960));
 }
 
@@ -520,49 +545,49 @@ TEST_F(SsrcOutboundContextTest, audioRewriteOutOfOrder)
     rtpHeader->sequenceNumber = 12;
     rtpHeader->timestamp = 5000;
 
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 12, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 12, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 12, 5000));
 
     rtpHeader = initializePacket(packet, *ssrcInboundContext);
     rtpHeader->sequenceNumber = 15;
     rtpHeader->timestamp = 5000 + 960 * 3;
 
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 15, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 15, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 15, 5000 + 960 * 3));
 
     rtpHeader = initializePacket(packet, *ssrcInboundContext);
     rtpHeader->sequenceNumber = 13;
     rtpHeader->timestamp = 5000 + 960;
 
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 13, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 13, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 13, 5000 + 960));
 
     rtpHeader = initializePacket(packet, *ssrcInboundContext);
     rtpHeader->sequenceNumber = 17;
     rtpHeader->timestamp = 5000 + 960 * 5;
 
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 17, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 17, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 17, 5000 + 960 * 5));
 
     rtpHeader = initializePacket(packet, *ssrcInboundContext);
     rtpHeader->sequenceNumber = 14;
     rtpHeader->timestamp = 5000 + 960 * 2;
 
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 14, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 14, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 14, 5000 + 960 * 2));
 
     rtpHeader = initializePacket(packet, *ssrcInboundContext);
     rtpHeader->sequenceNumber = 16;
     rtpHeader->timestamp = 5000 + 960 * 4;
 
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 16, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 16, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 16, 5000 + 960 * 4));
 
     rtpHeader = initializePacket(packet, *ssrcInboundContext);
     rtpHeader->sequenceNumber = 18;
     rtpHeader->timestamp = 5000 + 960 * 6;
 
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 18, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 18, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 18, 5000 + 960 * 6));
 }
 
@@ -577,7 +602,7 @@ TEST_F(SsrcOutboundContextTest, audioRewriteDropTelephoneEventsOutOfOrder)
     rtpHeader->sequenceNumber = 12;
     rtpHeader->timestamp = 5000;
 
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 12, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 12, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 12, 5000));
 
     ssrcOutboundContext->dropTelephoneEvent(17, ssrcInboundContext->ssrc);
@@ -587,7 +612,7 @@ TEST_F(SsrcOutboundContextTest, audioRewriteDropTelephoneEventsOutOfOrder)
     rtpHeader->sequenceNumber = 13;
     rtpHeader->timestamp = 5000 + 960;
 
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 13, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 13, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 13, 5000 + 960));
 
     ssrcOutboundContext->dropTelephoneEvent(18, ssrcInboundContext->ssrc);
@@ -597,7 +622,7 @@ TEST_F(SsrcOutboundContextTest, audioRewriteDropTelephoneEventsOutOfOrder)
     rtpHeader->timestamp = 5000 + 960 * 3;
 
     // This is recoverable as it is later than dropped telephone events but is newer than the last audio packet
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 15, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 15, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 15, 5000 + 960 * 3));
 
     rtpHeader = initializePacket(packet, *ssrcInboundContext);
@@ -605,14 +630,14 @@ TEST_F(SsrcOutboundContextTest, audioRewriteDropTelephoneEventsOutOfOrder)
     rtpHeader->timestamp = 5000 + 960 * 2;
 
     // This is not recoverable because is lated than dropped telephone events AND later than last audio packet sent
-    ASSERT_FALSE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 14, _wallClock, false));
+    ASSERT_FALSE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 14, _wallClock, false));
 
     rtpHeader = initializePacket(packet, *ssrcInboundContext);
     rtpHeader->sequenceNumber = 19;
     rtpHeader->timestamp = 5000 + 960 * 4;
 
     // Check if it next packet proceed correctly
-    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(*rtpHeader, *ssrcInboundContext, 19, _wallClock, false));
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, *ssrcInboundContext, 19, _wallClock, false));
     ASSERT_TRUE(verifyRtp(*rtpHeader, ssrcOutboundContext->ssrc, 16, 5000 + 960 * 4));
 }
 
@@ -1036,6 +1061,263 @@ TEST_F(SsrcOutboundContextTest, videoRewriteSeqSkipBeyondMarginRollover)
     examineVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 0x14003, 3, 0xFFF2, 3, 3, 3, 3, _wallClock);
 }
 
+TEST_F(SsrcOutboundContextTest, vp8TemporalLayerThinningKeepsCountersConsecutive)
+{
+    auto ssrcOutboundContext = createDefaultOutboundContextForVideoVp8();
+    auto ssrcInboundContext = createInboundContextForVideoVp8();
+
+    auto packet = memory::makeUniquePacket(*_allocator);
+    packet->setLength(packet->size);
+
+    auto rtpHeader = rtp::RtpHeader::create(*packet);
+    auto payload = rtpHeader->getPayload();
+    std::array<uint8_t, 6> vp8PayloadDescriptor = {0x90, 0xe0, 0xab, 0xb9, 0xd3, 0x00};
+    memcpy(payload, vp8PayloadDescriptor.data(), vp8PayloadDescriptor.size());
+
+    // L1T3 pattern 0, 2, 1, 2, 0 thinned to TL1
+    EXPECT_FALSE(dropTemporalLayerVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 1, 1, 0, false, 1));
+    examineVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 1, 1, 1, 1, 1, 1, 1, _wallClock);
+    EXPECT_TRUE(dropTemporalLayerVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 2, 2, 2, false, 1));
+    EXPECT_TRUE(dropTemporalLayerVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 3, 2, 2, false, 1));
+    EXPECT_FALSE(dropTemporalLayerVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 4, 3, 1, false, 1));
+    examineVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 4, 2, 2, 3, 1, 2, 1, _wallClock);
+    EXPECT_TRUE(dropTemporalLayerVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 5, 4, 2, false, 1));
+    EXPECT_FALSE(dropTemporalLayerVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 6, 5, 0, false, 1));
+    examineVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 6, 3, 3, 5, 2, 3, 2, _wallClock);
+}
+
+TEST_F(SsrcOutboundContextTest, vp8TemporalLayerThinningForwardsReorderedPackets)
+{
+    auto ssrcOutboundContext = createDefaultOutboundContextForVideoVp8();
+    auto ssrcInboundContext = createInboundContextForVideoVp8();
+
+    auto packet = memory::makeUniquePacket(*_allocator);
+    packet->setLength(packet->size);
+
+    auto rtpHeader = rtp::RtpHeader::create(*packet);
+    auto payload = rtpHeader->getPayload();
+    std::array<uint8_t, 6> vp8PayloadDescriptor = {0x90, 0xe0, 0xab, 0xb9, 0xd3, 0x00};
+    memcpy(payload, vp8PayloadDescriptor.data(), vp8PayloadDescriptor.size());
+
+    EXPECT_FALSE(dropTemporalLayerVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 1, 1, 0, false, 1));
+    examineVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 1, 1, 1, 1, 1, 1, 1, _wallClock);
+    EXPECT_FALSE(dropTemporalLayerVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 3, 3, 1, false, 1));
+    examineVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 3, 3, 3, 3, 1, 3, 1, _wallClock);
+
+    // the gap at 2 is already visible to the receiver so it cannot be hidden
+    EXPECT_FALSE(dropTemporalLayerVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 2, 2, 2, false, 1));
+}
+
+TEST_F(SsrcOutboundContextTest, vp8TemporalLayerSwitchUpOnLayerSync)
+{
+    auto ssrcOutboundContext = createDefaultOutboundContextForVideoVp8();
+    auto ssrcInboundContext = createInboundContextForVideoVp8();
+
+    auto packet = memory::makeUniquePacket(*_allocator);
+    packet->setLength(packet->size);
+
+    auto rtpHeader = rtp::RtpHeader::create(*packet);
+    auto payload = rtpHeader->getPayload();
+    std::array<uint8_t, 6> vp8PayloadDescriptor = {0x90, 0xe0, 0xab, 0xb9, 0xd3, 0x00};
+    memcpy(payload, vp8PayloadDescriptor.data(), vp8PayloadDescriptor.size());
+
+    EXPECT_FALSE(dropTemporalLayerVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 1, 1, 0, false, 0));
+    examineVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 1, 1, 1, 1, 1, 1, 1, _wallClock);
+    EXPECT_TRUE(dropTemporalLayerVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 2, 2, 2, false, 2));
+    EXPECT_FALSE(dropTemporalLayerVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 3, 3, 1, true, 2));
+    examineVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 3, 2, 2, 3, 1, 2, 1, _wallClock);
+    EXPECT_TRUE(dropTemporalLayerVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 4, 4, 2, false, 2));
+    EXPECT_FALSE(dropTemporalLayerVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 5, 5, 2, true, 2));
+    examineVp8(*ssrcOutboundContext, *ssrcInboundContext, *packet, 5, 3, 3, 5, 1, 3, 1, _wallClock);
+}
+
+TEST_F(SsrcOutboundContextTest, vp8RetransmissionIsRebuiltFromInboundCache)
+{
+    auto ssrcOutboundContext = createDefaultOutboundContextForVideoVp8();
+    auto ssrcInboundContext = createInboundContextForVideoVp8();
+    auto inboundPacketCache = std::make_shared<bridge::InboundPacketCache>("SsrcOutboundContextTest",
+        ssrcInboundContext->ssrc,
+        *_cacheAllocator);
+    inboundPacketCache->rtpMap = DEFAULT_VP8_RTP_MAP;
+
+    std::array<uint8_t, 6> vp8PayloadDescriptor = {0x90, 0xe0, 0xab, 0xb9, 0xd3, 0x00};
+    const uint8_t temporalLayers[] = {0, 2, 1, 2, 0, 2, 1, 2};
+    std::vector<memory::Packet> sentPackets;
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        memory::Packet packet;
+        packet.setLength(210);
+        auto rtpHeader = rtp::RtpHeader::create(packet);
+        auto payload = rtpHeader->getPayload();
+        memcpy(payload, vp8PayloadDescriptor.data(), vp8PayloadDescriptor.size());
+        rtpHeader->ssrc = ssrcInboundContext->ssrc;
+        rtpHeader->sequenceNumber = 100 + i;
+        rtpHeader->timestamp = 5000 + i * 3000;
+        codec::Vp8Header::setPicId(payload, 30 + i);
+        codec::Vp8Header::setTl0PicIdx(payload, 7 + i / 4);
+        payload[5] = temporalLayers[i] << 6;
+        payload[6] = i;
+        inboundPacketCache->add(packet, 100 + i);
+
+        if (ssrcOutboundContext->dropTemporalLayer(*rtpHeader, 100 + i, 1, false))
+        {
+            continue;
+        }
+
+        uint32_t sequenceNumberAfterRewrite = 0;
+        ASSERT_TRUE(ssrcOutboundContext->rewriteVideo(packet,
+            *ssrcInboundContext,
+            100 + i,
+            "",
+            sequenceNumberAfterRewrite,
+            _wallClock,
+            false));
+        ssrcOutboundContext->storeRetransmissionSource(*inboundPacketCache, sequenceNumberAfterRewrite, 100 + i);
+        sentPackets.push_back(packet);
+    }
+
+    ASSERT_EQ(4, sentPackets.size());
+    for (const auto& sentPacket : sentPackets)
+    {
+        const auto sequenceNumber = rtp::RtpHeader::fromPacket(sentPacket)->sequenceNumber.get();
+        memory::Packet retransmission;
+        ASSERT_TRUE(ssrcOutboundContext->rewriteRetransmission(sequenceNumber, retransmission));
+        ASSERT_EQ(sentPacket.getLength(), retransmission.getLength());
+        EXPECT_EQ(0, memcmp(sentPacket.get(), retransmission.get(), sentPacket.getLength()));
+    }
+
+    memory::Packet retransmission;
+    const auto lastSequenceNumber = rtp::RtpHeader::fromPacket(sentPackets.back())->sequenceNumber.get();
+    EXPECT_FALSE(ssrcOutboundContext->rewriteRetransmission(lastSequenceNumber + 1, retransmission));
+}
+
+TEST_F(SsrcOutboundContextTest, retransmissionAfterSimulcastSwitchUsesPreviousInboundCache)
+{
+    auto ssrcOutboundContext = createDefaultOutboundContextForVideoVp8();
+    bridge::SsrcInboundContext* inboundContexts[] = {createInboundContextForVideoVp8(), createInboundContextForVideoVp8()};
+    std::shared_ptr<bridge::InboundPacketCache> inboundPacketCaches[2];
+    for (int i = 0; i < 2; ++i)
+    {
+        inboundPacketCaches[i] = std::make_shared<bridge::InboundPacketCache>("SsrcOutboundContextTest",
+            inboundContexts[i]->ssrc,
+            *_cacheAllocator);
+        inboundPacketCaches[i]->rtpMap = DEFAULT_VP8_RTP_MAP;
+    }
+
+    std::array<uint8_t, 6> vp8PayloadDescriptor = {0x90, 0xe0, 0xab, 0xb9, 0xd3, 0x00};
+    std::vector<memory::Packet> sentPackets;
+    uint32_t outSequenceNumber = 0;
+    for (uint32_t i = 0; i < 8 + bridge::InboundPacketCache::maxPackets; ++i)
+    {
+        const auto source = i < 4 ? 0 : 1;
+        memory::Packet packet;
+        packet.setLength(210);
+        auto rtpHeader = rtp::RtpHeader::create(packet);
+        auto payload = rtpHeader->getPayload();
+        memcpy(payload, vp8PayloadDescriptor.data(), vp8PayloadDescriptor.size());
+        rtpHeader->ssrc = inboundContexts[source]->ssrc;
+        rtpHeader->sequenceNumber = 100 + i;
+        rtpHeader->timestamp = 5000 + i * 3000;
+        codec::Vp8Header::setPicId(payload, 30 + i);
+        codec::Vp8Header::setTl0PicIdx(payload, 7);
+        inboundPacketCaches[source]->add(packet, 100 + i);
+
+        ASSERT_TRUE(ssrcOutboundContext->rewriteVideo(packet,
+            *inboundContexts[source],
+            100 + i,
+            "",
+            outSequenceNumber,
+            _wallClock,
+            i == 0 || i == 4));
+        ssrcOutboundContext->storeRetransmissionSource(*inboundPacketCaches[source], outSequenceNumber, 100 + i);
+        if (i < 8)
+        {
+            sentPackets.push_back(packet);
+        }
+
+        if (i == 7)
+        {
+            // NACKs for packets sent before and after the switch are both served
+            for (const auto& sentPacket : sentPackets)
+            {
+                memory::Packet retransmission;
+                ASSERT_TRUE(ssrcOutboundContext->rewriteRetransmission(
+                    rtp::RtpHeader::fromPacket(sentPacket)->sequenceNumber.get(),
+                    retransmission));
+                ASSERT_EQ(sentPacket.getLength(), retransmission.getLength());
+                EXPECT_EQ(0, memcmp(sentPacket.get(), retransmission.get(), sentPacket.getLength()));
+            }
+        }
+    }
+
+    // the previous source is released once its sequence range has been reused
+    EXPECT_EQ(1, inboundPacketCaches[0].use_count());
+    memory::Packet retransmission;
+    EXPECT_FALSE(ssrcOutboundContext->rewriteRetransmission(
+        rtp::RtpHeader::fromPacket(sentPackets.front())->sequenceNumber.get(),
+        retransmission));
+}
+
+TEST_F(SsrcOutboundContextTest, audioHeaderExtensionsRewrittenAndLocated)
+{
+    bridge::RtpMap senderRtpMap(bridge::RtpMap::Format::OPUS);
+    senderRtpMap.audioLevelExtId.set(1);
+    senderRtpMap.absSendTimeExtId.set(2);
+    senderRtpMap.transportCcExtId.set(3);
+    bridge::RtpMap receiverRtpMap(bridge::RtpMap::Format::OPUS);
+    receiverRtpMap.absSendTimeExtId.set(5);
+    receiverRtpMap.transportCcExtId.set(3);
+
+    auto ssrcOutboundContext = createOutboundContext(kDefaultOutboundSsrc, receiverRtpMap);
+    bridge::SsrcInboundContext ssrcInboundContext(4711, senderRtpMap, bridge::RtpMap::EMPTY, nullptr, _wallClock);
+
+    memory::Packet packet;
+    packet.setLength(210);
+    auto rtpHeader = rtp::RtpHeader::create(packet);
+    rtpHeader->ssrc = ssrcInboundContext.ssrc;
+    rtpHeader->sequenceNumber = 12;
+    rtpHeader->timestamp = 5000;
+
+    rtp::RtpHeaderExtension extensionHead;
+    auto cursor = extensionHead.extensions().begin();
+    extensionHead.addExtension(cursor, rtp::GeneralExtension1Byteheader(1, 1));
+    extensionHead.addExtension(cursor, rtp::GeneralExtension1Byteheader(2, 3));
+    extensionHead.addExtension(cursor, rtp::GeneralExtension1Byteheader(3, 2));
+    rtpHeader->setExtensions(extensionHead, 100);
+    packet.setLength(rtpHeader->headerLength() + 100);
+
+    ASSERT_TRUE(ssrcOutboundContext->rewriteAudio(packet, ssrcInboundContext, 12, _wallClock, false));
+
+    // audio level is padded out as the receiver did not negotiate it
+    std::vector<uint8_t> extensionIds;
+    for (const auto& extension : rtpHeader->getExtensionHeader()->extensions())
+    {
+        if (extension.getId() != rtp::ExtHeaderIdentifiers::PADDING)
+        {
+            extensionIds.push_back(extension.getId());
+        }
+    }
+    EXPECT_EQ(std::vector<uint8_t>({5, 3}), extensionIds);
+    EXPECT_NE(0, packet.absSendTimeOffset);
+    EXPECT_NE(0, packet.transportSequenceNumberOffset);
+
+    rtp::setTransmissionTimestamp(packet, 5, utils::Time::sec * 3);
+    uint32_t sendTime = 0;
+    ASSERT_TRUE(rtp::getTransmissionTimestamp(packet, 5, sendTime));
+    EXPECT_EQ(3u << 18, sendTime);
+
+    ASSERT_TRUE(rtp::setTransportWideSequenceNumber(packet, 3, 4711));
+    uint16_t transportSequenceNumber = 0;
+    ASSERT_TRUE(rtp::getTransportWideSequenceNumber(packet, 3, transportSequenceNumber));
+    EXPECT_EQ(4711, transportSequenceNumber);
+
+    // a stale offset falls back to searching the extensions
+    packet.absSendTimeOffset = 17;
+    rtp::setTransmissionTimestamp(packet, 5, utils::Time::sec * 2);
+    ASSERT_TRUE(rtp::getTransmissionTimestamp(packet, 5, sendTime));
+    EXPECT_EQ(2u << 18, sendTime);
+}
+
 TEST_F(SsrcOutboundContextTest, videoRewriteH264)
 {
     auto ssrcOutboundContext = createDefaultOutboundContextForVideoH264();
@@ -1,6 +1,7 @@
 #include "bwe/RateController.h"
 #include "config/Config.h"
 #include "memory/PacketPoolAllocator.h"
+#include "rtp/RtcpTransportFeedback.h"
 #include "test/bwe/FakeVideoSource.h"
 #include "test/bwe/RcCall.h"
 #include "test/transport/NetworkLink.h"
@@ -113,3 +114,45 @@ TEST_P(RateControllerTestShortRtt, shortRtt)
 INSTANTIATE_TEST_SUITE_P(RateControllerShortRtt,
     RateControllerTestShortRtt,
     testing::Values(300, 500, 700, 1000, 1200, 3000, 4000, 5000));
+
+namespace
+{
+void sendAndReportTransportFeedback(bwe::RateController& rateControl,
+    uint16_t& sequenceNumber,
+    uint64_t& timestamp,
+    uint64_t sendInterval,
+    uint64_t receiveInterval)
+{
+    rtp::TransportFeedbackBuilder builder;
+    for (int i = 0; i < 50; ++i)
+    {
+        rateControl.onTransportWideSequenceNumberSent(timestamp + i * sendInterval, sequenceNumber, 1200);
+        builder.onPacketReceived(sequenceNumber++, timestamp + utils::Time::ms * 30 + i * receiveInterval);
+    }
+    timestamp += utils::Time::ms * 30 + 50 * receiveInterval;
+
+    std::array<uint8_t, rtp::TransportFeedbackBuilder::maxFeedbackSize> area;
+    ASSERT_GT(builder.build(area.data(), 1, 2), 0);
+    rateControl.onTransportFeedbackReceived(timestamp,
+        *reinterpret_cast<const rtp::RtcpTransportFeedback*>(area.data()));
+}
+} // namespace
+
+TEST(RateControllerTest, transportFeedback)
+{
+    bwe::RateControllerConfig rcConfig;
+    rcConfig.initialEstimateKbps = 1000;
+    bwe::RateController rateControl(1, rcConfig);
+
+    uint16_t sequenceNumber = 65500;
+    uint64_t timestamp = utils::Time::sec * 10;
+
+    // packets arrive as fast as they were sent
+    sendAndReportTransportFeedback(rateControl, sequenceNumber, timestamp, utils::Time::ms * 2, utils::Time::ms * 2);
+    EXPECT_EQ(2000.0, rateControl.getTargetRate());
+
+    // arrival spread grows, queue is building up at ~1.2Mbps
+    sendAndReportTransportFeedback(rateControl, sequenceNumber, timestamp, utils::Time::ms * 2, utils::Time::ms * 8);
+    EXPECT_LT(rateControl.getTargetRate(), 2000.0);
+    EXPECT_GT(rateControl.getTargetRate(), 1234.0);
+}
@@ -1,5 +1,7 @@
+#include "codec/AudioTools.h"
 #include <cmath>
 #include <gtest/gtest.h>
+#include <vector>
 
 namespace codec
 {
@@ -22,4 +24,54 @@ TEST(AudioProcess, audiolevel)
     auto dB = codec::computeAudioLevel(data, samples);
     double dBrms = 20 * std::log10(amplitude / (double(0x8000) * std::sqrt(2)));
     EXPECT_EQ(static_cast<int>(dBrms), -dB);
-}
\ No newline at end of file
+}
+TEST(AudioProcess, partialMixesSumToMix)
+{
+    const size_t samples = 960 * 2;
+    const size_t contributors = 40;
+    const size_t contributorsPerPartial = 16;
+    const double amplification = 0.5;
+    std::vector<int16_t> audio(contributors * samples);
+    for (size_t i = 0; i < audio.size(); ++i)
+    {
+        // odd samples in [-999, 999] so amplification leaves a half to truncate
+        audio[i] = static_cast<int16_t>(((i * 7919) % 1000) * 2) - 999;
+    }
+
+    std::vector<int16_t> mix(samples, 0);
+    for (size_t c = 0; c < contributors; ++c)
+    {
+        codec::addToMix(&audio[c * samples], mix.data(), samples, amplification);
+    }
+
+    std::vector<int16_t> partialMix(samples);
+    std::vector<int16_t> sumOfPartials(samples, 0);
+    for (size_t first = 0; first < contributors; first += contributorsPerPartial)
+    {
+        std::fill(partialMix.begin(), partialMix.end(), 0);
+        for (size_t c = first; c < std::min(contributors, first + contributorsPerPartial); ++c)
+        {
+            codec::addToMix(&audio[c * samples], partialMix.data(), samples, amplification);
+        }
+        codec::addToMix(partialMix.data(), sumOfPartials.data(), samples, 1.0);
+    }
+
+    // each contributor added at 0.5 truncates at most half a step, in the serial mix as well as in a partial mix
+    const double maxError = contributors * 0.5;
+    size_t differingSamples = 0;
+    for (size_t i = 0; i < samples; ++i)
+    {
+        double exactMix = 0;
+        for (size_t c = 0; c < contributors; ++c)
+        {
+            exactMix += amplification * audio[c * samples + i];
+        }
+        ASSERT_LE(std::abs(mix[i] - exactMix), maxError) << i;
+        ASSERT_LE(std::abs(sumOfPartials[i] - exactMix), maxError) << i;
+        if (mix[i] != sumOfPartials[i])
+        {
+            ++differingSamples;
+        }
+    }
+    EXPECT_GT(differingSamples, 0u);
+}
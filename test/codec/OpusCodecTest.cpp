@@ -144,3 +144,48 @@ TEST_F(OpusTest, seqSkip)
     auto dB = codec::computeAudioLevel(_pcmData, samples);
     EXPECT_EQ(static_cast<int>(-27), -dB);
 }
+
+TEST_F(OpusTest, levelDecoderMatchesFullDecode)
+{
+    codec::OpusEncoder encoder;
+    codec::OpusDecoder decoder;
+    codec::OpusDecoder levelDecoder(8000, 1);
+    int16_t pcmData[samples * 2];
+    int16_t decodeBuffer[samples * 2];
+    uint32_t sequenceNumber = 10;
+
+    for (const double volume : {0.1, 0.5, 2.0})
+    {
+        for (int i = 0; i < samples * 2; ++i)
+        {
+            pcmData[i] = _pcmData[i] * volume;
+        }
+
+        for (int packet = 0; packet < 20; ++packet, ++sequenceNumber)
+        {
+            const auto opusBytes = encoder.encode(pcmData, samples, _opusData, sizeof(_opusData));
+            ASSERT_GT(opusBytes, 2);
+            const auto samplesProduced = decoder.decode(sequenceNumber,
+                _opusData,
+                opusBytes,
+                reinterpret_cast<unsigned char*>(decodeBuffer),
+                samples);
+            ASSERT_EQ(samplesProduced, samples);
+
+            const auto fullLevel = codec::computeAudioLevel(decodeBuffer, samplesProduced * 2);
+            const auto level = codec::computeAudioLevel(levelDecoder, sequenceNumber, _opusData, opusBytes);
+            if (packet > 5)
+            {
+                EXPECT_NEAR(fullLevel, level, 2);
+            }
+        }
+    }
+}
+
+TEST_F(OpusTest, levelOfDtxWithoutDecode)
+{
+    codec::OpusDecoder levelDecoder(8000, 1);
+    _opusData[0] = 0x08;
+    EXPECT_EQ(127, codec::computeAudioLevel(levelDecoder, 10, _opusData, 1));
+    EXPECT_FALSE(levelDecoder.hasDecoded());
+}
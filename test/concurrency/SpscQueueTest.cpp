@@ -0,0 +1,104 @@
+#include "concurrency/SpscQueue.h"
+#include "TestValues.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+
+using namespace concurrency;
+
+TEST(SpscQueue, capacityRoundedUp)
+{
+    SpscQueue<Simple> queue(0);
+    EXPECT_EQ(8, queue.capacity());
+
+    SpscQueue<Simple> queue2(100);
+    EXPECT_EQ(128, queue2.capacity());
+}
+
+TEST(SpscQueue, pushPop)
+{
+    SpscQueue<Simple> queue(8);
+    Simple v;
+
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(nullptr, queue.front());
+    EXPECT_FALSE(queue.pop(v));
+
+    for (int i = 0; i < 8; ++i)
+    {
+        EXPECT_TRUE(queue.push(Simple(1, i)));
+    }
+    EXPECT_TRUE(queue.full());
+    EXPECT_FALSE(queue.push(Simple(1, 8)));
+    EXPECT_EQ(8, queue.size());
+
+    ASSERT_NE(nullptr, queue.front());
+    EXPECT_EQ(0, queue.front()->seqNo);
+    for (int i = 0; i < 8; ++i)
+    {
+        EXPECT_TRUE(queue.pop(v));
+        EXPECT_EQ(i, v.seqNo);
+    }
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.pop(v));
+}
+
+TEST(SpscQueue, failedPushKeepsValue)
+{
+    SpscQueue<std::unique_ptr<int>> queue(8);
+    for (int i = 0; i < 8; ++i)
+    {
+        EXPECT_TRUE(queue.push(std::make_unique<int>(i)));
+    }
+
+    auto value = std::make_unique<int>(8);
+    EXPECT_FALSE(queue.push(std::move(value)));
+    ASSERT_TRUE(value);
+    EXPECT_EQ(8, *value);
+
+    queue.clear();
+    EXPECT_TRUE(queue.empty());
+    EXPECT_TRUE(queue.push(std::move(value)));
+    EXPECT_EQ(1, queue.size());
+}
+
+TEST(SpscQueue, producerConsumer)
+{
+    SpscQueue<SimpleSmall> queue(64);
+    const int count = 100000;
+
+    std::thread producer([&queue]() {
+        for (int i = 0; i < count;)
+        {
+            if (queue.push(SimpleSmall(1, i)))
+            {
+                ++i;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    for (SimpleSmall v; expected < count;)
+    {
+        if (queue.pop(v))
+        {
+            EXPECT_EQ(expected, v.seqNo);
+            if (v.seqNo != expected)
+            {
+                break;
+            }
+            ++expected;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_EQ(count, expected);
+    EXPECT_TRUE(queue.empty());
+}
@@ -0,0 +1,26 @@
+#include "concurrency/ThreadUtils.h"
+#include <gtest/gtest.h>
+
+TEST(ThreadUtilsTest, parseCpuList)
+{
+    EXPECT_EQ(std::vector<int>({2}), concurrency::parseCpuList("2"));
+    EXPECT_EQ(std::vector<int>({2, 4, 5, 6, 9}), concurrency::parseCpuList("2,4-6,9"));
+    EXPECT_EQ(std::vector<int>({0, 1}), concurrency::parseCpuList("0-1,"));
+    EXPECT_TRUE(concurrency::parseCpuList("").empty());
+    EXPECT_TRUE(concurrency::parseCpuList("3-1").empty());
+    EXPECT_TRUE(concurrency::parseCpuList("a,2").empty());
+    EXPECT_TRUE(concurrency::parseCpuList("2;3").empty());
+}
+
+TEST(ThreadUtilsTest, setCpuAffinity)
+{
+    EXPECT_TRUE(concurrency::setCpuAffinity(-1));
+#ifndef __APPLE__
+    std::thread thread([] {
+        const int cpu = sched_getcpu();
+        EXPECT_TRUE(concurrency::setCpuAffinity(cpu));
+        EXPECT_EQ(cpu, sched_getcpu());
+    });
+    thread.join();
+#endif
+}
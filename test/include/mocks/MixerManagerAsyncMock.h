@@ -27,6 +27,8 @@ public:
         (bridge::EngineMixer & mixer, uint32_t ssrc, size_t endpointIdHash),
         (override));
 
+    MOCK_METHOD(void, allocateInboundPacketCache, (bridge::EngineMixer & mixer, uint32_t ssrc), (override));
+
     MOCK_METHOD(void,
         allocateRecordingRtpPacketCache,
         (bridge::EngineMixer & mixer, uint32_t ssrc, size_t endpointIdHash),
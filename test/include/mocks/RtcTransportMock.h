@@ -16,6 +16,7 @@ public:
     MOCK_METHOD(bool, isGatheringComplete, (), (const override));
     MOCK_METHOD(ice::IceCandidates, getLocalCandidates, (), (override));
     MOCK_METHOD((std::pair<std::string, std::string>), getLocalIceCredentials, (), (override));
+    MOCK_METHOD(bool, isIceLite, (), (const override));
 
     MOCK_METHOD(bool, setRemotePeer, (const transport::SocketAddress& target), (override));
     MOCK_METHOD(transport::SocketAddress&, getRemotePeer, (), (const override));
@@ -45,6 +46,7 @@ public:
         (uint8_t payloadType, utils::Optional<uint8_t> telephoneEventPayloadType, uint32_t rtpFrequency),
         (override));
     MOCK_METHOD(void, setAbsSendTimeExtensionId, (uint8_t extensionId), (override));
+    MOCK_METHOD(void, setTransportCcExtensionId, (uint8_t extensionId), (override));
 
     MOCK_METHOD(bool, isIceEnabled, (), (const override));
     MOCK_METHOD(bool, isDtlsEnabled, (), (const override));
@@ -75,12 +77,14 @@ public:
         setRtxProbeSource,
         (const uint32_t ssrc, uint32_t* sequenceCounter, const uint16_t payloadType),
         (override));
+    MOCK_METHOD(void, setPacingPriority, (uint32_t ssrc, transport::PacingPriority priority), (override));
 
     MOCK_METHOD(void, runTick, (uint64_t timestamp), (override));
     MOCK_METHOD(ice::IceSession::State, getIceState, (), (const override));
     MOCK_METHOD(transport::SrtpClient::State, getDtlsState, (), (const override));
 
     MOCK_METHOD(utils::Optional<ice::TransportType>, getSelectedTransportType, (), (const override));
+    MOCK_METHOD(uint64_t, getIceFastPathResponseCount, (), (const override));
 
     MOCK_METHOD(void, setTag, (const char* tag), (override));
     MOCK_METHOD(const char*, getTag, (), (const override));
@@ -96,6 +100,7 @@ public:
 
     MOCK_METHOD(void, getSdesKeys, (std::vector<srtp::AesKey> & sdesKeys), (const override));
     MOCK_METHOD(void, asyncSetRemoteSdesKey, (const srtp::AesKey& key), (override));
+    MOCK_METHOD(void, asyncSetPacketCapture, (std::shared_ptr<logger::PacketCapture> packetCapture), (override));
 };
 
 } // namespace test
@@ -69,6 +69,10 @@ public:
         (override));
 
     MOCK_METHOD(EndpointMetrics, getSharedUdpEndpointsMetrics, (), (const override));
+    MOCK_METHOD(void,
+        getSharedUdpEndpointsFlows,
+        (std::vector<transport::FlowStats> & flows, size_t maxCount),
+        (const override));
     MOCK_METHOD(bool, isGood, (), (const override));
 
     MOCK_METHOD(std::shared_ptr<transport::RtcTransport>,
@@ -20,6 +20,18 @@ public:
     CFG_PROP(uint16_t, rampup, 0);
     CFG_PROP(uint16_t, max_rampup, 0);
     CFG_PROP(uint16_t, duration, 60);
+
+    // comma separated endpoint captures from "start-capture" to replay through an in-process bridge
+    CFG_PROP(std::string, replayCaptures, "");
+    CFG_PROP(bool, replayRealTime, false);
+
+    // in-process scaling sweep over comma separated conference sizes and conference counts. Every point is run with
+    // mixed and forwarded audio, with and without simulcast
+    CFG_PROP(std::string, sweepEndpoints, "2,10,50,200");
+    CFG_PROP(std::string, sweepConferences, "1");
+    CFG_PROP(uint16_t, sweepVideoSenders, 9);
+    CFG_PROP(uint16_t, sweepDuration, 10);
+    CFG_PROP(std::string, sweepCsv, "./smb_scaling_sweep.csv");
 };
 
 } // namespace config
@@ -0,0 +1,144 @@
+#include "test/integration/LoadTestStats.h"
+#include "utils/Time.h"
+#include <chrono>
+#include <cstdio>
+#include <dirent.h>
+#include <sstream>
+#include <sys/resource.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <malloc.h>
+#endif
+
+namespace loadtest
+{
+
+HistogramSample::HistogramSample(const utils::Histogram& histogram)
+    : _name(histogram.getName()),
+      _sumNs(histogram.getSumNs())
+{
+    for (uint32_t i = 0; i < _buckets.size(); ++i)
+    {
+        _buckets[i] = histogram.getBucketCount(i);
+    }
+}
+
+HistogramSample HistogramSample::operator-(const HistogramSample& before) const
+{
+    HistogramSample result(*this);
+    for (uint32_t i = 0; i < _buckets.size(); ++i)
+    {
+        result._buckets[i] -= before._buckets[i];
+    }
+    result._sumNs -= before._sumNs;
+    return result;
+}
+
+uint64_t HistogramSample::getCount() const
+{
+    uint64_t count = 0;
+    for (auto bucket : _buckets)
+    {
+        count += bucket;
+    }
+    return count;
+}
+
+uint64_t HistogramSample::getPercentileNs(const double percentile) const
+{
+    const uint64_t count = getCount();
+    uint64_t accumulated = 0;
+    for (uint32_t i = 0; i < _buckets.size(); ++i)
+    {
+        accumulated += _buckets[i];
+        if (accumulated > 0 && accumulated >= percentile * count)
+        {
+            return utils::Histogram::getBucketBound(i);
+        }
+    }
+    return 0;
+}
+
+uint64_t getProcessCpuTime()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * utils::Time::sec +
+        (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * utils::Time::us;
+}
+
+uint64_t getThreadCpuTime(const std::vector<std::string>& threadNames)
+{
+    auto* taskDir = opendir("/proc/self/task");
+    if (!taskDir)
+    {
+        return 0;
+    }
+
+    const uint64_t ticksPerSecond = sysconf(_SC_CLK_TCK);
+    uint64_t cpuTime = 0;
+    while (auto* entry = readdir(taskDir))
+    {
+        if (entry->d_name[0] == '.')
+        {
+            continue;
+        }
+
+        char fileName[64];
+        snprintf(fileName, sizeof(fileName), "/proc/self/task/%s/stat", entry->d_name);
+        auto* file = fopen(fileName, "r");
+        if (!file)
+        {
+            continue;
+        }
+
+        char name[32];
+        unsigned long utime = 0;
+        unsigned long stime = 0;
+        const bool isRead = 3 ==
+            fscanf(file, "%*d (%31[^)]) %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", name, &utime, &stime);
+        fclose(file);
+
+        if (isRead && std::find(threadNames.begin(), threadNames.end(), name) != threadNames.end())
+        {
+            cpuTime += (utime + stime) * utils::Time::sec / ticksPerSecond;
+        }
+    }
+    closedir(taskDir);
+    return cpuTime;
+}
+
+size_t getHeapInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    const auto info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+uint64_t getWallClock()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+std::vector<std::string> splitList(const std::string& list)
+{
+    std::vector<std::string> result;
+    std::istringstream stream(list);
+    for (std::string item; std::getline(stream, item, ',');)
+    {
+        if (!item.empty())
+        {
+            result.push_back(item);
+        }
+    }
+    return result;
+}
+
+} // namespace loadtest
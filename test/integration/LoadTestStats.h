@@ -0,0 +1,45 @@
+#pragma once
+#include "utils/Metrics.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace loadtest
+{
+
+// Snapshot of a metrics histogram. Histograms are process global so load tests report the difference of two samples.
+class HistogramSample
+{
+public:
+    explicit HistogramSample(const utils::Histogram& histogram);
+
+    HistogramSample operator-(const HistogramSample& before) const;
+
+    const char* getName() const { return _name; }
+    uint64_t getCount() const;
+    uint64_t getSumNs() const { return _sumNs; }
+    uint64_t getMeanNs() const { return _sumNs / std::max(uint64_t(1), getCount()); }
+    // upper bound of the bucket that holds the percentile
+    uint64_t getPercentileNs(double percentile) const;
+
+private:
+    const char* _name;
+    std::array<uint64_t, utils::Histogram::bucketCount + 1> _buckets;
+    uint64_t _sumNs;
+};
+
+uint64_t getProcessCpuTime();
+
+// Cpu time of all threads with any of the names. Only available on Linux
+uint64_t getThreadCpuTime(const std::vector<std::string>& threadNames);
+
+// Bytes allocated from the heap and not yet freed. Unlike resident memory it shrinks when memory is released.
+size_t getHeapInUse();
+
+uint64_t getWallClock();
+
+std::vector<std::string> splitList(const std::string& list);
+
+} // namespace loadtest
@@ -0,0 +1,191 @@
+#include "test/integration/IntegrationTest.h"
+#include "test/integration/LoadTestConfig.h"
+#include "test/integration/LoadTestStats.h"
+#include "test/integration/emulator/CaptureReplay.h"
+#include "test/integration/emulator/HttpRequests.h"
+#include "utils/Metrics.h"
+#include <cinttypes>
+
+using namespace emulator;
+
+namespace
+{
+std::vector<loadtest::HistogramSample> sampleStages()
+{
+    std::vector<loadtest::HistogramSample> samples;
+    for (const auto* histogram : {&utils::metrics::engineTickDuration,
+             &utils::metrics::jobQueueWait,
+             &utils::metrics::receiveToSendLatency,
+             &utils::metrics::pacingQueueDelay,
+             &utils::metrics::pacingQueueDelayRtx})
+    {
+        samples.emplace_back(*histogram);
+    }
+    return samples;
+}
+} // namespace
+
+/**
+ * Replays endpoint captures of a conference through an in-process bridge on the fake network, one emulated client
+ * per capture. Configured with replayCaptures in the --load_test_config file. Runs on the TimeTurner as fast as
+ * possible, or in real time if replayRealTime is set. Reports time spent per stage, process cpu, packets forwarded and
+ * the receive bitrates of the clients.
+ */
+class ReplayTest : public IntegrationTest
+{
+public:
+    ReplayTest()
+    {
+        if (config::g_LoadTestConfigFile != nullptr && !_loadTestConfig.readFromFile(config::g_LoadTestConfigFile))
+        {
+            logger::error("Failed to read load test configuration from %s",
+                "ReplayTest",
+                config::g_LoadTestConfigFile);
+        }
+    }
+
+protected:
+    config::LoadTestConfig _loadTestConfig;
+};
+
+TEST_F(ReplayTest, captures)
+{
+    std::vector<std::unique_ptr<CaptureReplay>> captures;
+    uint64_t originUs = ~0ull;
+    uint64_t endUs = 0;
+    for (const auto& fileName : loadtest::splitList(_loadTestConfig.replayCaptures))
+    {
+        auto capture = std::make_unique<CaptureReplay>(fileName);
+        if (capture->isGood())
+        {
+            originUs = std::min(originUs, capture->getFirstTimestampUs());
+            endUs = std::max(endUs, capture->getLastTimestampUs());
+            captures.push_back(std::move(capture));
+        }
+    }
+
+    if (captures.empty())
+    {
+        enterRealTime(2 + _numWorkerThreads);
+        GTEST_SKIP() << "no captures configured in replayCaptures";
+    }
+
+    const uint64_t duration = (endUs - originUs) * utils::Time::us;
+    const bool realTime = _loadTestConfig.replayRealTime;
+
+    auto testBody = [&]() {
+        _config.readFromString(_defaultSmbConfig);
+
+        initBridge(_config);
+        const auto baseUrl = "http://127.0.0.1:8080";
+
+        GroupCall<SfuClient<Channel>> group(_httpd,
+            _instanceCounter,
+            *_mainPoolAllocator,
+            _audioAllocator,
+            *_clientTransportFactory,
+            *_publicTransportFactory,
+            *_sslDtls,
+            captures.size());
+
+        Conference conf(_httpd);
+
+        ScopedFinalize finalize(std::bind(&IntegrationTest::finalizeSimulation, this));
+        startSimulation();
+
+        group.startConference(conf, baseUrl);
+
+        CallConfigBuilder cfg(conf.getId());
+        cfg.url(baseUrl).av();
+
+        group.clients[0]->initiateCall(cfg.build());
+        for (size_t i = 1; i < group.clients.size(); ++i)
+        {
+            group.clients[i]->joinCall(cfg.build());
+        }
+
+        ASSERT_TRUE(group.connectAll(utils::Time::sec * _clientsConnectionTimeout));
+
+        const auto stagesBefore = sampleStages();
+        const auto cpuBefore = loadtest::getProcessCpuTime();
+        const auto wallClockBefore = loadtest::getWallClock();
+
+        const auto start = utils::Time::getAbsoluteTime();
+        for (size_t i = 0; i < captures.size(); ++i)
+        {
+            group.clients[i]->setReplay(std::move(captures[i]), start, originUs);
+        }
+        group.run(duration + utils::Time::ms * 200);
+
+        const auto cpuTime = loadtest::getProcessCpuTime() - cpuBefore;
+        const auto wallClockTime = loadtest::getWallClock() - wallClockBefore;
+        const auto stagesAfter = sampleStages();
+
+        uint64_t packetsReplayed = 0;
+        transport::PacketCounters audioReceived;
+        transport::PacketCounters videoReceived;
+        for (auto& client : group.clients)
+        {
+            packetsReplayed += client->getReplay()->getReplayedCount();
+            audioReceived += client->getCumulativeAudioReceiveCounters();
+            videoReceived += client->getCumulativeVideoReceiveCounters();
+        }
+
+        group.stopTransports();
+        group.awaitPendingJobs(utils::Time::sec * 4);
+        finalizeSimulation();
+
+        const double durationSeconds = static_cast<double>(duration) / utils::Time::sec;
+        logger::info("replayed %zu captures, %.1fs of media, %" PRIu64 " packets, %s",
+            "ReplayTest",
+            group.clients.size(),
+            durationSeconds,
+            packetsReplayed,
+            realTime ? "real time" : "time turner");
+        logger::info("cpu %.2fs, wall clock %.2fs, %.1f%% cpu per media second",
+            "ReplayTest",
+            static_cast<double>(cpuTime) / utils::Time::sec,
+            static_cast<double>(wallClockTime) / utils::Time::sec,
+            100.0 * cpuTime / std::max(uint64_t(1), duration));
+        for (size_t i = 0; i < stagesAfter.size(); ++i)
+        {
+            const auto stage = stagesAfter[i] - stagesBefore[i];
+            logger::info("%s count %" PRIu64 ", total %.3fs, avg %" PRIu64 "us",
+                "ReplayTest",
+                stage.getName(),
+                stage.getCount(),
+                static_cast<double>(stage.getSumNs()) / utils::Time::sec,
+                stage.getMeanNs() / utils::Time::us);
+        }
+        logger::info("forwarded audio %" PRIu64 " packets %.0f kbps, video %" PRIu64 " packets %.0f kbps",
+            "ReplayTest",
+            audioReceived.packets,
+            audioReceived.octets * 8 / (1000.0 * durationSeconds),
+            videoReceived.packets,
+            videoReceived.octets * 8 / (1000.0 * durationSeconds));
+
+        for (size_t i = 0; i < group.clients.size(); ++i)
+        {
+            std::unordered_map<uint32_t, transport::ReportSummary> transportSummary;
+            std::string clientName = "client_" + std::to_string(i);
+            group.clients[i]->getReportSummary(transportSummary);
+            logTransportSummary(clientName.c_str(), transportSummary);
+        }
+
+        EXPECT_GT(packetsReplayed, 0u);
+        if (group.clients.size() > 1)
+        {
+            EXPECT_GT(audioReceived.packets + videoReceived.packets, 0u);
+        }
+    };
+
+    if (realTime)
+    {
+        enterRealTime(2 + _numWorkerThreads);
+        testBody();
+    }
+    else
+    {
+        runTestInThread(expectedTestThreadCount(1), testBody, 60 + duration / utils::Time::sec);
+    }
+}
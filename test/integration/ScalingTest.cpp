@@ -0,0 +1,322 @@
+#include "bridge/engine/EngineMixer.h"
+#include "test/CsvWriter.h"
+#include "test/integration/IntegrationTest.h"
+#include "test/integration/LoadTestConfig.h"
+#include "test/integration/LoadTestStats.h"
+#include "test/integration/emulator/HttpRequests.h"
+#include "test/integration/emulator/Httpd.h"
+#include "utils/Format.h"
+#include "utils/Metrics.h"
+#include <algorithm>
+#include <cinttypes>
+
+using namespace emulator;
+
+namespace
+{
+struct SweepPoint
+{
+    uint32_t conferences;
+    uint32_t endpoints; // per conference
+    bool mixed;
+    bool simulcast;
+};
+
+std::vector<uint32_t> parseCounts(const std::string& list)
+{
+    std::vector<uint32_t> counts;
+    for (const auto& item : loadtest::splitList(list))
+    {
+        counts.push_back(std::stoul(item));
+    }
+    return counts;
+}
+
+// threads of the bridge under test as opposed to the emulated clients and fake network
+const std::vector<std::string> bridgeThreadNames = {"Engine", "RTWorker", "MMWorker"};
+} // namespace
+
+/**
+ * Capacity sweep of an in-process bridge with emulated clients on the fake network, run in real time. Conference size,
+ * conference count, mixed or forwarded audio and simulcast are varied as configured in the --load_test_config file.
+ * All endpoints send opus and the first sweepVideoSenders in each conference also send video. Every point is written as
+ * a CSV row with cpu per inbound stream, heap in use per endpoint and engine tick headroom. Process cpu and heap
+ * include the emulated clients. Bridge cpu is the engine and bridge worker threads only. The conferences of a point
+ * are removed by the bridge before the next point starts, so each point starts from the same heap.
+ */
+class ScalingTest : public IntegrationTest
+{
+public:
+    ScalingTest()
+    {
+        _mainPoolAllocator = std::make_unique<memory::PacketPoolAllocator>(memory::packetPoolSize * 32, "testMain");
+        if (config::g_LoadTestConfigFile != nullptr && !_loadTestConfig.readFromFile(config::g_LoadTestConfigFile))
+        {
+            logger::error("Failed to read load test configuration from %s",
+                "ScalingTest",
+                config::g_LoadTestConfigFile);
+        }
+    }
+
+protected:
+    bool runPoint(CsvWriter& csv, const SweepPoint& point);
+    void runClients(std::vector<std::unique_ptr<GroupCall<SfuClient<Channel>>>>& groups, uint64_t duration);
+    bool awaitConferencesRemoved(const std::vector<std::unique_ptr<Conference>>& conferences, uint64_t timeout);
+
+    static const uint32_t mixerInactivityTimeoutMs = 3000;
+
+    config::LoadTestConfig _loadTestConfig;
+};
+
+void ScalingTest::runClients(std::vector<std::unique_ptr<GroupCall<SfuClient<Channel>>>>& groups,
+    const uint64_t duration)
+{
+    utils::Pacer pacer(10 * utils::Time::ms);
+    const auto start = utils::Time::getAbsoluteTime();
+    for (auto timestamp = start; utils::Time::diffLT(start, timestamp, duration);
+         timestamp = utils::Time::getAbsoluteTime())
+    {
+        for (auto& group : groups)
+        {
+            for (auto& client : group->clients)
+            {
+                client->process(timestamp);
+            }
+        }
+        pacer.tick(utils::Time::getAbsoluteTime());
+        utils::Time::nanoSleep(pacer.timeToNextTick(utils::Time::getAbsoluteTime()));
+    }
+}
+
+// Conferences are removed by the bridge once idle for mixerInactivityTimeoutMs, as there is no conference delete request
+bool ScalingTest::awaitConferencesRemoved(const std::vector<std::unique_ptr<Conference>>& conferences,
+    const uint64_t timeout)
+{
+    const auto start = utils::Time::getAbsoluteTime();
+    while (utils::Time::diffLT(start, utils::Time::getAbsoluteTime(), timeout))
+    {
+        nlohmann::json responseBody;
+        if (!awaitResponse<HttpGetRequest>(_httpd,
+                "http://127.0.0.1:8080/conferences",
+                1500 * utils::Time::ms,
+                responseBody))
+        {
+            return false;
+        }
+
+        const bool isRemoved = std::none_of(conferences.begin(), conferences.end(), [&](const auto& conference) {
+            return std::find(responseBody.begin(), responseBody.end(), conference->getId()) != responseBody.end();
+        });
+        if (isRemoved)
+        {
+            return true;
+        }
+        utils::Time::nanoSleep(250 * utils::Time::ms);
+    }
+
+    logger::warn("conferences not removed after %" PRIu64 "ms", "ScalingTest", timeout / utils::Time::ms);
+    return false;
+}
+
+bool ScalingTest::runPoint(CsvWriter& csv, const SweepPoint& point)
+{
+    const auto baseUrl = "http://127.0.0.1:8080";
+    const uint32_t videoSenders = std::min(point.endpoints, static_cast<uint32_t>(_loadTestConfig.sweepVideoSenders));
+    const uint32_t totalEndpoints = point.conferences * point.endpoints;
+    const uint32_t streams = point.conferences * (point.endpoints + videoSenders * (point.simulcast ? 3 : 1));
+
+    logger::info("conferences %u, endpoints %u, %s audio, simulcast %c",
+        "ScalingTest",
+        point.conferences,
+        point.endpoints,
+        point.mixed ? "mixed" : "forwarded",
+        point.simulcast ? 't' : 'f');
+
+    const auto heapBefore = loadtest::getHeapInUse();
+
+    std::vector<std::unique_ptr<Conference>> conferences;
+    std::vector<std::unique_ptr<GroupCall<SfuClient<Channel>>>> groups;
+    bool isRemoved = false;
+    bool isCleanedUp = false;
+    auto removeConferences = [&]() {
+        if (isCleanedUp)
+        {
+            return;
+        }
+        isCleanedUp = true;
+        for (auto& group : groups)
+        {
+            group->disconnectClients();
+            group->stopTransports();
+            group->awaitPendingJobs(utils::Time::sec * 4);
+        }
+        groups.clear();
+        isRemoved = awaitConferencesRemoved(conferences, (mixerInactivityTimeoutMs + 10000) * utils::Time::ms);
+    };
+    // also on early return, so the next point does not run next to this one's conferences
+    ScopedFinalize finalize(removeConferences);
+    for (uint32_t c = 0; c < point.conferences; ++c)
+    {
+        conferences.push_back(std::make_unique<Conference>(_httpd));
+        groups.push_back(std::make_unique<GroupCall<SfuClient<Channel>>>(_httpd,
+            _instanceCounter,
+            *_mainPoolAllocator,
+            _audioAllocator,
+            *_clientTransportFactory,
+            *_publicTransportFactory,
+            *_sslDtls,
+            point.endpoints));
+        auto& group = *groups.back();
+        if (!group.startConference(*conferences.back(), baseUrl))
+        {
+            return false;
+        }
+
+        CallConfigBuilder cfg(conferences.back()->getId());
+        cfg.url(baseUrl).withOpus();
+        if (point.mixed)
+        {
+            cfg.mixed();
+        }
+        if (!point.simulcast)
+        {
+            cfg.noSimulcast();
+        }
+
+        for (uint32_t i = 0; i < point.endpoints; ++i)
+        {
+            auto callConfig = cfg;
+            if (i < videoSenders)
+            {
+                callConfig.withVideo();
+            }
+
+            if (i == 0)
+            {
+                group.clients[i]->initiateCall(callConfig.build());
+            }
+            else
+            {
+                group.clients[i]->joinCall(callConfig.build());
+            }
+        }
+    }
+
+    const uint64_t connectTimeout = utils::Time::sec * std::max(_clientsConnectionTimeout, totalEndpoints / 20);
+    for (auto& group : groups)
+    {
+        if (!group->connectAll(connectTimeout))
+        {
+            return false;
+        }
+    }
+
+    // let bandwidth estimates and mixers settle before measuring
+    runClients(groups, 2 * utils::Time::sec);
+
+    const auto heapAfter = loadtest::getHeapInUse();
+    const loadtest::HistogramSample ticksBefore(utils::metrics::engineTickDuration);
+    const auto processCpuBefore = loadtest::getProcessCpuTime();
+    const auto bridgeCpuBefore = loadtest::getThreadCpuTime(bridgeThreadNames);
+    const auto wallClockBefore = loadtest::getWallClock();
+    transport::PacketCounters receivedBefore;
+    for (auto& group : groups)
+    {
+        for (auto& client : group->clients)
+        {
+            receivedBefore += client->getCumulativeAudioReceiveCounters();
+            receivedBefore += client->getCumulativeVideoReceiveCounters();
+        }
+    }
+
+    runClients(groups, _loadTestConfig.sweepDuration * utils::Time::sec);
+
+    const auto wallClockTime = loadtest::getWallClock() - wallClockBefore;
+    const auto processCpuTime = loadtest::getProcessCpuTime() - processCpuBefore;
+    const auto bridgeCpuTime = loadtest::getThreadCpuTime(bridgeThreadNames) - bridgeCpuBefore;
+    const auto ticks = loadtest::HistogramSample(utils::metrics::engineTickDuration) - ticksBefore;
+    transport::PacketCounters received;
+    for (auto& group : groups)
+    {
+        for (auto& client : group->clients)
+        {
+            received += client->getCumulativeAudioReceiveCounters();
+            received += client->getCumulativeVideoReceiveCounters();
+        }
+    }
+
+    const double seconds = static_cast<double>(wallClockTime) / utils::Time::sec;
+    const double processCpuPerStream = processCpuTime / (utils::Time::us * seconds * streams);
+    const double bridgeCpuPerStream = bridgeCpuTime / (utils::Time::us * seconds * streams);
+    const double memoryPerEndpoint =
+        (heapAfter > heapBefore ? heapAfter - heapBefore : 0) / (1024.0 * totalEndpoints);
+    const uint64_t tickInterval = bridge::EngineMixer::iterationDurationMs * utils::Time::ms;
+    const uint64_t tickP99 = ticks.getPercentileNs(0.99);
+    const double headroom = 100.0 * (1.0 - std::min(1.0, static_cast<double>(tickP99) / tickInterval));
+    const double forwardedKbps = (received.octets - receivedBefore.octets) * 8 / (1000.0 * seconds);
+
+    csv.writeLine("%u,%u,%u,%s,%s,%u,%u,%.1f,%.1f,%.1f,%" PRIu64 ",%" PRIu64 ",%.1f,%.0f",
+        point.conferences,
+        point.endpoints,
+        totalEndpoints,
+        point.mixed ? "mixed" : "forwarded",
+        point.simulcast ? "simulcast" : "single",
+        videoSenders,
+        streams,
+        processCpuPerStream,
+        bridgeCpuPerStream,
+        memoryPerEndpoint,
+        ticks.getMeanNs() / utils::Time::us,
+        tickP99 / utils::Time::us,
+        headroom,
+        forwardedKbps);
+
+    removeConferences();
+    return isRemoved;
+}
+
+TEST_F(ScalingTest, sweep)
+{
+    const auto endpointCounts = parseCounts(_loadTestConfig.sweepEndpoints);
+    const auto conferenceCounts = parseCounts(_loadTestConfig.sweepConferences);
+
+    // tick durations are only meaningful in real time
+    enterRealTime(2 + _numWorkerThreads);
+    if (endpointCounts.empty() || conferenceCounts.empty())
+    {
+        GTEST_SKIP() << "no sweep configured";
+    }
+
+    _config.readFromString(utils::format(R"({
+        "ip":"127.0.0.1",
+        "ice.publicIpv4":"%s",
+        "ice.tcp.enable":false,
+        "ice.enableIpv6":true,
+        "mixerInactivityTimeoutMs":%u
+        })",
+        _ipv4.smb.c_str(),
+        mixerInactivityTimeoutMs));
+    initBridge(_config);
+
+    ScopedFinalize finalize(std::bind(&IntegrationTest::finalizeSimulation, this));
+    startSimulation();
+
+    CsvWriter csv(_loadTestConfig.sweepCsv.get().c_str());
+    csv.writeLine("conferences,endpointsPerConference,endpoints,audio,video,videoSenders,streams,"
+                  "processCpuUsPerStreamSecond,bridgeCpuUsPerStreamSecond,memoryKBPerEndpoint,tickMeanUs,tickP99Us,"
+                  "tickHeadroomPercent,forwardedKbps");
+
+    for (auto conferenceCount : conferenceCounts)
+    {
+        for (auto endpointCount : endpointCounts)
+        {
+            for (bool mixed : {false, true})
+            {
+                for (bool simulcast : {true, false})
+                {
+                    EXPECT_TRUE(runPoint(csv, SweepPoint{conferenceCount, endpointCount, mixed, simulcast}));
+                }
+            }
+        }
+    }
+}
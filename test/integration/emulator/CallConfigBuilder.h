@@ -23,6 +23,7 @@ struct CallConfig
     std::vector<std::string> neighbours;
     Audio audio = Audio::None;
     bool video = false;
+    bool simulcast = true;
     std::string relayType = "ssrc-rewrite";
     bool rtx = true;
     uint32_t idleTimeout = 0;
@@ -128,6 +129,12 @@ public:
         return *this;
     }
 
+    CallConfigBuilder& noSimulcast()
+    {
+        _config.simulcast = false;
+        return *this;
+    }
+
     CallConfigBuilder& disableRtx()
     {
         _config.rtx = false;
@@ -0,0 +1,279 @@
+#include "test/integration/emulator/CaptureReplay.h"
+#include "bridge/RtpMap.h"
+#include "logger/Logger.h"
+#include "logger/PacketCapture.h"
+#include "rtp/RtcpHeader.h"
+#include "rtp/RtpHeader.h"
+#include "utils/Time.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+namespace emulator
+{
+
+namespace
+{
+const uint32_t blockTypeEnhancedPacket = 0x00000006;
+const size_t blockHeaderSize = 8;
+const size_t enhancedPacketHeaderSize = 28;
+const size_t udpHeaderSize = 8;
+
+uint32_t readU32(const uint8_t* data)
+{
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+} // namespace
+
+CaptureReplay::CaptureReplay(const std::string& fileName)
+    : _paddedCount(0),
+      _startTimestamp(0),
+      _originUs(0),
+      _nextPacket(0),
+      _replayedCount(0)
+{
+    if (!load(fileName))
+    {
+        _packets.clear();
+        return;
+    }
+
+    // the capture file is a ring so the oldest packet may be anywhere
+    std::stable_sort(_packets.begin(), _packets.end(), [](const Packet& a, const Packet& b) {
+        return a.timestampUs < b.timestampUs;
+    });
+
+    logger::info("loaded %s, %zu packets in %zu streams, %u zero padded",
+        "CaptureReplay",
+        fileName.c_str(),
+        _packets.size(),
+        _streams.size(),
+        _paddedCount);
+}
+
+bool CaptureReplay::load(const std::string& fileName)
+{
+    auto* file = ::fopen(fileName.c_str(), "r");
+    if (!file)
+    {
+        logger::error("failed to open %s", "CaptureReplay", fileName.c_str());
+        return false;
+    }
+
+    ::fseek(file, 0, SEEK_END);
+    const auto fileSize = ::ftell(file);
+    ::fseek(file, 0, SEEK_SET);
+    _data.resize(fileSize > 0 ? fileSize : 0);
+    const bool readAll = ::fread(_data.data(), 1, _data.size(), file) == _data.size();
+    ::fclose(file);
+    if (!readAll)
+    {
+        logger::error("failed to read %s", "CaptureReplay", fileName.c_str());
+        return false;
+    }
+
+    const auto inboundInterface = static_cast<uint32_t>(logger::PacketCapture::Direction::Inbound);
+    const uint8_t rtxPayloadType = bridge::RtpMap(bridge::RtpMap::Format::RTX).payloadType;
+
+    for (size_t offset = 0; offset + blockHeaderSize <= _data.size();)
+    {
+        const uint8_t* block = _data.data() + offset;
+        const uint32_t blockType = readU32(block);
+        const uint32_t blockLength = readU32(block + 4);
+        if (blockLength < blockHeaderSize + 4 || offset + blockLength > _data.size())
+        {
+            // the capture was cut short by a crash or copied while running
+            logger::warn("truncated block at %zu in %s", "CaptureReplay", offset, fileName.c_str());
+            break;
+        }
+        offset += blockLength;
+
+        if (blockType != blockTypeEnhancedPacket || blockLength < enhancedPacketHeaderSize ||
+            readU32(block + 8) != inboundInterface)
+        {
+            continue;
+        }
+
+        const uint64_t timestampUs = (static_cast<uint64_t>(readU32(block + 12)) << 32) | readU32(block + 16);
+        const uint32_t capturedLength = readU32(block + 20);
+        const uint32_t originalLength = readU32(block + 24);
+        const uint8_t* ip = block + enhancedPacketHeaderSize;
+        if (enhancedPacketHeaderSize + capturedLength > blockLength || capturedLength < 20 || (ip[0] >> 4) != 4)
+        {
+            continue;
+        }
+
+        const size_t ipUdpHeaderSize = (ip[0] & 0xF) * 4 + udpHeaderSize;
+        if (capturedLength < ipUdpHeaderSize || originalLength < capturedLength)
+        {
+            continue;
+        }
+
+        const uint8_t* rtp = ip + ipUdpHeaderSize;
+        const uint32_t rtpCapturedLength = capturedLength - ipUdpHeaderSize;
+        const uint32_t rtpLength = originalLength - ipUdpHeaderSize;
+        if (rtpLength > memory::Packet::size || rtp::isRtcpPacket(rtp, rtpCapturedLength) ||
+            !rtp::isRtpPacket(rtp, rtpCapturedLength))
+        {
+            continue;
+        }
+
+        const auto* rtpHeader = reinterpret_cast<const rtp::RtpHeader*>(rtp);
+        if (rtpHeader->headerLength() > rtpCapturedLength || rtpHeader->payloadType == rtxPayloadType)
+        {
+            continue;
+        }
+
+        const auto streamIndex = findStream(rtpHeader->ssrc.get(), rtpHeader->payloadType);
+        auto& stream = _streams[streamIndex];
+        ++stream.packets;
+        stream.octets += rtpLength;
+        if (rtpCapturedLength < rtpLength)
+        {
+            ++stream.paddedPackets;
+            ++_paddedCount;
+        }
+
+        _packets.push_back(Packet{timestampUs,
+            static_cast<size_t>(rtp - _data.data()),
+            rtpCapturedLength,
+            rtpLength,
+            streamIndex});
+    }
+
+    return !_packets.empty();
+}
+
+uint32_t CaptureReplay::findStream(const uint32_t ssrc, const uint8_t payloadType)
+{
+    for (uint32_t i = 0; i < _streams.size(); ++i)
+    {
+        if (_streams[i].ssrc == ssrc && _streams[i].payloadType == payloadType)
+        {
+            return i;
+        }
+    }
+
+    Stream stream;
+    stream.ssrc = ssrc;
+    stream.payloadType = payloadType;
+    _streams.push_back(stream);
+    return _streams.size() - 1;
+}
+
+uint64_t CaptureReplay::getFirstTimestampUs() const
+{
+    return _packets.empty() ? 0 : _packets.front().timestampUs;
+}
+
+uint64_t CaptureReplay::getLastTimestampUs() const
+{
+    return _packets.empty() ? 0 : _packets.back().timestampUs;
+}
+
+void CaptureReplay::mapSsrcs(const uint32_t audioSsrc, const uint32_t* videoSsrcs, const size_t videoSsrcCount)
+{
+    const uint8_t audioPayloadType = bridge::RtpMap(bridge::RtpMap::Format::OPUS).payloadType;
+    const uint8_t videoPayloadType = bridge::RtpMap(bridge::RtpMap::Format::VP8).payloadType;
+
+    Stream* audioStream = nullptr;
+    std::vector<Stream*> videoStreams;
+    for (auto& stream : _streams)
+    {
+        stream.mappedSsrc = 0;
+        if (stream.payloadType == audioPayloadType && (!audioStream || stream.packets > audioStream->packets))
+        {
+            audioStream = &stream;
+        }
+        else if (stream.payloadType == videoPayloadType)
+        {
+            if (stream.paddedPackets > 0)
+            {
+                logger::info("skipping video ssrc %u, %u of %u packets captured without payload",
+                    "CaptureReplay",
+                    stream.ssrc,
+                    stream.paddedPackets,
+                    stream.packets);
+                continue;
+            }
+            videoStreams.push_back(&stream);
+        }
+    }
+
+    if (audioStream)
+    {
+        audioStream->mappedSsrc = audioSsrc;
+    }
+
+    // simulcast levels are offered lowest resolution first. Slides and extra streams are not replayed
+    std::sort(videoStreams.begin(), videoStreams.end(), [](const Stream* a, const Stream* b) {
+        return a->octets < b->octets;
+    });
+    for (size_t i = 0; i < videoStreams.size() && i < videoSsrcCount; ++i)
+    {
+        videoStreams[i]->mappedSsrc = videoSsrcs[i];
+    }
+
+    for (const auto& stream : _streams)
+    {
+        logger::info("ssrc %u pt %u, %u packets, %" PRIu64 " bytes replayed as %u",
+            "CaptureReplay",
+            stream.ssrc,
+            stream.payloadType,
+            stream.packets,
+            stream.octets,
+            stream.mappedSsrc);
+    }
+}
+
+void CaptureReplay::start(const uint64_t timestamp, const uint64_t originUs)
+{
+    _startTimestamp = timestamp;
+    _originUs = originUs;
+    _nextPacket = 0;
+    _replayedCount = 0;
+}
+
+memory::UniquePacket CaptureReplay::getNext(memory::PacketPoolAllocator& allocator, const uint64_t timestamp)
+{
+    while (_nextPacket < _packets.size())
+    {
+        const auto& item = _packets[_nextPacket];
+        const auto& stream = _streams[item.streamIndex];
+        const uint64_t releaseTime =
+            _startTimestamp + (item.timestampUs > _originUs ? item.timestampUs - _originUs : 0) * utils::Time::us;
+        if (utils::Time::diffGT(timestamp, releaseTime, 0))
+        {
+            return nullptr;
+        }
+
+        ++_nextPacket;
+        if (stream.mappedSsrc == 0)
+        {
+            continue;
+        }
+
+        auto packet = memory::makeUniquePacket(allocator, _data.data() + item.offset, item.capturedLength);
+        if (!packet)
+        {
+            return nullptr;
+        }
+
+        if (item.length > item.capturedLength)
+        {
+            std::memset(packet->get() + item.capturedLength, 0, item.length - item.capturedLength);
+            packet->setLength(item.length);
+        }
+
+        rtp::RtpHeader::fromPacket(*packet)->ssrc = stream.mappedSsrc;
+        ++_replayedCount;
+        return packet;
+    }
+
+    return nullptr;
+}
+
+} // namespace emulator
@@ -0,0 +1,75 @@
+#pragma once
+#include "memory/PacketPoolAllocator.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace emulator
+{
+
+/**
+ * Replays the inbound RTP of an endpoint capture made with "start-capture" (see logger::PacketCapture) as if sent by
+ * an emulated client. The captured audio and video streams are mapped onto the ssrcs of the client and released at
+ * their capture time relative to a common origin, so captures of several endpoints of the same conference keep their
+ * timing. RTCP and retransmissions are not replayed since the bridge and the client generate their own. Audio that
+ * was captured headers only is zero padded to its original length. Video streams captured headers only are not
+ * replayed since zero padded frames cannot be parsed as VP8.
+ */
+class CaptureReplay
+{
+public:
+    struct Stream
+    {
+        uint32_t ssrc = 0;
+        uint8_t payloadType = 0;
+        uint32_t packets = 0;
+        uint64_t octets = 0;
+        uint32_t paddedPackets = 0;
+        uint32_t mappedSsrc = 0;
+    };
+
+    explicit CaptureReplay(const std::string& fileName);
+
+    bool isGood() const { return !_packets.empty(); }
+
+    uint64_t getFirstTimestampUs() const;
+    uint64_t getLastTimestampUs() const;
+    size_t getPacketCount() const { return _packets.size(); }
+    uint32_t getPaddedCount() const { return _paddedCount; }
+    const std::vector<Stream>& getStreams() const { return _streams; }
+
+    // Maps the busiest audio stream and up to videoSsrcCount complete video streams, lowest bitrate first
+    void mapSsrcs(uint32_t audioSsrc, const uint32_t* videoSsrcs, size_t videoSsrcCount);
+    void start(uint64_t timestamp, uint64_t originUs);
+
+    // next packet due at timestamp, or nullptr
+    memory::UniquePacket getNext(memory::PacketPoolAllocator& allocator, uint64_t timestamp);
+    bool isDone() const { return _nextPacket >= _packets.size(); }
+
+    uint32_t getReplayedCount() const { return _replayedCount; }
+
+private:
+    struct Packet
+    {
+        uint64_t timestampUs;
+        size_t offset;
+        uint32_t capturedLength;
+        uint32_t length;
+        uint32_t streamIndex;
+    };
+
+    bool load(const std::string& fileName);
+    uint32_t findStream(uint32_t ssrc, uint8_t payloadType);
+
+    std::vector<uint8_t> _data;
+    std::vector<Packet> _packets;
+    std::vector<Stream> _streams;
+    uint32_t _paddedCount;
+
+    uint64_t _startTimestamp;
+    uint64_t _originUs;
+    size_t _nextPacket;
+    uint32_t _replayedCount;
+};
+
+} // namespace emulator
@@ -23,6 +23,7 @@ public:
     {
         assert(false);
     };
+    void registerStunFastPath(const std::string& stunUserName, ice::StunFastPath* fastPath) override {}
 
     void unregisterListener(Endpoint::IEvents* listener) override { assert(false); };
     void unregisterListener(const transport::SocketAddress& remotePort, Endpoint::IEvents* listener) override
@@ -48,6 +48,7 @@ public:
         registerDefaultListener(listener);
     }
     void registerDefaultListener(IEvents* defaultListener) override;
+    void registerStunFastPath(const std::string& stunUserName, ice::StunFastPath* fastPath) override {}
     void unregisterListener(IEvents* listener) override;
     void unregisterListener(const transport::SocketAddress& remotePort, IEvents* listener) override
     {
@@ -35,6 +35,7 @@ public:
     void registerListener(const std::string& stunUserName, IEvents* listener) override;
     void registerListener(const transport::SocketAddress& remotePort, IEvents* listener) override;
     void registerDefaultListener(IEvents* defaultListener) override;
+    void registerStunFastPath(const std::string& stunUserName, ice::StunFastPath* fastPath) override {}
     void unregisterListener(IEvents* listener) override;
     void unregisterListener(const transport::SocketAddress& remotePort, IEvents* listener) override;
 
@@ -18,6 +18,7 @@
 #include "rtp/RtcpHeader.h"
 #include "test/integration/emulator/ApiChannel.h"
 #include "test/integration/emulator/CallConfigBuilder.h"
+#include "test/integration/emulator/CaptureReplay.h"
 #include "test/integration/emulator/SfuClientReceivers.h"
 #include "test/transport/FakeNetwork.h"
 #include "transport/DataReceiver.h"
@@ -58,6 +59,7 @@ public:
           _videoSsrcMap(128),
           _loggableId("client", id),
           _recordingActive(true),
+          _replayActive(false),
           _expectedReceiveAudioType(Audio::None),
           _startTime(0)
     {
@@ -277,16 +279,17 @@ public:
     {
         if (_callConfig.video)
         {
-            _videoSsrcs[6] = 0;
+            const int ssrcCount = _callConfig.simulcast ? 6 : 2;
+            std::memset(_videoSsrcs, 0, sizeof(_videoSsrcs));
             const size_t bitrates[] = {100, 500, 2500};
-            for (int i = 0; i < 6; ++i)
+            for (int i = 0; i < ssrcCount; ++i)
             {
                 _videoSsrcs[i] = _idGenerator.next();
                 if (0 == i % 2)
                 {
                     _videoSources.emplace(_videoSsrcs[i],
                         std::make_unique<fakenet::FakeVideoSource>(_allocator,
-                            bitrates[i / 2],
+                            _callConfig.simulcast ? bitrates[i / 2] : bitrates[2],
                             _videoSsrcs[i],
                             _channel.getEndpointIdHash(),
                             i / 2));
@@ -346,6 +349,18 @@ public:
 
     void disconnect() { _channel.disconnect(); }
 
+    // Sends the captured media instead of the emulated sources. Must be called after connect.
+    void setReplay(std::unique_ptr<CaptureReplay> replay, uint64_t timestamp, uint64_t originUs)
+    {
+        const uint32_t videoSsrcs[] = {_videoSsrcs[0], _videoSsrcs[2], _videoSsrcs[4]};
+        replay->mapSsrcs(_audioSource->getSsrc(), videoSsrcs, _callConfig.video ? (_callConfig.simulcast ? 3 : 1) : 0);
+        replay->start(timestamp, originUs);
+        _replay = std::move(replay);
+        _replayActive = true;
+    }
+
+    const CaptureReplay* getReplay() const { return _replay.get(); }
+
     void process(uint64_t timestamp) { process(timestamp, true); }
 
     void process(uint64_t timestamp, bool sendVideo)
@@ -368,6 +383,12 @@ public:
             }
         }
 
+        if (_replay)
+        {
+            processReplay(timestamp);
+            return;
+        }
+
         auto packet = _audioSource->getPacket(timestamp);
         if (packet)
         {
@@ -411,6 +432,31 @@ public:
         }
     }
 
+    void processReplay(uint64_t timestamp)
+    {
+        while (auto packet = _replay->getNext(_allocator, timestamp))
+        {
+            auto rtpHeader = rtp::RtpHeader::fromPacket(*packet);
+            const bool isAudio = rtpHeader->ssrc.get() == _audioSource->getSsrc();
+            if (!isAudio)
+            {
+                auto cache = _videoCaches.find(rtpHeader->ssrc.get());
+                if (cache != _videoCaches.end())
+                {
+                    cache->second->add(*packet, rtpHeader->sequenceNumber);
+                }
+                _rtxStats.sender.packetsSent++;
+            }
+
+            auto* transport =
+                _bundleTransport ? _bundleTransport.get() : (isAudio ? _audioTransport.get() : _videoTransport.get());
+            if (!transport->getJobQueue().template addJob<MediaSendJob>(*transport, std::move(packet), timestamp))
+            {
+                logger::warn("failed to add SendMediaJob", "SfuClient");
+            }
+        }
+    }
+
     ChannelType _channel;
 
 public:
@@ -419,6 +465,12 @@ public:
         uint32_t extendedSequenceNumber,
         uint64_t timestamp) override
     {
+        if (_replayActive.load())
+        {
+            // Replayed media is not decodable by the emulated receivers. The transport receive counters account for it.
+            return;
+        }
+
         auto rtpHeader = rtp::RtpHeader::fromPacket(*packet);
 
         if (rtpHeader->payloadType == 111)
@@ -681,6 +733,7 @@ public:
     std::unordered_map<uint32_t, std::unique_ptr<fakenet::FakeVideoSource>> _videoSources;
     std::unordered_map<uint32_t, std::unique_ptr<bridge::PacketCache>> _videoCaches;
     std::unordered_map<uint32_t, uint32_t> _videoFeedbackSequenceCounter;
+    std::unique_ptr<CaptureReplay> _replay;
 
     const concurrency::MpmcHashmap32<uint32_t, RtpAudioReceiver*>& getAudioReceiveStats() const
     {
@@ -818,6 +871,20 @@ public:
         return transport::PacketCounters();
     }
 
+    transport::PacketCounters getCumulativeAudioReceiveCounters() const
+    {
+        if (_bundleTransport)
+        {
+            return _bundleTransport->getCumulativeAudioReceiveCounters();
+        }
+        if (_audioTransport)
+        {
+            return _audioTransport->getCumulativeAudioReceiveCounters();
+        }
+
+        return transport::PacketCounters();
+    }
+
     transport::PacketCounters getCumulativeVideoReceiveCounters() const
     {
         if (_bundleTransport)
@@ -846,6 +913,7 @@ private:
     concurrency::MpmcHashmap32<uint32_t, RtpVideoReceiver*> _videoSsrcMap;
     logger::LoggableId _loggableId;
     std::atomic_bool _recordingActive;
+    std::atomic_bool _replayActive;
     std::unordered_set<uint32_t> _remoteVideoSsrc;
     std::vector<api::SimulcastGroup> _remoteVideoStreams;
     std::unique_ptr<webrtc::WebRtcDataStream> _dataStream;
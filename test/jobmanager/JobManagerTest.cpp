@@ -2,6 +2,9 @@
 #include "concurrency/Semaphore.h"
 #include "jobmanager/JobQueue.h"
 #include "jobmanager/WorkerThread.h"
+#include "logger/Logger.h"
+#include "utils/Time.h"
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <gtest/gtest.h>
@@ -400,3 +403,78 @@ TEST_F(JobManagerTest, jobQueueDeletion)
     // in the ~JobQueue and process the remaining queued jobs.
     utils::Time::nanoSleep(utils::Time::ms * 30);
 }
+
+namespace
+{
+class LatencyJob : public jobmanager::Job
+{
+public:
+    LatencyJob(uint64_t postTime, std::vector<uint64_t>& latencies, std::atomic_uint32_t& completed)
+        : _postTime(postTime),
+          _latencies(latencies),
+          _completed(completed)
+    {
+    }
+
+    void run() override
+    {
+        _latencies.push_back(utils::Time::getAbsoluteTime() - _postTime);
+        ++_completed;
+    }
+
+private:
+    const uint64_t _postTime;
+    std::vector<uint64_t>& _latencies;
+    std::atomic_uint32_t& _completed;
+};
+
+// latency from posting a job until a single worker runs it, with sparse jobs like packets on a quiet port
+std::vector<uint64_t> measureWakeUpLatency(const concurrency::PollConfig& pollConfig, uint32_t count)
+{
+    jobmanager::TimerQueue timers(512);
+    JobManager jobManager(timers);
+    std::vector<uint64_t> latencies;
+    latencies.reserve(count);
+    std::atomic_uint32_t completed(0);
+    WorkerThread worker(jobManager, true, "LatencyWorker", pollConfig);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        jobManager.addJob<LatencyJob>(utils::Time::getAbsoluteTime(), latencies, completed);
+        utils::Time::nanoSleep(utils::Time::us * 300);
+        while (completed.load() <= i)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    jobManager.stop();
+    worker.stop();
+    std::sort(latencies.begin(), latencies.end());
+    return latencies;
+}
+} // namespace
+
+TEST(WorkerThreadTest, busyPollWakeUpLatency)
+{
+#ifdef NOPERF_TEST
+    GTEST_SKIP();
+#endif
+    const uint32_t count = 1000;
+    concurrency::PollConfig busyPoll;
+    busyPoll.busyPoll = true;
+
+    const auto sleeping = measureWakeUpLatency(concurrency::PollConfig(), count);
+    const auto spinning = measureWakeUpLatency(busyPoll, count);
+
+    for (auto percentile : {50, 90, 99})
+    {
+        const auto index = count * percentile / 100;
+        logger::info("wake up latency p%d sleeping %" PRIu64 "us, busy poll %" PRIu64 "us",
+            "WorkerThreadTest",
+            percentile,
+            sleeping[index] / utils::Time::us,
+            spinning[index] / utils::Time::us);
+    }
+    EXPECT_LT(spinning[count * 9 / 10], sleeping[count * 9 / 10]);
+}
@@ -0,0 +1,142 @@
+#include "logger/DeferredFormat.h"
+#include "logger/Logger.h"
+#include "logger/LoggerThread.h"
+#include "utils/Time.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+__attribute__((format(printf, 1, 2))) std::string deferredFormat(const char* format, ...)
+{
+    uint8_t arguments[512];
+    va_list args;
+    va_start(args, format);
+    const int argumentsLength = logger::deferred::capture(arguments, sizeof(arguments), format, args);
+    va_end(args);
+    if (argumentsLength < 0)
+    {
+        return "<not captured>";
+    }
+
+    char output[512];
+    logger::deferred::format(output, sizeof(output), format, arguments, argumentsLength);
+    return output;
+}
+
+__attribute__((format(printf, 1, 2))) std::string directFormat(const char* format, ...)
+{
+    char output[512];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(output, sizeof(output), format, args);
+    va_end(args);
+    return output;
+}
+
+__attribute__((format(printf, 3, 4))) int capture(uint8_t* arguments, size_t capacity, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    const int length = logger::deferred::capture(arguments, capacity, format, args);
+    va_end(args);
+    return length;
+}
+
+__attribute__((format(printf, 2, 3))) void post(logger::LoggerThread& loggerThread, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    loggerThread.post(utils::Time::now(), "INFO", "DeferredTest", nullptr, format, args);
+    va_end(args);
+}
+
+} // namespace
+
+TEST(DeferredFormat, sameAsPrintf)
+{
+    const std::string str("endpoint-1");
+    EXPECT_EQ(directFormat("no arguments"), deferredFormat("no arguments"));
+    EXPECT_EQ(directFormat("%d %u %x %5.2f%%", -3, 7u, 0xabcu, 3.14159),
+        deferredFormat("%d %u %x %5.2f%%", -3, 7u, 0xabcu, 3.14159));
+    EXPECT_EQ(directFormat("%zu %" PRIu64 " %" PRId64 " %lld", size_t(5), uint64_t(1) << 40, int64_t(-9), -1ll),
+        deferredFormat("%zu %" PRIu64 " %" PRId64 " %lld", size_t(5), uint64_t(1) << 40, int64_t(-9), -1ll));
+    EXPECT_EQ(directFormat("[%s] %-12s|%c|%p", str.c_str(), "left", 'x', &str),
+        deferredFormat("[%s] %-12s|%c|%p", str.c_str(), "left", 'x', &str));
+    EXPECT_EQ(directFormat("%.*s %*d", 3, "abcdef", 6, 42), deferredFormat("%.*s %*d", 3, "abcdef", 6, 42));
+    EXPECT_EQ(directFormat("%hhu %hd %ld", static_cast<unsigned char>(200), static_cast<short>(-7), -5l),
+        deferredFormat("%hhu %hd %ld", static_cast<unsigned char>(200), static_cast<short>(-7), -5l));
+}
+
+TEST(DeferredFormat, truncates)
+{
+    uint8_t arguments[64];
+    char output[8];
+
+    const char* format = "%s";
+    const int argumentsLength = capture(arguments, sizeof(arguments), format, "0123456789");
+    ASSERT_EQ(11, argumentsLength);
+    EXPECT_EQ(7, logger::deferred::format(output, sizeof(output), format, arguments, argumentsLength));
+    EXPECT_STREQ("0123456", output);
+
+    EXPECT_EQ(-1,
+        capture(arguments,
+            sizeof(arguments),
+            format,
+            "a string that is longer than the capture buffer of sixty four bytes in total"));
+}
+
+TEST(DeferredFormat, perfPostCost)
+{
+#ifdef NOPERF_TEST
+    GTEST_SKIP();
+#endif
+    const int threadCount = 4;
+    const int logsPerThread = 20000;
+    const std::string endpointId("a-typical-endpoint-id-0123456789");
+
+    for (bool deferredFormatting : {false, true})
+    {
+        logger::LoggerThread loggerThread("", false, false, 64 * 1024 * 1024);
+        loggerThread.setDeferredFormatting(deferredFormatting);
+
+        std::vector<uint64_t> durations(threadCount);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([&, t]() {
+                const auto start = utils::Time::getAbsoluteTime();
+                for (int i = 0; i < logsPerThread; ++i)
+                {
+                    post(loggerThread,
+                        "ssrc %u, endpoint %s, seq %u, bitrate %.2f kbps, ts %" PRIu64,
+                        0x12345678u + i,
+                        endpointId.c_str(),
+                        static_cast<uint32_t>(i & 0xFFFF),
+                        1234.5 + i,
+                        start);
+                }
+                durations[t] = utils::Time::getAbsoluteTime() - start;
+            });
+        }
+
+        uint64_t totalDuration = 0;
+        for (int t = 0; t < threadCount; ++t)
+        {
+            threads[t].join();
+            totalDuration += durations[t];
+        }
+        loggerThread.awaitLogDrained(0, utils::Time::sec * 5);
+        loggerThread.stop();
+
+        EXPECT_EQ(0, loggerThread.getDroppedLogCount());
+        logger::info("%s formatting, %" PRIu64 "ns per log call on %d threads",
+            "DeferredFormat",
+            deferredFormatting ? "deferred" : "immediate",
+            totalDuration / (threadCount * logsPerThread),
+            threadCount);
+    }
+}
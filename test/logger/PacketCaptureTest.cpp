@@ -0,0 +1,213 @@
+#include "logger/PacketCapture.h"
+#include "logger/Logger.h"
+#include "memory/PacketPoolAllocator.h"
+#include "rtp/RtpHeader.h"
+#include "utils/Time.h"
+#include <cstdio>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+
+struct Block
+{
+    uint32_t type;
+    std::vector<uint8_t> body;
+};
+
+template <typename T>
+T readValue(const std::vector<uint8_t>& data, size_t offset)
+{
+    T value;
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    return value;
+}
+
+std::vector<Block> readBlocks(const std::string& fileName)
+{
+    std::vector<Block> blocks;
+    auto* file = fopen(fileName.c_str(), "r");
+    if (!file)
+    {
+        return blocks;
+    }
+
+    uint32_t header[2];
+    while (fread(header, sizeof(header), 1, file) == 1)
+    {
+        Block block{header[0], std::vector<uint8_t>(header[1] - 8)};
+        if (fread(block.body.data(), 1, block.body.size(), file) != block.body.size())
+        {
+            blocks.push_back(Block{0xFFFFFFFF, {}});
+            break;
+        }
+        EXPECT_EQ(header[1], readValue<uint32_t>(block.body, block.body.size() - 4));
+        blocks.push_back(std::move(block));
+    }
+    fclose(file);
+    return blocks;
+}
+
+} // namespace
+
+struct PacketCaptureTest : public testing::Test
+{
+    PacketCaptureTest() : _allocator(1024, "PacketCaptureTest") {}
+
+    void SetUp() override
+    {
+        char directory[] = "/tmp/smbCaptureXXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(directory));
+        _directory = directory;
+        _fileName = _directory + "/capture.pcapng";
+    }
+
+    void TearDown() override
+    {
+        unlink(_fileName.c_str());
+        rmdir(_directory.c_str());
+    }
+
+    memory::UniquePacket makeRtpPacket(uint16_t sequenceNumber, size_t length)
+    {
+        auto packet = memory::makeUniquePacket(_allocator);
+        auto* rtpHeader = rtp::RtpHeader::create(*packet);
+        rtpHeader->ssrc = 4711;
+        rtpHeader->payloadType = 111;
+        rtpHeader->sequenceNumber = sequenceNumber;
+        packet->setLength(length);
+        return packet;
+    }
+
+    memory::PacketPoolAllocator _allocator;
+    std::string _directory;
+    std::string _fileName;
+};
+
+TEST_F(PacketCaptureTest, ringKeepsLatestPackets)
+{
+    const size_t slotCount = 10;
+    const uint32_t snapLength = 64;
+    const size_t slotSize = 28 + 28 + snapLength + 16;
+    {
+        logger::PacketCapture capture(_fileName, 100 + slotCount * slotSize, snapLength, true, 1000);
+        ASSERT_TRUE(capture.isGood());
+        ASSERT_EQ(slotCount, capture.getSlotCount());
+
+        const auto timestamp = utils::Time::getAbsoluteTime();
+        for (uint16_t i = 0; i < 25; ++i)
+        {
+            auto packet = makeRtpPacket(i, 200 + i);
+            capture.capture(*packet,
+                i % 2 ? logger::PacketCapture::Direction::Outbound : logger::PacketCapture::Direction::Inbound,
+                timestamp + i * utils::Time::ms);
+        }
+        EXPECT_EQ(25, capture.getCapturedCount());
+    }
+
+    const auto blocks = readBlocks(_fileName);
+    ASSERT_EQ(3 + slotCount, blocks.size());
+    EXPECT_EQ(0x0A0D0D0Au, blocks[0].type);
+    EXPECT_EQ(1u, blocks[1].type);
+    EXPECT_EQ(1u, blocks[2].type);
+
+    std::vector<uint16_t> sequenceNumbers;
+    for (size_t i = 3; i < blocks.size(); ++i)
+    {
+        const auto& body = blocks[i].body;
+        ASSERT_EQ(6u, blocks[i].type);
+        const auto capturedLength = readValue<uint32_t>(body, 12);
+        const auto originalLength = readValue<uint32_t>(body, 16);
+        EXPECT_EQ(28u + 12u, capturedLength); // ip, udp and rtp header
+        EXPECT_EQ(0x45, body[20]);
+
+        const auto* rtpHeader = rtp::RtpHeader::fromPtr(body.data() + 20 + 28, capturedLength - 28);
+        ASSERT_NE(nullptr, rtpHeader);
+        EXPECT_EQ(28u + 200 + rtpHeader->sequenceNumber.get(), originalLength);
+        EXPECT_EQ(rtpHeader->sequenceNumber.get() % 2, readValue<uint32_t>(body, 0));
+        sequenceNumbers.push_back(rtpHeader->sequenceNumber.get());
+    }
+
+    std::sort(sequenceNumbers.begin(), sequenceNumbers.end());
+    EXPECT_EQ(15, sequenceNumbers.front());
+    EXPECT_EQ(24, sequenceNumbers.back());
+}
+
+TEST_F(PacketCaptureTest, fullPayloadAndRateLimit)
+{
+    {
+        logger::PacketCapture capture(_fileName, 1024 * 1024, memory::Packet::size, false, 5);
+        ASSERT_TRUE(capture.isGood());
+
+        const auto timestamp = utils::Time::getAbsoluteTime();
+        for (uint16_t i = 0; i < 10; ++i)
+        {
+            auto packet = makeRtpPacket(i, 1000);
+            capture.capture(*packet, logger::PacketCapture::Direction::Inbound, timestamp + i * utils::Time::ms);
+        }
+        auto packet = makeRtpPacket(10, 1000);
+        capture.capture(*packet, logger::PacketCapture::Direction::Inbound, timestamp + utils::Time::sec * 2);
+
+        EXPECT_EQ(6, capture.getCapturedCount());
+        EXPECT_EQ(5, capture.getSkippedCount());
+    }
+
+    const auto blocks = readBlocks(_fileName);
+    ASSERT_EQ(3 + 6, blocks.size());
+    for (size_t i = 3; i < blocks.size(); ++i)
+    {
+        EXPECT_EQ(28u + 1000u, readValue<uint32_t>(blocks[i].body, 12));
+    }
+}
+
+TEST_F(PacketCaptureTest, discardRemovesFile)
+{
+    {
+        logger::PacketCapture capture(_fileName, 1024 * 1024, 256, true, 1000);
+        ASSERT_TRUE(capture.isGood());
+        capture.discard();
+    }
+
+    EXPECT_NE(0, access(_fileName.c_str(), F_OK));
+}
+
+TEST_F(PacketCaptureTest, existingFileIsNotTruncated)
+{
+    logger::PacketCapture running(_fileName, 1024 * 1024, 256, true, 1000);
+    ASSERT_TRUE(running.isGood());
+    auto packet = makeRtpPacket(1, 100);
+    running.capture(*packet, logger::PacketCapture::Direction::Inbound, utils::Time::getAbsoluteTime());
+
+    logger::PacketCapture second(_fileName, 1024 * 1024, 256, true, 1000);
+    EXPECT_FALSE(second.isGood());
+
+    struct stat fileStat;
+    ASSERT_EQ(0, stat(_fileName.c_str(), &fileStat));
+    EXPECT_GT(fileStat.st_size, 1024 * 1024 - 1024);
+    running.capture(*packet, logger::PacketCapture::Direction::Inbound, utils::Time::getAbsoluteTime());
+    EXPECT_EQ(2, running.getCapturedCount());
+}
+
+TEST_F(PacketCaptureTest, perfCaptureCost)
+{
+#ifdef NOPERF_TEST
+    GTEST_SKIP();
+#endif
+    logger::PacketCapture capture(_fileName, 16 * 1024 * 1024, memory::Packet::size, false, 0xFFFFFFFFu);
+    ASSERT_TRUE(capture.isGood());
+
+    auto packet = makeRtpPacket(1, 1200);
+    const int count = 200000;
+    const auto start = utils::Time::getAbsoluteTime();
+    for (int i = 0; i < count; ++i)
+    {
+        capture.capture(*packet, logger::PacketCapture::Direction::Outbound, start);
+    }
+    const auto duration = utils::Time::getAbsoluteTime() - start;
+    logger::info("%" PRIu64 "ns per captured 1200B packet", "PacketCaptureTest", duration / count);
+}
@@ -1,15 +1,23 @@
 #include "memory/PoolAllocator.h"
 #include "concurrency/MpmcQueue.h"
+#include "concurrency/ThreadUtils.h"
 #include "logger/Logger.h"
+#include "memory/PacketPoolAllocator.h"
 #include "test/bridge/DummyRtcTransport.h"
 #include "test/macros.h"
 #include "utils/Time.h"
+#include <cinttypes>
 #include <gtest/gtest.h>
 #include <memory>
 #include <random>
 #include <thread>
 #include <unistd.h>
 #include <vector>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
 namespace
 {
 
@@ -164,6 +172,179 @@ TEST_F(PoolAllocatorTest, performance)
     }
 }
 
+namespace
+{
+// counts data TLB read misses of the calling thread. Counters may be unavailable in containers and VMs
+class TlbMissCounter
+{
+public:
+    TlbMissCounter() : _fd(-1)
+    {
+#ifdef __linux__
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        _fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+
+    ~TlbMissCounter()
+    {
+        if (_fd >= 0)
+        {
+            close(_fd);
+        }
+    }
+
+    bool isAvailable() const { return _fd >= 0; }
+
+    void start()
+    {
+#ifdef __linux__
+        if (_fd >= 0)
+        {
+            ioctl(_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    uint64_t stop()
+    {
+        uint64_t count = 0;
+#ifdef __linux__
+        if (_fd >= 0)
+        {
+            ioctl(_fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(_fd, &count, sizeof(count)) != sizeof(count))
+            {
+                count = 0;
+            }
+        }
+#endif
+        return count;
+    }
+
+private:
+    int _fd;
+};
+
+// touches packets of a full pool at random, like the engine does when forwarding from many transports.
+// Returns the number of packets on another node than the calling thread.
+uint32_t touchPackets(const memory::page::Placement& placement)
+{
+    const size_t packetCount = 64 * 1024;
+    memory::PacketPoolAllocator allocator(packetCount, "TouchTest", placement);
+    std::vector<memory::Packet*> packets;
+    packets.reserve(allocator.size());
+    for (auto* packet = reinterpret_cast<memory::Packet*>(allocator.allocate()); packet;
+         packet = reinterpret_cast<memory::Packet*>(allocator.allocate()))
+    {
+        memset(packet, 0, sizeof(memory::Packet));
+        packets.push_back(packet);
+    }
+
+    const int threadNode = concurrency::getCurrentNumaNode();
+    uint32_t crossNodePackets = 0;
+    for (auto* packet : packets)
+    {
+        const int node = memory::page::getNumaNode(packet);
+        if (node >= 0 && node != threadNode)
+        {
+            ++crossNodePackets;
+        }
+    }
+
+    std::default_random_engine generator(1);
+    std::uniform_int_distribution<size_t> distribution(0, packets.size() - 1);
+    std::vector<size_t> order(4 * 1024 * 1024);
+    for (auto& index : order)
+    {
+        index = distribution(generator);
+    }
+
+    TlbMissCounter tlbMisses;
+    uint64_t sum = 0;
+    const auto start = utils::Time::getAbsoluteTime();
+    tlbMisses.start();
+    for (auto index : order)
+    {
+        auto* packet = packets[index];
+        sum += packet->get()[100];
+        packet->get()[1000] = static_cast<uint8_t>(sum);
+    }
+    const auto tlbMissCount = tlbMisses.stop();
+    const auto elapsed = utils::Time::getAbsoluteTime() - start;
+
+    logger::info("huge pages %c, node %d, %zu packets, %" PRIu64 "ns per touch, dTLB misses %s %.3f per touch, "
+                 "cross node packets %u",
+        "PoolAllocatorTest",
+        placement.hugePages ? 't' : 'f',
+        placement.numaNode,
+        packets.size(),
+        elapsed / order.size(),
+        tlbMisses.isAvailable() ? "" : "unavailable",
+        static_cast<double>(tlbMissCount) / order.size(),
+        crossNodePackets);
+
+    for (auto* packet : packets)
+    {
+        allocator.free(packet);
+    }
+    return crossNodePackets;
+}
+} // namespace
+
+TEST_F(PoolAllocatorTest, hugePagesAndNodes)
+{
+#ifdef NOPERF_TEST
+    GTEST_SKIP();
+#endif
+    memory::page::Placement placement;
+    touchPackets(placement);
+
+    placement.hugePages = true;
+    touchPackets(placement);
+
+    // confine a separate thread so the node affinity does not leak into other tests
+    uint32_t crossNodePackets = 0;
+    std::thread nodeThread([placement, &crossNodePackets]() mutable {
+        placement.numaNode = concurrency::getCurrentNumaNode();
+        concurrency::setNodeAffinity(placement.numaNode);
+        crossNodePackets = touchPackets(placement);
+    });
+    nodeThread.join();
+    EXPECT_EQ(0, crossNodePackets);
+}
+
+TEST(PoolAllocatorBasic, packetsOnPlacementNode)
+{
+    memory::page::Placement placement;
+    placement.numaNode = concurrency::getCurrentNumaNode();
+    if (placement.numaNode < 0)
+    {
+        GTEST_SKIP();
+    }
+
+    memory::PacketPoolAllocator allocator(1024, "NodeTest", placement);
+    auto* packet = reinterpret_cast<memory::Packet*>(allocator.allocate());
+    ASSERT_NE(nullptr, packet);
+    std::memset(packet, 0, sizeof(memory::Packet));
+
+    const int node = memory::page::getNumaNode(packet);
+    if (node >= 0)
+    {
+        EXPECT_EQ(placement.numaNode, node);
+    }
+    allocator.free(packet);
+}
+
 TEST(PoolAllocatorBasic, leakReport)
 {
     {
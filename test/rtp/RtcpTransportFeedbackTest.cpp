@@ -0,0 +1,151 @@
+#include "rtp/RtcpTransportFeedback.h"
+#include "memory/Packet.h"
+#include "rtp/RtcpFeedback.h"
+#include "rtp/RtpHeader.h"
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace
+{
+struct PacketStatus
+{
+    uint16_t sequenceNumber;
+    bool received;
+    int64_t receiveTime;
+};
+
+std::vector<PacketStatus> readFeedback(const rtp::RtcpTransportFeedback& feedback)
+{
+    std::vector<PacketStatus> statuses;
+    rtp::TransportFeedbackReader reader(feedback);
+    PacketStatus status;
+    while (reader.getNext(status.sequenceNumber, status.received, status.receiveTime))
+    {
+        statuses.push_back(status);
+    }
+    EXPECT_TRUE(reader.isValid());
+    return statuses;
+}
+} // namespace
+
+TEST(RtcpTransportFeedbackTest, buildAndParse)
+{
+    rtp::TransportFeedbackBuilder builder;
+    const uint64_t start = utils::Time::sec * 1000;
+    for (uint16_t i = 0; i < 10; ++i)
+    {
+        if (i == 4 || i == 5)
+        {
+            continue;
+        }
+        builder.onPacketReceived(65530 + i, start + i * utils::Time::ms * 2);
+    }
+    EXPECT_EQ(8, builder.getPendingCount());
+
+    std::array<uint8_t, rtp::TransportFeedbackBuilder::maxFeedbackSize> area;
+    const auto size = builder.build(area.data(), 1, 2);
+    EXPECT_GT(size, sizeof(rtp::RtcpTransportFeedback));
+    EXPECT_EQ(0, size % 4);
+    EXPECT_FALSE(builder.hasPendingFeedback());
+
+    const auto& feedback = *reinterpret_cast<const rtp::RtcpTransportFeedback*>(area.data());
+    EXPECT_TRUE(rtp::isTransportFeedback(&feedback));
+    EXPECT_TRUE(feedback.header.isValid());
+    EXPECT_EQ(size, feedback.header.size());
+    EXPECT_EQ(65530, feedback.baseSequenceNumber.get());
+    EXPECT_EQ(10, feedback.packetStatusCount.get());
+    EXPECT_EQ(0, feedback.feedbackPacketCount);
+
+    const auto statuses = readFeedback(feedback);
+    ASSERT_EQ(10, statuses.size());
+    for (uint16_t i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(static_cast<uint16_t>(65530 + i), statuses[i].sequenceNumber);
+        EXPECT_EQ(i != 4 && i != 5, statuses[i].received);
+        if (statuses[i].received)
+        {
+            EXPECT_EQ(static_cast<int64_t>(i * utils::Time::ms * 2), statuses[i].receiveTime - statuses[0].receiveTime);
+        }
+    }
+}
+
+TEST(RtcpTransportFeedbackTest, largeDeltasAndReorder)
+{
+    rtp::TransportFeedbackBuilder builder;
+    const uint64_t start = utils::Time::sec * 50;
+    builder.onPacketReceived(100, start);
+    builder.onPacketReceived(102, start + utils::Time::ms * 5);
+    builder.onPacketReceived(101, start + utils::Time::ms * 6);
+    builder.onPacketReceived(103, start + utils::Time::ms * 300);
+
+    std::array<uint8_t, rtp::TransportFeedbackBuilder::maxFeedbackSize> area;
+    ASSERT_GT(builder.build(area.data(), 1, 2), 0);
+
+    const auto statuses = readFeedback(*reinterpret_cast<const rtp::RtcpTransportFeedback*>(area.data()));
+    ASSERT_EQ(4, statuses.size());
+    EXPECT_EQ(static_cast<int64_t>(utils::Time::ms * 6), statuses[1].receiveTime - statuses[0].receiveTime);
+    EXPECT_EQ(static_cast<int64_t>(utils::Time::ms * 5), statuses[2].receiveTime - statuses[0].receiveTime);
+    EXPECT_EQ(static_cast<int64_t>(utils::Time::ms * 300), statuses[3].receiveTime - statuses[0].receiveTime);
+
+    // already reported
+    builder.onPacketReceived(99, start + utils::Time::ms * 301);
+    EXPECT_FALSE(builder.hasPendingFeedback());
+
+    builder.onPacketReceived(104, start + utils::Time::ms * 302);
+    ASSERT_GT(builder.build(area.data(), 1, 2), 0);
+    const auto& feedback = *reinterpret_cast<const rtp::RtcpTransportFeedback*>(area.data());
+    EXPECT_EQ(104, feedback.baseSequenceNumber.get());
+    EXPECT_EQ(1, feedback.packetStatusCount.get());
+    EXPECT_EQ(1, feedback.feedbackPacketCount);
+}
+
+TEST(RtcpTransportFeedbackTest, runLengthChunks)
+{
+    rtp::TransportFeedbackBuilder builder;
+    const uint64_t start = utils::Time::sec * 7;
+    builder.onPacketReceived(0, start);
+    builder.onPacketReceived(200, start + utils::Time::ms);
+    for (uint16_t i = 201; i < 240; ++i)
+    {
+        builder.onPacketReceived(i, start + utils::Time::ms * (i - 199));
+    }
+
+    std::array<uint8_t, rtp::TransportFeedbackBuilder::maxFeedbackSize> area;
+    const auto size = builder.build(area.data(), 1, 2);
+    // one vector chunk for the first packets, then run length chunks for the lost and received runs
+    EXPECT_LT(size, sizeof(rtp::RtcpTransportFeedback) + 4 * 2 + 41);
+
+    const auto statuses = readFeedback(*reinterpret_cast<const rtp::RtcpTransportFeedback*>(area.data()));
+    ASSERT_EQ(240, statuses.size());
+    uint32_t receivedCount = 0;
+    for (const auto& status : statuses)
+    {
+        receivedCount += status.received ? 1 : 0;
+    }
+    EXPECT_EQ(41, receivedCount);
+    EXPECT_EQ(static_cast<int64_t>(utils::Time::ms * 40), statuses.back().receiveTime - statuses[0].receiveTime);
+}
+
+TEST(RtcpTransportFeedbackTest, transportWideSequenceNumberExtension)
+{
+    memory::Packet packet;
+    auto* rtpHeader = rtp::RtpHeader::create(packet);
+    rtp::RtpHeaderExtension extensionHead;
+    auto cursor = extensionHead.extensions().begin();
+    rtp::GeneralExtension1Byteheader absSendTime(3, 3);
+    extensionHead.addExtension(cursor, absSendTime);
+    rtp::GeneralExtension1Byteheader transportSequenceNumber(5, 2);
+    extensionHead.addExtension(cursor, transportSequenceNumber);
+    rtpHeader->setExtensions(extensionHead);
+    packet.setLength(rtpHeader->headerLength() + 100);
+
+    uint16_t sequenceNumber = 0;
+    EXPECT_TRUE(rtp::setTransportWideSequenceNumber(packet, 5, 0xABCD));
+    EXPECT_TRUE(rtp::getTransportWideSequenceNumber(packet, 5, sequenceNumber));
+    EXPECT_EQ(0xABCD, sequenceNumber);
+
+    EXPECT_FALSE(rtp::setTransportWideSequenceNumber(packet, 3, 1));
+    EXPECT_FALSE(rtp::getTransportWideSequenceNumber(packet, 7, sequenceNumber));
+}
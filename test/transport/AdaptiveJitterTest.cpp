@@ -105,7 +105,7 @@ TEST_P(AudioPipelineTest, DISABLED_fileReRun)
 
         if (playbackPacer.timeToNextTick(timestamp) <= 0)
         {
-            pipeline->fetchStereo(samplesPerPacket);
+            pipeline->fetch(samplesPerPacket);
 
             ::fwrite(pipeline->getAudio(), samplesPerPacket * 2, sizeof(int16_t), audioPlayback.get());
 
@@ -162,7 +162,7 @@ TEST_F(AudioPipelineTest, DTX)
             {
                 ++underruns;
             }
-            auto fetched = pipeline->fetchStereo(samplesPerPacket);
+            auto fetched = pipeline->fetch(samplesPerPacket);
             playbackPacer.tick(timestamp);
             if (fetched == 0)
             {
@@ -227,7 +227,7 @@ TEST_F(AudioPipelineTest, ptime10)
             {
                 ++underruns;
             }
-            pipeline->fetchStereo(samplesPerPacketFetch);
+            pipeline->fetch(samplesPerPacketFetch);
             playbackPacer.tick(timestamp);
         }
 
@@ -288,7 +288,7 @@ TEST_F(AudioPipelineTest, ContinuousTone)
             {
                 ++underruns;
             }
-            auto fetched = pipeline->fetchStereo(samplesPerPacket);
+            auto fetched = pipeline->fetch(samplesPerPacket);
             playbackPacer.tick(timestamp);
             if (fetched == 0)
             {
@@ -325,6 +325,69 @@ TEST_F(AudioPipelineTest, ContinuousTone)
     EXPECT_LE(underruns, 30);
 }
 
+TEST_F(AudioPipelineTest, narrowbandMono)
+{
+    const uint32_t sampleRate = 16000;
+    memory::PacketPoolAllocator allocator(4096 * 4, "JitterTest");
+
+    auto pipeline = std::make_unique<codec::AudioReceivePipeline>(48000, 20, 100, 1, sampleRate, 1);
+    EXPECT_EQ(sampleRate, pipeline->getSampleRate());
+    EXPECT_EQ(1, pipeline->getChannels());
+
+    const auto samplesPerPacket = sampleRate / 50;
+    uint32_t extendedSequenceNumber = 0;
+
+    utils::Pacer playbackPacer(utils::Time::ms * 20);
+    playbackPacer.reset(100);
+
+    emulator::JitterPacketSource audioSource(allocator, 20, 43);
+    audioSource.openWithTone(800, 1.0);
+    uint32_t underruns = 0;
+    uint32_t fetches = 0;
+
+    for (uint64_t timeSteps = 0; timeSteps < 9000; ++timeSteps)
+    {
+        _timeTurner.advance(utils::Time::ms * 2);
+        const auto timestamp = utils::Time::getAbsoluteTime();
+        if (pipeline->needProcess())
+        {
+            pipeline->process(timestamp);
+        }
+
+        if (playbackPacer.timeToNextTick(timestamp) <= 0)
+        {
+            if (pipeline->needProcess())
+            {
+                ++underruns;
+            }
+            const auto fetched = pipeline->fetch(samplesPerPacket);
+            playbackPacer.tick(timestamp);
+            if (fetched > 0)
+            {
+                ++fetches;
+                EXPECT_EQ(samplesPerPacket, fetched);
+                EXPECT_EQ(samplesPerPacket, pipeline->getAudioSampleCount());
+            }
+        }
+
+        auto packet = audioSource.getNext(timestamp);
+        if (!packet)
+        {
+            continue;
+        }
+        auto header = rtp::RtpHeader::fromPacket(*packet);
+
+        const int16_t advance =
+            static_cast<int16_t>(header->sequenceNumber.get() - (extendedSequenceNumber & 0xFFFFu));
+        extendedSequenceNumber += advance;
+
+        pipeline->onRtpPacket(extendedSequenceNumber, std::move(packet), timestamp);
+    }
+
+    EXPECT_GT(fetches, 800);
+    EXPECT_LE(underruns, 30);
+}
+
 TEST_F(AudioPipelineTest, lowJitter)
 {
     const uint32_t rtpFrequency = 48000;
@@ -362,7 +425,7 @@ TEST_F(AudioPipelineTest, lowJitter)
             {
                 ++underruns;
             }
-            pipeline->fetchStereo(samplesPerPacketFetch);
+            pipeline->fetch(samplesPerPacketFetch);
             playbackPacer.tick(timestamp);
         }
 
@@ -426,7 +489,7 @@ TEST_F(AudioPipelineTest, nearEmpty)
             {
                 ++underruns;
             }
-            pipeline->fetchStereo(samplesPerPacketFetch);
+            pipeline->fetch(samplesPerPacketFetch);
             playbackPacer.tick(timestamp);
         }
 
@@ -443,9 +506,9 @@ TEST_F(AudioPipelineTest, nearEmpty)
     EXPECT_EQ(underruns, 1);
     _timeTurner.advance(40 * utils::Time::ms);
     pipeline->process(utils::Time::getAbsoluteTime());
-    EXPECT_EQ(pipeline->fetchStereo(samplesPerPacketFetch), 960);
+    EXPECT_EQ(pipeline->fetch(samplesPerPacketFetch), 960);
     pipeline->process(utils::Time::getAbsoluteTime());
-    EXPECT_EQ(pipeline->fetchStereo(samplesPerPacketFetch), 0);
+    EXPECT_EQ(pipeline->fetch(samplesPerPacketFetch), 0);
 }
 
 TEST_F(AudioPipelineTest, everIncreasing)
@@ -491,7 +554,7 @@ TEST_F(AudioPipelineTest, everIncreasing)
             {
                 ++underruns;
             }
-            pipeline->fetchStereo(samplesPerPacketFetch);
+            pipeline->fetch(samplesPerPacketFetch);
             playbackPacer.tick(timestamp);
         }
 
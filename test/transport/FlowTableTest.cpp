@@ -0,0 +1,195 @@
+#include "transport/FlowTable.h"
+#include "concurrency/MpmcHashmap.h"
+#include "logger/Logger.h"
+#include "rtp/RtcpHeader.h"
+#include "rtp/RtpHeader.h"
+#include "utils/Time.h"
+#include <gtest/gtest.h>
+#include <random>
+
+namespace
+{
+struct Listener
+{
+    int id;
+};
+
+transport::SocketAddress makeAddress(uint32_t index)
+{
+    return transport::SocketAddress(0x0A000000u + (index >> 4), static_cast<uint16_t>(10000 + (index & 0xF)));
+}
+} // namespace
+
+TEST(FlowTableTest, keyPacking)
+{
+    const auto ipv4 = transport::SocketAddress::parse("192.168.1.20", 5004);
+    const auto ipv6 = transport::SocketAddress::parse("2001:db8::17", 5004);
+
+    transport::FlowKey key4(ipv4, 10000);
+    transport::FlowKey key6(ipv6, 10000);
+    EXPECT_FALSE(key4.empty());
+    EXPECT_FALSE(key6.empty());
+    EXPECT_NE(key4, key6);
+    EXPECT_EQ(key4, transport::FlowKey(ipv4, 10000));
+    EXPECT_NE(key4, transport::FlowKey(ipv4, 10001));
+    EXPECT_NE(key4, transport::FlowKey(transport::SocketAddress(ipv4, 5006), 10000));
+
+    EXPECT_EQ(ipv4, key4.getRemote());
+    EXPECT_EQ(ipv6, key6.getRemote());
+    EXPECT_EQ(10000, key6.getLocalPort());
+    EXPECT_EQ(IPPROTO_UDP, key6.getProtocol());
+    EXPECT_TRUE(transport::FlowKey(transport::SocketAddress(), 10000).empty());
+}
+
+TEST(FlowTableTest, classify)
+{
+    uint8_t data[200];
+    std::memset(data, 0, sizeof(data));
+    auto rtpHeader = reinterpret_cast<rtp::RtpHeader*>(data);
+    rtpHeader->version = 2;
+    rtpHeader->payloadType = 100;
+    EXPECT_EQ(transport::PacketClass::RTP, transport::classifyPacket(data, 100, transport::PacketClass::UNKNOWN));
+    EXPECT_EQ(transport::PacketClass::RTP, transport::classifyPacket(data, 100, transport::PacketClass::RTP));
+    EXPECT_EQ(transport::PacketClass::RTP, transport::classifyPacket(data, 100, transport::PacketClass::DTLS));
+
+    auto rtcpHeader = reinterpret_cast<rtp::RtcpHeader*>(data);
+    rtcpHeader->packetType = rtp::RtcpPacketType::RECEIVER_REPORT;
+    EXPECT_EQ(transport::PacketClass::RTCP, transport::classifyPacket(data, 100, transport::PacketClass::RTP));
+
+    data[0] = 22; // handshake
+    EXPECT_EQ(transport::PacketClass::DTLS, transport::classifyPacket(data, 100, transport::PacketClass::RTP));
+
+    data[0] = 70;
+    EXPECT_EQ(transport::PacketClass::UNKNOWN, transport::classifyPacket(data, 100, transport::PacketClass::RTP));
+}
+
+TEST(FlowTableTest, addFindErase)
+{
+    Listener listeners[4] = {{0}, {1}, {2}, {3}};
+    const uint32_t flowCount = 600;
+    transport::FlowTable<Listener> table(flowCount);
+
+    for (uint32_t i = 0; i < flowCount; ++i)
+    {
+        const transport::FlowKey key(makeAddress(i), 10000);
+        EXPECT_EQ(nullptr, table.find(key));
+        auto* flow = table.add(key, &listeners[i % 4]);
+        ASSERT_NE(nullptr, flow);
+        flow->onPacket(transport::PacketClass::RTP, 100 + i);
+    }
+    EXPECT_EQ(flowCount, table.size());
+    EXPECT_EQ(nullptr, table.add(transport::FlowKey(makeAddress(flowCount), 10000), &listeners[0]));
+
+    for (uint32_t i = 0; i < flowCount; ++i)
+    {
+        auto* flow = table.find(transport::FlowKey(makeAddress(i), 10000));
+        ASSERT_NE(nullptr, flow);
+        EXPECT_EQ(&listeners[i % 4], flow->getListener());
+        EXPECT_EQ(transport::PacketClass::RTP, flow->getPacketClass());
+    }
+
+    EXPECT_TRUE(table.erase(transport::FlowKey(makeAddress(7), 10000)));
+    EXPECT_FALSE(table.erase(transport::FlowKey(makeAddress(7), 10000)));
+    EXPECT_EQ(nullptr, table.find(transport::FlowKey(makeAddress(7), 10000)));
+
+    EXPECT_EQ(flowCount / 4, table.eraseListener(&listeners[1]));
+    EXPECT_EQ(flowCount - 1 - flowCount / 4, table.size());
+    for (uint32_t i = 0; i < flowCount; ++i)
+    {
+        auto* flow = table.find(transport::FlowKey(makeAddress(i), 10000));
+        if (i % 4 == 1 || i == 7)
+        {
+            EXPECT_EQ(nullptr, flow);
+        }
+        else
+        {
+            ASSERT_NE(nullptr, flow);
+            EXPECT_EQ(&listeners[i % 4], flow->getListener());
+        }
+    }
+
+    std::vector<transport::FlowStats> flows;
+    table.getFlows(flows, flowCount);
+    ASSERT_EQ(table.size(), flows.size());
+    for (auto& stats : flows)
+    {
+        EXPECT_EQ(1, stats.packets);
+        EXPECT_EQ(10000, stats.localPort);
+        auto* flow = table.find(transport::FlowKey(stats.remote, stats.localPort));
+        EXPECT_NE(nullptr, flow);
+    }
+}
+
+TEST(FlowTableTest, counters)
+{
+    Listener listener = {0};
+    transport::FlowTable<Listener> table(16);
+    const auto address = makeAddress(1);
+
+    auto* flow = table.add(transport::FlowKey(address, 10000), &listener);
+    ASSERT_NE(nullptr, flow);
+    flow->onPacket(transport::PacketClass::DTLS, 300);
+    flow->onPacket(transport::PacketClass::RTP, 1200);
+    flow->onPacket(transport::PacketClass::RTP, 1000);
+    flow->onDrop();
+    table.countUnknownDrop();
+
+    std::vector<transport::FlowStats> flows;
+    table.getFlows(flows, 16);
+    ASSERT_EQ(1, flows.size());
+    EXPECT_EQ(address, flows[0].remote);
+    EXPECT_EQ(3, flows[0].packets);
+    EXPECT_EQ(2500, flows[0].bytes);
+    EXPECT_EQ(1, flows[0].drops);
+    EXPECT_EQ(transport::PacketClass::RTP, flows[0].packetClass);
+    EXPECT_EQ(1, table.getUnknownDrops());
+}
+
+TEST(FlowTableTest, perfLookup)
+{
+#ifdef NOPERF_TEST
+    GTEST_SKIP();
+#endif
+    Listener listener = {0};
+    const uint32_t flowCount = 4096;
+    transport::FlowTable<Listener> table(flowCount);
+    concurrency::MpmcHashmap32<transport::SocketAddress, Listener*> map(flowCount * 5);
+    std::vector<transport::SocketAddress> addresses;
+    for (uint32_t i = 0; i < flowCount; ++i)
+    {
+        addresses.push_back(makeAddress(i * 7));
+        table.add(transport::FlowKey(addresses.back(), 10000), &listener);
+        map.emplace(addresses.back(), &listener);
+    }
+    std::shuffle(addresses.begin(), addresses.end(), std::mt19937(1));
+
+    const int rounds = 200;
+    size_t hits = 0;
+    auto start = utils::Time::getAbsoluteTime();
+    for (int r = 0; r < rounds; ++r)
+    {
+        for (auto& address : addresses)
+        {
+            hits += (map.getItem(address) != nullptr);
+        }
+    }
+    const auto mapTime = utils::Time::getAbsoluteTime() - start;
+
+    start = utils::Time::getAbsoluteTime();
+    for (int r = 0; r < rounds; ++r)
+    {
+        for (auto& address : addresses)
+        {
+            hits += (table.find(transport::FlowKey(address, 10000)) != nullptr);
+        }
+    }
+    const auto tableTime = utils::Time::getAbsoluteTime() - start;
+
+    const auto lookups = rounds * flowCount;
+    logger::info("lookup map %" PRIu64 "ns, flow table %" PRIu64 "ns, %zu",
+        "FlowTableTest",
+        mapTime / lookups,
+        tableTime / lookups,
+        hits);
+    EXPECT_EQ(lookups * 2, hits);
+}
@@ -1,11 +1,14 @@
 #include "FakeNetwork.h"
 #include "crypto/SslHelper.h"
 #include "jobmanager/JobManager.h"
+#include "jobmanager/WorkerThread.h"
 #include "logger/Logger.h"
 #include "memory/AudioPacketPoolAllocator.h"
 #include "memory/Packet.h"
+#include "mocks/EndpointListenerMock.h"
 #include "mocks/IceSessionEventListenerMock.h"
 #include "test/integration/emulator/TimeTurner.h"
+#include "transport/EndpointFactoryImpl.h"
 #include "transport/RtcSocket.h"
 #include "transport/RtcePoll.h"
 #include "transport/ice/IceSerialize.h"
@@ -387,6 +390,257 @@ TEST_F(IceTest, build)
     EXPECT_TRUE(msg.isAuthentic(hmacComputer1));
 }
 
+namespace
+{
+ice::StunMessage makeBindingRequest(const char* userNames, const char* pwd, bool useCandidate)
+{
+    using namespace ice;
+    StunMessage msg;
+    msg.header.setMethod(StunHeader::BindingRequest);
+    msg.header.transactionId.set({0x1111, 0x2222, 0x3333});
+    msg.add(StunGenericAttribute(StunAttribute::USERNAME, userNames));
+    msg.add(StunAttribute64(StunAttribute::ICE_CONTROLLING, 0x1234123));
+    msg.add(StunPriority(912837490u));
+    if (useCandidate)
+    {
+        msg.add(StunGenericAttribute(StunAttribute::USE_CANDIDATE));
+    }
+    crypto::HMAC hmacComputer(pwd, strlen(pwd));
+    msg.addMessageIntegrity(hmacComputer);
+    msg.addFingerprint();
+    return msg;
+}
+} // namespace
+
+TEST_F(IceTest, hmacSha1MatchesHmac)
+{
+    const char* pwd = "Hw89ty98masndbn";
+    crypto::HMAC hmacComputer(pwd, strlen(pwd));
+    crypto::HmacSha1 hmacKey(pwd, strlen(pwd));
+
+    auto msg = makeBindingRequest("target:sender", pwd, false);
+    EXPECT_TRUE(msg.isAuthentic(hmacKey));
+
+    ice::StunMessage response;
+    response.header.setMethod(ice::StunHeader::BindingResponse);
+    response.add(ice::StunGenericAttribute(ice::StunAttribute::SOFTWARE, "slice"));
+    response.addMessageIntegrity(hmacKey);
+    response.addFingerprint();
+    EXPECT_TRUE(response.isValid());
+    EXPECT_TRUE(response.isAuthentic(hmacComputer));
+
+    const std::string longKey(100, 'k');
+    crypto::HMAC longHmac(longKey.c_str(), longKey.size());
+    crypto::HmacSha1 longHmacKey(longKey.c_str(), longKey.size());
+    uint8_t expected[20];
+    uint8_t actual[20];
+    longHmac.add(pwd, strlen(pwd));
+    longHmac.compute(expected);
+    crypto::HmacSha1::Digest digest(longHmacKey);
+    digest.add(pwd, strlen(pwd));
+    digest.compute(actual);
+    EXPECT_EQ(0, std::memcmp(expected, actual, sizeof(actual)));
+}
+
+TEST_F(IceTest, stunFastPath)
+{
+    using namespace ice;
+    const char* pwd = "Hw89ty98masndbn";
+    const auto source = transport::SocketAddress::parse("192.168.1.20", 5004);
+    crypto::HMAC hmacComputer(pwd, strlen(pwd));
+
+    StunFastPath fastPath("slice");
+    fastPath.setCredentials(std::make_pair<std::string, std::string>("target", pwd));
+
+    StunMessage response;
+    const auto request = makeBindingRequest("target:sender", pwd, false);
+    EXPECT_FALSE(fastPath.respond(request, source, 1000, response));
+
+    fastPath.enable(IceRole::CONTROLLED);
+    EXPECT_TRUE(fastPath.respond(request, source, 2000, response));
+    EXPECT_TRUE(response.isValid());
+    EXPECT_TRUE(response.isAuthentic(hmacComputer));
+    EXPECT_EQ(StunHeader::BindingResponse, response.header.getMethod());
+    EXPECT_EQ(request.header.transactionId.get(), response.header.transactionId.get());
+    auto* mappedAddress = response.getAttribute<StunXorMappedAddress>(StunAttribute::XOR_MAPPED_ADDRESS);
+    ASSERT_NE(nullptr, mappedAddress);
+    EXPECT_EQ(source, mappedAddress->getAddress(response.header));
+    EXPECT_EQ(2000, fastPath.getLastRequestTimestamp());
+    EXPECT_EQ(1, fastPath.getResponseCount());
+
+    // left to the session
+    StunMessage rejected;
+    EXPECT_FALSE(fastPath.respond(makeBindingRequest("target:sender", pwd, true), source, 3000, rejected));
+    EXPECT_FALSE(fastPath.respond(makeBindingRequest("target:sender", "wrongpassword", false), source, 3000, rejected));
+    EXPECT_FALSE(fastPath.respond(makeBindingRequest("other:sender", pwd, false), source, 3000, rejected));
+
+    fastPath.disable();
+    fastPath.enable(IceRole::CONTROLLING);
+    EXPECT_FALSE(fastPath.respond(request, source, 3000, rejected));
+    EXPECT_EQ(2000, fastPath.getLastRequestTimestamp());
+    EXPECT_EQ(1, fastPath.getResponseCount());
+}
+
+namespace
+{
+template <typename TPredicate>
+bool waitFor(TPredicate predicate)
+{
+    for (int i = 0; i < 200 && !predicate(); ++i)
+    {
+        utils::Time::rawNanoSleep(5 * utils::Time::ms);
+    }
+    return predicate();
+}
+} // namespace
+
+// Drives the fast path through a shared endpoint. Requests are only answered on the receive thread when the remote
+// port is routed to the session that owns the user name, others are passed to the session.
+TEST(IceStunTest, fastPathOnSharedEndpoint)
+{
+    using namespace ice;
+    const char* pwd = "Hw89ty98masndbn";
+
+    jobmanager::TimerQueue timers(64);
+    jobmanager::JobManager jobManager(timers);
+    jobmanager::WorkerThread workerThread(jobManager, true);
+    auto rtcePoll = transport::createRtcePoll();
+    memory::PacketPoolAllocator allocator(1024, "IceStunTest");
+
+    auto endpoint = std::shared_ptr<transport::UdpEndpoint>(transport::EndpointFactoryImpl::createUdpEndpointStatic(
+        jobManager,
+        16,
+        allocator,
+        transport::SocketAddress::parse("127.0.0.1", 20111),
+        *rtcePoll,
+        true));
+    auto client = std::shared_ptr<transport::UdpEndpoint>(transport::EndpointFactoryImpl::createUdpEndpointStatic(
+        jobManager,
+        16,
+        allocator,
+        transport::SocketAddress::parse("127.0.0.1", 20112),
+        *rtcePoll,
+        false));
+    ASSERT_TRUE(endpoint->isGood());
+    ASSERT_TRUE(client->isGood());
+    const auto endpointAddress = endpoint->getLocalPort();
+    const auto clientAddress = client->getLocalPort();
+
+    std::atomic_int sessionRequests(0);
+    NiceMock<fakenet::EndpointListenerMock> session;
+    ON_CALL(session, onIceReceived).WillByDefault([&sessionRequests](transport::Endpoint&,
+                                                      const transport::SocketAddress&,
+                                                      const transport::SocketAddress&,
+                                                      memory::UniquePacket,
+                                                      uint64_t) { ++sessionRequests; });
+
+    std::atomic_int clientResponses(0);
+    NiceMock<fakenet::EndpointListenerMock> clientListener;
+    ON_CALL(clientListener, onIceReceived)
+        .WillByDefault([&clientResponses](transport::Endpoint&,
+                           const transport::SocketAddress&,
+                           const transport::SocketAddress&,
+                           memory::UniquePacket packet,
+                           uint64_t) {
+            auto* response = StunMessage::fromPtr(packet->get());
+            if (response->header.getMethod() == StunHeader::BindingResponse)
+            {
+                ++clientResponses;
+            }
+        });
+
+    StunFastPath fastPath("slice");
+    fastPath.setCredentials(std::make_pair<std::string, std::string>("target", pwd));
+    fastPath.enable(IceRole::CONTROLLED);
+    endpoint->registerListener("target", &session);
+    endpoint->registerStunFastPath("target", &fastPath);
+    client->registerListener("sender", &clientListener);
+    endpoint->start();
+    client->start();
+    ASSERT_TRUE(waitFor([&]() {
+        return endpoint->getState() == transport::Endpoint::State::CONNECTED &&
+            client->getState() == transport::Endpoint::State::CONNECTED;
+    }));
+
+    const auto sendRequest = [&](bool useCandidate) {
+        const auto request = makeBindingRequest("target:sender", pwd, useCandidate);
+        client->sendStunTo(endpointAddress,
+            request.header.transactionId.get(),
+            &request,
+            request.size(),
+            utils::Time::getAbsoluteTime());
+    };
+
+    // remote port is not yet routed to the session
+    sendRequest(false);
+    EXPECT_TRUE(waitFor([&]() { return sessionRequests == 1; }));
+    EXPECT_EQ(0, clientResponses);
+    EXPECT_EQ(0, fastPath.getResponseCount());
+
+    endpoint->registerListener(clientAddress, &session);
+    sendRequest(false);
+    EXPECT_TRUE(waitFor([&]() { return clientResponses == 1; }));
+    EXPECT_EQ(1, sessionRequests);
+    EXPECT_EQ(1, fastPath.getResponseCount());
+
+    // nomination is left to the session
+    sendRequest(true);
+    EXPECT_TRUE(waitFor([&]() { return sessionRequests == 2; }));
+    EXPECT_EQ(1, clientResponses);
+
+    const auto metrics = endpoint->getMetrics(utils::Time::getAbsoluteTime());
+    EXPECT_EQ(1, metrics.stunFastPathResponses);
+    EXPECT_EQ(1, metrics.stunFastPathFallbacks);
+
+    endpoint->stop(nullptr);
+    client->stop(nullptr);
+    EXPECT_TRUE(waitFor([&]() {
+        return endpoint->getState() != transport::Endpoint::State::STOPPING &&
+            client->getState() != transport::Endpoint::State::STOPPING;
+    }));
+    // job queues of the endpoints are drained by the worker thread on destruction
+    endpoint.reset();
+    client.reset();
+
+    rtcePoll->stop();
+    timers.stop();
+    jobManager.stop();
+    workerThread.stop();
+}
+
+TEST(IceStunTest, perfAuthentication)
+{
+#ifdef NOPERF_TEST
+    GTEST_SKIP();
+#endif
+    const char* pwd = "Hw89ty98masndbn";
+    crypto::HMAC hmacComputer(pwd, strlen(pwd));
+    crypto::HmacSha1 hmacKey(pwd, strlen(pwd));
+    const auto request = makeBindingRequest("target:sender", pwd, false);
+
+    const int count = 50000;
+    int authentic = 0;
+    auto start = utils::Time::getAbsoluteTime();
+    for (int i = 0; i < count; ++i)
+    {
+        authentic += request.isAuthentic(hmacComputer) ? 1 : 0;
+    }
+    const auto hmacTime = utils::Time::getAbsoluteTime() - start;
+
+    start = utils::Time::getAbsoluteTime();
+    for (int i = 0; i < count; ++i)
+    {
+        authentic += request.isAuthentic(hmacKey) ? 1 : 0;
+    }
+    const auto precomputedTime = utils::Time::getAbsoluteTime() - start;
+
+    logger::info("authenticate %" PRIu64 "ns hmac, %" PRIu64 "ns precomputed pads",
+        "IceTest",
+        hmacTime / count,
+        precomputedTime / count);
+    EXPECT_EQ(count * 2, authentic);
+}
+
 class IceSocketAdapter : public ice::IceEndpoint
 {
 public:
@@ -977,6 +1231,92 @@ TEST_F(IceTest, iceprobes2)
     EXPECT_TRUE(firewall2.hasIp(pair2.first.address, fakenet::Protocol::UDP));
 }
 
+namespace
+{
+class CountingEndpoint : public FakeEndpoint
+{
+public:
+    CountingEndpoint(const transport::SocketAddress& port, fakenet::Gateway& gateway) : FakeEndpoint(port, gateway) {}
+
+    void sendStunTo(const transport::SocketAddress& target,
+        ice::Int96 transactionId,
+        const void* data,
+        size_t len,
+        uint64_t timestamp) override
+    {
+        if (ice::isRequest(data))
+        {
+            ++requestCount;
+        }
+        FakeEndpoint::sendStunTo(target, transactionId, data, len, timestamp);
+    }
+
+    size_t requestCount = 0;
+};
+} // namespace
+
+TEST_F(IceTest, iceLite)
+{
+    fakenet::Internet internet;
+
+    FakeStunServer stunServer(transport::SocketAddress::parse("64.233.165.127", 19302), internet);
+    fakenet::Firewall firewall1(transport::SocketAddress::parse("216.93.246.10", 0), internet);
+
+    FakeEndpoint endpoint1(transport::SocketAddress::parse("172.16.0.10", 2000), firewall1);
+    CountingEndpoint endpoint2(transport::SocketAddress::parse("35.1.1.10", 10000), internet);
+
+    ice::IceConfig config;
+    ice::IceConfig liteConfig;
+    liteConfig.lite = true;
+    IceSessions sessions;
+    sessions.emplace_back(
+        std::make_unique<ice::IceSession>(1, config, ice::IceComponent::RTP, ice::IceRole::CONTROLLED, nullptr));
+    sessions.emplace_back(
+        std::make_unique<ice::IceSession>(2, liteConfig, ice::IceComponent::RTP, ice::IceRole::CONTROLLING, nullptr));
+    EXPECT_EQ(ice::IceRole::CONTROLLED, sessions[1]->getRole());
+
+    endpoint1.attach(sessions[0]);
+    endpoint2.attach(sessions[1]);
+
+    std::vector<transport::SocketAddress> stunServers;
+    stunServers.push_back(stunServer.getIp());
+    sessions[0]->gatherLocalCandidates(stunServers, timeSource.getAbsoluteTime());
+    sessions[1]->gatherLocalCandidates(std::vector<transport::SocketAddress>(), timeSource.getAbsoluteTime());
+    for (int i = 0; i < 100 && sessions[0]->getState() != ice::IceSession::State::READY; ++i)
+    {
+        internet.process(timeSource.getAbsoluteTime());
+        sessions[0]->processTimeout(timeSource.getAbsoluteTime());
+        timeSource.advance(10 * utils::Time::ms);
+    }
+    ASSERT_EQ(ice::IceSession::State::READY, sessions[0]->getState());
+
+    // the full agent learns it is talking to a lite agent from the signalling and takes the controlling role
+    exchangeInfo(sessions);
+    sessions[0]->probeRemoteCandidates(ice::IceRole::CONTROLLING, timeSource.getAbsoluteTime());
+    sessions[1]->probeRemoteCandidates(sessions[1]->getRole(), timeSource.getAbsoluteTime());
+    EXPECT_EQ(ice::IceSession::State::CONNECTING, sessions[1]->getState());
+    EXPECT_EQ(static_cast<int64_t>(config.connectTimeout * utils::Time::ms),
+        sessions[1]->nextTimeout(timeSource.getAbsoluteTime()));
+
+    EXPECT_TRUE(establishIce(internet, sessions, timeSource, utils::Time::sec * 30));
+    ASSERT_EQ(ice::IceSession::State::CONNECTED, sessions[0]->getState());
+    ASSERT_EQ(ice::IceSession::State::CONNECTED, sessions[1]->getState());
+
+    auto pair1 = sessions[0]->getSelectedPair();
+    auto pair2 = sessions[1]->getSelectedPair();
+    EXPECT_EQ(endpoint2._address, pair1.second.address);
+    EXPECT_EQ(endpoint2._address, pair2.first.address);
+    EXPECT_EQ(pair1.first.address, pair2.second.address);
+    EXPECT_TRUE(firewall1.hasIp(pair2.second.address, fakenet::Protocol::UDP));
+
+    // no probes and no timers on the lite side
+    EXPECT_EQ(-1, sessions[1]->nextTimeout(timeSource.getAbsoluteTime()));
+    runIce(internet, sessions, timeSource, utils::Time::sec * 20);
+    EXPECT_EQ(ice::IceSession::State::CONNECTED, sessions[0]->getState());
+    EXPECT_EQ(ice::IceSession::State::CONNECTED, sessions[1]->getState());
+    EXPECT_EQ(0, endpoint2.requestCount);
+}
+
 TEST_F(IceTest, timerNoCandidates)
 {
     fakenet::Internet internet;
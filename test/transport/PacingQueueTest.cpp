@@ -0,0 +1,188 @@
+#include "transport/PacingQueue.h"
+#include "rtp/RtpHeader.h"
+#include "utils/Time.h"
+#include <gtest/gtest.h>
+
+namespace
+{
+const uint32_t ipOverhead = 34;
+
+memory::UniquePacket makePacket(memory::PacketPoolAllocator& allocator,
+    uint32_t ssrc,
+    uint16_t sequenceNumber,
+    uint32_t rtpTimestamp,
+    size_t length = 1200)
+{
+    auto packet = memory::makeUniquePacket(allocator);
+    packet->clear();
+    packet->setLength(length);
+    auto rtpHeader = rtp::RtpHeader::create(*packet);
+    rtpHeader->ssrc = ssrc;
+    rtpHeader->sequenceNumber = sequenceNumber;
+    rtpHeader->timestamp = rtpTimestamp;
+    rtpHeader->payloadType = 100;
+    return packet;
+}
+
+uint32_t getSsrc(const memory::UniquePacket& packet)
+{
+    return rtp::RtpHeader::fromPacket(*packet)->ssrc.get();
+}
+
+uint16_t getSequenceNumber(const memory::UniquePacket& packet)
+{
+    return rtp::RtpHeader::fromPacket(*packet)->sequenceNumber.get();
+}
+} // namespace
+
+class PacingQueueTest : public ::testing::Test
+{
+public:
+    PacingQueueTest() : _allocator(4096, "PacingQueueTest") {}
+
+protected:
+    memory::PacketPoolAllocator _allocator;
+};
+
+TEST_F(PacingQueueTest, fifoPerSsrc)
+{
+    transport::PacingQueue queue(ipOverhead, 0);
+    const uint64_t timestamp = utils::Time::getAbsoluteTime();
+    for (uint16_t i = 0; i < 20; ++i)
+    {
+        EXPECT_TRUE(queue.push(makePacket(_allocator, 1000 + i % 2, i, 9000), false, timestamp));
+    }
+    EXPECT_EQ(20, queue.size());
+
+    uint16_t expectedSequenceNumber[2] = {0, 1};
+    while (auto packet = queue.fetch(SIZE_MAX, timestamp))
+    {
+        auto& expected = expectedSequenceNumber[getSsrc(packet) - 1000];
+        EXPECT_EQ(expected, getSequenceNumber(packet));
+        expected += 2;
+    }
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(20, expectedSequenceNumber[0]);
+    EXPECT_EQ(21, expectedSequenceNumber[1]);
+}
+
+TEST_F(PacingQueueTest, retransmissionsFirst)
+{
+    transport::PacingQueue queue(ipOverhead, 0);
+    const uint64_t timestamp = utils::Time::getAbsoluteTime();
+    queue.push(makePacket(_allocator, 1000, 1, 9000), false, timestamp);
+    queue.push(makePacket(_allocator, 2000, 7, 9000), true, timestamp);
+    EXPECT_EQ(1, queue.size());
+    EXPECT_EQ(1, queue.rtxSize());
+
+    EXPECT_EQ(nullptr, queue.fetch(1200, timestamp));
+    auto packet = queue.fetch(1200 + ipOverhead, timestamp);
+    ASSERT_NE(nullptr, packet);
+    EXPECT_EQ(2000, getSsrc(packet));
+    packet = queue.fetch(1200 + ipOverhead, timestamp);
+    ASSERT_NE(nullptr, packet);
+    EXPECT_EQ(1000, getSsrc(packet));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(PacingQueueTest, weightedShare)
+{
+    transport::PacingQueue queue(ipOverhead, 0);
+    queue.setPriority(1000, transport::PacingPriority::SCREENSHARE);
+    queue.setPriority(2000, transport::PacingPriority::THUMBNAIL);
+    const uint64_t timestamp = utils::Time::getAbsoluteTime();
+    for (uint16_t i = 0; i < 300; ++i)
+    {
+        queue.push(makePacket(_allocator, 1000, i, 9000 * (i / 10)), false, timestamp);
+        queue.push(makePacket(_allocator, 2000, i, 9000 * (i / 10)), false, timestamp);
+    }
+
+    uint32_t counts[2] = {0, 0};
+    for (int i = 0; i < 140; ++i)
+    {
+        auto packet = queue.fetch(SIZE_MAX, timestamp);
+        ASSERT_NE(nullptr, packet);
+        ++counts[getSsrc(packet) == 1000 ? 0 : 1];
+    }
+    EXPECT_NEAR(120, counts[0], 6);
+    EXPECT_NEAR(20, counts[1], 6);
+}
+
+TEST_F(PacingQueueTest, keyFrameBurstInterleaved)
+{
+    transport::PacingQueue queue(ipOverhead, 0);
+    const uint64_t timestamp = utils::Time::getAbsoluteTime();
+    for (uint16_t i = 0; i < 100; ++i)
+    {
+        queue.push(makePacket(_allocator, 1000, i, 9000), false, timestamp);
+    }
+    for (uint16_t i = 0; i < 5; ++i)
+    {
+        queue.push(makePacket(_allocator, 2000, i, 9000), false, timestamp);
+    }
+
+    int lastIndex = -1;
+    for (int i = 0; !queue.empty(); ++i)
+    {
+        auto packet = queue.fetch(SIZE_MAX, timestamp);
+        ASSERT_NE(nullptr, packet);
+        if (getSsrc(packet) == 2000)
+        {
+            lastIndex = i;
+        }
+    }
+    EXPECT_LT(lastIndex, 12);
+}
+
+TEST_F(PacingQueueTest, dropStaleFrames)
+{
+    transport::PacingQueue queue(ipOverhead, utils::Time::ms * 100);
+    const uint64_t start = utils::Time::getAbsoluteTime();
+    for (uint16_t i = 0; i < 3; ++i)
+    {
+        queue.push(makePacket(_allocator, 1000, i, 9000), false, start);
+    }
+    for (uint16_t i = 3; i < 5; ++i)
+    {
+        queue.push(makePacket(_allocator, 1000, i, 12000), false, start + utils::Time::ms * 20);
+    }
+    queue.push(makePacket(_allocator, 1000, 5, 15000), false, start + utils::Time::ms * 50);
+    queue.push(makePacket(_allocator, 2000, 77, 9000), true, start);
+
+    auto packet = queue.fetch(SIZE_MAX, start + utils::Time::ms * 110);
+    ASSERT_NE(nullptr, packet);
+    EXPECT_EQ(1000, getSsrc(packet));
+    EXPECT_EQ(3, getSequenceNumber(packet));
+    EXPECT_EQ(4, queue.getDropCount());
+
+    packet = queue.fetch(SIZE_MAX, start + utils::Time::ms * 115);
+    ASSERT_NE(nullptr, packet);
+    EXPECT_EQ(4, getSequenceNumber(packet));
+
+    // frame 15000 is dropped as a whole
+    queue.push(makePacket(_allocator, 1000, 6, 15000), false, start + utils::Time::ms * 140);
+    queue.push(makePacket(_allocator, 1000, 7, 18000), false, start + utils::Time::ms * 140);
+    packet = queue.fetch(SIZE_MAX, start + utils::Time::ms * 160);
+    ASSERT_NE(nullptr, packet);
+    EXPECT_EQ(7, getSequenceNumber(packet));
+    EXPECT_EQ(6, queue.getDropCount());
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(PacingQueueTest, full)
+{
+    transport::PacingQueue queue(ipOverhead, 0);
+    const uint64_t timestamp = utils::Time::getAbsoluteTime();
+    for (uint16_t i = 0; i < transport::PacingQueue::capacity; ++i)
+    {
+        EXPECT_TRUE(queue.push(makePacket(_allocator, 1000 + i % 50, i, 9000, 200), false, timestamp));
+    }
+    EXPECT_TRUE(queue.full());
+    EXPECT_FALSE(queue.push(makePacket(_allocator, 1000, 0, 9000, 200), false, timestamp));
+
+    queue.clear();
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(nullptr, queue.fetch(SIZE_MAX, timestamp));
+    EXPECT_TRUE(queue.push(makePacket(_allocator, 1000, 0, 9000, 200), false, timestamp));
+    EXPECT_EQ(1, queue.size());
+}
@@ -0,0 +1,269 @@
+#include "transport/RecordingFileEndpoint.h"
+#include "memory/PacketPoolAllocator.h"
+#include "rtp/RtpHeader.h"
+#include "transport/recp/RecControlHeader.h"
+#include "transport/recp/RecStreamAddedEventBuilder.h"
+#include "utils/Time.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cstdio>
+#include <dirent.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace transport;
+
+namespace
+{
+
+class RecordingListener : public RecordingEndpoint::IRecordingEvents
+{
+public:
+    RecordingListener() : ackedSequenceNumber(0), ackCount(0), unregistered(false) {}
+
+    void onRecControlReceived(RecordingEndpoint& endpoint,
+        const SocketAddress& source,
+        const SocketAddress& target,
+        memory::UniquePacket packet) override
+    {
+        auto* header = recp::RecControlHeader::fromPacket(*packet);
+        if (header->isEventAck())
+        {
+            ackedSequenceNumber = header->sequenceNumber.get();
+            ++ackCount;
+        }
+    }
+
+    void onUnregistered(RecordingEndpoint& endpoint) override { unregistered = true; }
+
+    std::atomic<uint16_t> ackedSequenceNumber;
+    std::atomic_int ackCount;
+    std::atomic_bool unregistered;
+};
+
+class StopListener : public Endpoint::IStopEvents
+{
+public:
+    void onEndpointStopped(Endpoint* endpoint) override { stopped = true; }
+
+    bool stopped = false;
+};
+
+std::vector<std::string> listFiles(const std::string& directory)
+{
+    std::vector<std::string> files;
+    auto* dir = opendir(directory.c_str());
+    for (auto* entry = readdir(dir); entry; entry = readdir(dir))
+    {
+        if (entry->d_name[0] != '.')
+        {
+            files.push_back(directory + "/" + entry->d_name);
+        }
+    }
+    closedir(dir);
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+} // namespace
+
+struct RecordingFileEndpointTest : public testing::Test
+{
+    RecordingFileEndpointTest() : _allocator(4096, "RecordingFileEndpointTest") {}
+
+    void SetUp() override
+    {
+        char directory[] = "/tmp/smbRecordingXXXXXX";
+        ASSERT_NE(nullptr, mkdtemp(directory));
+        _directory = directory;
+    }
+
+    void TearDown() override
+    {
+        for (auto& file : listFiles(_directory))
+        {
+            unlink(file.c_str());
+        }
+        rmdir(_directory.c_str());
+    }
+
+    memory::UniquePacket makeRtpPacket(uint32_t ssrc, uint16_t sequenceNumber, size_t length)
+    {
+        auto packet = memory::makeUniquePacket(_allocator);
+        auto* rtpHeader = rtp::RtpHeader::create(*packet);
+        rtpHeader->ssrc = ssrc;
+        rtpHeader->payloadType = 100;
+        rtpHeader->sequenceNumber = sequenceNumber;
+        packet->setLength(length);
+        return packet;
+    }
+
+    memory::PacketPoolAllocator _allocator;
+    std::string _directory;
+};
+
+TEST_F(RecordingFileEndpointTest, writesSegmentsAndAcksEvents)
+{
+    const uint64_t segmentSize = 16 * 1024;
+    RecordingFileEndpoint endpoint(_directory, segmentSize, 4 * 1024, 16, utils::Time::ms * 10, _allocator);
+    ASSERT_TRUE(endpoint.isGood());
+    endpoint.start();
+
+    RecordingListener listener;
+    const auto peer = SocketAddress::parse("127.0.0.1", 9000);
+    endpoint.registerRecordingListener(peer, &listener);
+
+    const int packetCount = 100;
+    const size_t packetLength = 1000;
+    endpoint.sendTo(peer,
+        recp::RecStreamAddedEventBuilder(_allocator)
+            .setSequenceNumber(17)
+            .setTimestamp(0)
+            .setSsrc(4711)
+            .setIsScreenSharing(false)
+            .setRtpPayloadType(100)
+            .setPayloadFormat(bridge::RtpMap::Format::VP8)
+            .setEndpoint("test")
+            .setWallClock(utils::Time::now())
+            .build());
+    for (int i = 0; i < packetCount; ++i)
+    {
+        if (i == packetCount / 2)
+        {
+            utils::Time::rawNanoSleep(utils::Time::ms * 20);
+        }
+        endpoint.sendTo(peer, makeRtpPacket(4711 + i % 2, i / 2, packetLength));
+    }
+
+    endpoint.unregisterRecordingListener(&listener);
+    for (int i = 0; i < 500 && !listener.unregistered; ++i)
+    {
+        utils::Time::nanoSleep(utils::Time::ms * 2);
+    }
+    ASSERT_TRUE(listener.unregistered);
+    EXPECT_EQ(1, listener.ackCount);
+    EXPECT_EQ(17, listener.ackedSequenceNumber);
+    EXPECT_EQ(0, endpoint.getDroppedPackets());
+
+    StopListener stopListener;
+    endpoint.stop(&stopListener);
+    EXPECT_TRUE(stopListener.stopped);
+
+    const auto files = listFiles(_directory);
+    EXPECT_GE(files.size(), (packetCount * packetLength) / segmentSize + 1);
+
+    int rtpCount = 0;
+    int eventCount = 0;
+    uint32_t lastOffset = 0;
+    uint64_t totalBytes = 0;
+    alignas(8) uint8_t data[memory::Packet::size];
+    for (auto& fileName : files)
+    {
+        const bool isEventFile = fileName.find("-events.") != std::string::npos;
+        const bool isSsrcFile =
+            fileName.find("-4711.") != std::string::npos || fileName.find("-4712.") != std::string::npos;
+        EXPECT_TRUE(isEventFile || isSsrcFile) << fileName;
+
+        auto* file = fopen(fileName.c_str(), "r");
+        ASSERT_NE(nullptr, file);
+        char line[128];
+        ASSERT_NE(nullptr, fgets(line, sizeof(line), file));
+        EXPECT_EQ(std::string("#!rtpplay1.0 127.0.0.1/9000\n"), line);
+        uint8_t fileHeader[16];
+        ASSERT_EQ(1, fread(fileHeader, sizeof(fileHeader), 1, file));
+        uint64_t fileSize = strlen(line) + sizeof(fileHeader);
+
+        uint16_t length;
+        uint16_t packetLength;
+        uint32_t offset;
+        while (fread(&length, 2, 1, file) == 1 && fread(&packetLength, 2, 1, file) == 1 &&
+            fread(&offset, 4, 1, file) == 1)
+        {
+            const uint16_t size = ntohs(length) - 8;
+            ASSERT_EQ(size, ntohs(packetLength));
+            ASSERT_EQ(size, fread(data, 1, size, file));
+            fileSize += size + 8;
+            if (rtp::isRtpPacket(data, size))
+            {
+                auto* rtpHeader = rtp::RtpHeader::fromPtr(data, size);
+                EXPECT_NE(std::string::npos, fileName.find("-" + std::to_string(rtpHeader->ssrc.get()) + "."));
+                ++rtpCount;
+                if (rtpHeader->ssrc.get() == 4711 && rtpHeader->sequenceNumber.get() == packetCount / 4)
+                {
+                    EXPECT_GE(ntohl(offset), 20);
+                }
+                lastOffset = std::max(lastOffset, ntohl(offset));
+            }
+            else if (recp::isRecPacket(data, size))
+            {
+                EXPECT_TRUE(isEventFile);
+                ++eventCount;
+            }
+        }
+        fclose(file);
+        EXPECT_LE(fileSize, segmentSize);
+        totalBytes += fileSize;
+    }
+
+    EXPECT_EQ(packetCount, rtpCount);
+    EXPECT_EQ(1, eventCount);
+    EXPECT_GE(lastOffset, 20);
+    EXPECT_EQ(totalBytes, endpoint.getBytesWritten());
+}
+
+TEST_F(RecordingFileEndpointTest, moreStreamsThanWriteBuffers)
+{
+    RecordingFileEndpoint endpoint(_directory, 1024 * 1024, 4 * 1024, 2, utils::Time::sec, _allocator);
+    ASSERT_TRUE(endpoint.isGood());
+    endpoint.start();
+
+    RecordingListener listener;
+    const auto peer = SocketAddress::parse("127.0.0.1", 9000);
+    endpoint.registerRecordingListener(peer, &listener);
+
+    const int streamCount = 5;
+    const int packetCount = 100;
+    const size_t packetLength = 500;
+    for (int i = 0; i < packetCount; ++i)
+    {
+        endpoint.sendTo(peer, makeRtpPacket(4711 + i % streamCount, i / streamCount, packetLength));
+    }
+
+    endpoint.unregisterRecordingListener(&listener);
+    for (int i = 0; i < 500 && !listener.unregistered; ++i)
+    {
+        utils::Time::nanoSleep(utils::Time::ms * 2);
+    }
+    ASSERT_TRUE(listener.unregistered);
+    EXPECT_EQ(0, endpoint.getDroppedPackets());
+
+    StopListener stopListener;
+    endpoint.stop(&stopListener);
+
+    const auto files = listFiles(_directory);
+    EXPECT_EQ(streamCount, files.size());
+    const uint64_t fileHeaderSize = strlen("#!rtpplay1.0 127.0.0.1/9000\n") + 16;
+    EXPECT_EQ(streamCount * fileHeaderSize + packetCount * (packetLength + 8), endpoint.getBytesWritten());
+}
+
+TEST_F(RecordingFileEndpointTest, unregisterAfterStop)
+{
+    RecordingFileEndpoint endpoint(_directory, 1024 * 1024, 4 * 1024, 2, utils::Time::sec, _allocator);
+    ASSERT_TRUE(endpoint.isGood());
+    endpoint.start();
+
+    RecordingListener listener;
+    const auto peer = SocketAddress::parse("127.0.0.1", 9000);
+    endpoint.registerRecordingListener(peer, &listener);
+
+    StopListener stopListener;
+    endpoint.stop(&stopListener);
+    EXPECT_TRUE(stopListener.stopped);
+
+    endpoint.registerRecordingListener(peer, &listener);
+    endpoint.unregisterRecordingListener(&listener);
+    EXPECT_TRUE(listener.unregistered);
+}
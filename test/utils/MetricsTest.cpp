@@ -0,0 +1,49 @@
+#include "utils/Metrics.h"
+#include "utils/Time.h"
+#include <gtest/gtest.h>
+
+TEST(Metrics, histogramBuckets)
+{
+    EXPECT_EQ(0, utils::Histogram::getBucketIndex(0));
+    EXPECT_EQ(0, utils::Histogram::getBucketIndex(utils::Time::us));
+    EXPECT_EQ(1, utils::Histogram::getBucketIndex(utils::Time::us + 1));
+    EXPECT_EQ(1, utils::Histogram::getBucketIndex(utils::Time::us * 2));
+    EXPECT_EQ(10, utils::Histogram::getBucketIndex(utils::Time::us * 1000));
+    EXPECT_EQ(utils::Histogram::bucketCount, utils::Histogram::getBucketIndex(utils::Time::sec * 5));
+
+    for (uint32_t i = 0; i < utils::Histogram::bucketCount; ++i)
+    {
+        EXPECT_EQ(i, utils::Histogram::getBucketIndex(utils::Histogram::getBucketBound(i)));
+        EXPECT_EQ(i + 1, utils::Histogram::getBucketIndex(utils::Histogram::getBucketBound(i) + utils::Time::us));
+    }
+}
+
+TEST(Metrics, histogramObserve)
+{
+    utils::Histogram histogram("test_seconds", "Test histogram.");
+    histogram.observe(utils::Time::us * 3);
+    histogram.observe(utils::Time::us * 4);
+    histogram.observe(utils::Time::sec * 10);
+
+    EXPECT_EQ(2, histogram.getBucketCount(2));
+    EXPECT_EQ(1, histogram.getBucketCount(utils::Histogram::bucketCount));
+    EXPECT_EQ(utils::Time::sec * 10 + utils::Time::us * 7, histogram.getSumNs());
+}
+
+TEST(Metrics, describeOpenMetrics)
+{
+    utils::metrics::engineTickDuration.observe(utils::Time::ms * 3);
+
+    std::string text;
+    utils::metrics::describe(text);
+    EXPECT_NE(std::string::npos, text.find("# TYPE smb_engine_tick_duration_seconds histogram\n"));
+    EXPECT_NE(std::string::npos, text.find("smb_engine_tick_duration_seconds_bucket{le=\"0.004096\"} "));
+    EXPECT_NE(std::string::npos, text.find("smb_engine_tick_duration_seconds_bucket{le=\"+Inf\"} "));
+    EXPECT_NE(std::string::npos, text.find("smb_engine_tick_duration_seconds_count "));
+    EXPECT_NE(std::string::npos, text.find("# TYPE smb_pacing_queue_delay_seconds histogram\n"));
+
+    utils::metrics::describeGauge(text, "smb_test_items", "Test gauge.");
+    utils::metrics::appendGaugeValue(text, "smb_test_items", "pool", "main", 17);
+    EXPECT_NE(std::string::npos, text.find("# TYPE smb_test_items gauge\n"));
+    EXPECT_NE(std::string::npos, text.find("smb_test_items{pool=\"main\"} 17\n"));
+}
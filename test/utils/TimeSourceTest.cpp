@@ -2,6 +2,7 @@
 #include "utils/Time.h"
 #include <chrono>
 #include <gtest/gtest.h>
+#include <thread>
 TEST(DISABLED_TimeSource, Comparison)
 {
     auto startAbs = utils::Time::getAbsoluteTime();
@@ -18,3 +19,51 @@ TEST(DISABLED_TimeSource, Comparison)
         "",
         std::chrono::duration_cast<std::chrono::microseconds>(endSteady - startSteady).count());
 }
+
+TEST(TimeSource, approximateTimeIsCachedPerThread)
+{
+    // caching threads keep their state, so run on a thread of its own
+    std::thread cachingThread([]() {
+        const auto refreshed = utils::Time::refreshApproximateTime();
+        utils::Time::rawNanoSleep(2 * utils::Time::ms);
+        EXPECT_EQ(refreshed, utils::Time::getApproximateTime());
+
+        uint64_t otherThreadTime = 0;
+        std::thread otherThread([&otherThreadTime]() { otherThreadTime = utils::Time::getApproximateTime(); });
+        otherThread.join();
+        EXPECT_GE(otherThreadTime, refreshed + 2 * utils::Time::ms);
+
+        utils::Time::invalidateApproximateTime();
+        const auto firstRead = utils::Time::getApproximateTime();
+        EXPECT_GE(firstRead, refreshed + 2 * utils::Time::ms);
+        utils::Time::rawNanoSleep(2 * utils::Time::ms);
+        EXPECT_EQ(firstRead, utils::Time::getApproximateTime());
+    });
+    cachingThread.join();
+}
+
+TEST(TimeSource, tscClockFollowsMonotonicClock)
+{
+    const bool wasEnabled = utils::Time::isTscClockEnabled();
+    if (!utils::Time::enableTscClock())
+    {
+        GTEST_SKIP();
+    }
+
+    const auto startTsc = utils::Time::getRawAbsoluteTime();
+    const auto startMonotonic = utils::Time::rawAbsoluteTime();
+    utils::Time::rawNanoSleep(100 * utils::Time::ms);
+    const auto elapsedTsc = utils::Time::getRawAbsoluteTime() - startTsc;
+    const auto elapsedMonotonic = utils::Time::rawAbsoluteTime() - startMonotonic;
+    const auto offset = static_cast<double>(utils::Time::rawAbsoluteTime()) -
+        static_cast<double>(utils::Time::getRawAbsoluteTime());
+
+    if (!wasEnabled)
+    {
+        utils::Time::disableTscClock();
+    }
+
+    // bounds allow for preemption between the paired reads on loaded machines
+    EXPECT_NEAR(static_cast<double>(elapsedMonotonic), static_cast<double>(elapsedTsc), 2.0 * utils::Time::ms);
+    EXPECT_NEAR(0.0, offset, 5.0 * utils::Time::ms);
+}
@@ -68,6 +68,8 @@ public:
     virtual void registerListener(const std::string& stunUserName, IEvents* listener) = 0;
     virtual void registerListener(const SocketAddress& remotePort, IEvents* listener) = 0;
     virtual void registerDefaultListener(IEvents* defaultListener) = 0;
+    // Lets the endpoint answer binding requests for the user itself. Endpoints without a fast path ignore it.
+    virtual void registerStunFastPath(const std::string& stunUserName, ice::StunFastPath* fastPath) = 0;
 
     virtual void unregisterListener(IEvents* listener) = 0;
     virtual void unregisterListener(const SocketAddress& remotePort, IEvents* listener) = 0;
@@ -8,7 +8,10 @@ struct EndpointMetrics
         : sendQueue(sQueue),
           receiveKbps(rKbps),
           sendKbps(sKbs),
-          sendQueueDrops(sendDrops)
+          sendQueueDrops(sendDrops),
+          unknownFlowDrops(0),
+          stunFastPathResponses(0),
+          stunFastPathFallbacks(0)
     {
     }
 
@@ -20,6 +23,9 @@ struct EndpointMetrics
         receiveKbps += rhs.receiveKbps;
         sendKbps += rhs.sendKbps;
         sendQueueDrops += rhs.sendQueueDrops;
+        unknownFlowDrops += rhs.unknownFlowDrops;
+        stunFastPathResponses += rhs.stunFastPathResponses;
+        stunFastPathFallbacks += rhs.stunFastPathFallbacks;
         return *this;
     }
 
@@ -27,6 +33,9 @@ struct EndpointMetrics
     double receiveKbps;
     double sendKbps;
     uint64_t sendQueueDrops;
+    uint64_t unknownFlowDrops; // datagrams without a known listener on a shared port
+    uint64_t stunFastPathResponses;
+    uint64_t stunFastPathFallbacks; // requests of fast path sessions left to the IceSession
 };
 
 inline EndpointMetrics operator+(const EndpointMetrics& lhs, const EndpointMetrics& rhs)
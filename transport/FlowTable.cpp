@@ -0,0 +1,128 @@
+#include "transport/FlowTable.h"
+#include "rtp/RtcpHeader.h"
+#include "rtp/RtpHeader.h"
+#include "transport/dtls/SslDtls.h"
+#include "transport/ice/Stun.h"
+
+namespace transport
+{
+
+namespace
+{
+bool isClass(PacketClass packetClass, const void* data, size_t length)
+{
+    switch (packetClass)
+    {
+    case PacketClass::STUN:
+        return ice::isStunMessage(data, length);
+    case PacketClass::DTLS:
+        return isDtlsPacket(data, length);
+    case PacketClass::RTCP:
+        return rtp::isRtcpPacket(data, length);
+    case PacketClass::RTP:
+        return rtp::isRtpPacket(data, length);
+    default:
+        return false;
+    }
+}
+
+uint64_t mixWords(uint64_t a, uint64_t b, uint64_t c)
+{
+    uint64_t h = a * 0x9E3779B97F4A7C15ull;
+    h ^= (b + 0x632BE59BD9B4E019ull) * 0xC2B2AE3D27D4EB4Full;
+    h ^= (c + 0x165667B19E3779F9ull) * 0x85EBCA77C2B2AE63ull;
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ull;
+    return h ^ (h >> 32);
+}
+} // namespace
+
+PacketClass classifyPacket(const void* data, size_t length, PacketClass hint)
+{
+    if (hint != PacketClass::UNKNOWN && isClass(hint, data, length))
+    {
+        return hint;
+    }
+
+    for (auto packetClass : {PacketClass::STUN, PacketClass::DTLS, PacketClass::RTCP, PacketClass::RTP})
+    {
+        if (packetClass != hint && isClass(packetClass, data, length))
+        {
+            return packetClass;
+        }
+    }
+    return PacketClass::UNKNOWN;
+}
+
+const char* toString(PacketClass packetClass)
+{
+    switch (packetClass)
+    {
+    case PacketClass::STUN:
+        return "stun";
+    case PacketClass::DTLS:
+        return "dtls";
+    case PacketClass::RTCP:
+        return "rtcp";
+    case PacketClass::RTP:
+        return "rtp";
+    default:
+        return "unknown";
+    }
+}
+
+FlowKey::FlowKey(const SocketAddress& remote, uint16_t localPort, uint8_t protocol) : hash(0), words{0, 0, 0}
+{
+    const auto family = remote.getFamily();
+    if (family == AF_INET6)
+    {
+        std::memcpy(words, &remote.getIpv6()->sin6_addr, sizeof(in6_addr));
+    }
+    else if (family == AF_INET)
+    {
+        std::memcpy(words, &remote.getIpv4()->sin_addr, sizeof(in_addr));
+    }
+    else
+    {
+        return;
+    }
+
+    words[2] = static_cast<uint64_t>(family) | (static_cast<uint64_t>(protocol) << 8) |
+        (static_cast<uint64_t>(remote.getPort()) << 16) | (static_cast<uint64_t>(localPort) << 32);
+    hash = mixWords(words[0], words[1], words[2]);
+}
+
+FlowKey::FlowKey(const uint64_t* packedWords)
+    : hash(mixWords(packedWords[0], packedWords[1], packedWords[2])),
+      words{packedWords[0], packedWords[1], packedWords[2]}
+{
+}
+
+SocketAddress FlowKey::getRemote() const
+{
+    const auto family = static_cast<int>(words[2] & 0xFF);
+    const auto port = static_cast<uint16_t>(words[2] >> 16);
+    if (family == AF_INET6)
+    {
+        return SocketAddress(reinterpret_cast<const uint8_t*>(words), port);
+    }
+    else if (family == AF_INET)
+    {
+        uint32_t ipv4 = 0;
+        std::memcpy(&ipv4, words, sizeof(ipv4));
+        return SocketAddress(ntohl(ipv4), port);
+    }
+    return SocketAddress();
+}
+
+uint16_t FlowKey::getLocalPort() const
+{
+    return static_cast<uint16_t>(words[2] >> 32);
+}
+
+uint8_t FlowKey::getProtocol() const
+{
+    return static_cast<uint8_t>(words[2] >> 8);
+}
+
+} // namespace transport
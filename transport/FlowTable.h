@@ -0,0 +1,349 @@
+#pragma once
+#include "utils/SocketAddress.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <netinet/in.h>
+#include <vector>
+
+namespace transport
+{
+
+// Demultiplexing class of a datagram on a shared port. The classes are disjoint by the first bytes of the packet
+// (RFC 7983) so they may be tested in any order.
+enum class PacketClass : uint8_t
+{
+    UNKNOWN = 0,
+    STUN,
+    DTLS,
+    RTCP,
+    RTP
+};
+
+/**
+ * Classifies a datagram. The hint is tested first, which makes the common case a single test for flows that
+ * carry mainly RTP after the handshake.
+ */
+PacketClass classifyPacket(const void* data, size_t length, PacketClass hint);
+const char* toString(PacketClass packetClass);
+
+// Remote address, remote port, local port and protocol packed into three words. The hash is computed once when the
+// key is built and is reused for probing.
+struct FlowKey
+{
+    FlowKey() : hash(0), words{0, 0, 0} {}
+    FlowKey(const SocketAddress& remote, uint16_t localPort, uint8_t protocol = IPPROTO_UDP);
+    explicit FlowKey(const uint64_t* packedWords);
+
+    bool operator==(const FlowKey& other) const { return hash == other.hash && equals(other.words); }
+    bool operator!=(const FlowKey& other) const { return !(*this == other); }
+    bool equals(const uint64_t* other) const
+    {
+        return words[0] == other[0] && words[1] == other[1] && words[2] == other[2];
+    }
+
+    bool empty() const { return isEmpty(words); }
+    static bool isEmpty(const uint64_t* packedWords) { return (packedWords[2] & 0xFF) == 0; }
+
+    SocketAddress getRemote() const;
+    uint16_t getLocalPort() const;
+    uint8_t getProtocol() const;
+
+    uint64_t hash;
+    // words[0..1] address, ipv4 in first 4 bytes. words[2] family, protocol, remote port and local port
+    uint64_t words[3];
+};
+
+struct FlowStats
+{
+    SocketAddress remote;
+    uint16_t localPort = 0;
+    PacketClass packetClass = PacketClass::UNKNOWN;
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+    uint64_t drops = 0;
+};
+
+/**
+ * Open addressing table of flows on an endpoint with linear probing and backward shift deletion. A flow occupies
+ * one cache line and caches the listener it resolved to, the class of the last packet and packet, byte and drop
+ * counters.
+ * Single writer, which is the receive job queue of the endpoint. getFlows may be called from any thread and
+ * reads consistent flows through a per flow sequence counter.
+ * Only flows with a known listener are added. When the table is full, add returns nullptr and the caller
+ * falls back to its listener maps.
+ */
+template <typename T>
+class FlowTable
+{
+public:
+    class alignas(64) Flow
+    {
+    public:
+        Flow()
+            : version(0),
+              packetClass(PacketClass::UNKNOWN),
+              words{0, 0, 0},
+              listener(nullptr),
+              packets(0),
+              bytes(0),
+              drops(0)
+        {
+        }
+
+        T* getListener() const { return listener.load(std::memory_order_relaxed); }
+        PacketClass getPacketClass() const { return packetClass.load(std::memory_order_relaxed); }
+
+        void onPacket(PacketClass packetClass_, size_t length)
+        {
+            packetClass.store(packetClass_, std::memory_order_relaxed);
+            packets.store(packets.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            bytes.store(bytes.load(std::memory_order_relaxed) + length, std::memory_order_relaxed);
+        }
+
+        void onDrop() { drops.store(drops.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+    private:
+        friend class FlowTable;
+
+        // Fields read by getFlows are atomics so the snapshot races only on values, which the version detects.
+        // Relaxed access compiles to plain loads and stores on the receive path.
+        bool empty() const { return (words[2].load(std::memory_order_relaxed) & 0xFF) == 0; }
+        bool equals(const uint64_t* other) const
+        {
+            return words[0].load(std::memory_order_relaxed) == other[0] &&
+                words[1].load(std::memory_order_relaxed) == other[1] &&
+                words[2].load(std::memory_order_relaxed) == other[2];
+        }
+
+        void loadWords(uint64_t* target) const
+        {
+            for (size_t i = 0; i < 3; ++i)
+            {
+                target[i] = words[i].load(std::memory_order_relaxed);
+            }
+        }
+
+        void storeWords(const uint64_t* source)
+        {
+            for (size_t i = 0; i < 3; ++i)
+            {
+                words[i].store(source[i], std::memory_order_relaxed);
+            }
+        }
+
+        void copyFrom(const Flow& other)
+        {
+            uint64_t otherWords[3];
+            other.loadWords(otherWords);
+            storeWords(otherWords);
+            listener.store(other.getListener(), std::memory_order_relaxed);
+            packetClass.store(other.getPacketClass(), std::memory_order_relaxed);
+            packets.store(other.packets.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            bytes.store(other.bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            drops.store(other.drops.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+
+        std::atomic_uint32_t version;
+        std::atomic<PacketClass> packetClass;
+        std::atomic_uint64_t words[3];
+        std::atomic<T*> listener;
+        std::atomic_uint64_t packets;
+        std::atomic_uint64_t bytes;
+        std::atomic_uint64_t drops;
+    };
+
+    explicit FlowTable(size_t maxFlows) : _maxFlows(maxFlows), _mask(0), _count(0), _unknownDrops(0)
+    {
+        size_t slotCount = 16;
+        while (slotCount < maxFlows * 2)
+        {
+            slotCount *= 2;
+        }
+        _mask = slotCount - 1;
+        _flows.reset(new Flow[slotCount]);
+    }
+
+    Flow* find(const FlowKey& key)
+    {
+        for (size_t i = key.hash & _mask;; i = (i + 1) & _mask)
+        {
+            auto& flow = _flows[i];
+            if (flow.empty())
+            {
+                return nullptr;
+            }
+            if (flow.equals(key.words))
+            {
+                return &flow;
+            }
+        }
+    }
+
+    Flow* add(const FlowKey& key, T* listener)
+    {
+        assert(!key.empty() && listener);
+        for (size_t i = key.hash & _mask;; i = (i + 1) & _mask)
+        {
+            auto& flow = _flows[i];
+            if (flow.equals(key.words))
+            {
+                flow.listener.store(listener, std::memory_order_relaxed);
+                return &flow;
+            }
+            if (flow.empty())
+            {
+                if (_count.load(std::memory_order_relaxed) >= _maxFlows)
+                {
+                    return nullptr;
+                }
+
+                beginWrite(flow);
+                flow.storeWords(key.words);
+                flow.listener.store(listener, std::memory_order_relaxed);
+                flow.packetClass.store(PacketClass::UNKNOWN, std::memory_order_relaxed);
+                flow.packets.store(0, std::memory_order_relaxed);
+                flow.bytes.store(0, std::memory_order_relaxed);
+                flow.drops.store(0, std::memory_order_relaxed);
+                endWrite(flow);
+                _count.store(_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return &flow;
+            }
+        }
+    }
+
+    bool erase(const FlowKey& key)
+    {
+        for (size_t i = key.hash & _mask;; i = (i + 1) & _mask)
+        {
+            if (_flows[i].empty())
+            {
+                return false;
+            }
+            if (_flows[i].equals(key.words))
+            {
+                eraseAt(i);
+                return true;
+            }
+        }
+    }
+
+    // Removes all flows routed to the listener. Returns number of flows removed.
+    size_t eraseListener(const T* listener)
+    {
+        size_t removed = 0;
+        for (size_t i = 0; i <= _mask;)
+        {
+            if (!_flows[i].empty() && _flows[i].getListener() == listener)
+            {
+                eraseAt(i);
+                ++removed;
+                continue; // another flow may have been shifted into this slot
+            }
+            ++i;
+        }
+        return removed;
+    }
+
+    void countUnknownDrop()
+    {
+        _unknownDrops.store(_unknownDrops.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    size_t size() const { return _count.load(std::memory_order_relaxed); }
+    size_t capacity() const { return _maxFlows; }
+    uint64_t getUnknownDrops() const { return _unknownDrops.load(std::memory_order_relaxed); }
+
+    // Snapshot of at most maxCount flows. Flows shifted during the snapshot may be missed or reported twice.
+    void getFlows(std::vector<FlowStats>& flows, size_t maxCount) const
+    {
+        for (size_t i = 0; i <= _mask && flows.size() < maxCount; ++i)
+        {
+            const auto& flow = _flows[i];
+            for (int retries = 0; retries < 8; ++retries)
+            {
+                const uint32_t version = flow.version.load(std::memory_order_acquire);
+                if (version & 1)
+                {
+                    continue;
+                }
+
+                uint64_t words[3];
+                flow.loadWords(words);
+                FlowStats stats;
+                stats.packetClass = flow.getPacketClass();
+                stats.packets = flow.packets.load(std::memory_order_relaxed);
+                stats.bytes = flow.bytes.load(std::memory_order_relaxed);
+                stats.drops = flow.drops.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (flow.version.load(std::memory_order_relaxed) != version)
+                {
+                    continue;
+                }
+
+                if (!FlowKey::isEmpty(words))
+                {
+                    const FlowKey key(words);
+                    stats.remote = key.getRemote();
+                    stats.localPort = key.getLocalPort();
+                    flows.push_back(stats);
+                }
+                break;
+            }
+        }
+    }
+
+private:
+    static void beginWrite(Flow& flow)
+    {
+        flow.version.store(flow.version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    static void endWrite(Flow& flow)
+    {
+        flow.version.store(flow.version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // backward shift deletion keeps probe sequences short without tombstones
+    void eraseAt(size_t hole)
+    {
+        for (size_t i = (hole + 1) & _mask;; i = (i + 1) & _mask)
+        {
+            auto& flow = _flows[i];
+            if (flow.empty())
+            {
+                break;
+            }
+
+            uint64_t words[3];
+            flow.loadWords(words);
+            const size_t home = FlowKey(words).hash & _mask;
+            const bool canMove = (i > hole) ? (home <= hole || home > i) : (home <= hole && home > i);
+            if (canMove)
+            {
+                auto& target = _flows[hole];
+                beginWrite(target);
+                target.copyFrom(flow);
+                endWrite(target);
+                hole = i;
+            }
+        }
+
+        auto& flow = _flows[hole];
+        const uint64_t emptyWords[3] = {0, 0, 0};
+        beginWrite(flow);
+        flow.storeWords(emptyWords);
+        flow.listener.store(nullptr, std::memory_order_relaxed);
+        endWrite(flow);
+        _count.store(_count.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    }
+
+    const size_t _maxFlows;
+    size_t _mask;
+    std::unique_ptr<Flow[]> _flows;
+    std::atomic_size_t _count;
+    std::atomic_uint64_t _unknownDrops;
+};
+
+} // namespace transport
@@ -47,9 +47,14 @@ void IceStartJob::run()
 
     auto timestamp = utils::Time::getAbsoluteTime();
     _session.probeRemoteCandidates(_session.getRole(), timestamp);
+    const auto timeoutNs = _session.nextTimeout(timestamp);
+    if (timeoutNs < 0)
+    {
+        return; // lite session that was nominated before start
+    }
     _transport.getJobQueue().getJobManager().replaceTimedJob<IceTimerTriggerJob>(_transport.getId(),
         TIMER_ID,
-        _session.nextTimeout(timestamp) / 1000,
+        timeoutNs / 1000,
         _transport,
         _session);
 }
@@ -0,0 +1,329 @@
+#include "transport/PacingQueue.h"
+#include "rtp/RtpHeader.h"
+#include "utils/Metrics.h"
+#include "utils/Time.h"
+
+namespace transport
+{
+
+namespace
+{
+uint32_t getWeight(PacingPriority priority)
+{
+    switch (priority)
+    {
+    case PacingPriority::THUMBNAIL:
+        return 1;
+    case PacingPriority::PINNED:
+        return 4;
+    case PacingPriority::SCREENSHARE:
+        return 6;
+    default:
+        return 2;
+    }
+}
+
+utils::Histogram& getDelayHistogram(PacingPriority priority)
+{
+    switch (priority)
+    {
+    case PacingPriority::THUMBNAIL:
+        return utils::metrics::pacingQueueDelayThumbnail;
+    case PacingPriority::PINNED:
+        return utils::metrics::pacingQueueDelayPinned;
+    case PacingPriority::SCREENSHARE:
+        return utils::metrics::pacingQueueDelayScreenShare;
+    default:
+        return utils::metrics::pacingQueueDelayVideo;
+    }
+}
+} // namespace
+
+PacingQueue::PacingQueue(uint32_t ipOverhead, uint64_t deadline)
+    : _ipOverhead(ipOverhead),
+      _deadline(deadline),
+      _slots(new Slot[capacity]),
+      _freeSlot(0),
+      _count(0),
+      _dropCount(0),
+      _activeHead(npos),
+      _activeTail(npos),
+      _priorityCount(0)
+{
+    clear();
+}
+
+void PacingQueue::setPriority(uint32_t ssrc, PacingPriority priority)
+{
+    bool found = false;
+    for (size_t i = 0; i < _priorityCount; ++i)
+    {
+        if (_priorities[i].ssrc == ssrc)
+        {
+            _priorities[i].priority = priority;
+            found = true;
+            break;
+        }
+    }
+
+    if (!found)
+    {
+        // overwrite an entry when full. Ssrcs of rewritten video are few and long lived
+        auto& entry = _priorities[_priorityCount < _priorities.size() ? _priorityCount++
+                                                                      : ssrc % _priorities.size()];
+        entry.ssrc = ssrc;
+        entry.priority = priority;
+    }
+
+    for (size_t i = 0; i < maxFlows; ++i)
+    {
+        if (_flows[i].ssrc == ssrc)
+        {
+            _flows[i].priority = priority;
+        }
+    }
+}
+
+PacingPriority PacingQueue::getPriority(uint32_t ssrc) const
+{
+    for (size_t i = 0; i < _priorityCount; ++i)
+    {
+        if (_priorities[i].ssrc == ssrc)
+        {
+            return _priorities[i].priority;
+        }
+    }
+    return PacingPriority::VIDEO;
+}
+
+// Flows stick to their ssrc while idle. A new ssrc takes over an idle flow. If all flows are busy, ssrcs share flows.
+uint32_t PacingQueue::findFlow(uint32_t ssrc)
+{
+    uint32_t idleFlow = npos;
+    for (uint32_t i = 0; i < maxFlows; ++i)
+    {
+        if (_flows[i].ssrc == ssrc)
+        {
+            return i;
+        }
+        if (idleFlow == npos && _flows[i].count == 0)
+        {
+            idleFlow = i;
+        }
+    }
+
+    const uint32_t flowIndex = (idleFlow != npos ? idleFlow : ssrc % maxFlows);
+    auto& flow = _flows[flowIndex];
+    if (flow.count == 0)
+    {
+        flow.ssrc = ssrc;
+        flow.priority = getPriority(ssrc);
+    }
+    return flowIndex;
+}
+
+bool PacingQueue::push(memory::UniquePacket packet, bool isRetransmission, uint64_t timestamp)
+{
+    const auto* rtpHeader = rtp::RtpHeader::fromPacket(*packet);
+    if (!rtpHeader || _freeSlot == npos)
+    {
+        return false;
+    }
+
+    const uint32_t flowIndex = isRetransmission ? rtxFlow : findFlow(rtpHeader->ssrc.get());
+
+    const uint32_t slotIndex = _freeSlot;
+    auto& slot = _slots[slotIndex];
+    _freeSlot = slot.next;
+    slot.rtpTimestamp = rtpHeader->timestamp.get();
+    slot.enqueueTimestamp = timestamp;
+    slot.packet = std::move(packet);
+    slot.next = npos;
+
+    auto& flow = _flows[flowIndex];
+    append(flow, slotIndex);
+    ++_count;
+
+    if (!isRetransmission && !flow.active)
+    {
+        activate(flowIndex);
+    }
+    return true;
+}
+
+memory::UniquePacket PacingQueue::fetch(size_t budget, uint64_t timestamp)
+{
+    auto& rtx = _flows[rtxFlow];
+    dropStale(rtx, timestamp, true);
+    if (rtx.count > 0)
+    {
+        if (budget < _slots[rtx.head].packet->getLength() + _ipOverhead)
+        {
+            return nullptr;
+        }
+        observeDelay(rtx, timestamp, true);
+        return popHead(rtx);
+    }
+
+    while (_activeHead != npos)
+    {
+        auto& flow = _flows[_activeHead];
+        dropStale(flow, timestamp, false);
+        if (flow.count == 0)
+        {
+            deactivateHead();
+            continue;
+        }
+
+        const int64_t length = _slots[flow.head].packet->getLength();
+        if (flow.deficit >= length)
+        {
+            if (budget < length + _ipOverhead)
+            {
+                return nullptr;
+            }
+
+            flow.deficit -= length;
+            observeDelay(flow, timestamp, false);
+            auto packet = popHead(flow);
+            if (flow.count == 0)
+            {
+                deactivateHead();
+            }
+            return packet;
+        }
+
+        // credit the flow for next round and let the others send
+        flow.deficit += quantum * getWeight(flow.priority);
+        if (_activeHead != _activeTail)
+        {
+            const uint32_t flowIndex = _activeHead;
+            _activeHead = flow.nextActive;
+            flow.nextActive = npos;
+            _flows[_activeTail].nextActive = flowIndex;
+            _activeTail = flowIndex;
+        }
+    }
+
+    return nullptr;
+}
+
+void PacingQueue::clear()
+{
+    for (size_t i = 0; i < capacity; ++i)
+    {
+        _slots[i].packet.reset();
+        _slots[i].next = (i + 1 < capacity ? i + 1 : npos);
+    }
+    _freeSlot = 0;
+    _count = 0;
+
+    for (auto& flow : _flows)
+    {
+        flow.head = npos;
+        flow.tail = npos;
+        flow.count = 0;
+        flow.nextActive = npos;
+        flow.deficit = 0;
+        flow.active = false;
+    }
+    _activeHead = npos;
+    _activeTail = npos;
+}
+
+void PacingQueue::append(Flow& flow, uint32_t slotIndex)
+{
+    if (flow.tail == npos)
+    {
+        flow.head = slotIndex;
+    }
+    else
+    {
+        _slots[flow.tail].next = slotIndex;
+    }
+    flow.tail = slotIndex;
+    ++flow.count;
+}
+
+memory::UniquePacket PacingQueue::popHead(Flow& flow)
+{
+    const uint32_t slotIndex = flow.head;
+    auto& slot = _slots[slotIndex];
+    flow.head = slot.next;
+    if (flow.head == npos)
+    {
+        flow.tail = npos;
+    }
+    --flow.count;
+    --_count;
+
+    auto packet = std::move(slot.packet);
+    slot.next = _freeSlot;
+    _freeSlot = slotIndex;
+    return packet;
+}
+
+void PacingQueue::observeDelay(const Flow& flow, uint64_t timestamp, bool isRetransmission) const
+{
+    const auto delay = timestamp - _slots[flow.head].enqueueTimestamp;
+    utils::metrics::pacingQueueDelay.observe(delay);
+    if (isRetransmission)
+    {
+        utils::metrics::pacingQueueDelayRtx.observe(delay);
+    }
+    else
+    {
+        getDelayHistogram(flow.priority).observe(delay);
+    }
+}
+
+void PacingQueue::dropStale(Flow& flow, uint64_t timestamp, bool isRetransmission)
+{
+    if (_deadline == 0)
+    {
+        return;
+    }
+
+    while (flow.count > 0 && utils::Time::diffGT(_slots[flow.head].enqueueTimestamp, timestamp, _deadline))
+    {
+        // the rest of a stale frame is of no use to the receiver
+        const auto rtpTimestamp = _slots[flow.head].rtpTimestamp;
+        do
+        {
+            popHead(flow);
+            ++_dropCount;
+        } while (!isRetransmission && flow.count > 0 && _slots[flow.head].rtpTimestamp == rtpTimestamp);
+    }
+}
+
+void PacingQueue::activate(uint32_t flowIndex)
+{
+    auto& flow = _flows[flowIndex];
+    flow.active = true;
+    flow.deficit = 0;
+    flow.nextActive = npos;
+    if (_activeTail == npos)
+    {
+        _activeHead = flowIndex;
+    }
+    else
+    {
+        _flows[_activeTail].nextActive = flowIndex;
+    }
+    _activeTail = flowIndex;
+}
+
+void PacingQueue::deactivateHead()
+{
+    auto& flow = _flows[_activeHead];
+    flow.active = false;
+    flow.deficit = 0;
+    _activeHead = flow.nextActive;
+    flow.nextActive = npos;
+    if (_activeHead == npos)
+    {
+        _activeTail = npos;
+    }
+}
+
+} // namespace transport
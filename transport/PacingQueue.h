@@ -0,0 +1,106 @@
+#pragma once
+#include "memory/PacketPoolAllocator.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+
+namespace transport
+{
+
+// Share of the pacing budget a video ssrc gets when the downlink is constrained
+enum class PacingPriority : uint8_t
+{
+    THUMBNAIL = 0,
+    VIDEO,
+    PINNED,
+    SCREENSHARE
+};
+
+/**
+ * Pacing queue for video with one flow per ssrc served by deficit round robin. Each flow is credited a quantum scaled
+ * by the weight of its priority per round, so a key frame burst on one ssrc is interleaved with the other ssrcs at its
+ * weight instead of delaying all of them. Retransmissions are kept in a separate flow that is served first.
+ * If a deadline is set, video that has waited longer than the deadline is dropped a frame at a time and stale
+ * retransmissions are dropped.
+ * Not thread safe. Used from the transport job queue only.
+ */
+class PacingQueue
+{
+public:
+    static constexpr size_t maxFlows = 32;
+    static constexpr size_t capacity = 1024;
+    static constexpr uint32_t quantum = 1200;
+
+    PacingQueue(uint32_t ipOverhead, uint64_t deadline);
+
+    void setPriority(uint32_t ssrc, PacingPriority priority);
+
+    bool push(memory::UniquePacket packet, bool isRetransmission, uint64_t timestamp);
+
+    // next packet that fits in the budget including ip overhead, or nullptr
+    memory::UniquePacket fetch(size_t budget, uint64_t timestamp);
+
+    void clear();
+
+    bool empty() const { return _count == 0; }
+    bool full() const { return _count >= capacity; }
+    size_t size() const { return _count - _flows[rtxFlow].count; }
+    size_t rtxSize() const { return _flows[rtxFlow].count; }
+    uint64_t getDropCount() const { return _dropCount; }
+
+private:
+    static constexpr uint32_t npos = ~0u;
+    static constexpr uint32_t rtxFlow = maxFlows;
+
+    struct Slot
+    {
+        memory::UniquePacket packet;
+        uint64_t enqueueTimestamp = 0;
+        uint32_t rtpTimestamp = 0;
+        uint32_t next = npos;
+    };
+
+    struct Flow
+    {
+        uint32_t ssrc = 0;
+        uint32_t head = npos;
+        uint32_t tail = npos;
+        uint32_t count = 0;
+        uint32_t nextActive = npos;
+        int64_t deficit = 0;
+        PacingPriority priority = PacingPriority::VIDEO;
+        bool active = false;
+    };
+
+    struct SsrcPriority
+    {
+        uint32_t ssrc = 0;
+        PacingPriority priority = PacingPriority::VIDEO;
+    };
+
+    uint32_t findFlow(uint32_t ssrc);
+    PacingPriority getPriority(uint32_t ssrc) const;
+    void append(Flow& flow, uint32_t slotIndex);
+    memory::UniquePacket popHead(Flow& flow);
+    void observeDelay(const Flow& flow, uint64_t timestamp, bool isRetransmission) const;
+    void dropStale(Flow& flow, uint64_t timestamp, bool isRetransmission);
+    void activate(uint32_t flowIndex);
+    void deactivateHead();
+
+    const uint32_t _ipOverhead;
+    const uint64_t _deadline;
+
+    std::unique_ptr<Slot[]> _slots;
+    uint32_t _freeSlot;
+    size_t _count;
+    uint64_t _dropCount;
+
+    std::array<Flow, maxFlows + 1> _flows;
+    uint32_t _activeHead;
+    uint32_t _activeTail;
+
+    std::array<SsrcPriority, 64> _priorities;
+    size_t _priorityCount;
+};
+
+} // namespace transport
@@ -23,6 +23,9 @@ public:
     virtual void registerRecordingListener(const SocketAddress& remotePort, IRecordingEvents* listener) = 0;
 
     virtual void unregisterRecordingListener(IRecordingEvents* listener) = 0;
+
+    // Packets are stored on this node in plain text and event acks are produced by the endpoint itself
+    virtual bool isLocalFileSink() const { return false; }
 };
 
 class RecordingEndpointImpl : public RecordingEndpoint
@@ -50,6 +53,7 @@ public:
 
     void registerListener(const std::string& stunUserName, Endpoint::IEvents* listener) override { assert(false); };
     void registerListener(const SocketAddress& remotePort, Endpoint::IEvents* listener) override { assert(false); };
+    void registerStunFastPath(const std::string& stunUserName, ice::StunFastPath* fastPath) override {}
 
     void unregisterListener(Endpoint::IEvents* listener) override { assert(false); };
     void unregisterListener(const SocketAddress& remotePort, Endpoint::IEvents* listener) override { assert(false); }
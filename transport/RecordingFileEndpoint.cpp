@@ -0,0 +1,599 @@
+#include "transport/RecordingFileEndpoint.h"
+#include "concurrency/ThreadUtils.h"
+#include "rtp/RtcpHeader.h"
+#include "rtp/RtpHeader.h"
+#include "transport/recp/RecControlHeader.h"
+#include "transport/recp/RecHeader.h"
+#include "utils/Time.h"
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstring>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace transport
+{
+
+namespace
+{
+const uint32_t commandQueueSize = 16 * 1024;
+
+// rtpdump RD_hdr_t and RD_packet_t, network byte order
+struct RtpDumpFileHeader
+{
+    uint32_t startSeconds;
+    uint32_t startMicroseconds;
+    uint32_t source;
+    uint16_t port;
+    uint16_t padding;
+};
+
+struct RtpDumpRecordHeader
+{
+    uint16_t length; // including this header
+    uint16_t packetLength; // 0 for RTCP
+    uint32_t offset; // ms since start of stream
+};
+
+const size_t recordHeaderSize = sizeof(RtpDumpRecordHeader);
+const size_t maxFileHeaderSize = 64 + sizeof(RtpDumpFileHeader);
+
+bool isDirectory(const std::string& path)
+{
+    struct stat info;
+    return !path.empty() && ::stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+} // namespace
+
+RecordingFileEndpoint::SegmentFile::SegmentFile(const std::string& baseName,
+    const SocketAddress& source,
+    const uint64_t startTimestamp,
+    uint64_t segmentSize,
+    uint32_t writeBufferSize)
+    : _baseName(baseName),
+      _source(source),
+      _startTimestamp(startTimestamp),
+      _startWallClock(utils::Time::now() -
+          std::chrono::nanoseconds(utils::Time::diff(startTimestamp, utils::Time::getAbsoluteTime()))),
+      _segmentSize(segmentSize),
+      _fd(-1),
+      _segmentIndex(0),
+      _segmentBytes(0),
+      _bytesWritten(0),
+      _lastFlushTime(utils::Time::getAbsoluteTime()),
+      _bufferSize(writeBufferSize),
+      _bufferLength(0)
+{
+}
+
+RecordingFileEndpoint::SegmentFile::~SegmentFile()
+{
+    flush();
+    if (_fd != -1)
+    {
+        ::close(_fd);
+    }
+}
+
+// The buffer can only be handed back when flushed, records of different files must not mix
+std::unique_ptr<uint8_t[]> RecordingFileEndpoint::SegmentFile::releaseBuffer()
+{
+    assert(_bufferLength == 0);
+    return std::move(_buffer);
+}
+
+bool RecordingFileEndpoint::SegmentFile::openNextSegment()
+{
+    if (_fd != -1)
+    {
+        ::close(_fd);
+        _fd = -1;
+    }
+
+    char fileName[PATH_MAX];
+    snprintf(fileName, sizeof(fileName), "%s.%04u.rtpdump", _baseName.c_str(), _segmentIndex++);
+    _fd = ::open(fileName, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (_fd == -1)
+    {
+        logger::error("failed to open recording segment %s, err %d", "RecordingFileEndpoint", fileName, errno);
+        return false;
+    }
+
+    // every segment starts with the rtpdump header so it can be played on its own
+    const int textLength = snprintf(reinterpret_cast<char*>(_buffer.get()),
+        maxFileHeaderSize - sizeof(RtpDumpFileHeader),
+        "#!rtpplay1.0 %s/%u\n",
+        _source.ipToString().c_str(),
+        _source.getPort());
+    _bufferLength = std::min(static_cast<size_t>(std::max(textLength, 0)),
+        maxFileHeaderSize - sizeof(RtpDumpFileHeader) - 1);
+
+    const auto sinceEpoch = std::chrono::duration_cast<std::chrono::microseconds>(_startWallClock.time_since_epoch());
+    RtpDumpFileHeader fileHeader;
+    fileHeader.startSeconds = htonl(static_cast<uint32_t>(sinceEpoch.count() / 1000000));
+    fileHeader.startMicroseconds = htonl(static_cast<uint32_t>(sinceEpoch.count() % 1000000));
+    fileHeader.source = (_source.getFamily() == AF_INET ? _source.getIpv4()->sin_addr.s_addr : 0);
+    fileHeader.port = htons(_source.getPort());
+    fileHeader.padding = 0;
+    std::memcpy(_buffer.get() + _bufferLength, &fileHeader, sizeof(fileHeader));
+    _bufferLength += sizeof(fileHeader);
+
+    _segmentBytes = 0;
+    return true;
+}
+
+// Records are never split between segments, so the buffer is flushed before it would cross the segment size
+bool RecordingFileEndpoint::SegmentFile::append(const memory::Packet& packet, const uint64_t timestamp)
+{
+    const size_t recordSize = recordHeaderSize + packet.getLength();
+    if (_bufferLength + recordSize > _bufferSize ||
+        (_segmentBytes + _bufferLength + recordSize > _segmentSize && _bufferLength > 0))
+    {
+        if (!flush())
+        {
+            return false;
+        }
+    }
+
+    if (_fd == -1 || _segmentBytes + recordSize > _segmentSize)
+    {
+        if (!openNextSegment())
+        {
+            return false;
+        }
+    }
+
+    RtpDumpRecordHeader recordHeader;
+    recordHeader.length = htons(recordSize);
+    recordHeader.packetLength = htons(rtp::isRtcpPacket(packet) ? 0 : packet.getLength());
+    recordHeader.offset = htonl(static_cast<uint32_t>(
+        std::max(int64_t(0), utils::Time::diff(_startTimestamp, timestamp)) / static_cast<int64_t>(utils::Time::ms)));
+    std::memcpy(_buffer.get() + _bufferLength, &recordHeader, sizeof(recordHeader));
+    std::memcpy(_buffer.get() + _bufferLength + recordHeaderSize, packet.get(), packet.getLength());
+    _bufferLength += recordSize;
+    return true;
+}
+
+bool RecordingFileEndpoint::SegmentFile::flush()
+{
+    _lastFlushTime = utils::Time::getAbsoluteTime();
+    if (_bufferLength == 0 || _fd == -1)
+    {
+        return true;
+    }
+
+    size_t offset = 0;
+    while (offset < _bufferLength)
+    {
+        const auto written = ::write(_fd, _buffer.get() + offset, _bufferLength - offset);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            logger::error("failed to write recording segment %s, err %d",
+                "RecordingFileEndpoint",
+                _baseName.c_str(),
+                errno);
+            _bufferLength = 0;
+            return false;
+        }
+        offset += written;
+    }
+
+    _segmentBytes += _bufferLength;
+    _bytesWritten += _bufferLength;
+    _bufferLength = 0;
+    return true;
+}
+
+RecordingFileEndpoint::RecordingFileEndpoint(const std::string& directory,
+    uint64_t segmentSize,
+    uint32_t writeBufferSize,
+    uint32_t writeBufferCount,
+    uint64_t flushInterval,
+    memory::PacketPoolAllocator& allocator)
+    : _name("RecordingFileEndpoint"),
+      _directory(directory),
+      _segmentSize(std::max(segmentSize, static_cast<uint64_t>(writeBufferSize))),
+      _writeBufferSize(std::max(writeBufferSize,
+          static_cast<uint32_t>(memory::Packet::size + recordHeaderSize + maxFileHeaderSize))),
+      _writeBufferCount(std::max(writeBufferCount, 1u)),
+      _flushInterval(flushInterval),
+      _allocator(allocator),
+      _isGood(isDirectory(directory)),
+      _state(State::CREATED),
+      _running(true),
+      _commands(commandQueueSize),
+      _writerWaiting(false),
+      _bytesWritten(0),
+      _droppedPackets(0),
+      _allocatedWriteBuffers(0)
+{
+    if (!_isGood)
+    {
+        logger::error("recording directory %s does not exist", _name.c_str(), directory.c_str());
+        return;
+    }
+
+    _thread = std::make_unique<std::thread>([this] { this->run(); });
+}
+
+RecordingFileEndpoint::~RecordingFileEndpoint()
+{
+    _running = false;
+    _commandsPending.post();
+    if (_thread)
+    {
+        _thread->join();
+    }
+    logger::debug("removed", _name.c_str());
+}
+
+void RecordingFileEndpoint::start()
+{
+    if (_isGood)
+    {
+        _state = State::CONNECTED;
+    }
+}
+
+void RecordingFileEndpoint::stop(IStopEvents* listener)
+{
+    std::lock_guard<std::mutex> locker(_registrationLock);
+    _running = false;
+    _commandsPending.post();
+    if (_thread)
+    {
+        _thread->join();
+        _thread.reset();
+    }
+    _state = State::CREATED;
+    listener->onEndpointStopped(this);
+}
+
+// The semaphore is only posted when the writer is about to block, to keep the media threads off its mutex
+bool RecordingFileEndpoint::pushCommand(Command&& command)
+{
+    if (!_commands.push(std::move(command)))
+    {
+        return false;
+    }
+
+    if (_writerWaiting.exchange(false))
+    {
+        _commandsPending.post();
+    }
+    return true;
+}
+
+// The lock keeps stop from joining the writer between the check and the push, so a queued command is always
+// processed. Without a writer there is nothing to record and unregistration completes inline.
+void RecordingFileEndpoint::registerRecordingListener(const SocketAddress& remotePort, IRecordingEvents* listener)
+{
+    std::lock_guard<std::mutex> locker(_registrationLock);
+    if (!_thread)
+    {
+        logger::warn("not recording %s, endpoint is stopped", _name.c_str(), remotePort.toString().c_str());
+        return;
+    }
+
+    while (!pushCommand(Command{Command::Type::Register, remotePort, listener, memory::UniquePacket(), 0}))
+    {
+        std::this_thread::yield();
+    }
+}
+
+void RecordingFileEndpoint::unregisterRecordingListener(IRecordingEvents* listener)
+{
+    std::lock_guard<std::mutex> locker(_registrationLock);
+    if (!_thread)
+    {
+        listener->onUnregistered(*this);
+        return;
+    }
+
+    while (!pushCommand(Command{Command::Type::Unregister, SocketAddress(), listener, memory::UniquePacket(), 0}))
+    {
+        std::this_thread::yield();
+    }
+}
+
+void RecordingFileEndpoint::sendTo(const transport::SocketAddress& target, memory::UniquePacket packet)
+{
+    if (!pushCommand(
+            Command{Command::Type::Packet, target, nullptr, std::move(packet), utils::Time::getAbsoluteTime()}))
+    {
+        ++_droppedPackets;
+    }
+}
+
+EndpointMetrics RecordingFileEndpoint::getMetrics(uint64_t timestamp) const
+{
+    return EndpointMetrics(_commands.size(), 0.0, 0.0, _droppedPackets);
+}
+
+std::string RecordingFileEndpoint::makeBaseName(const SocketAddress& target) const
+{
+    char baseName[PATH_MAX];
+    snprintf(baseName,
+        sizeof(baseName),
+        "%s/rec-%" PRId64 "-%s-%u",
+        _directory.c_str(),
+        static_cast<int64_t>(
+            std::chrono::duration_cast<std::chrono::seconds>(utils::Time::now().time_since_epoch()).count()),
+        target.ipToString().c_str(),
+        target.getPort());
+    return baseName;
+}
+
+void RecordingFileEndpoint::run()
+{
+    concurrency::setThreadName("RecWriter");
+    const uint32_t flushIntervalMs = std::max(uint64_t(1), _flushInterval / utils::Time::ms);
+
+    Command command;
+    for (;;)
+    {
+        bool gotCommand = false;
+        for (int i = 0; i < 1024 && _commands.pop(command); ++i)
+        {
+            gotCommand = true;
+            processCommand(command);
+            command.packet.reset();
+        }
+
+        flushIdleFiles(utils::Time::getAbsoluteTime());
+
+        if (!gotCommand)
+        {
+            if (!_running)
+            {
+                break;
+            }
+
+            // a command pushed before the flag was raised is seen by the empty check, later ones post
+            _writerWaiting = true;
+            if (_commands.empty() && _running)
+            {
+                _commandsPending.wait(flushIntervalMs);
+            }
+            _writerWaiting = false;
+        }
+    }
+
+    for (auto& it : _sinks)
+    {
+        flushSink(it.second);
+    }
+    _sinks.clear();
+    _freeWriteBuffers.clear();
+    _allocatedWriteBuffers = 0;
+}
+
+void RecordingFileEndpoint::processCommand(Command& command)
+{
+    switch (command.type)
+    {
+    case Command::Type::Register:
+    {
+        auto& sink = _sinks[command.target];
+        sink.listener = command.listener;
+        if (sink.baseName.empty())
+        {
+            sink.baseName = makeBaseName(command.target);
+        }
+        return;
+    }
+    case Command::Type::Unregister:
+        for (auto it = _sinks.begin(); it != _sinks.end();)
+        {
+            if (it->second.listener == command.listener)
+            {
+                flushSink(it->second);
+                it = _sinks.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        command.listener->onUnregistered(*this);
+        return;
+    case Command::Type::Packet:
+    {
+        auto it = _sinks.find(command.target);
+        if (it == _sinks.end() || !command.packet)
+        {
+            ++_droppedPackets;
+            return;
+        }
+
+        auto* file = getFile(it->second, command.target, *command.packet, command.timestamp);
+        if (!file)
+        {
+            ++_droppedPackets;
+            return;
+        }
+        if (!file->hasBuffer())
+        {
+            file->setBuffer(acquireWriteBuffer());
+        }
+
+        const auto bytesWritten = file->getBytesWritten();
+        const bool appended = file->append(*command.packet, command.timestamp);
+        _bytesWritten += file->getBytesWritten() - bytesWritten;
+        if (!appended)
+        {
+            ++_droppedPackets;
+            return;
+        }
+
+        if (recp::isRecPacket(*command.packet))
+        {
+            acknowledgeEvent(command.target, it->second.listener, *command.packet);
+        }
+        return;
+    }
+    }
+}
+
+RecordingFileEndpoint::SegmentFile* RecordingFileEndpoint::getFile(Sink& sink,
+    const SocketAddress& target,
+    const memory::Packet& packet,
+    const uint64_t timestamp)
+{
+    if (recp::isRecPacket(packet))
+    {
+        if (!sink.events)
+        {
+            sink.events = std::make_unique<SegmentFile>(sink.baseName + "-events",
+                target,
+                timestamp,
+                _segmentSize,
+                _writeBufferSize);
+        }
+        return sink.events.get();
+    }
+
+    uint32_t ssrc = 0;
+    if (rtp::isRtpPacket(packet))
+    {
+        ssrc = rtp::RtpHeader::fromPacket(packet)->ssrc;
+    }
+    else if (rtp::isRtcpPacket(packet))
+    {
+        ssrc = rtp::RtcpHeader::fromPtr(packet.get(), packet.getLength())->getReporterSsrc();
+    }
+    else
+    {
+        return nullptr;
+    }
+
+    auto& file = sink.streams[ssrc];
+    if (!file)
+    {
+        file = std::make_unique<SegmentFile>(sink.baseName + "-" + std::to_string(ssrc),
+            target,
+            timestamp,
+            _segmentSize,
+            _writeBufferSize);
+    }
+    return file.get();
+}
+
+void RecordingFileEndpoint::acknowledgeEvent(const SocketAddress& target,
+    IRecordingEvents* listener,
+    memory::Packet& packet)
+{
+    auto ackPacket = memory::makeUniquePacket(_allocator);
+    if (!ackPacket || !listener)
+    {
+        return;
+    }
+
+    const auto* recHeader = recp::RecHeader::fromPacket(packet);
+    auto* ack = recp::RecControlHeader::fromPtr(ackPacket->get(), recp::REC_CONTROL_HEADER_SIZE);
+    ack->id = 0x01;
+    ack->ackType = recp::AckType::EventAck;
+    ack->sequenceNumber = recHeader->sequenceNumber;
+    ackPacket->setLength(recp::REC_CONTROL_HEADER_SIZE);
+
+    listener->onRecControlReceived(*this, target, target, std::move(ackPacket));
+}
+
+void RecordingFileEndpoint::flushIdleFiles(const uint64_t timestamp)
+{
+    const auto flushIfIdle = [this, timestamp](SegmentFile& file) {
+        if (file.getBufferedBytes() > 0 && utils::Time::diffGE(file.getLastFlushTime(), timestamp, _flushInterval))
+        {
+            flushFile(file);
+        }
+    };
+
+    for (auto& it : _sinks)
+    {
+        for (auto& stream : it.second.streams)
+        {
+            flushIfIdle(*stream.second);
+        }
+        if (it.second.events)
+        {
+            flushIfIdle(*it.second.events);
+        }
+    }
+}
+
+void RecordingFileEndpoint::flushSink(Sink& sink)
+{
+    for (auto& stream : sink.streams)
+    {
+        flushFile(*stream.second);
+    }
+    if (sink.events)
+    {
+        flushFile(*sink.events);
+    }
+}
+
+void RecordingFileEndpoint::flushFile(SegmentFile& file)
+{
+    const auto bytesWritten = file.getBytesWritten();
+    file.flush();
+    _bytesWritten += file.getBytesWritten() - bytesWritten;
+    if (file.hasBuffer())
+    {
+        _freeWriteBuffers.push_back(file.releaseBuffer());
+    }
+}
+
+std::unique_ptr<uint8_t[]> RecordingFileEndpoint::acquireWriteBuffer()
+{
+    if (_freeWriteBuffers.empty())
+    {
+        if (_allocatedWriteBuffers < _writeBufferCount)
+        {
+            ++_allocatedWriteBuffers;
+            return std::unique_ptr<uint8_t[]>(new uint8_t[_writeBufferSize]);
+        }
+
+        auto* oldestFile = findOldestBufferingFile();
+        assert(oldestFile);
+        flushFile(*oldestFile);
+    }
+
+    auto buffer = std::move(_freeWriteBuffers.back());
+    _freeWriteBuffers.pop_back();
+    return buffer;
+}
+
+RecordingFileEndpoint::SegmentFile* RecordingFileEndpoint::findOldestBufferingFile()
+{
+    SegmentFile* oldestFile = nullptr;
+    const auto checkFile = [&oldestFile](SegmentFile& file) {
+        if (file.hasBuffer() &&
+            (!oldestFile || utils::Time::diffGT(file.getLastFlushTime(), oldestFile->getLastFlushTime(), 0)))
+        {
+            oldestFile = &file;
+        }
+    };
+
+    for (auto& it : _sinks)
+    {
+        for (auto& stream : it.second.streams)
+        {
+            checkFile(*stream.second);
+        }
+        if (it.second.events)
+        {
+            checkFile(*it.second.events);
+        }
+    }
+    return oldestFile;
+}
+
+} // namespace transport
@@ -0,0 +1,185 @@
+#pragma once
+#include "concurrency/MpmcQueue.h"
+#include "concurrency/Semaphore.h"
+#include "memory/PacketPoolAllocator.h"
+#include "transport/RecordingEndpoint.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace transport
+{
+
+/**
+ * Recording endpoint that stores the recording streams on this node instead of sending them to a recorder.
+ * Every registered recording transport gets a sequence of segment files per SSRC and one for its rec events. The
+ * files are in rtpdump format (rtpplay1.0), each record carrying the arrival time in ms since the start of the
+ * stream. RTP and RTCP are stored as sent, RTCP in the file of the reporting SSRC with the rtpdump plen set to 0.
+ *
+ * sendTo only queues the packet. A writer thread appends the packets to a large buffer per file and writes it
+ * with a single write call when full or after flushInterval, so the media threads never touch the disk.
+ * Files take their buffer from a pool of writeBufferCount buffers and return it when flushed. When all buffers are
+ * in use, the file that has buffered the longest is flushed to free one, so memory does not grow with the number
+ * of SSRCs. The writer blocks on a semaphore while the queue is empty. Rec events are acked by the writer thread
+ * once they have been buffered.
+ */
+class RecordingFileEndpoint : public RecordingEndpoint
+{
+public:
+    RecordingFileEndpoint(const std::string& directory,
+        uint64_t segmentSize,
+        uint32_t writeBufferSize,
+        uint32_t writeBufferCount,
+        uint64_t flushInterval,
+        memory::PacketPoolAllocator& allocator);
+
+    ~RecordingFileEndpoint();
+
+    void sendStunTo(const transport::SocketAddress& target,
+        ice::Int96 transactionId,
+        const void* data,
+        size_t len,
+        uint64_t timestamp) override
+    {
+        assert(false);
+    }
+
+    void cancelStunTransaction(ice::Int96 transactionId) override { assert(false); }
+
+    void registerListener(const std::string& stunUserName, Endpoint::IEvents* listener) override { assert(false); };
+    void registerListener(const SocketAddress& remotePort, Endpoint::IEvents* listener) override { assert(false); };
+    void registerDefaultListener(IEvents* defaultListener) override{};
+    void registerStunFastPath(const std::string& stunUserName, ice::StunFastPath* fastPath) override {}
+
+    void unregisterListener(Endpoint::IEvents* listener) override { assert(false); };
+    void unregisterListener(const SocketAddress& remotePort, Endpoint::IEvents* listener) override { assert(false); }
+
+    void registerRecordingListener(const SocketAddress& remotePort, IRecordingEvents* listener) override;
+    void unregisterRecordingListener(IRecordingEvents* listener) override;
+    bool isLocalFileSink() const override { return true; }
+
+    bool openPort(uint16_t port) override { return false; }
+    bool isGood() const override { return _isGood; }
+    ice::TransportType getTransportType() const override { return ice::TransportType::UDP; }
+    SocketAddress getLocalPort() const override { return SocketAddress(); }
+
+    void sendTo(const transport::SocketAddress& target, memory::UniquePacket packet) override;
+
+    void start() override;
+    void stop(IStopEvents* listener) override;
+
+    bool configureBufferSizes(size_t sendBufferSize, size_t receiveBufferSize) override { return true; }
+
+    const char* getName() const override { return _name.c_str(); }
+    State getState() const override { return _state; }
+
+    EndpointMetrics getMetrics(uint64_t timestamp) const override;
+
+    uint64_t getBytesWritten() const { return _bytesWritten; }
+    uint32_t getDroppedPackets() const { return _droppedPackets; }
+
+private:
+    struct Command
+    {
+        enum class Type
+        {
+            Register,
+            Unregister,
+            Packet
+        };
+
+        Type type;
+        SocketAddress target;
+        IRecordingEvents* listener;
+        memory::UniquePacket packet;
+        uint64_t timestamp;
+    };
+
+    class SegmentFile
+    {
+    public:
+        SegmentFile(const std::string& baseName,
+            const SocketAddress& source,
+            uint64_t startTimestamp,
+            uint64_t segmentSize,
+            uint32_t writeBufferSize);
+        ~SegmentFile();
+
+        bool append(const memory::Packet& packet, uint64_t timestamp);
+        bool flush();
+        bool hasBuffer() const { return _buffer != nullptr; }
+        void setBuffer(std::unique_ptr<uint8_t[]> buffer) { _buffer = std::move(buffer); }
+        std::unique_ptr<uint8_t[]> releaseBuffer();
+        uint64_t getLastFlushTime() const { return _lastFlushTime; }
+        uint64_t getBytesWritten() const { return _bytesWritten; }
+        size_t getBufferedBytes() const { return _bufferLength; }
+
+    private:
+        bool openNextSegment();
+
+        const std::string _baseName;
+        const SocketAddress _source;
+        const uint64_t _startTimestamp;
+        const std::chrono::system_clock::time_point _startWallClock;
+        const uint64_t _segmentSize;
+        int _fd;
+        uint32_t _segmentIndex;
+        uint64_t _segmentBytes;
+        uint64_t _bytesWritten;
+        uint64_t _lastFlushTime;
+        std::unique_ptr<uint8_t[]> _buffer;
+        const size_t _bufferSize;
+        size_t _bufferLength;
+    };
+
+    struct Sink
+    {
+        IRecordingEvents* listener;
+        std::string baseName;
+        std::unordered_map<uint32_t, std::unique_ptr<SegmentFile>> streams;
+        std::unique_ptr<SegmentFile> events;
+    };
+
+    void run();
+    bool pushCommand(Command&& command);
+    void processCommand(Command& command);
+    SegmentFile* getFile(Sink& sink, const SocketAddress& target, const memory::Packet& packet, uint64_t timestamp);
+    void acknowledgeEvent(const SocketAddress& target, IRecordingEvents* listener, memory::Packet& packet);
+    void flushIdleFiles(uint64_t timestamp);
+    void flushSink(Sink& sink);
+    void flushFile(SegmentFile& file);
+    std::unique_ptr<uint8_t[]> acquireWriteBuffer();
+    SegmentFile* findOldestBufferingFile();
+    std::string makeBaseName(const SocketAddress& target) const;
+
+    logger::LoggableId _name;
+    const std::string _directory;
+    const uint64_t _segmentSize;
+    const uint32_t _writeBufferSize;
+    const uint32_t _writeBufferCount;
+    const uint64_t _flushInterval;
+    memory::PacketPoolAllocator& _allocator;
+    bool _isGood;
+    std::atomic<State> _state;
+    std::atomic_bool _running;
+    concurrency::MpmcQueue<Command> _commands;
+    concurrency::Semaphore _commandsPending;
+    std::atomic_bool _writerWaiting;
+    std::atomic_uint64_t _bytesWritten;
+    std::atomic_uint32_t _droppedPackets;
+    std::mutex _registrationLock;
+
+    // owned by writer thread
+    std::unordered_map<SocketAddress, Sink> _sinks;
+    std::vector<std::unique_ptr<uint8_t[]>> _freeWriteBuffers;
+    uint32_t _allocatedWriteBuffers;
+
+    std::unique_ptr<std::thread> _thread; // must be last
+};
+
+} // namespace transport
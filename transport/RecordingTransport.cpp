@@ -74,7 +74,8 @@ RecordingTransport::RecordingTransport(jobmanager::JobManager& jobManager,
     logger::info("Recording client: %s", _loggableId.c_str(), _peerPort.toString().c_str());
 
     assert(_recordingEndpoint->isGood());
-    assert(recordingEndpoint->getLocalPort().getFamily() == remotePeer.getFamily());
+    assert(recordingEndpoint->isLocalFileSink() ||
+        recordingEndpoint->getLocalPort().getFamily() == remotePeer.getFamily());
 
     _recordingEndpoint->registerRecordingListener(_peerPort, this);
     ++_jobCounter;
@@ -84,7 +85,8 @@ RecordingTransport::RecordingTransport(jobmanager::JobManager& jobManager,
 
     _isInitialized = true;
 
-    if (recordingEndpoint->getLocalPort().getFamily() != remotePeer.getFamily())
+    if (!recordingEndpoint->isLocalFileSink() &&
+        recordingEndpoint->getLocalPort().getFamily() != remotePeer.getFamily())
     {
         logger::error("ip family mismatch. local ip family: %d, remote ip family: %d",
             _loggableId.c_str(),
@@ -137,25 +139,33 @@ void RecordingTransport::protectAndSend(memory::UniquePacket packet, const Socke
         auto* rtpHeader = rtp::RtpHeader::fromPacket(*packet);
         auto roc = getRolloverCounter(rtpHeader->ssrc, rtpHeader->sequenceNumber);
 
-        uint8_t iv[crypto::DEFAULT_AES_IV_SIZE];
-        _ivGenerator->generateForRtp(rtpHeader->ssrc, roc, rtpHeader->sequenceNumber, iv, crypto::DEFAULT_AES_IV_SIZE);
-
-        auto payload = rtpHeader->getPayload();
-
-        auto headerLength = rtpHeader->headerLength();
-        auto payloadLength = packet->getLength() - headerLength;
-        uint16_t encryptedLength = _config.mtu - headerLength;
-
-        _aes->gcmEncrypt(payload,
-            payloadLength,
-            reinterpret_cast<unsigned char*>(payload),
-            encryptedLength,
-            iv,
-            crypto::DEFAULT_AES_IV_SIZE,
-            reinterpret_cast<unsigned char*>(rtpHeader),
-            headerLength);
-
-        packet->setLength(headerLength + encryptedLength);
+        // local file sink stores the payload in plain text
+        if (!_recordingEndpoint->isLocalFileSink())
+        {
+            uint8_t iv[crypto::DEFAULT_AES_IV_SIZE];
+            _ivGenerator->generateForRtp(rtpHeader->ssrc,
+                roc,
+                rtpHeader->sequenceNumber,
+                iv,
+                crypto::DEFAULT_AES_IV_SIZE);
+
+            auto payload = rtpHeader->getPayload();
+
+            auto headerLength = rtpHeader->headerLength();
+            auto payloadLength = packet->getLength() - headerLength;
+            uint16_t encryptedLength = _config.mtu - headerLength;
+
+            _aes->gcmEncrypt(payload,
+                payloadLength,
+                reinterpret_cast<unsigned char*>(payload),
+                encryptedLength,
+                iv,
+                crypto::DEFAULT_AES_IV_SIZE,
+                reinterpret_cast<unsigned char*>(rtpHeader),
+                headerLength);
+
+            packet->setLength(headerLength + encryptedLength);
+        }
 
         const auto timestamp = utils::Time::getAbsoluteTime();
 
@@ -194,26 +204,29 @@ void RecordingTransport::protectAndSend(memory::UniquePacket packet, const Socke
             onSendingStreamRemovedEvent(*packet);
         }
 
-        uint8_t iv[crypto::DEFAULT_AES_IV_SIZE];
-        _ivGenerator->generateForRec(static_cast<uint8_t>(recHeader->event),
-            recHeader->sequenceNumber,
-            recHeader->timestamp,
-            iv,
-            crypto::DEFAULT_AES_IV_SIZE);
-
-        auto payloadLength = packet->getLength() - recp::REC_HEADER_SIZE;
-        uint16_t encryptedLength = _config.mtu - recp::REC_HEADER_SIZE;
-
-        _aes->gcmEncrypt(payload,
-            payloadLength,
-            reinterpret_cast<unsigned char*>(payload),
-            encryptedLength,
-            iv,
-            crypto::DEFAULT_AES_IV_SIZE,
-            reinterpret_cast<unsigned char*>(recHeader),
-            recp::REC_HEADER_SIZE);
-
-        packet->setLength(recp::REC_HEADER_SIZE + encryptedLength);
+        if (!_recordingEndpoint->isLocalFileSink())
+        {
+            uint8_t iv[crypto::DEFAULT_AES_IV_SIZE];
+            _ivGenerator->generateForRec(static_cast<uint8_t>(recHeader->event),
+                recHeader->sequenceNumber,
+                recHeader->timestamp,
+                iv,
+                crypto::DEFAULT_AES_IV_SIZE);
+
+            auto payloadLength = packet->getLength() - recp::REC_HEADER_SIZE;
+            uint16_t encryptedLength = _config.mtu - recp::REC_HEADER_SIZE;
+
+            _aes->gcmEncrypt(payload,
+                payloadLength,
+                reinterpret_cast<unsigned char*>(payload),
+                encryptedLength,
+                iv,
+                crypto::DEFAULT_AES_IV_SIZE,
+                reinterpret_cast<unsigned char*>(recHeader),
+                recp::REC_HEADER_SIZE);
+
+            packet->setLength(recp::REC_HEADER_SIZE + encryptedLength);
+        }
         _recordingEndpoint->sendTo(target, std::move(packet));
     }
     else if (rtp::isRtcpPacket(*packet))
@@ -5,6 +5,7 @@
 #include "memory/AudioPacketPoolAllocator.h"
 #include "memory/PacketPoolAllocator.h"
 #include "transport/DataReceiver.h"
+#include "transport/PacingQueue.h"
 #include "transport/PacketCounters.h"
 #include "transport/RtpReceiveState.h"
 #include "transport/RtpSenderState.h"
@@ -34,6 +35,10 @@ namespace jobmanager
 {
 class JobQueue;
 }
+namespace logger
+{
+class PacketCapture;
+}
 
 namespace transport
 {
@@ -57,6 +62,7 @@ public:
     virtual bool isGatheringComplete() const = 0;
     virtual ice::IceCandidates getLocalCandidates() = 0;
     virtual std::pair<std::string, std::string> getLocalIceCredentials() = 0;
+    virtual bool isIceLite() const = 0;
 
     virtual bool setRemotePeer(const SocketAddress& target) = 0;
     virtual const SocketAddress& getRemotePeer() const = 0;
@@ -78,6 +84,7 @@ public:
         utils::Optional<uint8_t> telephoneEventPayloadType,
         uint32_t rtpFrequency) = 0;
     virtual void setAbsSendTimeExtensionId(uint8_t extensionId) = 0;
+    virtual void setTransportCcExtensionId(uint8_t extensionId) = 0;
 
     virtual bool isIceEnabled() const = 0;
 
@@ -100,12 +107,16 @@ public:
     virtual uint64_t getInboundPacketCount() const = 0;
 
     virtual void setRtxProbeSource(const uint32_t ssrc, uint32_t* sequenceCounter, const uint16_t payloadType) = 0;
+    // share of pacing budget for outbound video ssrc. Call on the transport job queue
+    virtual void setPacingPriority(uint32_t ssrc, PacingPriority priority) = 0;
 
     virtual void runTick(uint64_t timestamp) = 0;
     virtual ice::IceSession::State getIceState() const = 0;
     virtual SrtpClient::State getDtlsState() const = 0;
 
     virtual utils::Optional<ice::TransportType> getSelectedTransportType() const = 0;
+    // binding requests answered on the receive thread of a shared port
+    virtual uint64_t getIceFastPathResponseCount() const = 0;
 
     virtual void setTag(const char* tag) = 0;
     virtual const char* getTag() const = 0;
@@ -113,6 +124,9 @@ public:
     virtual uint64_t getLastReceivedPacketTimestamp() const = 0;
     virtual void getSdesKeys(std::vector<srtp::AesKey>& sdesKeys) const = 0;
     virtual void asyncSetRemoteSdesKey(const srtp::AesKey& key) = 0;
+
+    // plain text RTP and RTCP is captured until set to nullptr
+    virtual void asyncSetPacketCapture(std::shared_ptr<logger::PacketCapture> packetCapture) = 0;
 };
 
 std::shared_ptr<RtcTransport> createTransport(jobmanager::JobManager& jobmanager,
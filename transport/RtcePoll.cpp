@@ -32,7 +32,7 @@ class RtcePollImpl : public RtcePoll
     };
 
 public:
-    RtcePollImpl();
+    RtcePollImpl(const concurrency::PollConfig& pollConfig, uint32_t socketBusyPollUs);
     ~RtcePollImpl();
 
     void run() override;
@@ -52,7 +52,8 @@ private:
 
     bool listenSocketEvents(RtcePoll::IEventListener* listener, int fd);
     bool unlistenSocketEvents(int fd);
-    void awaitSocketEvents(int64_t timeoutMs);
+    int awaitSocketEvents(int64_t timeoutMs);
+    void enableSocketBusyPoll(int fd);
 
     struct SocketRegistration
     {
@@ -73,14 +74,21 @@ private:
     concurrency::MpmcQueue<SocketRegistration> _pendingRegistrations;
     std::unordered_map<int, SocketRegistration> _monitoredSockets;
 
+    const concurrency::PollConfig _pollConfig;
+    const uint32_t _socketBusyPollUs;
+    bool _socketBusyPollFailed;
+
     std::atomic_bool _running;
     std::unique_ptr<std::thread> _networkThread;
 };
 
-RtcePollImpl::RtcePollImpl()
+RtcePollImpl::RtcePollImpl(const concurrency::PollConfig& pollConfig, uint32_t socketBusyPollUs)
     : _kernel_fd(-1),
       _firedEvents(100),
       _pendingRegistrations(2048),
+      _pollConfig(pollConfig),
+      _socketBusyPollUs(pollConfig.busyPoll ? socketBusyPollUs : 0),
+      _socketBusyPollFailed(false),
       _running(false),
       _networkThread(nullptr)
 {
@@ -143,6 +151,10 @@ bool RtcePollImpl::listenSocketEvents(RtcePoll::IEventListener* listener, int fd
     {
         return false;
     }
+    if (socketType == SOCK_DGRAM && _socketBusyPollUs > 0)
+    {
+        enableSocketBusyPoll(fd);
+    }
 #ifdef __APPLE__
     struct kevent readEvent;
 
@@ -214,10 +226,28 @@ bool RtcePollImpl::unlistenSocketEvents(int fd)
 #endif
 }
 
+void RtcePollImpl::enableSocketBusyPoll(int fd)
+{
+#ifdef SO_BUSY_POLL
+    int busyPollUs = static_cast<int>(_socketBusyPollUs);
+    bool success = 0 == setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &busyPollUs, sizeof(busyPollUs));
+#ifdef SO_PREFER_BUSY_POLL
+    int preferBusyPoll = 1;
+    success = success && 0 == setsockopt(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &preferBusyPoll, sizeof(preferBusyPoll));
+#endif
+    if (!success && !_socketBusyPollFailed)
+    {
+        _socketBusyPollFailed = true;
+        logger::warn("Failed to enable socket busy poll, err %d. Requires CAP_NET_ADMIN", "RtcePoll", errno);
+    }
+#endif
+}
+
 // This thread is time critical.
 void RtcePollImpl::run()
 {
     concurrency::setThreadName("Rtce");
+    concurrency::setAffinity(_pollConfig);
 
     while (_running)
     {
@@ -238,7 +268,17 @@ void RtcePollImpl::run()
             }
         }
 
-        awaitSocketEvents(100);
+        if (_pollConfig.busyPoll)
+        {
+            if (awaitSocketEvents(0) == 0)
+            {
+                concurrency::cpuRelax();
+            }
+        }
+        else
+        {
+            awaitSocketEvents(100);
+        }
     }
 }
 
@@ -246,7 +286,7 @@ void RtcePollImpl::run()
     On Mac we could add a user event to wake it up when there are pending registrations.
     But it does not seem to be that easy on linux unless you create some in mem file and close it.
 */
-void RtcePollImpl::awaitSocketEvents(int64_t timeoutMs)
+int RtcePollImpl::awaitSocketEvents(int64_t timeoutMs)
 {
 #ifdef __APPLE__
     const struct timespec timeout
@@ -317,6 +357,7 @@ void RtcePollImpl::awaitSocketEvents(int64_t timeoutMs)
     {
         logger::error("failed to wait for socket event. err: %d", "", errno);
     }
+    return event_count;
 }
 
 bool RtcePollImpl::add(int fd, RtcePoll::IEventListener* listener)
@@ -330,9 +371,9 @@ bool RtcePollImpl::remove(int fd, RtcePoll::IEventListener* listener)
     return _pendingRegistrations.push(SocketRegistration{UNREGISTER, listener, fd});
 }
 
-std::unique_ptr<RtcePoll> createRtcePoll()
+std::unique_ptr<RtcePoll> createRtcePoll(const concurrency::PollConfig& pollConfig, uint32_t socketBusyPollUs)
 {
-    return std::make_unique<RtcePollImpl>();
+    return std::make_unique<RtcePollImpl>(pollConfig, socketBusyPollUs);
 }
 
 } // namespace transport
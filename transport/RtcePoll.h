@@ -1,4 +1,5 @@
 #pragma once
+#include "concurrency/ThreadUtils.h"
 #include <memory>
 namespace transport
 {
@@ -30,6 +31,10 @@ public:
     virtual bool isRunning() const = 0;
 };
 
-std::unique_ptr<RtcePoll> createRtcePoll();
+// In busy poll mode the event thread never blocks in the kernel. A non zero socketBusyPollUs also enables
+// SO_BUSY_POLL on registered sockets, which needs CAP_NET_ADMIN above the net.core.busy_read sysctl value. It is
+// ignored unless pollConfig.busyPoll is set, as a socket busy polling on an unpinned thread only burns cpu.
+std::unique_ptr<RtcePoll> createRtcePoll(const concurrency::PollConfig& pollConfig = concurrency::PollConfig(),
+    uint32_t socketBusyPollUs = 0);
 
 } // namespace transport
\ No newline at end of file
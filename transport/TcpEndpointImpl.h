@@ -93,6 +93,7 @@ public:
     void registerListener(const std::string& stunUserName, IEvents* listener) override;
     void registerListener(const SocketAddress& remotePort, IEvents* listener) override;
     void registerDefaultListener(IEvents* defaultListener) override;
+    void registerStunFastPath(const std::string& stunUserName, ice::StunFastPath* fastPath) override {}
 
     void unregisterListener(IEvents* listener) override;
     void unregisterListener(const SocketAddress& remotePort, IEvents* listener) override{};
@@ -2,6 +2,7 @@
 #include "concurrency/MpmcHashmap.h"
 #include "config/Config.h"
 #include "memory/PacketPoolAllocator.h"
+#include "transport/RecordingFileEndpoint.h"
 #include "transport/RecordingTransport.h"
 #include "transport/RtcTransport.h"
 #include "transport/TcpEndpoint.h"
@@ -56,6 +57,7 @@ public:
           _config(config),
           _sctpConfig(sctpConfig),
           _iceConfig(iceConfig),
+          _fullIceConfig(iceConfig),
           _bweConfig(bweConfig),
           _rateControllerConfig(rateControllerConfig),
           _interfaces(interfaces),
@@ -73,6 +75,7 @@ public:
 #else
         const size_t receiveBufferSize = 40 * 1024 * 1024;
 #endif
+        _fullIceConfig.lite = false;
         if (config.ice.singlePort != 0)
         {
             for (uint32_t portOffset = 0; portOffset < std::max(1u, config.ice.sharedPorts.get()); ++portOffset)
@@ -134,7 +137,32 @@ public:
                 }
             }
         }
-        if (config.recording.singlePort != 0)
+        if (!config.recording.localDirectory.get().empty())
+        {
+            auto endPoint = std::shared_ptr<RecordingEndpoint>(
+                new RecordingFileEndpoint(config.recording.localDirectory.get(),
+                    config.recording.localSegmentSize,
+                    config.recording.localWriteBufferSize,
+                    config.recording.localWriteBuffers,
+                    config.recording.localFlushInterval,
+                    _mainAllocator),
+                getDeleter());
+
+            if (endPoint->isGood())
+            {
+                logger::info("recording to local directory %s", _name, config.recording.localDirectory.get().c_str());
+                _sharedRecordingEndpoints.emplace_back(std::vector<std::shared_ptr<RecordingEndpoint>>{endPoint});
+                endPoint->start();
+            }
+            else
+            {
+                _good = false;
+                logger::error("failed to open local recording directory %s",
+                    _name,
+                    config.recording.localDirectory.get().c_str());
+            }
+        }
+        else if (config.recording.singlePort != 0)
         {
             for (uint32_t portOffset = 0; portOffset < std::max(1u, config.recording.sharedPorts.get()); ++portOffset)
             {
@@ -393,7 +421,7 @@ public:
                 endpointIdHash,
                 _config,
                 _sctpConfig,
-                _iceConfig,
+                _fullIceConfig,
                 iceRole,
                 _bweConfig,
                 _rateControllerConfig,
@@ -424,7 +452,7 @@ public:
             endpointId,
             _config,
             _sctpConfig,
-            _iceConfig,
+            _fullIceConfig,
             iceRole,
             _bweConfig,
             _rateControllerConfig,
@@ -511,7 +539,7 @@ public:
                     ++endpointIndex)
                 {
                     auto endpoint = _sharedRecordingEndpoints[listIndex][endpointIndex];
-                    if (endpoint->getLocalPort().getFamily() == peer.getFamily())
+                    if (endpoint->isLocalFileSink() || endpoint->getLocalPort().getFamily() == peer.getFamily())
                     {
                         return createRecordingTransport(_jobManager,
                             _config,
@@ -549,6 +577,17 @@ public:
         return metrics;
     }
 
+    void getSharedUdpEndpointsFlows(std::vector<FlowStats>& flows, size_t maxCount) const override
+    {
+        for (auto& endpoints : _sharedEndpoints)
+        {
+            for (auto& endpoint : endpoints)
+            {
+                static_cast<const UdpEndpoint&>(*endpoint).getFlows(flows, maxCount);
+            }
+        }
+    }
+
     bool isGood() const override { return _good; }
 
     void maintenance(uint64_t timestamp) override
@@ -665,6 +704,8 @@ private:
     const config::Config& _config;
     const sctp::SctpConfig& _sctpConfig;
     const ice::IceConfig& _iceConfig;
+    // ice-lite is only used on shared ports. Private ports and barbells run full ICE
+    ice::IceConfig _fullIceConfig;
     const bwe::Config& _bweConfig;
     const bwe::RateControllerConfig& _rateControllerConfig;
     const std::vector<SocketAddress> _interfaces;
@@ -76,6 +76,7 @@ public:
         const uint8_t aesKey[32],
         const uint8_t salt[12]) = 0;
     virtual EndpointMetrics getSharedUdpEndpointsMetrics() const = 0;
+    virtual void getSharedUdpEndpointsFlows(std::vector<FlowStats>& flows, size_t maxCount) const = 0;
     virtual bool isGood() const = 0;
 
     virtual std::shared_ptr<RtcTransport> createOnPorts(const ice::IceRole iceRole,
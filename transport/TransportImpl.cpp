@@ -8,9 +8,11 @@
 #include "ice/IceSerialize.h"
 #include "ice/IceSession.h"
 #include "logger/Logger.h"
+#include "logger/PacketCapture.h"
 #include "logger/PacketLogger.h"
 #include "memory/AudioPacketPoolAllocator.h"
 #include "rtp/RtcpFeedback.h"
+#include "rtp/RtcpTransportFeedback.h"
 #include "rtp/RtpHeader.h"
 #include "sctp/SctpAssociation.h"
 #include "transport/DtlsJob.h"
@@ -18,6 +20,7 @@
 #include "transport/SctpJob.h"
 #include "transport/ice/IceSerialize.h"
 #include "utils/Function.h"
+#include "utils/Metrics.h"
 #include "utils/SocketAddress.h"
 #include "utils/StdExtensions.h"
 #include <arpa/inet.h>
@@ -293,7 +296,7 @@ public:
         {
             return;
         }
-        _transport.doRunTick(utils::Time::getAbsoluteTime());
+        _transport.doRunTick(utils::Time::getApproximateTime());
     }
 
 private:
@@ -395,12 +398,15 @@ TransportImpl::TransportImpl(jobmanager::JobManager& jobmanager,
       _inboundSsrcCounters(16),
       _isRunning(true),
       _absSendTimeExtensionId(0),
+      _transportCcExtensionId(0),
       _videoRtxPayloadType(96),
       _sctpConfig(sctpConfig),
       _bwe(std::make_unique<bwe::BandwidthEstimator>(bweConfig)),
+      _transportCc(_randomGenerator.next()),
       _rateController(_loggableId.getInstanceId(), rateControllerConfig),
       _rtxProbeSsrc(0),
       _rtxProbeSequenceCounter(nullptr),
+      _pacingQueue(_config.ipOverhead, _config.rctl.pacingDeadlineMs * utils::Time::ms),
       _pacingInUse(false),
       _iceState(ice::IceSession::State::IDLE),
       _dtlsState(SrtpClient::State::IDLE),
@@ -499,12 +505,15 @@ TransportImpl::TransportImpl(jobmanager::JobManager& jobmanager,
       _inboundSsrcCounters(expectedInboundStreamCount),
       _isRunning(true),
       _absSendTimeExtensionId(0),
+      _transportCcExtensionId(0),
       _videoRtxPayloadType(96),
       _sctpConfig(sctpConfig),
       _bwe(std::make_unique<bwe::BandwidthEstimator>(bweConfig)),
+      _transportCc(_randomGenerator.next()),
       _rateController(_loggableId.getInstanceId(), rateControllerConfig),
       _rtxProbeSsrc(0),
       _rtxProbeSequenceCounter(nullptr),
+      _pacingQueue(_config.ipOverhead, _config.rctl.pacingDeadlineMs * utils::Time::ms),
       _pacingInUse(false),
       _iceState(ice::IceSession::State::IDLE),
       _dtlsState(SrtpClient::State::IDLE),
@@ -797,6 +806,7 @@ void TransportImpl::internalRtpReceived(Endpoint& endpoint,
     }
 
     packet->endpointIdHash = _endpointIdHash;
+    packet->receiveTimestamp = timestamp;
 
     bool rembReady = false;
     if (_absSendTimeExtensionId)
@@ -817,6 +827,15 @@ void TransportImpl::internalRtpReceived(Endpoint& endpoint,
         }
     }
 
+    if (_transportCcExtensionId)
+    {
+        uint16_t transportSequenceNumber = 0;
+        if (rtp::getTransportWideSequenceNumber(*packet, _transportCcExtensionId, transportSequenceNumber))
+        {
+            _transportCc.feedbackBuilder.onPacketReceived(transportSequenceNumber, timestamp);
+        }
+    }
+
     const uint32_t ssrc = rtpHeader->ssrc;
     const auto rtpFrequency = _audio.containsPayload(rtpHeader->payloadType) ? _audio.rtpFrequency : 90000;
     auto& ssrcState = getInboundSsrc(ssrc, rtpFrequency);
@@ -842,6 +861,13 @@ void TransportImpl::internalRtpReceived(Endpoint& endpoint,
         sendReports(timestamp, rembReady);
     }
 
+    if (_transportCc.feedbackBuilder.hasPendingFeedback() &&
+        (utils::Time::diffGE(_transportCc.lastFeedbackTime, timestamp, utils::Time::ms * 50) ||
+            _transportCc.feedbackBuilder.getPendingCount() >= rtp::TransportFeedbackBuilder::maxPacketsPerFeedback / 2))
+    {
+        sendTransportFeedback(timestamp);
+    }
+
     if (ssrcState.currentRtpSource != source)
     {
         logger::debug("RTP ssrc %u from %s", _loggableId.c_str(), ssrc, source.toString().c_str());
@@ -953,6 +979,7 @@ void TransportImpl::internalRtcpReceived(Endpoint& endpoint,
     }
 
     const auto receiveTime = timestamp;
+    packet->receiveTimestamp = timestamp;
 
     _bwe->onUnmarkedTraffic(packet->getLength(), timestamp);
 
@@ -1091,7 +1118,7 @@ void TransportImpl::internalIceReceived(Endpoint& endpoint,
             dataReceiver->onIceReceived(this, timestamp);
         }
         auto newTimeout = _rtpIceSession->nextTimeout(timestamp);
-        if (newTimeout != timeout)
+        if (newTimeout >= 0 && newTimeout != timeout)
         {
             _jobQueue.getJobManager().replaceTimedJob<IceTimerTriggerJob>(getId(),
                 IceTimerTriggerJob::TIMER_ID,
@@ -1214,6 +1241,15 @@ void TransportImpl::processRtcpReport(const rtp::RtcpHeader& header,
             _outboundMetrics.estimatedKbps = _rateController.getTargetRate();
         }
     }
+    else if (rtp::isTransportFeedback(&header))
+    {
+        if (_uplinkEstimationEnabled)
+        {
+            _rateController.onTransportFeedbackReceived(timestamp,
+                reinterpret_cast<const rtp::RtcpTransportFeedback&>(header));
+            _outboundMetrics.estimatedKbps = _rateController.getTargetRate();
+        }
+    }
     else if (rtp::isRemb(&header))
     {
         const auto& remb = reinterpret_cast<const rtp::RtcpRembFeedback&>(header);
@@ -1272,9 +1308,16 @@ RtpReceiveState& TransportImpl::getInboundSsrc(const uint32_t ssrc, uint32_t rtp
 
 RtpSenderState& TransportImpl::getOutboundSsrc(const uint32_t ssrc, const uint32_t rtpFrequency)
 {
+    auto& cacheEntry = _outboundSsrcCache[ssrc % (sizeof(_outboundSsrcCache) / sizeof(_outboundSsrcCache[0]))];
+    if (cacheEntry.senderState && cacheEntry.ssrc == ssrc)
+    {
+        return *cacheEntry.senderState;
+    }
+
     auto ssrcIt = _outboundSsrcCounters.find(ssrc);
     if (ssrcIt != _outboundSsrcCounters.cend())
     {
+        cacheEntry = {ssrc, &ssrcIt->second};
         return ssrcIt->second;
     }
 
@@ -1290,9 +1333,14 @@ RtpSenderState& TransportImpl::getOutboundSsrc(const uint32_t ssrc, const uint32
         }
         logger::warn("unexpected number of outbound streams. Discarding %u", _loggableId.c_str(), nominee->first);
         _outboundSsrcCounters.erase(nominee->first);
+        for (auto& entry : _outboundSsrcCache)
+        {
+            entry = OutboundSsrcCacheEntry();
+        }
     }
 
     auto pairIt = _outboundSsrcCounters.emplace(ssrc, rtpFrequency, _config);
+    cacheEntry = {ssrc, &pairIt.first->second};
     return pairIt.first->second; // TODO error check
 }
 
@@ -1495,6 +1543,11 @@ void TransportImpl::doProtectAndSend(uint64_t timestamp,
     ++_outboundMetrics.packetCount;
 
     assert(packet->getLength() + 24 <= _config.mtu);
+    if (_packetCapture && endpoint)
+    {
+        _packetCapture->capture(*packet, logger::PacketCapture::Direction::Outbound, timestamp);
+    }
+
     if (endpoint && _srtpClient->protect(*packet))
     {
         _sendRateTracker.update(packet->getLength(), timestamp);
@@ -1536,6 +1589,11 @@ void TransportImpl::sendPadding(uint64_t timestamp)
                 rtp::GeneralExtension1Byteheader absSendTime(_absSendTimeExtensionId, 3);
                 auto cursor = extensionHead.extensions().begin();
                 extensionHead.addExtension(cursor, absSendTime);
+                if (_transportCcExtensionId)
+                {
+                    rtp::GeneralExtension1Byteheader transportSequenceNumber(_transportCcExtensionId, 2);
+                    extensionHead.addExtension(cursor, transportSequenceNumber);
+                }
                 padRtpHeader->setExtensions(extensionHead);
             }
 
@@ -1550,23 +1608,12 @@ void TransportImpl::sendPadding(uint64_t timestamp)
     }
 }
 
-namespace
-{
-template <typename T>
-void clearPacingQueueIfFull(T& pacingQueue)
-{
-    if (pacingQueue.full())
-    {
-        pacingQueue.clear();
-    }
-}
-} // namespace
 void TransportImpl::protectAndSend(memory::UniquePacket packet)
 {
     DBGCHECK_SINGLETHREADED(_singleThreadMutex);
 
     assert(_srtpClient);
-    const auto timestamp = utils::Time::getAbsoluteTime();
+    const auto timestamp = utils::Time::getApproximateTime();
 
     if (!_srtpClient->isConnected() || !_selectedRtp)
     {
@@ -1584,15 +1631,13 @@ void TransportImpl::protectAndSend(memory::UniquePacket packet)
         const auto payloadType = rtpHeader->payloadType;
         const auto isAudio = (payloadType <= 8 || _audio.containsPayload(payloadType));
 
-        clearPacingQueueIfFull(_pacingQueue);
-        clearPacingQueueIfFull(_rtxPacingQueue);
-        if (payloadType == _videoRtxPayloadType)
-        {
-            _rtxPacingQueue.push_front(std::move(packet));
-        }
-        else if (!isAudio)
+        if (!isAudio)
         {
-            _pacingQueue.push_front(std::move(packet));
+            if (_pacingQueue.full())
+            {
+                _pacingQueue.clear();
+            }
+            _pacingQueue.push(std::move(packet), payloadType == _videoRtxPayloadType, timestamp);
         }
         else
         {
@@ -1623,7 +1668,7 @@ void TransportImpl::sendReports(uint64_t timestamp, bool rembReady)
         }
 
         logger::info("Estimates 5s, Downlink %u - %ukbps, rate %.1fkbps, Uplink rctl %.0fkbps, rate %.1fkbps, remb "
-                     "%ukbps, rtt %.1fms, pacingQ %zu, rtpProbingEnabled %s, maxjitter %.2f",
+                     "%ukbps, rtt %.1fms, pacingQ %zu, pacing drops %" PRIu64 ", rtpProbingEnabled %s, maxjitter %.2f",
             _loggableId.c_str(),
             oldMin,
             oldMax,
@@ -1632,7 +1677,8 @@ void TransportImpl::sendReports(uint64_t timestamp, bool rembReady)
             _sendRateTracker.get(timestamp, utils::Time::ms * 600) * 8 * utils::Time::ms,
             _outboundRembEstimateKbps,
             _rttNtp * 1000.0 / 0x10000,
-            _pacingQueue.size() + _rtxPacingQueue.size(),
+            _pacingQueue.size() + _pacingQueue.rtxSize(),
+            _pacingQueue.getDropCount(),
             _rateController.isRtpProbingEnabled() ? "t" : "f",
             maxJitter * 1000.0);
 
@@ -1676,12 +1722,32 @@ void TransportImpl::protectAndSendRtp(uint64_t timestamp, memory::UniquePacket p
         }
     }
 
+    // The transport wide sequence number is only rewritten in place. Packets get the extension element from the
+    // sender, with the id remapped to ours by the forwarder, or from the padding and probe builders. Packets from a
+    // sender that did not carry the extension go out without it and are not part of transport-cc feedback.
+    bool hasTransportSequenceNumber = false;
+    if (_transportCcExtensionId)
+    {
+        hasTransportSequenceNumber =
+            rtp::setTransportWideSequenceNumber(*packet, _transportCcExtensionId, _transportCc.sequenceNumber);
+    }
+
     auto& ssrcState = getOutboundSsrc(rtpHeader->ssrc, rtpFrequency);
 
     ssrcState.onRtpSent(timestamp, *packet);
     if (_uplinkEstimationEnabled)
     {
         _rateController.onRtpSent(timestamp, rtpHeader->ssrc, rtpHeader->sequenceNumber, packet->getLength());
+        if (hasTransportSequenceNumber)
+        {
+            _rateController.onTransportWideSequenceNumberSent(timestamp,
+                _transportCc.sequenceNumber,
+                packet->getLength());
+        }
+    }
+    if (hasTransportSequenceNumber)
+    {
+        ++_transportCc.sequenceNumber;
     }
 
 #if DEBUG_RTP
@@ -1694,9 +1760,36 @@ void TransportImpl::protectAndSendRtp(uint64_t timestamp, memory::UniquePacket p
     }
 #endif
 
+    if (packet->receiveTimestamp != 0)
+    {
+        utils::metrics::receiveToSendLatency.observe(timestamp - packet->receiveTimestamp);
+    }
     doProtectAndSend(timestamp, std::move(packet), _peerRtpPort, _selectedRtp);
 }
 
+void TransportImpl::sendTransportFeedback(const uint64_t timestamp)
+{
+    if (!_selectedRtcp)
+    {
+        return;
+    }
+
+    auto packet = memory::makeUniquePacket(_mainAllocator);
+    if (!packet)
+    {
+        logger::warn("failed to allocate transport feedback packet", _loggableId.c_str());
+        return;
+    }
+
+    const uint32_t mediaSsrc = _inboundSsrcCounters.size() > 0 ? _inboundSsrcCounters.begin()->first : 0;
+    packet->setLength(_transportCc.feedbackBuilder.build(packet->get(), _transportCc.reporterSsrc, mediaSsrc));
+    _transportCc.lastFeedbackTime = timestamp;
+    if (packet->getLength() > 0)
+    {
+        sendRtcp(std::move(packet), timestamp);
+    }
+}
+
 void TransportImpl::sendRtcp(memory::UniquePacket rtcpPacket, const uint64_t timestamp)
 {
     auto* report = rtp::RtcpReport::fromPacket(*rtcpPacket);
@@ -1771,18 +1864,26 @@ void TransportImpl::onSendingRtcp(const memory::Packet& rtcpPacket, const uint64
 
 bool TransportImpl::unprotect(memory::Packet& packet)
 {
-    if (_srtpClient->isConnected())
+    if (_srtpClient->isConnected() && _srtpClient->unprotect(packet))
     {
-        return _srtpClient->unprotect(packet);
+        if (_packetCapture)
+        {
+            _packetCapture->capture(packet, logger::PacketCapture::Direction::Inbound, packet.receiveTimestamp);
+        }
+        return true;
     }
     return false;
 }
 
 bool TransportImpl::unprotectFirstRtp(memory::Packet& packet, uint32_t& rolloverCounter)
 {
-    if (_srtpClient->isConnected())
+    if (_srtpClient->isConnected() && _srtpClient->unprotectFirstRtp(packet, rolloverCounter))
     {
-        return _srtpClient->unprotectFirstRtp(packet, rolloverCounter);
+        if (_packetCapture)
+        {
+            _packetCapture->capture(packet, logger::PacketCapture::Direction::Inbound, packet.receiveTimestamp);
+        }
+        return true;
     }
     return false;
 }
@@ -2031,6 +2132,38 @@ void TransportImpl::onIceCandidateChanged(ice::IceSession* session,
     }
 }
 
+uint64_t TransportImpl::getIceFastPathResponseCount() const
+{
+    return _rtpIceSession ? _rtpIceSession->getStunFastPath().getResponseCount() : 0;
+}
+
+void TransportImpl::enableStunFastPath()
+{
+    auto& fastPath = _rtpIceSession->getStunFastPath();
+    fastPath.enable(_rtpIceSession->getRole());
+    for (auto& endpoint : _rtpEndpoints)
+    {
+        if (endpoint->getTransportType() == ice::TransportType::UDP)
+        {
+            endpoint->registerStunFastPath(_rtpIceSession->getLocalCredentials().first, &fastPath);
+        }
+    }
+}
+
+uint64_t TransportImpl::getLastReceivedPacketTimestamp() const
+{
+    const uint64_t timestamp = _lastReceivedPacketTimestamp;
+    if (_rtpIceSession && _rtpIceSession->getStunFastPath().isEnabled())
+    {
+        const auto fastPathTimestamp = _rtpIceSession->getStunFastPath().getLastRequestTimestamp();
+        if (fastPathTimestamp != 0 && utils::Time::diffGT(timestamp, fastPathTimestamp, 0))
+        {
+            return fastPathTimestamp;
+        }
+    }
+    return timestamp;
+}
+
 void TransportImpl::onIceCompleted(ice::IceSession* session)
 {
     logger::debug("ice completed %s",
@@ -2042,6 +2175,10 @@ void TransportImpl::onIceStateChanged(ice::IceSession* session, const ice::IceSe
 {
     _iceState = state;
     _isConnected = (_selectedRtp && _srtpClient->isConnected());
+    if (state != ice::IceSession::State::CONNECTED)
+    {
+        session->getStunFastPath().disable();
+    }
 
     switch (state)
     {
@@ -2073,6 +2210,11 @@ void TransportImpl::onIceStateChanged(ice::IceSession* session, const ice::IceSe
             }
         }
 
+        if (_config.ice.stunFastPath)
+        {
+            enableStunFastPath();
+        }
+
         if (_rtpIceSession->getRole() == ice::IceRole::CONTROLLING)
         {
             for (auto& endpoint : _rtpEndpoints)
@@ -2218,6 +2360,14 @@ void TransportImpl::setAbsSendTimeExtensionId(uint8_t extensionId)
     _absSendTimeExtensionId = extensionId;
 }
 
+/**
+ * extension id = 0 means off
+ */
+void TransportImpl::setTransportCcExtensionId(uint8_t extensionId)
+{
+    _transportCcExtensionId = extensionId;
+}
+
 uint16_t TransportImpl::allocateOutboundSctpStream()
 {
     if (_sctpAssociation)
@@ -2408,6 +2558,12 @@ void TransportImpl::setRtxProbeSource(const uint32_t ssrc, uint32_t* sequenceCou
     _rateController.setRtpProbingEnabled(!!sequenceCounter);
 }
 
+void TransportImpl::setPacingPriority(const uint32_t ssrc, const PacingPriority priority)
+{
+    DBGCHECK_SINGLETHREADED(_singleThreadMutex);
+    _pacingQueue.setPriority(ssrc, priority);
+}
+
 void TransportImpl::runTick(uint64_t timestamp)
 {
     if (_pacingInUse.load())
@@ -2428,21 +2584,15 @@ void TransportImpl::doRunTick(const uint64_t timestamp)
     {
         sendPadding(timestamp);
     }
-    _pacingInUse = !_pacingQueue.empty() || !_rtxPacingQueue.empty();
+    _pacingInUse = !_pacingQueue.empty();
     _pacingQueueStats.pacingQueueSize = _pacingQueue.size();
-    _pacingQueueStats.rtxPacingQueueSize = _rtxPacingQueue.size();
-}
-
-memory::UniquePacket TransportImpl::tryFetchPriorityPacket(size_t budget)
-{
-    auto& queue = _rtxPacingQueue.empty() ? _pacingQueue : _rtxPacingQueue;
-    return !queue.empty() && budget >= queue.back()->getLength() + _config.ipOverhead ? queue.fetchBack() : nullptr;
+    _pacingQueueStats.rtxPacingQueueSize = _pacingQueue.rtxSize();
 }
 
 void TransportImpl::drainPacingBuffer(uint64_t timestamp, DrainPacingBufferMode mode)
 {
     auto budget = DrainPacingBufferMode::UseBudget == mode ? _rateController.getPacingBudget(timestamp) : SIZE_MAX;
-    while (auto packet = tryFetchPriorityPacket(budget))
+    while (auto packet = _pacingQueue.fetch(budget, timestamp))
     {
         budget -= packet->getLength() + _config.ipOverhead;
         protectAndSendRtp(timestamp, std::move(packet));
@@ -2544,4 +2694,9 @@ void TransportImpl::asyncSetRemoteSdesKey(const srtp::AesKey& key)
     _jobQueue.post(_jobCounter, [this, key]() { _srtpClient->setRemoteKey(key); });
 }
 
+void TransportImpl::asyncSetPacketCapture(std::shared_ptr<logger::PacketCapture> packetCapture)
+{
+    _jobQueue.post(_jobCounter, [this, packetCapture]() { _packetCapture = packetCapture; });
+}
+
 } // namespace transport
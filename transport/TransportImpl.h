@@ -7,6 +7,7 @@
 #include "ice/IceSession.h"
 #include "logger/Logger.h"
 #include "memory/AudioPacketPoolAllocator.h"
+#include "rtp/RtcpTransportFeedback.h"
 #include "rtp/SendTimeDial.h"
 #include "sctp/SctpAssociation.h"
 #include "sctp/SctpServerPort.h"
@@ -107,6 +108,7 @@ public: // Transport
     void removeSrtpLocalSsrc(const uint32_t ssrc) override;
     bool setSrtpRemoteRolloverCounter(const uint32_t ssrc, const uint32_t rolloverCounter) override;
     void setRtxProbeSource(const uint32_t ssrc, uint32_t* sequenceCounter, const uint16_t payloadType) override;
+    void setPacingPriority(uint32_t ssrc, PacingPriority priority) override;
 
     /** Called from httpd threads */
     bool isGatheringComplete() const override;
@@ -114,6 +116,7 @@ public: // Transport
     ice::IceCandidates getLocalCandidates() override;
     /** Called from httpd threads */
     std::pair<std::string, std::string> getLocalIceCredentials() override;
+    bool isIceLite() const override { return _rtpIceSession && _rtpIceSession->isLite(); }
 
     /** Called from httpd threads. Must be set before DtlsFingerprint otherwise DTLS handshake will fail */
     bool setRemotePeer(const SocketAddress& target) override;
@@ -176,6 +179,7 @@ public: // Transport
         utils::Optional<uint8_t> telephoneEventPayloadType,
         uint32_t rtpFrequency) override;
     void setAbsSendTimeExtensionId(uint8_t extensionId) override;
+    void setTransportCcExtensionId(uint8_t extensionId) override;
 
     bool sendSctp(uint16_t streamId, uint32_t protocolId, const void* data, uint16_t length) override;
     uint16_t allocateOutboundSctpStream() override;
@@ -185,14 +189,16 @@ public: // Transport
     ice::IceSession::State getIceState() const override { return _iceState; };
     SrtpClient::State getDtlsState() const override { return _dtlsState; };
     utils::Optional<ice::TransportType> getSelectedTransportType() const override { return _transportType.load(); }
+    uint64_t getIceFastPathResponseCount() const override;
 
     void setTag(const char* tag) override;
     const char* getTag() const override { return _tag; };
 
-    uint64_t getLastReceivedPacketTimestamp() const override { return _lastReceivedPacketTimestamp; }
+    uint64_t getLastReceivedPacketTimestamp() const override;
 
     void getSdesKeys(std::vector<srtp::AesKey>& sdesKeys) const override;
     void asyncSetRemoteSdesKey(const srtp::AesKey& key) override;
+    void asyncSetPacketCapture(std::shared_ptr<logger::PacketCapture> packetCapture) override;
 
 private: // SslWriteBioListener
     // Called from Transport serial thread
@@ -339,6 +345,7 @@ private:
         int activeInboundCount);
 
     void sendReports(uint64_t timestamp, bool rembReady = false);
+    void sendTransportFeedback(uint64_t timestamp);
     void sendRtcp(memory::UniquePacket rtcpPacket, const uint64_t timestamp) override;
 
     void onSendingRtcp(const memory::Packet& rtcpPacket, uint64_t timestamp);
@@ -347,8 +354,8 @@ private:
     RtpSenderState& getOutboundSsrc(uint32_t ssrc, uint32_t rtpFrequency);
 
     void onTransportConnected();
+    void enableStunFastPath();
     void drainPacingBuffer(uint64_t timestamp, DrainPacingBufferMode);
-    memory::UniquePacket tryFetchPriorityPacket(size_t budget);
 
     std::atomic_bool _isInitialized;
     logger::LoggableId _loggableId;
@@ -411,6 +418,13 @@ private:
     std::atomic_uint32_t _rttNtp;
 
     concurrency::MpmcHashmap32<uint32_t, RtpSenderState> _outboundSsrcCounters;
+    // Direct mapped cache of _outboundSsrcCounters for the send path, cleared when a stream is evicted from the map.
+    // Transport jobs only
+    struct OutboundSsrcCacheEntry
+    {
+        uint32_t ssrc = 0;
+        RtpSenderState* senderState = nullptr;
+    } _outboundSsrcCache[16];
     concurrency::MpmcHashmap32<uint32_t, RtpReceiveState> _inboundSsrcCounters;
 
     std::atomic_bool _isRunning;
@@ -427,6 +441,7 @@ private:
         uint32_t rtpFrequency;
     } _audio;
     uint8_t _absSendTimeExtensionId;
+    uint8_t _transportCcExtensionId;
     uint16_t _videoRtxPayloadType;
 
     const sctp::SctpConfig& _sctpConfig;
@@ -445,16 +460,31 @@ private:
         uint32_t lastReportedEstimateKbps;
     } _rtcp;
 
+    struct TransportCc
+    {
+        explicit TransportCc(uint32_t reporterSsrc)
+            : reporterSsrc(reporterSsrc),
+              sequenceNumber(0),
+              lastFeedbackTime(0)
+        {
+        }
+
+        // fixed sender ssrc of our feedback, independent of which media streams come and go
+        const uint32_t reporterSsrc;
+        uint16_t sequenceNumber;
+        uint64_t lastFeedbackTime;
+        rtp::TransportFeedbackBuilder feedbackBuilder;
+    } _transportCc;
+
     bwe::RateController _rateController;
     uint32_t _rtxProbeSsrc;
     uint32_t* _rtxProbeSequenceCounter;
 
-    using PacingQueue = memory::RandomAccessBacklog<memory::UniquePacket, 512>;
     PacingQueue _pacingQueue;
-    PacingQueue _rtxPacingQueue;
     std::atomic_bool _pacingInUse;
 
     std::unique_ptr<logger::PacketLoggerThread> _packetLogger;
+    std::shared_ptr<logger::PacketCapture> _packetCapture;
     std::atomic<ice::IceSession::State> _iceState;
     std::atomic<SrtpClient::State> _dtlsState;
     std::atomic<bool> _isConnected;
@@ -1,5 +1,6 @@
 #pragma once
 #include "transport/Endpoint.h"
+#include "transport/FlowTable.h"
 #include "transport/RtcSocket.h"
 #include "transport/RtcePoll.h"
 
@@ -13,5 +14,8 @@ public:
     // auxilary
     virtual bool openPort(uint16_t port) = 0;
     virtual bool isGood() const = 0;
+
+    // Thread safe snapshot of the demultiplexed flows, if the endpoint keeps a flow table
+    virtual void getFlows(std::vector<FlowStats>& flows, size_t maxCount) const {}
 };
 } // namespace transport
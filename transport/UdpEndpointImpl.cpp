@@ -43,7 +43,11 @@ UdpEndpointImpl::UdpEndpointImpl(jobmanager::JobManager& jobManager,
       _iceListeners(maxSessionCount * 2),
       _dtlsListeners(maxSessionCount * 5),
       _iceResponseListeners(maxSessionCount * 16),
-      _defaultListener(nullptr)
+      _defaultListener(nullptr),
+      _flows(maxSessionCount * 2),
+      _stunFastPaths(maxSessionCount * 2),
+      _stunFastPathResponses(0),
+      _stunFastPathFallbacks(0)
 {
 }
 
@@ -131,6 +135,7 @@ void UdpEndpointImpl::internalUnregisterListener(IEvents* listener)
     {
         if (item.second == listener)
         {
+            _stunFastPaths.erase(item.first);
             _iceListeners.erase(item.first);
             listener->onUnregistered(*this);
             break;
@@ -154,21 +159,34 @@ void UdpEndpointImpl::internalUnregisterListener(IEvents* listener)
             listener->onUnregistered(*this);
         }
     }
+
+    _flows.eraseListener(listener);
 }
 
 void UdpEndpointImpl::dispatchReceivedPacket(const SocketAddress& srcAddress,
     memory::UniquePacket packet,
     const uint64_t timestamp)
 {
+    const auto localPort = _baseUdpEndpoint._socket.getBoundPort();
+    const FlowKey flowKey(srcAddress, localPort.getPort());
+    auto* flow = _flows.find(flowKey);
+    const auto packetClass =
+        classifyPacket(packet->get(), packet->getLength(), flow ? flow->getPacketClass() : PacketClass::UNKNOWN);
+    if (flow)
+    {
+        flow->onPacket(packetClass, packet->getLength());
+    }
+
     UdpEndpointImpl::IEvents* listener = _defaultListener;
 
-    if (ice::isStunMessage(packet->get(), packet->getLength()))
+    if (packetClass == PacketClass::STUN)
     {
         auto msg = ice::StunMessage::fromPtr(packet->get());
 
         if (msg->header.isRequest())
         {
             auto users = msg->getAttribute<ice::StunUserName>(ice::StunAttribute::USERNAME);
+            listener = nullptr;
             if (users)
             {
                 auto userName = users->getNames().first;
@@ -178,10 +196,11 @@ void UdpEndpointImpl::dispatchReceivedPacket(const SocketAddress& srcAddress,
                     users->getNames().first.c_str(),
                     srcAddress.toString().c_str(),
                     listener ? "" : "unknown user");
-            }
-            if (!users || !listener)
-            {
-                return;
+
+                if (listener && respondOnFastPath(srcAddress, *msg, userName, listener, flow, timestamp))
+                {
+                    return;
+                }
             }
         }
         else if (msg->header.isResponse())
@@ -202,11 +221,7 @@ void UdpEndpointImpl::dispatchReceivedPacket(const SocketAddress& srcAddress,
 
         if (listener)
         {
-            listener->onIceReceived(*this,
-                srcAddress,
-                _baseUdpEndpoint._socket.getBoundPort(),
-                std::move(packet),
-                timestamp);
+            listener->onIceReceived(*this, srcAddress, localPort, std::move(packet), timestamp);
             return;
         }
         else
@@ -214,17 +229,13 @@ void UdpEndpointImpl::dispatchReceivedPacket(const SocketAddress& srcAddress,
             LOG("cannot find listener for STUN", _name.c_str());
         }
     }
-    else if (transport::isDtlsPacket(packet->get(), packet->getLength()))
+    else if (packetClass == PacketClass::DTLS)
     {
-        listener = _dtlsListeners.getItem(srcAddress);
+        listener = findDtlsListener(flowKey, srcAddress, flow, packetClass, packet->getLength());
         listener = listener ? listener : _defaultListener.load();
         if (listener)
         {
-            listener->onDtlsReceived(*this,
-                srcAddress,
-                _baseUdpEndpoint._socket.getBoundPort(),
-                std::move(packet),
-                timestamp);
+            listener->onDtlsReceived(*this, srcAddress, localPort, std::move(packet), timestamp);
             return;
         }
         else
@@ -232,20 +243,16 @@ void UdpEndpointImpl::dispatchReceivedPacket(const SocketAddress& srcAddress,
             LOG("cannot find listener for DTLS source %s", _name.c_str(), srcAddress.toString().c_str());
         }
     }
-    else if (rtp::isRtcpPacket(packet->get(), packet->getLength()))
+    else if (packetClass == PacketClass::RTCP)
     {
         auto rtcpReport = rtp::RtcpReport::fromPtr(packet->get(), packet->getLength());
         if (rtcpReport)
         {
-            listener = _dtlsListeners.getItem(srcAddress);
+            listener = findDtlsListener(flowKey, srcAddress, flow, packetClass, packet->getLength());
 
             if (listener)
             {
-                listener->onRtcpReceived(*this,
-                    srcAddress,
-                    _baseUdpEndpoint._socket.getBoundPort(),
-                    std::move(packet),
-                    timestamp);
+                listener->onRtcpReceived(*this, srcAddress, localPort, std::move(packet), timestamp);
                 return;
             }
             else
@@ -254,20 +261,16 @@ void UdpEndpointImpl::dispatchReceivedPacket(const SocketAddress& srcAddress,
             }
         }
     }
-    else if (rtp::isRtpPacket(packet->get(), packet->getLength()))
+    else if (packetClass == PacketClass::RTP)
     {
         auto rtpPacket = rtp::RtpHeader::fromPacket(*packet);
         if (rtpPacket)
         {
-            listener = _dtlsListeners.getItem(srcAddress);
+            listener = findDtlsListener(flowKey, srcAddress, flow, packetClass, packet->getLength());
 
             if (listener)
             {
-                listener->onRtpReceived(*this,
-                    srcAddress,
-                    _baseUdpEndpoint._socket.getBoundPort(),
-                    std::move(packet),
-                    timestamp);
+                listener->onRtpReceived(*this, srcAddress, localPort, std::move(packet), timestamp);
                 return;
             }
             else
@@ -280,7 +283,89 @@ void UdpEndpointImpl::dispatchReceivedPacket(const SocketAddress& srcAddress,
     {
         LOG("Unexpected packet from %s", _name.c_str(), srcAddress.toString().c_str());
     }
+
     // unexpected packet that can come from anywhere. We do not log as it facilitates DoS
+    if (flow)
+    {
+        flow->onDrop();
+    }
+    else
+    {
+        _flows.countUnknownDrop();
+    }
+}
+
+// Resolves media and DTLS packets through the flow table. On a miss the listener map is consulted and the flow is
+// added, so following packets from the same 5-tuple cost one probe.
+UdpEndpointImpl::IEvents* UdpEndpointImpl::findDtlsListener(const FlowKey& flowKey,
+    const SocketAddress& srcAddress,
+    FlowTable<IEvents>::Flow*& flow,
+    PacketClass packetClass,
+    size_t length)
+{
+    if (flow)
+    {
+        return flow->getListener();
+    }
+
+    auto* listener = _dtlsListeners.getItem(srcAddress);
+    if (listener && !flowKey.empty())
+    {
+        flow = _flows.add(flowKey, listener);
+        if (flow)
+        {
+            flow->onPacket(packetClass, length);
+        }
+    }
+    return listener;
+}
+
+// Binding requests from a remote port that is already routed to the session are answered here. The
+// IceSession picks up the request timestamp to keep the nominated pair alive.
+bool UdpEndpointImpl::respondOnFastPath(const SocketAddress& srcAddress,
+    const ice::StunMessage& msg,
+    const std::string& userName,
+    IEvents* listener,
+    FlowTable<IEvents>::Flow* flow,
+    const uint64_t timestamp)
+{
+    auto* fastPath = _stunFastPaths.getItem(userName);
+    if (!fastPath || !fastPath->isEnabled())
+    {
+        return false;
+    }
+
+    const auto* routedListener = flow ? flow->getListener() : _dtlsListeners.getItem(srcAddress);
+    if (routedListener != listener)
+    {
+        return false;
+    }
+
+    ice::StunMessage response;
+    if (!fastPath->respond(msg, srcAddress, timestamp, response))
+    {
+        _stunFastPathFallbacks.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    _stunFastPathResponses.fetch_add(1, std::memory_order_relaxed);
+    sendTo(srcAddress, memory::makeUniquePacket(_baseUdpEndpoint._allocator, &response, response.size()));
+    return true;
+}
+
+// posted on receive job queue to be ordered with internalUnregisterListener, which erases the fast path
+void UdpEndpointImpl::registerStunFastPath(const std::string& stunUserName, ice::StunFastPath* fastPath)
+{
+    const bool posted = _baseUdpEndpoint._receiveJobs.post([this, stunUserName, fastPath]() {
+        if (_iceListeners.contains(stunUserName) && !_stunFastPaths.contains(stunUserName))
+        {
+            _stunFastPaths.emplace(stunUserName, fastPath);
+        }
+    });
+    if (!posted)
+    {
+        logger::warn("failed to post register STUN fast path job", _name.c_str());
+    }
 }
 
 void UdpEndpointImpl::registerListener(const std::string& stunUserName, IEvents* listener)
@@ -328,6 +413,7 @@ void UdpEndpointImpl::swapListener(const SocketAddress& srcAddress, IEvents* new
         {
             it->second->onUnregistered(*this);
         }
+        _flows.erase(FlowKey(srcAddress, _baseUdpEndpoint._socket.getBoundPort().getPort()));
         it->second = newListener;
         newListener->onRegistered(*this);
         return;
@@ -349,6 +435,7 @@ void UdpEndpointImpl::unregisterListener(const SocketAddress& remotePort, IEvent
         {
             LOG("remove listener on %s", _name.c_str(), remotePort.toString().c_str());
             _dtlsListeners.erase(it->first);
+            _flows.erase(FlowKey(remotePort, _baseUdpEndpoint._socket.getBoundPort().getPort()));
             listener->onUnregistered(*this);
         }
     });
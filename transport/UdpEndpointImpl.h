@@ -2,6 +2,7 @@
 #include "concurrency/MpmcHashmap.h"
 #include "memory/PacketPoolAllocator.h"
 #include "transport/BaseUdpEndpoint.h"
+#include "transport/FlowTable.h"
 
 namespace transport
 {
@@ -45,6 +46,7 @@ public:
     }
 
     virtual void registerDefaultListener(IEvents* defaultListener) override { _defaultListener = defaultListener; }
+    void registerStunFastPath(const std::string& stunUserName, ice::StunFastPath* fastPath) override;
 
     virtual void start() override { _baseUdpEndpoint.start(); }
     virtual void stop(IStopEvents* listener) override { _baseUdpEndpoint.stop(listener); }
@@ -60,15 +62,38 @@ public:
 
     virtual EndpointMetrics getMetrics(uint64_t timestamp) const override
     {
-        return _baseUdpEndpoint.getMetrics(timestamp);
+        auto metrics = _baseUdpEndpoint.getMetrics(timestamp);
+        metrics.unknownFlowDrops = _flows.getUnknownDrops();
+        metrics.stunFastPathResponses = getStunFastPathResponses();
+        metrics.stunFastPathFallbacks = getStunFastPathFallbacks();
+        return metrics;
     }
 
+    void getFlows(std::vector<FlowStats>& flows, size_t maxCount) const override
+    {
+        _flows.getFlows(flows, maxCount);
+    }
+    uint64_t getUnknownDrops() const { return _flows.getUnknownDrops(); }
+    uint64_t getStunFastPathResponses() const { return _stunFastPathResponses.load(std::memory_order_relaxed); }
+    uint64_t getStunFastPathFallbacks() const { return _stunFastPathFallbacks.load(std::memory_order_relaxed); }
+
 private:
     void dispatchReceivedPacket(const SocketAddress& srcAddress, memory::UniquePacket packet, const uint64_t timestamp);
 
     void internalUnregisterListener(IEvents* listener);
     void internalUnregisterStunListener(ice::Int96 transactionId);
     void swapListener(const SocketAddress& srcAddress, IEvents* newListener);
+    IEvents* findDtlsListener(const FlowKey& flowKey,
+        const SocketAddress& srcAddress,
+        FlowTable<IEvents>::Flow*& flow,
+        PacketClass packetClass,
+        size_t length);
+    bool respondOnFastPath(const SocketAddress& srcAddress,
+        const ice::StunMessage& msg,
+        const std::string& userName,
+        IEvents* listener,
+        FlowTable<IEvents>::Flow* flow,
+        uint64_t timestamp);
 
     logger::LoggableId _name;
     BaseUdpEndpoint _baseUdpEndpoint;
@@ -79,5 +104,13 @@ private:
     // mainly used for client requests. SMB mainly uses dtlsListener for IP:port
     concurrency::MpmcHashmap32<ice::Int96, IEvents*> _iceResponseListeners;
     std::atomic<Endpoint::IEvents*> _defaultListener;
+
+    // Cache of _dtlsListeners per 5-tuple. Only accessed from receive job queue, except for stats.
+    FlowTable<IEvents> _flows;
+
+    // keyed as _iceListeners and removed with them
+    concurrency::MpmcHashmap32<std::string, ice::StunFastPath*> _stunFastPaths;
+    std::atomic_uint64_t _stunFastPathResponses;
+    std::atomic_uint64_t _stunFastPathFallbacks;
 };
 } // namespace transport
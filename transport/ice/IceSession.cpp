@@ -62,9 +62,11 @@ IceSession::IceSession(size_t sessionId,
       _config(config),
       _state(State::IDLE),
       _eventSink(eventSink),
-      _credentials(role, static_cast<uint64_t>(_idGenerator.next().w0) << 32 | _idGenerator.next().w1),
+      _credentials(config.lite ? IceRole::CONTROLLED : role,
+          static_cast<uint64_t>(_idGenerator.next().w0) << 32 | _idGenerator.next().w1),
       _sessionStart(0),
-      _connectedCount(0)
+      _connectedCount(0),
+      _stunFastPath(_config.software)
 {
     char ufrag[14 + 1];
     char pwd[24 + 1]; // length selected to make attribute *4 length
@@ -76,6 +78,7 @@ IceSession::IceSession(size_t sessionId,
     generateCredentialString(_idGenerator, pwd, sizeof(pwd) - 1);
     _credentials.local = std::make_pair<std::string, std::string>(ufrag, pwd);
     _hmacComputer.local.init(_credentials.local.second.c_str(), _credentials.local.second.size());
+    _stunFastPath.setCredentials(_credentials.local);
 }
 
 // add most preferred UDP end point first. It will affect prioritization of candidates
@@ -187,9 +190,19 @@ void IceSession::probeRemoteCandidates(const IceRole role, uint64_t timestamp)
     DBGCHECK_SINGLETHREADED(_mutexGuard);
     if (_sessionStart == 0)
     {
-        _credentials.role = role;
+        _credentials.role = _config.lite ? IceRole::CONTROLLED : role;
         _sessionStart = timestamp;
     }
+    if (_config.lite)
+    {
+        // the remote agent runs the checks. We wait for a nomination until connect timeout
+        if (_state < State::CONNECTING)
+        {
+            reportState(State::CONNECTING);
+        }
+        processTimeout(timestamp);
+        return;
+    }
     if (_credentials.remote.second.empty())
     {
         return;
@@ -293,14 +306,18 @@ IceSession::CandidatePair* IceSession::addProbeForRemoteCandidate(const Endpoint
     }
     auto& candidatePair = _candidatePairs.back();
 
-    StunMessage& iceProbe(candidatePair->original);
-    iceProbe.header.transactionId.set(_idGenerator.next());
-    iceProbe.header.setMethod(StunHeader::BindingRequest);
-    iceProbe.add(StunGenericAttribute(StunAttribute::SOFTWARE, _config.software));
-    iceProbe.add(StunPriority(static_cast<uint32_t>(ice::IceCandidate::computeCandidatePriority(remoteCandidate.type,
-        endpoint.preference,
-        _component,
-        remoteCandidate.transportType))));
+    if (!_config.lite)
+    {
+        StunMessage& iceProbe(candidatePair->original);
+        iceProbe.header.transactionId.set(_idGenerator.next());
+        iceProbe.header.setMethod(StunHeader::BindingRequest);
+        iceProbe.add(StunGenericAttribute(StunAttribute::SOFTWARE, _config.software));
+        iceProbe.add(StunPriority(static_cast<uint32_t>(ice::IceCandidate::computeCandidatePriority(
+            remoteCandidate.type,
+            endpoint.preference,
+            _component,
+            remoteCandidate.transportType))));
+    }
 
     logger::info("added candidate pair %s-%s HOST-%s %s",
         _logId.c_str(),
@@ -520,6 +537,12 @@ bool IceSession::processValidStunTcpRequest(IceEndpoint* localEndpoint,
     if (isAttached(localEndpoint))
     {
         sendResponse(localEndpoint, remotePort, 0, msg, now);
+        auto* pair = _config.lite ? findCandidatePair(localEndpoint, remotePort) : nullptr;
+        if (pair)
+        {
+            pair->state = ProbeState::Succeeded;
+            pair->receptionTimestamp = now;
+        }
         return true;
     }
 
@@ -536,7 +559,14 @@ bool IceSession::processValidStunTcpRequest(IceEndpoint* localEndpoint,
         candidatePair->accept();
         sendResponse(localEndpoint, remotePort, 0, msg, now);
         candidatePair->receptionTimestamp = now;
-        candidatePair->send(now);
+        if (_config.lite)
+        {
+            candidatePair->state = ProbeState::Succeeded;
+        }
+        else
+        {
+            candidatePair->send(now);
+        }
     }
 
     if (_state == State::CONNECTING)
@@ -659,6 +689,71 @@ bool IceSession::processValidStunUdpRequest(IceEndpoint* localEndpoint,
     return true;
 }
 
+// A lite agent creates a pair only for the local endpoint and remote address the check arrived on. An authentic
+// check makes the pair valid as the remote agent will not nominate a pair it has not received a response on.
+bool IceSession::processValidStunLiteRequest(IceEndpoint* localEndpoint,
+    const transport::SocketAddress& remotePort,
+    const StunMessage& msg,
+    int remoteCandidatePriority,
+    uint64_t now)
+{
+    auto* pair = findCandidatePair(localEndpoint, remotePort);
+    if (!pair)
+    {
+        const auto* localEndpointInfo = findEndpointInfo(localEndpoint);
+        if (!localEndpointInfo)
+        {
+            logger::error("Receive stun from unattached endpoint. %s %s",
+                _logId.c_str(),
+                toString(localEndpoint->getTransportType()).c_str(),
+                localEndpoint->getLocalPort().toFixedString().c_str());
+
+            sendResponse(localEndpoint, remotePort, StunError::Code::ServerError, msg, now, "Server Error");
+            return false;
+        }
+
+        if (_candidatePairs.size() >= _config.maxCandidateCount)
+        {
+            removeUnviableRemoteCandidates(now);
+        }
+        if (_candidatePairs.size() >= _config.maxCandidateCount)
+        {
+            logger::info("too many candidate pairs %u, %s",
+                _logId.c_str(),
+                _config.maxCandidateCount,
+                maybeMasked(remotePort).c_str());
+            sendResponse(localEndpoint, remotePort, 0, msg, now);
+            return false;
+        }
+
+        const auto* remoteCandidate = findCandidateWithUdpAddress(_remoteCandidates, remotePort);
+        if (!remoteCandidate)
+        {
+            remoteCandidate = &addRemoteCandidate(IceCandidate(_component,
+                localEndpoint->getTransportType(),
+                remoteCandidatePriority,
+                remotePort,
+                remotePort,
+                IceCandidate::Type::PRFLX));
+        }
+
+        pair = addProbeForRemoteCandidate(*localEndpointInfo, *remoteCandidate);
+        if (!pair)
+        {
+            sendResponse(localEndpoint, remotePort, StunError::Code::ServerError, msg, now, "Server Error");
+            return false;
+        }
+        sortCheckList();
+    }
+
+    pair->state = ProbeState::Succeeded;
+    pair->receptionTimestamp = now;
+    // Only send response after accept! Otherwise we could drop early media
+    pair->accept();
+    sendResponse(localEndpoint, remotePort, 0, msg, now);
+    return true;
+}
+
 void IceSession::processValidStunRequest(IceEndpoint* localEndpoint,
     const transport::SocketAddress& remotePort,
     const StunMessage& msg,
@@ -686,8 +781,9 @@ void IceSession::processValidStunRequest(IceEndpoint* localEndpoint,
     }
     else if (localEndpoint->getTransportType() == TransportType::UDP)
     {
-        successfullyProcessed =
-            processValidStunUdpRequest(localEndpoint, remotePort, msg, remoteCandidatePriority, now);
+        successfullyProcessed = _config.lite
+            ? processValidStunLiteRequest(localEndpoint, remotePort, msg, remoteCandidatePriority, now)
+            : processValidStunUdpRequest(localEndpoint, remotePort, msg, remoteCandidatePriority, now);
     }
 
     if (successfullyProcessed && _credentials.role == IceRole::CONTROLLED)
@@ -767,7 +863,16 @@ void IceSession::onRequestReceived(IceEndpoint* localEndpoint,
     }
     const auto* peerControlling = msg.getAttribute<StunAttribute64>(StunAttribute::ICE_CONTROLLING);
     const auto* peerControlled = msg.getAttribute<StunAttribute64>(StunAttribute::ICE_CONTROLLED);
-    if (_credentials.role == ice::IceRole::CONTROLLING && peerControlling)
+    if (_config.lite)
+    {
+        // a lite agent never takes the controlling role. The full agent has to switch
+        if (peerControlled)
+        {
+            sendResponse(localEndpoint, remotePort, StunError::Code::RoleConflict, msg, now, "Role Conflict");
+            return;
+        }
+    }
+    else if (_credentials.role == ice::IceRole::CONTROLLING && peerControlling)
     {
         if (_credentials.tieBreaker >= peerControlling->get())
         {
@@ -1426,9 +1531,23 @@ int64_t IceSession::nextTimeout(const uint64_t now) const
         return -1;
     }
 
+    if (_config.lite && _state != State::GATHERING)
+    {
+        // only the connect timeout while waiting for nomination
+        if (_state != State::CONNECTING)
+        {
+            return -1;
+        }
+        return std::max(int64_t(0), utils::Time::diff(now, _sessionStart + _config.connectTimeout * utils::Time::ms));
+    }
+
     int64_t minTimeout = _config.keepAliveInterval * utils::Time::ms;
     for (auto& candidatePair : _candidatePairs)
     {
+        if (_config.lite && !candidatePair->gatheringProbe)
+        {
+            continue;
+        }
         const auto timeout = candidatePair->nextTimeout(now);
         if (timeout < 0)
         {
@@ -1462,6 +1581,30 @@ int64_t IceSession::processTimeout(const uint64_t now)
     }
 
     DBGCHECK_SINGLETHREADED(_mutexGuard);
+    if (_config.lite)
+    {
+        // requests towards stun servers while gathering are the only ones a lite agent sends
+        for (auto& candidatePair : _candidatePairs)
+        {
+            if (candidatePair->gatheringProbe)
+            {
+                candidatePair->processTimeout(now);
+            }
+        }
+        stateCheck(now);
+        return nextTimeout(now);
+    }
+
+    if (_nomination && _stunFastPath.isEnabled())
+    {
+        // binding requests answered on the fast path also keep the nominated pair alive
+        const auto fastPathTimestamp = _stunFastPath.getLastRequestTimestamp();
+        if (fastPathTimestamp != 0 && utils::Time::diffGT(_nomination->receptionTimestamp, fastPathTimestamp, 0))
+        {
+            _nomination->receptionTimestamp = fastPathTimestamp;
+        }
+    }
+
     bool hadInProgressBeforeProcess = false;
     bool hasInProgressAfterProcess = false;
     for (auto it = _candidatePairs.rbegin(); it != _candidatePairs.rend(); ++it)
@@ -1527,6 +1670,7 @@ void IceSession::setLocalCredentials(const std::pair<std::string, std::string>&
 {
     _credentials.local = credentials;
     _hmacComputer.local.init(credentials.second.c_str(), credentials.second.size());
+    _stunFastPath.setCredentials(credentials);
 }
 
 void IceSession::setRemoteCredentials(const std::string& ufrag, const std::string& pwd)
@@ -2100,4 +2244,71 @@ const char* toString(IceSession::ProbeState s)
     static const char* stateStrings[] = {"Waiting", "InProgress", "Succeeded", "Failed", "Frozen"};
     return stateStrings[static_cast<int>(s)];
 }
+StunFastPath::StunFastPath(const std::string& software)
+    : _software(software),
+      _enabled(false),
+      _role(IceRole::CONTROLLED),
+      _lastRequestTimestamp(0),
+      _responseCount(0)
+{
+}
+
+void StunFastPath::setCredentials(const std::pair<std::string, std::string>& localCredentials)
+{
+    assert(!_enabled.load());
+    _localUser = localCredentials.first;
+    _hmacKey.init(localCredentials.second.c_str(), localCredentials.second.size());
+}
+
+void StunFastPath::enable(IceRole role)
+{
+    _role.store(role);
+    _enabled.store(true, std::memory_order_release);
+}
+
+void StunFastPath::disable()
+{
+    _enabled.store(false, std::memory_order_release);
+}
+
+bool StunFastPath::respond(const StunMessage& request,
+    const transport::SocketAddress& source,
+    const uint64_t timestamp,
+    StunMessage& response)
+{
+    if (!isEnabled() || request.header.getMethod() != StunHeader::BindingRequest || !request.isValid())
+    {
+        return false;
+    }
+
+    if (request.getAttribute(StunAttribute::USE_CANDIDATE))
+    {
+        return false;
+    }
+
+    const auto role = _role.load();
+    if ((role == IceRole::CONTROLLING && request.getAttribute(StunAttribute::ICE_CONTROLLING)) ||
+        (role == IceRole::CONTROLLED && request.getAttribute(StunAttribute::ICE_CONTROLLED)))
+    {
+        return false;
+    }
+
+    const auto* userName = request.getAttribute<StunUserName>(StunAttribute::USERNAME);
+    if (!userName || !userName->isTargetUser(_localUser.c_str()) || !request.isAuthentic(_hmacKey))
+    {
+        return false;
+    }
+
+    response.header.transactionId = request.header.transactionId;
+    response.header.setMethod(StunHeader::BindingResponse);
+    response.add(StunGenericAttribute(StunAttribute::SOFTWARE, _software));
+    response.add(StunXorMappedAddress(source, response.header));
+    response.addMessageIntegrity(_hmacKey);
+    response.addFingerprint();
+
+    _lastRequestTimestamp.store(timestamp, std::memory_order_relaxed);
+    _responseCount.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
 } // namespace ice
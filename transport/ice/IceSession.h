@@ -7,6 +7,7 @@
 #include "utils/SocketAddress.h"
 #include "utils/StdExtensions.h"
 #include "utils/Time.h"
+#include <atomic>
 #include <deque>
 
 namespace ice
@@ -40,6 +41,7 @@ struct IceConfig
                                                   // removed if space for new candidates is needed
 
     std::string software = "slice"; // keep short please.
+    bool lite = false; // ICE-lite. Only answers checks and latches the nominated pair. Always controlled.
     transport::SocketAddress publicIpv4;
     transport::SocketAddress publicIpv6;
 };
@@ -97,10 +99,45 @@ struct CandidatePairKey
     transport::SocketAddress remoteAddress;
 };
 
+/**
+ * Answers binding requests of an established session on the receive thread of a shared port, without a trip to
+ * the transport job queue. Only authentic requests without USE-CANDIDATE or a role conflict are answered, all
+ * others are left to the IceSession. Credentials must be set while disabled. Enable and respond may then be
+ * used from different threads.
+ */
+class StunFastPath
+{
+public:
+    explicit StunFastPath(const std::string& software);
+
+    void setCredentials(const std::pair<std::string, std::string>& localCredentials);
+    void enable(IceRole role);
+    void disable();
+    bool isEnabled() const { return _enabled.load(std::memory_order_acquire); }
+
+    bool respond(const StunMessage& request,
+        const transport::SocketAddress& source,
+        uint64_t timestamp,
+        StunMessage& response);
+
+    uint64_t getLastRequestTimestamp() const { return _lastRequestTimestamp.load(std::memory_order_relaxed); }
+    uint64_t getResponseCount() const { return _responseCount.load(std::memory_order_relaxed); }
+
+private:
+    const std::string _software;
+    std::string _localUser;
+    crypto::HmacSha1 _hmacKey;
+    std::atomic_bool _enabled;
+    std::atomic<IceRole> _role;
+    std::atomic_uint64_t _lastRequestTimestamp;
+    std::atomic_uint64_t _responseCount;
+};
+
 typedef std::vector<IceCandidate> IceCandidates;
 // Establishes connectivity over one or more sockets
 // You will need one IceSession per ice component
 // You drive the session by calling onStunPacketReceived and processTimeout
+// In lite mode no probes are sent and there are no timers once connected
 // It is not thread safe
 class IceSession
 {
@@ -217,6 +254,10 @@ public:
         return _credentials.role;
     }
 
+    bool isLite() const { return _config.lite; }
+
+    StunFastPath& getStunFastPath() { return _stunFastPath; }
+
     void stop();
 
 private:
@@ -363,6 +404,12 @@ private:
         int remoteCandidatePriority,
         uint64_t now);
 
+    bool processValidStunLiteRequest(IceEndpoint* localEndpoint,
+        const transport::SocketAddress& remotePort,
+        const StunMessage& data,
+        int remoteCandidatePriority,
+        uint64_t now);
+
     void onRequestReceived(IceEndpoint* localEndpoint,
         const transport::SocketAddress& remotePort,
         const StunMessage& data,
@@ -398,10 +445,11 @@ private:
     uint32_t _connectedCount;
     struct HmacComputers
     {
-        crypto::HMAC local;
-        crypto::HMAC remote;
+        crypto::HmacSha1 local;
+        crypto::HmacSha1 remote;
     };
-    mutable HmacComputers _hmacComputer;
+    HmacComputers _hmacComputer;
+    StunFastPath _stunFastPath;
 
     DBGCHECK_SINGLETHREADED_MUTEX(_mutexGuard);
 };
@@ -232,25 +232,42 @@ void StunMessage::computeHMAC(crypto::HMAC& hmacComputer, uint8_t* hmac20b) cons
 {
     hmacComputer.reset();
     const auto start = reinterpret_cast<const uint8_t*>(this);
+    const int digestableLength = getDigestableLength();
 
-    // if there is no message-integrity attribute yet, we assume that is going to be the next one added
-    // fake length will thus include the not yet added integrity-attribute
-    int digestableLength = header.length + sizeof(StunHeader);
+    const nwuint16_t fakeLength(digestableLength - sizeof(StunHeader) + StunMessageIntegrity::size());
+    hmacComputer.add(start, 2);
+    hmacComputer.add(&fakeLength, 2);
+    hmacComputer.add(start + 4, digestableLength - 4);
+    hmacComputer.compute(hmac20b);
+}
 
+void StunMessage::computeHMAC(const crypto::HmacSha1& hmacKey, uint8_t* hmac20b) const
+{
+    crypto::HmacSha1::Digest digest(hmacKey);
+    const auto start = reinterpret_cast<const uint8_t*>(this);
+    const int digestableLength = getDigestableLength();
+
+    const nwuint16_t fakeLength(digestableLength - sizeof(StunHeader) + StunMessageIntegrity::size());
+    digest.add(start, 2);
+    digest.add(&fakeLength, 2);
+    digest.add(start + 4, digestableLength - 4);
+    digest.compute(hmac20b);
+}
+
+// if there is no message-integrity attribute yet, we assume that is going to be the next one added
+// fake length will thus include the not yet added integrity-attribute
+int StunMessage::getDigestableLength() const
+{
+    const auto start = reinterpret_cast<const uint8_t*>(this);
     for (auto it = cbegin(); it != cend(); ++it)
     {
         if (it->type == StunAttribute::MESSAGE_INTEGRITY)
         {
-            digestableLength = reinterpret_cast<const uint8_t*>(&(*it)) - start;
-            break;
+            return reinterpret_cast<const uint8_t*>(&(*it)) - start;
         }
     }
 
-    const nwuint16_t fakeLength(digestableLength - sizeof(StunHeader) + StunMessageIntegrity::size());
-    hmacComputer.add(start, 2);
-    hmacComputer.add(&fakeLength, 2);
-    hmacComputer.add(start + 4, digestableLength - 4);
-    hmacComputer.compute(hmac20b);
+    return header.length + sizeof(StunHeader);
 }
 
 void StunMessage::addMessageIntegrity(crypto::HMAC& hmacComputer)
@@ -262,6 +279,15 @@ void StunMessage::addMessageIntegrity(crypto::HMAC& hmacComputer)
     add(attribute);
 }
 
+void StunMessage::addMessageIntegrity(const crypto::HmacSha1& hmacKey)
+{
+    StunMessageIntegrity attribute;
+    uint8_t hmac[20];
+    computeHMAC(hmacKey, hmac);
+    attribute.setHmac(hmac);
+    add(attribute);
+}
+
 // Verifies that all known attributes are well formed and that fingerprint is valid
 bool StunMessage::isValid() const
 {
@@ -315,22 +341,42 @@ bool StunMessage::isValid() const
     return true;
 }
 
-bool StunMessage::isAuthentic(crypto::HMAC& hmacComputer) const
+const StunMessageIntegrity* StunMessage::getMessageIntegrity() const
 {
     for (auto& attribute : *this)
     {
         if (attribute.type == StunAttribute::MESSAGE_INTEGRITY)
         {
-            if (attribute.length != 20)
-            {
-                return false;
-            }
-            uint8_t hmac[20];
-            computeHMAC(hmacComputer, hmac);
-            return reinterpret_cast<const StunMessageIntegrity&>(attribute).isMatch(hmac);
+            return attribute.length == 20 ? &reinterpret_cast<const StunMessageIntegrity&>(attribute) : nullptr;
         }
     }
-    return false;
+    return nullptr;
+}
+
+bool StunMessage::isAuthentic(crypto::HMAC& hmacComputer) const
+{
+    const auto* integrity = getMessageIntegrity();
+    if (!integrity)
+    {
+        return false;
+    }
+
+    uint8_t hmac[20];
+    computeHMAC(hmacComputer, hmac);
+    return integrity->isMatch(hmac);
+}
+
+bool StunMessage::isAuthentic(const crypto::HmacSha1& hmacKey) const
+{
+    const auto* integrity = getMessageIntegrity();
+    if (!integrity)
+    {
+        return false;
+    }
+
+    uint8_t hmac[20];
+    computeHMAC(hmacKey, hmac);
+    return integrity->isMatch(hmac);
 }
 
 void StunMessage::addFingerprint()
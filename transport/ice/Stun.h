@@ -10,6 +10,7 @@
 namespace crypto
 {
 class HMAC;
+class HmacSha1;
 }
 
 namespace ice
@@ -320,6 +321,7 @@ public:
     uint32_t computeFingerprint() const;
 
     void addMessageIntegrity(crypto::HMAC& hmacComputer);
+    void addMessageIntegrity(const crypto::HmacSha1& hmacKey);
     void addFingerprint();
     static const StunMessage* fromPtr(const void* ptr);
     size_t size() const { return header.length + sizeof(header); }
@@ -339,6 +341,7 @@ public:
 
     bool isValid() const;
     bool isAuthentic(crypto::HMAC& hmacComputer) const;
+    bool isAuthentic(const crypto::HmacSha1& hmacKey) const;
 
     StunMessage& operator=(const StunMessage& b);
 
@@ -347,6 +350,9 @@ public:
 
 private:
     void computeHMAC(crypto::HMAC& hmacComputer, uint8_t* hash20b) const;
+    void computeHMAC(const crypto::HmacSha1& hmacKey, uint8_t* hash20b) const;
+    int getDigestableLength() const;
+    const StunMessageIntegrity* getMessageIntegrity() const;
 };
 
 bool isStunMessage(const void* data, size_t length);
@@ -0,0 +1,83 @@
+#include "utils/Metrics.h"
+#include "utils/Format.h"
+#include <cinttypes>
+
+namespace
+{
+const utils::Histogram* const histograms[] = {&utils::metrics::engineTickDuration,
+    &utils::metrics::jobQueueWait,
+    &utils::metrics::receiveToSendLatency,
+    &utils::metrics::pacingQueueDelay,
+    &utils::metrics::pacingQueueDelayRtx,
+    &utils::metrics::pacingQueueDelayScreenShare,
+    &utils::metrics::pacingQueueDelayPinned,
+    &utils::metrics::pacingQueueDelayVideo,
+    &utils::metrics::pacingQueueDelayThumbnail};
+} // namespace
+
+namespace utils
+{
+
+Histogram::Histogram(const char* name, const char* help) : _name(name), _help(help), _sumNs(0)
+{
+    for (auto& bucket : _buckets)
+    {
+        bucket.store(0);
+    }
+}
+
+namespace metrics
+{
+
+Histogram engineTickDuration("smb_engine_tick_duration_seconds", "Time to run all mixers in one engine tick.");
+Histogram jobQueueWait("smb_job_queue_wait_seconds", "Time jobs wait in the worker job queue before running.");
+Histogram receiveToSendLatency("smb_receive_to_send_latency_seconds",
+    "Time from receiving a forwarded RTP packet until it is sent.");
+Histogram pacingQueueDelay("smb_pacing_queue_delay_seconds", "Time video packets wait in transport pacing queues.");
+Histogram pacingQueueDelayRtx("smb_pacing_queue_delay_rtx_seconds", "Time retransmissions wait in pacing queues.");
+Histogram pacingQueueDelayScreenShare("smb_pacing_queue_delay_screenshare_seconds",
+    "Time screen share packets wait in pacing queues.");
+Histogram pacingQueueDelayPinned("smb_pacing_queue_delay_pinned_seconds",
+    "Time pinned video packets wait in pacing queues.");
+Histogram pacingQueueDelayVideo("smb_pacing_queue_delay_video_seconds",
+    "Time other video packets wait in pacing queues.");
+Histogram pacingQueueDelayThumbnail("smb_pacing_queue_delay_thumbnail_seconds",
+    "Time thumbnail video packets wait in pacing queues.");
+
+void describe(std::string& out)
+{
+    for (const auto* histogram : histograms)
+    {
+        const char* name = histogram->getName();
+        out.append(utils::format("# TYPE %s histogram\n# HELP %s %s\n", name, name, histogram->getHelp()));
+        uint64_t cumulativeCount = 0;
+        for (uint32_t bucket = 0; bucket < Histogram::bucketCount; ++bucket)
+        {
+            cumulativeCount += histogram->getBucketCount(bucket);
+            out.append(utils::format("%s_bucket{le=\"%.6f\"} %" PRIu64 "\n",
+                name,
+                Histogram::getBucketBound(bucket) / 1.0e9,
+                cumulativeCount));
+        }
+        cumulativeCount += histogram->getBucketCount(Histogram::bucketCount);
+        out.append(utils::format("%s_bucket{le=\"+Inf\"} %" PRIu64 "\n", name, cumulativeCount));
+        out.append(utils::format("%s_sum %.9f\n%s_count %" PRIu64 "\n",
+            name,
+            histogram->getSumNs() / 1.0e9,
+            name,
+            cumulativeCount));
+    }
+}
+
+void describeGauge(std::string& out, const char* name, const char* help)
+{
+    out.append(utils::format("# TYPE %s gauge\n# HELP %s %s\n", name, name, help));
+}
+
+void appendGaugeValue(std::string& out, const char* name, const char* label, const char* labelValue, uint64_t value)
+{
+    out.append(utils::format("%s{%s=\"%s\"} %" PRIu64 "\n", name, label, labelValue, value));
+}
+
+} // namespace metrics
+} // namespace utils
@@ -0,0 +1,71 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace utils
+{
+
+/**
+ * Lock free latency histogram with power of two buckets from 1us to ~0.5s. Observing a value costs two relaxed atomic
+ * increments and can be done from any thread, including the engine thread.
+ */
+class Histogram
+{
+public:
+    static constexpr uint32_t bucketCount = 20;
+
+    Histogram(const char* name, const char* help);
+
+    void observe(uint64_t durationNs)
+    {
+        _buckets[getBucketIndex(durationNs)].fetch_add(1, std::memory_order_relaxed);
+        _sumNs.fetch_add(durationNs, std::memory_order_relaxed);
+    }
+
+    const char* getName() const { return _name; }
+    const char* getHelp() const { return _help; }
+
+    // upper bound of bucket in ns. The last bucket has no upper bound
+    static uint64_t getBucketBound(uint32_t index) { return 1000ull << index; }
+    uint64_t getBucketCount(uint32_t index) const { return _buckets[index].load(std::memory_order_relaxed); }
+    uint64_t getSumNs() const { return _sumNs.load(std::memory_order_relaxed); }
+
+    static uint32_t getBucketIndex(uint64_t durationNs)
+    {
+        const uint64_t durationUs = (durationNs + 999) / 1000;
+        if (durationUs <= 1)
+        {
+            return 0;
+        }
+        const uint32_t index = 64 - __builtin_clzll(durationUs - 1);
+        return index < bucketCount ? index : bucketCount;
+    }
+
+private:
+    const char* _name;
+    const char* _help;
+    std::array<std::atomic_uint64_t, bucketCount + 1> _buckets;
+    std::atomic_uint64_t _sumNs;
+};
+
+namespace metrics
+{
+// Appends all histograms in OpenMetrics text format
+void describe(std::string& out);
+void describeGauge(std::string& out, const char* name, const char* help);
+void appendGaugeValue(std::string& out, const char* name, const char* label, const char* labelValue, uint64_t value);
+
+extern Histogram engineTickDuration;
+extern Histogram jobQueueWait;
+extern Histogram receiveToSendLatency;
+extern Histogram pacingQueueDelay;
+extern Histogram pacingQueueDelayRtx;
+extern Histogram pacingQueueDelayScreenShare;
+extern Histogram pacingQueueDelayPinned;
+extern Histogram pacingQueueDelayVideo;
+extern Histogram pacingQueueDelayThumbnail;
+} // namespace metrics
+
+} // namespace utils
@@ -106,7 +106,7 @@ public:
         std::memset(_data, 0, S);
     }
 
-    bool endsWidth(char c) const { return _offset > 0 && _data[_offset - 1] == c; }
+    bool endsWith(char c) const { return _offset > 0 && _data[_offset - 1] == c; }
     bool empty() const { return _offset == 0; }
 
 private:
@@ -128,4 +128,69 @@ private:
     }
 };
 
+/**
+ * Growing counterpart of StringBuilder for bodies of unknown size, e.g. API responses written with json::writer.
+ * Reserve the expected size up front and release the string when done to avoid copies.
+ */
+class DynamicStringBuilder
+{
+public:
+    explicit DynamicStringBuilder(const size_t capacity) { _data.reserve(capacity); }
+
+    DynamicStringBuilder& append(const std::string& string)
+    {
+        _data.append(string);
+        return *this;
+    }
+
+    DynamicStringBuilder& append(const char* string)
+    {
+        _data.append(string);
+        return *this;
+    }
+
+    DynamicStringBuilder& append(const char* string, const size_t length)
+    {
+        _data.append(string, length);
+        return *this;
+    }
+
+    DynamicStringBuilder& append(const bool value)
+    {
+        _data.append(value ? "true" : "false");
+        return *this;
+    }
+
+    DynamicStringBuilder& append(const int32_t value)
+    {
+        char valueString[16];
+        auto count = std::snprintf(valueString, 16, "%d", value);
+        return append(valueString, count);
+    }
+
+    DynamicStringBuilder& append(const uint32_t value)
+    {
+        char valueString[16];
+        auto count = std::snprintf(valueString, 16, "%u", value);
+        return append(valueString, count);
+    }
+
+    DynamicStringBuilder& append(const size_t value)
+    {
+        char valueString[24];
+        auto count = std::snprintf(valueString, 24, "%zu", value);
+        return append(valueString, count);
+    }
+
+    const char* get() const { return _data.c_str(); }
+    size_t getLength() const { return _data.size(); }
+    std::string release() { return std::move(_data); }
+
+    bool endsWith(char c) const { return !_data.empty() && _data.back() == c; }
+    bool empty() const { return _data.empty(); }
+
+private:
+    std::string _data;
+};
+
 } // namespace utils
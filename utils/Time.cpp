@@ -1,5 +1,6 @@
 #include "utils/Time.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <stdio.h>
 #include <time.h>
@@ -11,11 +12,110 @@
 #include <ctime>
 #include <pthread.h>
 #endif
+#if defined(__x86_64__) && !defined(__APPLE__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define SMB_TSC_CLOCK 1
+#endif
 namespace
 {
 #ifdef __APPLE__
 struct mach_timebase_info machTimeBase;
 #endif
+
+// cached time is discarded when the time source is replaced
+std::atomic_uint32_t timeSourceGeneration(0);
+struct ApproximateTime
+{
+    uint64_t timestamp = 0;
+    uint32_t generation = 0;
+    bool isCaching = false; // only threads that invalidate or refresh the time use the cache
+    bool isSet = false;
+};
+thread_local ApproximateTime approximateTime;
+
+#ifdef SMB_TSC_CLOCK
+// Converts TSC ticks to ns since the calibration point. Invariant TSC runs at constant rate in all power states and
+// is synchronized across cores.
+class TscClock
+{
+public:
+    TscClock() : _enabled(false), _tscBase(0), _nsBase(0), _nsPerTickQ32(0) {}
+
+    bool calibrate()
+    {
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) || !(edx & (1u << 8)))
+        {
+            return false;
+        }
+
+        uint64_t startTsc = 0;
+        const uint64_t startNs = sample(startTsc);
+        const timespec calibrationTime = {0, 50'000'000};
+        ::nanosleep(&calibrationTime, nullptr);
+        uint64_t endTsc = 0;
+        const uint64_t endNs = sample(endTsc);
+
+        const uint64_t ticks = endTsc - startTsc;
+        const uint64_t elapsedNs = endNs - startNs;
+        if (endTsc <= startTsc || ticks < elapsedNs / 10 || ticks > elapsedNs * 10)
+        {
+            return false; // outside 100MHz - 10GHz
+        }
+
+        _nsPerTickQ32 = (static_cast<unsigned __int128>(elapsedNs) << 32) / ticks;
+        _tscBase = endTsc;
+        _nsBase = endNs;
+        _enabled.store(true, std::memory_order_release);
+        return true;
+    }
+
+    bool isEnabled() const { return _enabled.load(std::memory_order_acquire); }
+    void disable() { _enabled.store(false, std::memory_order_release); }
+
+    uint64_t now() const
+    {
+        const uint64_t ticks = __rdtsc() - _tscBase;
+        return _nsBase + static_cast<uint64_t>((static_cast<unsigned __int128>(ticks) * _nsPerTickQ32) >> 32);
+    }
+
+private:
+    static uint64_t monotonicNs()
+    {
+        timespec timeSpec = {};
+        clock_gettime(CLOCK_MONOTONIC, &timeSpec);
+        return static_cast<uint64_t>(timeSpec.tv_sec) * 1000000000ULL + static_cast<uint64_t>(timeSpec.tv_nsec);
+    }
+
+    // pair a TSC reading with CLOCK_MONOTONIC, taking the tightest of a few attempts to reduce preemption noise
+    static uint64_t sample(uint64_t& tsc)
+    {
+        uint64_t bestWindow = ~0ull;
+        uint64_t ns = 0;
+        for (int i = 0; i < 8; ++i)
+        {
+            const uint64_t before = __rdtsc();
+            const uint64_t timestamp = monotonicNs();
+            const uint64_t after = __rdtsc();
+            if (after - before < bestWindow)
+            {
+                bestWindow = after - before;
+                tsc = before + (after - before) / 2;
+                ns = timestamp;
+            }
+        }
+        return ns;
+    }
+
+    std::atomic_bool _enabled;
+    uint64_t _tscBase;
+    uint64_t _nsBase;
+    uint64_t _nsPerTickQ32;
+};
+
+TscClock tscClock;
+#endif
 } // namespace
 
 namespace utils
@@ -29,7 +129,16 @@ utils::TimeSource* _timeSource = nullptr;
 class TimeSourceImpl final : public utils::TimeSource
 {
 public:
-    uint64_t getAbsoluteTime() const override { return rawAbsoluteTime(); }
+    uint64_t getAbsoluteTime() const override
+    {
+#ifdef SMB_TSC_CLOCK
+        if (tscClock.isEnabled())
+        {
+            return tscClock.now();
+        }
+#endif
+        return rawAbsoluteTime();
+    }
 
     uint64_t getApproximateTime() const override
     {
@@ -122,6 +231,7 @@ void initialize(TimeSource& timeSource)
     }
 
     _timeSource = &timeSource;
+    ++timeSourceGeneration;
 }
 
 uint64_t getAbsoluteTime()
@@ -134,10 +244,61 @@ uint64_t getRawAbsoluteTime()
     return _defaultTimeSource.getAbsoluteTime();
 }
 
-// faster on Mac
 uint64_t getApproximateTime()
 {
-    return _timeSource->getApproximateTime();
+    if (!approximateTime.isCaching)
+    {
+        return _timeSource->getApproximateTime();
+    }
+
+    const auto generation = timeSourceGeneration.load(std::memory_order_relaxed);
+    if (!approximateTime.isSet || approximateTime.generation != generation)
+    {
+        approximateTime.timestamp = _timeSource->getAbsoluteTime();
+        approximateTime.generation = generation;
+        approximateTime.isSet = true;
+    }
+    return approximateTime.timestamp;
+}
+
+uint64_t refreshApproximateTime()
+{
+    approximateTime.timestamp = _timeSource->getAbsoluteTime();
+    approximateTime.generation = timeSourceGeneration.load(std::memory_order_relaxed);
+    approximateTime.isCaching = true;
+    approximateTime.isSet = true;
+    return approximateTime.timestamp;
+}
+
+void invalidateApproximateTime()
+{
+    approximateTime.isCaching = true;
+    approximateTime.isSet = false;
+}
+
+bool enableTscClock()
+{
+#ifdef SMB_TSC_CLOCK
+    return tscClock.isEnabled() || tscClock.calibrate();
+#else
+    return false;
+#endif
+}
+
+void disableTscClock()
+{
+#ifdef SMB_TSC_CLOCK
+    tscClock.disable();
+#endif
+}
+
+bool isTscClockEnabled()
+{
+#ifdef SMB_TSC_CLOCK
+    return tscClock.isEnabled();
+#else
+    return false;
+#endif
 }
 
 std::chrono::system_clock::time_point now()
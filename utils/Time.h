@@ -34,7 +34,24 @@ bool isDefaultTimeSource();
  */
 uint64_t getAbsoluteTime();
 uint64_t getRawAbsoluteTime();
+
+/**
+ * Returns the time cached on this thread. After invalidateApproximateTime the first call reads the clock and later
+ * calls reuse it, so a job step pays for at most one clock read however many callers it has. Threads that never
+ * refresh or invalidate get the time source value on every call.
+ */
 uint64_t getApproximateTime();
+uint64_t refreshApproximateTime();
+void invalidateApproximateTime();
+
+/**
+ * Use the invariant TSC instead of clock_gettime for the default time source. The TSC is calibrated against
+ * CLOCK_MONOTONIC, which blocks for a few tens of ms. Returns false and keeps clock_gettime if the CPU lacks an
+ * invariant TSC. Must be called before other threads read the time.
+ */
+bool enableTscClock();
+void disableTscClock();
+bool isTscClockEnabled();
 void nanoSleep(int64_t ns);
 void nanoSleep(int32_t ns);
 void nanoSleep(uint64_t ns);